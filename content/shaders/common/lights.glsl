@@ -0,0 +1,43 @@
+// Общие объявления источников света
+// Подключается через #include (см. utils::gl::ShaderPreprocessor)
+#pragma once
+
+// Размер массивов источников света (может быть задан при специализации шейдера)
+#ifndef MAX_LIGHT_SOURCES
+#define MAX_LIGHT_SOURCES 2
+#endif
+
+#define LIGHT_TYPE_AMBIENT 0
+#define LIGHT_TYPE_POINT 1
+#define LIGHT_TYPE_SPOT 2
+#define LIGHT_TYPE_DIRECTIONAL 3
+
+// Битовая маска присутствующих в сцене типов источников (по умолчанию - все типы)
+// Код обработки отсутствующих типов не попадает в программу
+#ifndef LIGHT_TYPE_MASK
+#define LIGHT_TYPE_MASK 0xF
+#endif
+
+#define HAS_AMBIENT ((LIGHT_TYPE_MASK & (1 << LIGHT_TYPE_AMBIENT)) != 0)
+#define HAS_POINT ((LIGHT_TYPE_MASK & (1 << LIGHT_TYPE_POINT)) != 0)
+#define HAS_SPOT ((LIGHT_TYPE_MASK & (1 << LIGHT_TYPE_SPOT)) != 0)
+#define HAS_DIRECTIONAL ((LIGHT_TYPE_MASK & (1 << LIGHT_TYPE_DIRECTIONAL)) != 0)
+
+uniform vec3   light_positions[MAX_LIGHT_SOURCES];
+uniform vec3   light_directions[MAX_LIGHT_SOURCES];
+uniform vec3   light_colors[MAX_LIGHT_SOURCES];
+uniform uint   light_types[MAX_LIGHT_SOURCES];
+uniform float  light_fall_offs[MAX_LIGHT_SOURCES];
+uniform float  light_hot_spots[MAX_LIGHT_SOURCES];
+uniform uint   light_count;
+
+// Типы источников известны на этапе компиляции (LIGHT_TYPES - список типов через запятую)
+// Кол-во итераций и типы становятся константами, цикл разворачивается без ветвлений по типу
+#ifdef LIGHT_TYPES
+const uint light_types_static[MAX_LIGHT_SOURCES] = uint[](LIGHT_TYPES);
+#define LIGHT_TYPE(i) light_types_static[i]
+#define LIGHT_COUNT MAX_LIGHT_SOURCES
+#else
+#define LIGHT_TYPE(i) light_types[i]
+#define LIGHT_COUNT light_count
+#endif
\ No newline at end of file
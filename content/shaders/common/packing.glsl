@@ -0,0 +1,12 @@
+// Распаковка сжатых атрибутов вершин (см. utils/geometry/pack.hpp)
+// Подключается через #include (см. utils::gl::ShaderPreprocessor)
+#pragma once
+
+// Восстановление единичного вектора из октаэдрической проекции (см. utils::geometry::pack_octahedral)
+vec3 oct_decode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#version 420 core
+
+layout (location = 0) out vec4 color;
+
+uniform vec3 object_color;
+
+#ifdef TEXTURED
+uniform sampler2D texture_sampler;
+#endif
+
+in VS_OUT {
+    vec2 uv;
+    vec3 normal;
+} fs_in;
+
+void main()
+{
+    // Направленный свет сверху и фоновая составляющая
+    float light = 0.35 + 0.65 * max(dot(normalize(fs_in.normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+
+#ifdef TEXTURED
+    vec3 albedo = texture(texture_sampler, fs_in.uv).rgb * object_color;
+#else
+    vec3 albedo = object_color;
+#endif
+
+    color = vec4(albedo * light, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 420 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+
+// Атрибуты экземпляра (матрица занимает 4 положения - 2, 3, 4, 5)
+layout (location = 2) in mat4 instance_model;
+layout (location = 6) in vec3 instance_color;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float time;
+
+out VS_OUT {
+    vec3 normal;
+    vec3 color;
+} vs_out;
+
+void main()
+{
+    // Волна по сетке экземпляров (анимация без обновления буфера экземпляров)
+    vec4 world = instance_model * vec4(position, 1.0);
+    world.y += sin(time * 2.0 + (instance_model[3].x + instance_model[3].z) * 0.3) * 0.5;
+
+    gl_Position = projection * view * world;
+
+    vs_out.normal = (instance_model * vec4(normal, 0.0)).xyz;
+    vs_out.color = instance_color;
+}
\ No newline at end of file
@@ -2,9 +2,19 @@
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 uv;
-layout (location = 2) in vec3 normal;
+layout (location = 2) in vec2 normal_oct;
 
+#include "../common/packing.glsl"
+
+#ifdef INSTANCED
+// Матрица модели экземпляра (занимает 4 положения - 3, 4, 5, 6), экземпляр выбирается командой через base_instance
+layout (location = 3) in mat4 instance_model;
+#define MODEL instance_model
+#else
 uniform mat4 model;
+#define MODEL model
+#endif
+
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -16,9 +26,9 @@ out VS_OUT {
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_Position = projection * view * MODEL * vec4(position, 1.0);
 
     vs_out.uv = uv;
-    vs_out.pos = (model * vec4(position, 1.0)).xyz;
-    vs_out.normal = (model * vec4(normal, 0.0)).xyz;
+    vs_out.pos = (MODEL * vec4(position, 1.0)).xyz;
+    vs_out.normal = (MODEL * vec4(oct_decode(normal_oct), 0.0)).xyz;
 }
\ No newline at end of file
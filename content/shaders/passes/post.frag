@@ -0,0 +1,47 @@
+#version 420 core
+
+layout (location = 0) out vec4 color;
+
+uniform sampler2D source_texture;
+
+// Доля текстуры, занятая кадром (динамическое разрешение - рендеринг в левый нижний участок текстуры)
+uniform vec2 uv_scale;
+
+in VS_OUT {
+    vec2 uv;
+} fs_in;
+
+// Выборка в пределах занятого участка (соседние тексели за его границей не принадлежат текущему кадру)
+vec3 sample_source(vec2 uv)
+{
+    vec2 half_texel = 0.5 / vec2(textureSize(source_texture, 0));
+    return texture(source_texture, clamp(uv, half_texel, uv_scale - half_texel)).rgb;
+}
+
+void main()
+{
+    vec2 uv = fs_in.uv * uv_scale;
+
+#if defined(BLUR_HORIZONTAL) || defined(BLUR_VERTICAL)
+    // Размытие по Гауссу вдоль одной оси (9 выборок с шагом в 2 текселя)
+    const float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+#ifdef BLUR_HORIZONTAL
+    vec2 texel = vec2(2.0 / float(textureSize(source_texture, 0).x), 0.0);
+#else
+    vec2 texel = vec2(0.0, 2.0 / float(textureSize(source_texture, 0).y));
+#endif
+    vec3 result = sample_source(uv) * weights[0];
+    for(int i = 1; i < 5; i++)
+    {
+        result += sample_source(uv + texel * float(i)) * weights[i];
+        result += sample_source(uv - texel * float(i)) * weights[i];
+    }
+    color = vec4(result, 1.0);
+#elif defined(VIGNETTE)
+    // Затемнение к краям кадра
+    float d = length(fs_in.uv - vec2(0.5)) * 1.4142;
+    color = vec4(sample_source(uv) * (1.0 - smoothstep(0.4, 1.0, d) * 0.8), 1.0);
+#else
+    color = vec4(sample_source(uv), 1.0);
+#endif
+}
\ No newline at end of file
@@ -4,11 +4,61 @@ layout (location = 0) out vec4 color;
 
 uniform sampler2D frame_texture;
 
+// Доля текстуры, занятая кадром (динамическое разрешение)
+uniform vec2 uv_scale;
+
+// Бикубическая фильтрация (Catmull-Rom), иначе - фильтрация, заданная параметрами текстуры
+uniform bool bicubic;
+
 in VS_OUT {
     vec2 uv;
 } fs_in;
 
+// Выборка в пределах занятого участка
+vec4 sample_frame(vec2 uv, vec2 texel)
+{
+    return texture(frame_texture, clamp(uv, texel * 0.5, uv_scale - texel * 0.5));
+}
+
+// Catmull-Rom за 9 билинейных выборок (веса соседних текселей по оси объединяются в одну выборку между ними)
+vec4 sample_catmull_rom(vec2 uv)
+{
+    vec2 size = vec2(textureSize(frame_texture, 0));
+    vec2 texel = 1.0 / size;
+
+    vec2 position = uv * size;
+    vec2 center = floor(position - 0.5) + 0.5;
+    vec2 f = position - center;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 offset12 = w2 / w12;
+
+    vec2 uv0 = (center - 1.0) * texel;
+    vec2 uv3 = (center + 2.0) * texel;
+    vec2 uv12 = (center + offset12) * texel;
+
+    vec4 result = vec4(0.0);
+    result += sample_frame(vec2(uv0.x, uv0.y), texel) * w0.x * w0.y;
+    result += sample_frame(vec2(uv12.x, uv0.y), texel) * w12.x * w0.y;
+    result += sample_frame(vec2(uv3.x, uv0.y), texel) * w3.x * w0.y;
+    result += sample_frame(vec2(uv0.x, uv12.y), texel) * w0.x * w12.y;
+    result += sample_frame(vec2(uv12.x, uv12.y), texel) * w12.x * w12.y;
+    result += sample_frame(vec2(uv3.x, uv12.y), texel) * w3.x * w12.y;
+    result += sample_frame(vec2(uv0.x, uv3.y), texel) * w0.x * w3.y;
+    result += sample_frame(vec2(uv12.x, uv3.y), texel) * w12.x * w3.y;
+    result += sample_frame(vec2(uv3.x, uv3.y), texel) * w3.x * w3.y;
+
+    // Отрицательные веса дают выход за пределы исходного диапазона
+    return max(result, vec4(0.0));
+}
+
 void main()
 {
-    color = texture(frame_texture, fs_in.uv);
+    vec2 uv = fs_in.uv * uv_scale;
+    color = bicubic ? sample_catmull_rom(uv) : sample_frame(uv, 1.0 / vec2(textureSize(frame_texture, 0)));
 }
\ No newline at end of file
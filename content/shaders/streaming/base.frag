@@ -0,0 +1,15 @@
+#version 430 core
+
+layout (location = 0) out vec4 color;
+
+in VS_OUT {
+    vec3 normal;
+    vec3 color;
+} fs_in;
+
+void main()
+{
+    // Простое направленное освещение с небольшой фоновой составляющей
+    float diffuse = max(dot(normalize(fs_in.normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+    color = vec4(fs_in.color * (diffuse * 0.8 + 0.2), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+
+// Данные экземпляра (обновляются каждый кадр)
+struct Instance
+{
+    mat4 model;
+    vec4 color;
+};
+
+// Матрицы камеры (обновляются каждый кадр)
+layout (std140, binding = 0) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+};
+
+// Буфер экземпляров (выбор по gl_InstanceID)
+layout (std430, binding = 0) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+out VS_OUT {
+    vec3 normal;
+    vec3 color;
+} vs_out;
+
+void main()
+{
+    Instance instance = instances[gl_InstanceID];
+
+    gl_Position = projection * view * instance.model * vec4(position, 1.0);
+
+    vs_out.normal = (instance.model * vec4(normal, 0.0)).xyz;
+    vs_out.color = instance.color.rgb;
+}
\ No newline at end of file
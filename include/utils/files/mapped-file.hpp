@@ -0,0 +1,267 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace utils::files
+{
+#ifdef _WIN32
+    namespace detail
+    {
+        /**
+         * Отобразить файл средствами Win32
+         * Заголовок не подключает windows.h (его макросы min/max, NEAR/FAR и прочие ломают пользовательский код),
+         * реализация компилируется в единице трансляции, определяющей MAPPED_FILE_IMPLEMENTATION
+         * @param path Путь к файлу
+         * @param file Дескриптор файла
+         * @param mapping Объект отображения
+         * @param data Отображенное содержимое (nullptr для пустого файла)
+         * @param size Размер содержимого
+         * @throws std::runtime_error Ошибка открытия либо отображения
+         */
+        void win32_map(const std::string& path, void*& file, void*& mapping, const void*& data, size_t& size);
+
+        /**
+         * Снять отображение и закрыть файл (Win32)
+         * @param file Дескриптор файла
+         * @param mapping Объект отображения
+         * @param data Отображенное содержимое
+         */
+        void win32_unmap(void* file, void* mapping, const void* data);
+    }
+#endif
+
+    /**
+     * Файл, отображенный в память (только чтение)
+     * Содержимое не копируется: страницы подгружаются системой при первом обращении,
+     * поэтому данные можно передавать напрямую в API (например, в glNamedBufferStorage)
+     */
+    class MappedFile final
+    {
+    public:
+        /**
+         * Конструктор по умолчанию (пустой объект)
+         */
+        MappedFile() = default;
+
+        /**
+         * Основной конструктор (отображает файл в память)
+         * @param path Путь к файлу
+         */
+        explicit MappedFile(const std::string& path)
+        {
+            if(!std::filesystem::exists(path))
+            {
+                throw std::runtime_error("Cant open file \"" + path + "\"");
+            }
+
+#ifdef _WIN32
+            detail::win32_map(path, file_, mapping_, data_, size_);
+#else
+            file_ = open(path.c_str(), O_RDONLY);
+            if(file_ < 0)
+            {
+                throw std::runtime_error("Cant open file \"" + path + "\"");
+            }
+
+            struct stat st = {};
+            fstat(file_, &st);
+            size_ = static_cast<size_t>(st.st_size);
+
+            if(size_ > 0)
+            {
+                void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_, 0);
+                if(data == MAP_FAILED)
+                {
+                    unmap();
+                    throw std::runtime_error("Cant map file \"" + path + "\"");
+                }
+                data_ = data;
+            }
+#endif
+        }
+
+        /**
+         * Запрет копирования через конструктор
+         * @param other Другой объект
+         */
+        MappedFile(const MappedFile& other) = delete;
+
+        /**
+         * Перемещение через конструктор
+         * @param other Другой объект
+         */
+        MappedFile(MappedFile&& other) noexcept
+            : file_(other.file_)
+#ifdef _WIN32
+            , mapping_(other.mapping_)
+#endif
+            , data_(other.data_)
+            , size_(other.size_)
+        {
+            other.file_ = INVALID_FILE;
+#ifdef _WIN32
+            other.mapping_ = nullptr;
+#endif
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+
+        /**
+         * Запрет копирования через присваивание
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+        /**
+         * Перемещение через присваивание
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if(this == &other) return *this;
+
+            unmap();
+            std::swap(file_, other.file_);
+#ifdef _WIN32
+            std::swap(mapping_, other.mapping_);
+#endif
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+
+            return *this;
+        }
+
+        /**
+         * Деструктор (снимает отображение и закрывает файл)
+         */
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        /**
+         * Снять отображение и закрыть файл
+         */
+        void unmap()
+        {
+#ifdef _WIN32
+            detail::win32_unmap(file_, mapping_, data_);
+            mapping_ = nullptr;
+#else
+            if(data_) munmap(const_cast<void*>(data_), size_);
+            if(file_ != INVALID_FILE) close(file_);
+#endif
+            file_ = INVALID_FILE;
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        /**
+         * Получить указатель на содержимое файла
+         * @return Указатель (nullptr для пустого файла)
+         */
+        [[nodiscard]] const void* data() const
+        {
+            return data_;
+        }
+
+        /**
+         * Получить размер файла
+         * @return Размер в байтах
+         */
+        [[nodiscard]] size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * Отображен ли файл
+         * @return Состояние
+         */
+        [[nodiscard]] bool ready() const
+        {
+            return data_ != nullptr;
+        }
+
+    private:
+#ifdef _WIN32
+        using FileHandle = void*;
+        static constexpr FileHandle INVALID_FILE = nullptr;
+#else
+        using FileHandle = int;
+        static constexpr FileHandle INVALID_FILE = -1;
+#endif
+
+        // Дескриптор файла
+        FileHandle file_ = INVALID_FILE;
+#ifdef _WIN32
+        // Объект отображения
+        void* mapping_ = nullptr;
+#endif
+        // Отображенное содержимое
+        const void* data_ = nullptr;
+        // Размер содержимого
+        size_t size_ = 0;
+    };
+}
+
+#if defined(_WIN32) && defined(MAPPED_FILE_IMPLEMENTATION)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+namespace utils::files::detail
+{
+    void win32_map(const std::string& path, void*& file, void*& mapping, const void*& data, size_t& size)
+    {
+        HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(handle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Cant open file \"" + path + "\"");
+        }
+
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(handle, &file_size);
+        file = handle;
+        size = static_cast<size_t>(file_size.QuadPart);
+        if(size == 0) return;
+
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if(!data)
+        {
+            win32_unmap(file, mapping, data);
+            file = nullptr;
+            mapping = nullptr;
+            size = 0;
+            throw std::runtime_error("Cant map file \"" + path + "\"");
+        }
+    }
+
+    void win32_unmap(void* file, void* mapping, const void* data)
+    {
+        if(data) UnmapViewOfFile(data);
+        if(mapping) CloseHandle(mapping);
+        if(file) CloseHandle(file);
+    }
+}
+
+#endif
\ No newline at end of file
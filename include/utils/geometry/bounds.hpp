@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace utils::geometry
+{
+    /**
+     * Ограничивающая сфера
+     */
+    struct BoundingSphere
+    {
+        glm::vec3 center = {0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+    };
+
+    /**
+     * Ограничивающий прямоугольный объем, выровненный по осям (AABB)
+     * Пустой объем (по умолчанию) имеет min > max и расширяется первой добавленной точкой
+     */
+    struct Aabb
+    {
+        glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+        /**
+         * Расширить объем до включения точки
+         * @param point Точка
+         */
+        void expand(const glm::vec3& point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        /**
+         * Расширить объем до включения другого объема
+         * @param other Другой объем
+         */
+        void expand(const Aabb& other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+
+        /**
+         * Центр объема
+         * @return Точка
+         */
+        [[nodiscard]] glm::vec3 center() const
+        {
+            return (min + max) * 0.5f;
+        }
+
+        /**
+         * Площадь поверхности (для оценки вероятности попадания луча, SAH)
+         * @return Площадь (0 для пустого объема)
+         */
+        [[nodiscard]] float surface_area() const
+        {
+            const glm::vec3 d = max - min;
+            if(d.x < 0.0f || d.y < 0.0f || d.z < 0.0f) return 0.0f;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        /**
+         * Пересекается ли с другим объемом
+         * @param other Другой объем
+         * @return Объемы пересекаются (или касаются)
+         */
+        [[nodiscard]] bool overlaps(const Aabb& other) const
+        {
+            return min.x <= other.max.x && max.x >= other.min.x &&
+                   min.y <= other.max.y && max.y >= other.min.y &&
+                   min.z <= other.max.z && max.z >= other.min.z;
+        }
+
+        bool operator==(const Aabb& other) const
+        {
+            return min == other.min && max == other.max;
+        }
+
+        bool operator!=(const Aabb& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Положение объема относительно пирамиды видимости
+     */
+    enum class EContainment : unsigned
+    {
+        // Целиком снаружи
+        OUTSIDE = 0,
+        // Пересекает границу
+        INTERSECTS,
+        // Целиком внутри
+        INSIDE
+    };
+
+    /**
+     * Пирамида видимости (6 плоскостей, нормали направлены внутрь)
+     * Плоскость задана вектором (нормаль, расстояние): точка p внутри, если dot(n, p) + d >= 0
+     */
+    struct Frustum
+    {
+        enum EPlane : unsigned
+        {
+            LEFT_PLANE = 0,
+            RIGHT_PLANE,
+            BOTTOM_PLANE,
+            TOP_PLANE,
+            NEAR_PLANE,
+            FAR_PLANE
+        };
+
+        glm::vec4 planes[6] = {};
+    };
+
+    /**
+     * Получить пирамиду видимости из матрицы (метод Gribb-Hartmann, клиппинг OpenGL -w <= z <= w)
+     * Для матрицы projection * view плоскости получаются в мировом пространстве,
+     * для projection * view * model - в пространстве объекта
+     * @param matrix Матрица преобразования в пространство отсечения
+     * @return Пирамида видимости (с нормализованными плоскостями)
+     */
+    inline Frustum extract_frustum(const glm::mat4& matrix)
+    {
+        // Строки матрицы (glm хранит столбцы)
+        const glm::vec4 r0 = {matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]};
+        const glm::vec4 r1 = {matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]};
+        const glm::vec4 r2 = {matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]};
+        const glm::vec4 r3 = {matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]};
+
+        Frustum frustum;
+        frustum.planes[Frustum::LEFT_PLANE] = r3 + r0;
+        frustum.planes[Frustum::RIGHT_PLANE] = r3 - r0;
+        frustum.planes[Frustum::BOTTOM_PLANE] = r3 + r1;
+        frustum.planes[Frustum::TOP_PLANE] = r3 - r1;
+        frustum.planes[Frustum::NEAR_PLANE] = r3 + r2;
+        frustum.planes[Frustum::FAR_PLANE] = r3 - r2;
+
+        for(auto& plane : frustum.planes)
+        {
+            const float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+            if(length > 0.0f) plane /= length;
+        }
+
+        return frustum;
+    }
+
+    /**
+     * Проверка пересечения сферы с пирамидой видимости (консервативная - сферы у ребер могут считаться видимыми)
+     * @param frustum Пирамида видимости
+     * @param center Центр сферы
+     * @param radius Радиус сферы
+     * @return Сфера хотя бы частично внутри
+     */
+    inline bool sphere_in_frustum(const Frustum& frustum, const glm::vec3& center, float radius)
+    {
+        for(const auto& plane : frustum.planes)
+        {
+            if(plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Положение прямоугольного объема относительно пирамиды видимости (консервативное, как и для сфер)
+     * @param frustum Пирамида видимости
+     * @param box Объем
+     * @return Снаружи, пересекает или целиком внутри
+     */
+    inline EContainment classify_aabb(const Frustum& frustum, const Aabb& box)
+    {
+        const glm::vec3 center = box.center();
+        const glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+        auto result = EContainment::INSIDE;
+        for(const auto& plane : frustum.planes)
+        {
+            // Расстояние от центра до плоскости и проекция половины размеров на нормаль
+            const float d = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float r = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+
+            if(d < -r) return EContainment::OUTSIDE;
+            if(d < r) result = EContainment::INTERSECTS;
+        }
+        return result;
+    }
+
+    /**
+     * Приближенная ограничивающая сфера набора точек (алгоритм Риттера)
+     * Начальная сфера строится по самой удаленной паре крайних точек вдоль осей, затем расширяется
+     * до включения всех точек (результат больше минимальной сферы не более чем на ~5-20%)
+     * @tparam P Функция получения точки по индексу - glm::vec3(size_t)
+     * @param count Кол-во точек
+     * @param point Функция получения точки
+     * @return Ограничивающая сфера
+     */
+    template<typename P>
+    inline BoundingSphere compute_bounding_sphere(size_t count, const P& point)
+    {
+        BoundingSphere sphere;
+        if(count == 0) return sphere;
+
+        // Крайние точки вдоль каждой оси
+        size_t min_index[3] = {0, 0, 0};
+        size_t max_index[3] = {0, 0, 0};
+        for(size_t i = 0; i < count; i++)
+        {
+            const glm::vec3 p = point(i);
+            for(int axis = 0; axis < 3; axis++)
+            {
+                if(p[axis] < point(min_index[axis])[axis]) min_index[axis] = i;
+                if(p[axis] > point(max_index[axis])[axis]) max_index[axis] = i;
+            }
+        }
+
+        // Начальная сфера по наиболее удаленной паре
+        int best_axis = 0;
+        float best_distance = -1.0f;
+        for(int axis = 0; axis < 3; axis++)
+        {
+            const glm::vec3 d = point(max_index[axis]) - point(min_index[axis]);
+            const float distance = glm::dot(d, d);
+            if(distance > best_distance)
+            {
+                best_distance = distance;
+                best_axis = axis;
+            }
+        }
+
+        const glm::vec3 a = point(min_index[best_axis]);
+        const glm::vec3 b = point(max_index[best_axis]);
+        sphere.center = (a + b) * 0.5f;
+        sphere.radius = glm::length(b - a) * 0.5f;
+
+        // Расширение сферы до включения всех точек
+        for(size_t i = 0; i < count; i++)
+        {
+            const glm::vec3 p = point(i);
+            const float distance = glm::length(p - sphere.center);
+            if(distance > sphere.radius)
+            {
+                const float radius = (sphere.radius + distance) * 0.5f;
+                sphere.center += (p - sphere.center) * ((radius - sphere.radius) / distance);
+                sphere.radius = radius;
+            }
+        }
+
+        return sphere;
+    }
+}
\ No newline at end of file
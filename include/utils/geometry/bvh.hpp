@@ -0,0 +1,535 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "bounds.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Луч (направление не обязательно нормализовано, расстояния измеряются в длинах направления)
+     */
+    struct Ray
+    {
+        glm::vec3 origin = {0.0f, 0.0f, 0.0f};
+        glm::vec3 direction = {0.0f, 0.0f, 1.0f};
+    };
+
+    /**
+     * Результат пересечения луча
+     */
+    struct RayHit
+    {
+        // Индекс объекта (NO_HIT - пересечения нет)
+        uint32_t object = std::numeric_limits<uint32_t>::max();
+        // Расстояние до точки пересечения
+        float distance = std::numeric_limits<float>::max();
+
+        /**
+         * Было ли пересечение
+         * @return Есть пересечение
+         */
+        [[nodiscard]] bool hit() const
+        {
+            return object != std::numeric_limits<uint32_t>::max();
+        }
+    };
+
+    /**
+     * Пересечение луча с прямоугольным объемом (метод плоскостей)
+     * @param box Объем
+     * @param origin Начало луча
+     * @param inv_direction Обратное направление луча (1 / direction)
+     * @param max_distance Максимальное расстояние
+     * @return Расстояние до входа в объем (отрицательное - пересечения нет, 0 - начало луча внутри)
+     */
+    inline float intersect_ray_aabb(const Aabb& box, const glm::vec3& origin, const glm::vec3& inv_direction, float max_distance)
+    {
+        const glm::vec3 t0 = (box.min - origin) * inv_direction;
+        const glm::vec3 t1 = (box.max - origin) * inv_direction;
+        const glm::vec3 t_near = glm::min(t0, t1);
+        const glm::vec3 t_far = glm::max(t0, t1);
+
+        const float enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+        const float exit = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance));
+        return enter <= exit ? enter : -1.0f;
+    }
+
+    /**
+     * Иерархия ограничивающих объемов (BVH) для пространственных запросов к объектам сцены
+     * Дерево строится по эвристике площадей поверхности (SAH, с разбиением центров на корзины) и хранится
+     * плоским массивом узлов в порядке обхода в глубину: левый потомок следует сразу за узлом, а индекс
+     * пропуска (skip) указывает на узел после поддерева. Объекты поддерева занимают непрерывный участок
+     * массива объектов, поэтому поддерево целиком внутри пирамиды видимости выдается без обхода.
+     * Для движущихся объектов достаточно пересчета объемов узлов (refit) без перестроения топологии
+     */
+    class Bvh
+    {
+    public:
+        /**
+         * Узел дерева
+         */
+        struct Node
+        {
+            // Объем узла
+            Aabb bounds;
+            // Первый объект поддерева (индекс в массиве объектов)
+            uint32_t first;
+            // Кол-во объектов поддерева
+            uint32_t count;
+            // Индекс узла, следующего за поддеревом (для листа - следующий узел)
+            uint32_t skip;
+        };
+
+        /**
+         * Отсутствующий узел (родитель корня)
+         */
+        constexpr static uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * Кол-во корзин для оценки разбиений
+         */
+        constexpr static size_t SAH_BINS = 16;
+
+        /**
+         * Максимальная глубина дерева (глубже узлы становятся листьями, ограничивает стек обхода лучом)
+         */
+        constexpr static uint32_t MAX_DEPTH = 48;
+
+    public:
+        /**
+         * Конструктор по умолчанию (пустое дерево)
+         */
+        Bvh() = default;
+
+        /**
+         * Построение дерева
+         * @param bounds Объемы объектов (индекс объекта - индекс в массиве)
+         * @param max_leaf_size Максимальное кол-во объектов в листе
+         */
+        void build(const std::vector<Aabb>& bounds, size_t max_leaf_size = 4)
+        {
+            nodes_.clear();
+            parents_.clear();
+            objects_.resize(bounds.size());
+            leaf_of_.assign(bounds.size(), NO_NODE);
+            max_leaf_size_ = std::max<size_t>(max_leaf_size, 1);
+            if(bounds.empty()) return;
+
+            for(size_t i = 0; i < bounds.size(); i++) objects_[i] = static_cast<uint32_t>(i);
+
+            centers_.resize(bounds.size());
+            for(size_t i = 0; i < bounds.size(); i++) centers_[i] = bounds[i].center();
+
+            nodes_.reserve(bounds.size() * 2 / max_leaf_size_ + 1);
+            build_node(bounds, 0, static_cast<uint32_t>(bounds.size()), NO_NODE, 0);
+
+            centers_.clear();
+            centers_.shrink_to_fit();
+        }
+
+        /**
+         * Полный пересчет объемов узлов (топология дерева не меняется)
+         * Потомки расположены в массиве после родителя, поэтому достаточно одного обратного прохода
+         * @param bounds Новые объемы объектов (кол-во объектов не должно меняться)
+         */
+        void refit(const std::vector<Aabb>& bounds)
+        {
+            for(size_t n = nodes_.size(); n-- > 0;)
+            {
+                auto& node = nodes_[n];
+                node.bounds = is_leaf(static_cast<uint32_t>(n))
+                        ? leaf_bounds(bounds, node)
+                        : merged_children(static_cast<uint32_t>(n));
+            }
+        }
+
+        /**
+         * Частичный пересчет объемов (только листья измененных объектов и их предки)
+         * Подъем к корню прекращается на узле, объем которого не изменился
+         * @param bounds Новые объемы объектов
+         * @param changed Индексы измененных объектов
+         */
+        void refit(const std::vector<Aabb>& bounds, const std::vector<uint32_t>& changed)
+        {
+            if(nodes_.empty()) return;
+
+            for(const uint32_t object : changed)
+            {
+                const uint32_t leaf = leaf_of_[object];
+                nodes_[leaf].bounds = leaf_bounds(bounds, nodes_[leaf]);
+
+                for(uint32_t n = parents_[leaf]; n != NO_NODE; n = parents_[n])
+                {
+                    const Aabb merged = merged_children(n);
+                    if(merged == nodes_[n].bounds) break;
+                    nodes_[n].bounds = merged;
+                }
+            }
+        }
+
+        /**
+         * Стоимость дерева по эвристике площадей поверхности (ожидаемая стоимость запроса лучом)
+         * Растет по мере пересчета объемов движущихся объектов, используется для решения о перестроении
+         * @return Стоимость (в единицах проверок объектов)
+         */
+        [[nodiscard]] float sah_cost() const
+        {
+            if(nodes_.empty()) return 0.0f;
+
+            const float root_area = std::max(nodes_[0].bounds.surface_area(), std::numeric_limits<float>::min());
+            float cost = 0.0f;
+            for(uint32_t n = 0; n < nodes_.size(); n++)
+            {
+                const float p = nodes_[n].bounds.surface_area() / root_area;
+                cost += is_leaf(n) ? p * static_cast<float>(nodes_[n].count) : p * TRAVERSAL_COST;
+            }
+            return cost;
+        }
+
+        /**
+         * Запрос объектов, пересекающих пирамиду видимости
+         * Поддеревья целиком внутри выдаются без дальнейших проверок, объекты листьев на границе
+         * выдаются без индивидуальной проверки (объем листа точно охватывает объекты)
+         * @tparam F Функция обработки объекта - void(uint32_t)
+         * @param frustum Пирамида видимости
+         * @param visit Функция обработки
+         */
+        template<typename F>
+        void query_frustum(const Frustum& frustum, const F& visit) const
+        {
+            uint32_t n = 0;
+            while(n < nodes_.size())
+            {
+                const auto& node = nodes_[n];
+                const auto containment = classify_aabb(frustum, node.bounds);
+
+                if(containment == EContainment::OUTSIDE)
+                {
+                    n = node.skip;
+                    continue;
+                }
+
+                if(containment == EContainment::INSIDE || is_leaf(n))
+                {
+                    for(uint32_t i = node.first; i < node.first + node.count; i++) visit(objects_[i]);
+                    n = node.skip;
+                    continue;
+                }
+
+                n++;
+            }
+        }
+
+        /**
+         * Запрос объектов, объемы листьев которых пересекают заданный объем
+         * @tparam F Функция проверки объекта - void(uint32_t), точная проверка выполняется вызывающей стороной
+         * @param box Объем запроса
+         * @param visit Функция обработки кандидата
+         */
+        template<typename F>
+        void query_overlap(const Aabb& box, const F& visit) const
+        {
+            uint32_t n = 0;
+            while(n < nodes_.size())
+            {
+                const auto& node = nodes_[n];
+                if(!node.bounds.overlaps(box))
+                {
+                    n = node.skip;
+                    continue;
+                }
+
+                if(is_leaf(n))
+                {
+                    for(uint32_t i = node.first; i < node.first + node.count; i++) visit(objects_[i]);
+                }
+                n++;
+            }
+        }
+
+        /**
+         * Поиск ближайшего пересечения луча
+         * Узлы обходятся от ближнего потомка к дальнему, поддеревья дальше найденного пересечения пропускаются
+         * @tparam F Функция точной проверки - float(uint32_t object, float max_distance),
+         *           возвращает расстояние до пересечения либо отрицательное значение
+         * @param ray Луч
+         * @param max_distance Максимальное расстояние
+         * @param intersect Функция проверки объекта
+         * @return Ближайшее пересечение
+         */
+        template<typename F>
+        [[nodiscard]] RayHit raycast(const Ray& ray, float max_distance, const F& intersect) const
+        {
+            RayHit result;
+            result.distance = max_distance;
+            if(nodes_.empty()) return result;
+
+            const glm::vec3 inv_direction = 1.0f / ray.direction;
+            if(intersect_ray_aabb(nodes_[0].bounds, ray.origin, inv_direction, result.distance) < 0.0f) return result;
+
+            // Узел глубины d оставляет в стеке не более d отложенных узлов и двух своих потомков
+            uint32_t stack[MAX_DEPTH + 2];
+            size_t stack_size = 0;
+            stack[stack_size++] = 0;
+
+            while(stack_size > 0)
+            {
+                const uint32_t n = stack[--stack_size];
+                const auto& node = nodes_[n];
+
+                if(is_leaf(n))
+                {
+                    for(uint32_t i = node.first; i < node.first + node.count; i++)
+                    {
+                        const float distance = intersect(objects_[i], result.distance);
+                        if(distance >= 0.0f && distance < result.distance)
+                        {
+                            result.distance = distance;
+                            result.object = objects_[i];
+                        }
+                    }
+                    continue;
+                }
+
+                // Потомки: левый - следующий узел, правый - узел после поддерева левого
+                const uint32_t left = n + 1;
+                const uint32_t right = nodes_[left].skip;
+                const float t_left = intersect_ray_aabb(nodes_[left].bounds, ray.origin, inv_direction, result.distance);
+                const float t_right = intersect_ray_aabb(nodes_[right].bounds, ray.origin, inv_direction, result.distance);
+
+                // Ближний потомок кладется в стек последним (обрабатывается первым)
+                assert(stack_size <= MAX_DEPTH);
+                if(t_left >= 0.0f && t_right >= 0.0f)
+                {
+                    const bool left_first = t_left <= t_right;
+                    stack[stack_size++] = left_first ? right : left;
+                    stack[stack_size++] = left_first ? left : right;
+                }
+                else if(t_left >= 0.0f) stack[stack_size++] = left;
+                else if(t_right >= 0.0f) stack[stack_size++] = right;
+            }
+
+            return result;
+        }
+
+        /**
+         * Узлы дерева (в порядке обхода в глубину, корень - первый)
+         * @return Массив узлов
+         */
+        [[nodiscard]] const std::vector<Node>& nodes() const
+        {
+            return nodes_;
+        }
+
+        /**
+         * Кол-во объектов
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t object_count() const
+        {
+            return objects_.size();
+        }
+
+        /**
+         * Является ли узел листом
+         * @param n Индекс узла
+         * @return Лист
+         */
+        [[nodiscard]] bool is_leaf(uint32_t n) const
+        {
+            return nodes_[n].skip == n + 1;
+        }
+
+    private:
+        /**
+         * Относительная стоимость обхода узла (к стоимости проверки объекта)
+         */
+        constexpr static float TRAVERSAL_COST = 1.0f;
+
+        /**
+         * Объем листа по объемам его объектов
+         * @param bounds Объемы объектов
+         * @param node Лист
+         * @return Объем
+         */
+        [[nodiscard]] Aabb leaf_bounds(const std::vector<Aabb>& bounds, const Node& node) const
+        {
+            Aabb result;
+            for(uint32_t i = node.first; i < node.first + node.count; i++) result.expand(bounds[objects_[i]]);
+            return result;
+        }
+
+        /**
+         * Объединение объемов потомков внутреннего узла
+         * @param n Индекс узла
+         * @return Объем
+         */
+        [[nodiscard]] Aabb merged_children(uint32_t n) const
+        {
+            Aabb result = nodes_[n + 1].bounds;
+            result.expand(nodes_[nodes_[n + 1].skip].bounds);
+            return result;
+        }
+
+        /**
+         * Рекурсивное построение поддерева для участка массива объектов
+         * @param bounds Объемы объектов
+         * @param begin Начало участка
+         * @param end Конец участка
+         * @param parent Индекс родителя
+         * @param depth Глубина узла
+         * @return Индекс узла
+         */
+        uint32_t build_node(const std::vector<Aabb>& bounds, uint32_t begin, uint32_t end, uint32_t parent, uint32_t depth)
+        {
+            const auto index = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back({});
+            parents_.push_back(parent);
+
+            Aabb node_bounds, center_bounds;
+            for(uint32_t i = begin; i < end; i++)
+            {
+                node_bounds.expand(bounds[objects_[i]]);
+                center_bounds.expand(centers_[objects_[i]]);
+            }
+
+            nodes_[index].bounds = node_bounds;
+            nodes_[index].first = begin;
+            nodes_[index].count = end - begin;
+
+            const uint32_t count = end - begin;
+            // На предельной глубине узел становится листом независимо от кол-ва объектов
+            assert(depth <= MAX_DEPTH);
+            const uint32_t mid = count > 1 && depth < MAX_DEPTH ? find_split(bounds, begin, end, node_bounds, center_bounds) : begin;
+
+            if(mid == begin || mid == end)
+            {
+                // Лист
+                for(uint32_t i = begin; i < end; i++) leaf_of_[objects_[i]] = index;
+                nodes_[index].skip = index + 1;
+                return index;
+            }
+
+            build_node(bounds, begin, mid, index, depth + 1);
+            build_node(bounds, mid, end, index, depth + 1);
+            nodes_[index].skip = static_cast<uint32_t>(nodes_.size());
+            return index;
+        }
+
+        /**
+         * Поиск разбиения участка по SAH (центры объектов распределяются по корзинам вдоль каждой оси)
+         * Объекты участка переупорядочиваются так, что левая часть предшествует правой
+         * @param bounds Объемы объектов
+         * @param begin Начало участка
+         * @param end Конец участка
+         * @param node_bounds Объем участка
+         * @param center_bounds Объем центров объектов участка
+         * @return Граница разбиения (begin или end - узел становится листом: объектов не больше допустимого
+         *         в листе и разбиение по SAH не дешевле проверки всех объектов листа)
+         */
+        uint32_t find_split(const std::vector<Aabb>& bounds, uint32_t begin, uint32_t end, const Aabb& node_bounds, const Aabb& center_bounds)
+        {
+            const uint32_t count = end - begin;
+            const glm::vec3 extent = center_bounds.max - center_bounds.min;
+
+            // Все центры совпадают - разбиение пополам по кол-ву (если объектов больше допустимого в листе)
+            if(extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f)
+            {
+                return count > max_leaf_size_ ? begin + count / 2 : begin;
+            }
+
+            struct Bin
+            {
+                Aabb bounds;
+                uint32_t count = 0;
+            };
+
+            float best_cost = std::numeric_limits<float>::max();
+            int best_axis = -1;
+            size_t best_bin = 0;
+
+            for(int axis = 0; axis < 3; axis++)
+            {
+                if(extent[axis] <= 0.0f) continue;
+
+                Bin bins[SAH_BINS];
+                const float scale = static_cast<float>(SAH_BINS) / extent[axis];
+                for(uint32_t i = begin; i < end; i++)
+                {
+                    const uint32_t object = objects_[i];
+                    const auto b = std::min(SAH_BINS - 1, static_cast<size_t>((centers_[object][axis] - center_bounds.min[axis]) * scale));
+                    bins[b].bounds.expand(bounds[object]);
+                    bins[b].count++;
+                }
+
+                // Площади и кол-ва слева и справа от каждой границы корзин
+                float right_area[SAH_BINS - 1];
+                uint32_t right_count[SAH_BINS - 1];
+                Aabb accumulated;
+                uint32_t accumulated_count = 0;
+                for(size_t b = SAH_BINS - 1; b > 0; b--)
+                {
+                    accumulated.expand(bins[b].bounds);
+                    accumulated_count += bins[b].count;
+                    right_area[b - 1] = accumulated.surface_area();
+                    right_count[b - 1] = accumulated_count;
+                }
+
+                accumulated = Aabb();
+                accumulated_count = 0;
+                for(size_t b = 0; b < SAH_BINS - 1; b++)
+                {
+                    accumulated.expand(bins[b].bounds);
+                    accumulated_count += bins[b].count;
+                    if(accumulated_count == 0 || right_count[b] == 0) continue;
+
+                    const float cost = accumulated.surface_area() * static_cast<float>(accumulated_count) +
+                                       right_area[b] * static_cast<float>(right_count[b]);
+                    if(cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_bin = b;
+                    }
+                }
+            }
+
+            // Сравнение со стоимостью листа (стоимость разбиения отнесена к площади узла),
+            // участок больше допустимого в листе разбивается в любом случае
+            const float area = node_bounds.surface_area();
+            const float split_cost = area > 0.0f ? TRAVERSAL_COST + best_cost / area : 0.0f;
+            if(best_axis < 0 || (count <= max_leaf_size_ && split_cost >= static_cast<float>(count)))
+            {
+                return count > max_leaf_size_ ? begin + count / 2 : begin;
+            }
+
+            const float scale = static_cast<float>(SAH_BINS) / extent[best_axis];
+            const float min = center_bounds.min[best_axis];
+            const auto middle = std::partition(objects_.begin() + begin, objects_.begin() + end, [&](uint32_t object){
+                return std::min(SAH_BINS - 1, static_cast<size_t>((centers_[object][best_axis] - min) * scale)) <= best_bin;
+            });
+
+            return static_cast<uint32_t>(middle - objects_.begin());
+        }
+
+        // Узлы (порядок обхода в глубину)
+        std::vector<Node> nodes_;
+        // Родители узлов (для частичного пересчета)
+        std::vector<uint32_t> parents_;
+        // Индексы объектов (объекты поддерева занимают непрерывный участок)
+        std::vector<uint32_t> objects_;
+        // Лист каждого объекта
+        std::vector<uint32_t> leaf_of_;
+        // Центры объемов объектов (только на время построения)
+        std::vector<glm::vec3> centers_;
+        // Максимальное кол-во объектов в листе
+        size_t max_leaf_size_ = 4;
+    };
+}
\ No newline at end of file
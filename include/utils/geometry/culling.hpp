@@ -0,0 +1,370 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../threads/job-system.hpp"
+#include "bounds.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Размер пакета для параллельного отсечения (элементов на задачу)
+     */
+    constexpr size_t CULL_BATCH_SIZE = 16384;
+
+    /**
+     * Набор ограничивающих сфер в виде структуры массивов (SoA)
+     * Каждая компонента хранится отдельным массивом, поэтому 8 сфер загружаются в регистры AVX без перестановок
+     */
+    struct SphereBoundsSoA
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        /**
+         * Добавить сферу
+         * @param sphere Ограничивающая сфера
+         */
+        void push_back(const BoundingSphere& sphere)
+        {
+            x.push_back(sphere.center.x);
+            y.push_back(sphere.center.y);
+            z.push_back(sphere.center.z);
+            radius.push_back(sphere.radius);
+        }
+
+        /**
+         * Задать сферу
+         * @param i Индекс
+         * @param sphere Ограничивающая сфера
+         */
+        void set(size_t i, const BoundingSphere& sphere)
+        {
+            x[i] = sphere.center.x;
+            y[i] = sphere.center.y;
+            z[i] = sphere.center.z;
+            radius[i] = sphere.radius;
+        }
+
+        /**
+         * Изменить кол-во сфер
+         * @param count Кол-во
+         */
+        void resize(size_t count)
+        {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+            radius.resize(count);
+        }
+
+        /**
+         * Кол-во сфер
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t size() const
+        {
+            return x.size();
+        }
+    };
+
+    /**
+     * Набор ограничивающих прямоугольных объемов (AABB) в виде структуры массивов (SoA)
+     * Объем задан центром и половиной размеров (так проверка с плоскостью не требует выбора вершины)
+     */
+    struct BoxBoundsSoA
+    {
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> center_z;
+        std::vector<float> extent_x;
+        std::vector<float> extent_y;
+        std::vector<float> extent_z;
+
+        /**
+         * Добавить объем
+         * @param min Минимальная точка
+         * @param max Максимальная точка
+         */
+        void push_back(const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 center = (min + max) * 0.5f;
+            const glm::vec3 extent = (max - min) * 0.5f;
+            center_x.push_back(center.x);
+            center_y.push_back(center.y);
+            center_z.push_back(center.z);
+            extent_x.push_back(extent.x);
+            extent_y.push_back(extent.y);
+            extent_z.push_back(extent.z);
+        }
+
+        /**
+         * Кол-во объемов
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t size() const
+        {
+            return center_x.size();
+        }
+    };
+
+    namespace detail
+    {
+#if defined(__AVX2__)
+        /**
+         * Таблица сжатия: для каждой 8-битной маски видимости - номера видимых элементов подряд и их кол-во
+         * Позволяет записать индексы видимых элементов одной операцией вместо цикла по битам
+         * @return Таблица (256 строк по 8 индексов и кол-ву)
+         */
+        inline const std::array<std::array<uint32_t, 9>, 256>& compaction_table()
+        {
+            static const auto table = [](){
+                std::array<std::array<uint32_t, 9>, 256> result = {};
+                for(unsigned mask = 0; mask < 256; mask++)
+                {
+                    unsigned n = 0;
+                    for(unsigned bit = 0; bit < 8; bit++)
+                    {
+                        if(mask & (1u << bit)) result[mask][n++] = bit;
+                    }
+                    result[mask][8] = n;
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        /**
+         * Записать индексы видимых элементов из 8 последовательных
+         * @param table Таблица сжатия
+         * @param out Выходной массив (должен иметь место под 8 значений)
+         * @param first Индекс первого из 8 элементов
+         * @param mask Маска видимости
+         * @return Кол-во записанных индексов
+         */
+        inline size_t compact8(const std::array<std::array<uint32_t, 9>, 256>& table, uint32_t* out, size_t first, int mask)
+        {
+            const auto& row = table[static_cast<unsigned>(mask)];
+            const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.data()));
+            const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), lanes);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), indices);
+            return row[8];
+        }
+#endif
+
+        /**
+         * Параллельное отсечение пакетами
+         * Пакет записывает видимые индексы в свой участок выходного массива, затем участки сдвигаются подряд
+         * (порядок индексов сохраняется)
+         * @tparam F Функция отсечения участка - size_t(begin, end, out)
+         * @param jobs Система задач
+         * @param count Кол-во элементов
+         * @param visible Индексы видимых элементов
+         * @param batch_size Размер пакета
+         * @param cull Функция отсечения
+         * @return Кол-во видимых
+         */
+        template<typename F>
+        inline size_t cull_parallel(threads::JobSystem& jobs, size_t count, std::vector<uint32_t>& visible, size_t batch_size, const F& cull)
+        {
+            visible.resize(count);
+            batch_size = std::max<size_t>(batch_size, 8);
+
+            const size_t batch_count = (count + batch_size - 1) / batch_size;
+            std::vector<size_t> batch_visible(batch_count, 0);
+
+            jobs.parallel_for(count, batch_size, [&](size_t begin, size_t end){
+                batch_visible[begin / batch_size] = cull(begin, end, visible.data() + begin);
+            });
+
+            size_t total = 0;
+            for(size_t b = 0; b < batch_count; b++)
+            {
+                if(total != b * batch_size)
+                {
+                    std::memmove(visible.data() + total, visible.data() + b * batch_size, batch_visible[b] * sizeof(uint32_t));
+                }
+                total += batch_visible[b];
+            }
+
+            visible.resize(total);
+            return total;
+        }
+    }
+
+    /**
+     * Отсечение сфер пирамидой видимости (участок набора)
+     * С AVX2 проверяется по 8 сфер за раз, индексы видимых записываются без ветвлений
+     * @param frustum Пирамида видимости
+     * @param bounds Набор сфер
+     * @param begin Первый элемент участка
+     * @param end Конец участка
+     * @param out Индексы видимых сфер (место не меньше end - begin значений)
+     * @return Кол-во видимых
+     */
+    inline size_t cull_spheres(const Frustum& frustum, const SphereBoundsSoA& bounds, size_t begin, size_t end, uint32_t* out)
+    {
+        size_t visible = 0;
+        size_t i = begin;
+
+#if defined(__AVX2__)
+        const auto& table = detail::compaction_table();
+        __m256 px[6], py[6], pz[6], pw[6];
+        for(size_t p = 0; p < 6; p++)
+        {
+            px[p] = _mm256_set1_ps(frustum.planes[p].x);
+            py[p] = _mm256_set1_ps(frustum.planes[p].y);
+            pz[p] = _mm256_set1_ps(frustum.planes[p].z);
+            pw[p] = _mm256_set1_ps(frustum.planes[p].w);
+        }
+
+        for(; i + 8 <= end; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(bounds.x.data() + i);
+            const __m256 y = _mm256_loadu_ps(bounds.y.data() + i);
+            const __m256 z = _mm256_loadu_ps(bounds.z.data() + i);
+            const __m256 neg_r = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(bounds.radius.data() + i));
+
+            // Сфера видима, если ни для одной плоскости не лежит целиком снаружи (dot(n, c) + w >= -r)
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for(size_t p = 0; p < 6; p++)
+            {
+                const __m256 d = _mm256_fmadd_ps(px[p], x, _mm256_fmadd_ps(py[p], y, _mm256_fmadd_ps(pz[p], z, pw[p])));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, neg_r, _CMP_GE_OQ));
+            }
+
+            visible += detail::compact8(table, out + visible, i, _mm256_movemask_ps(inside));
+        }
+#endif
+
+        for(; i < end; i++)
+        {
+            if(sphere_in_frustum(frustum, {bounds.x[i], bounds.y[i], bounds.z[i]}, bounds.radius[i]))
+            {
+                out[visible++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        return visible;
+    }
+
+    /**
+     * Отсечение прямоугольных объемов пирамидой видимости (участок набора)
+     * Объем снаружи плоскости, если проекция его половины размеров на нормаль меньше расстояния до центра
+     * @param frustum Пирамида видимости
+     * @param bounds Набор объемов
+     * @param begin Первый элемент участка
+     * @param end Конец участка
+     * @param out Индексы видимых объемов (место не меньше end - begin значений)
+     * @return Кол-во видимых
+     */
+    inline size_t cull_boxes(const Frustum& frustum, const BoxBoundsSoA& bounds, size_t begin, size_t end, uint32_t* out)
+    {
+        size_t visible = 0;
+        size_t i = begin;
+
+#if defined(__AVX2__)
+        const auto& table = detail::compaction_table();
+        __m256 px[6], py[6], pz[6], pw[6], ax[6], ay[6], az[6];
+        for(size_t p = 0; p < 6; p++)
+        {
+            px[p] = _mm256_set1_ps(frustum.planes[p].x);
+            py[p] = _mm256_set1_ps(frustum.planes[p].y);
+            pz[p] = _mm256_set1_ps(frustum.planes[p].z);
+            pw[p] = _mm256_set1_ps(frustum.planes[p].w);
+            ax[p] = _mm256_set1_ps(std::abs(frustum.planes[p].x));
+            ay[p] = _mm256_set1_ps(std::abs(frustum.planes[p].y));
+            az[p] = _mm256_set1_ps(std::abs(frustum.planes[p].z));
+        }
+
+        for(; i + 8 <= end; i += 8)
+        {
+            const __m256 cx = _mm256_loadu_ps(bounds.center_x.data() + i);
+            const __m256 cy = _mm256_loadu_ps(bounds.center_y.data() + i);
+            const __m256 cz = _mm256_loadu_ps(bounds.center_z.data() + i);
+            const __m256 ex = _mm256_loadu_ps(bounds.extent_x.data() + i);
+            const __m256 ey = _mm256_loadu_ps(bounds.extent_y.data() + i);
+            const __m256 ez = _mm256_loadu_ps(bounds.extent_z.data() + i);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for(size_t p = 0; p < 6; p++)
+            {
+                const __m256 d = _mm256_fmadd_ps(px[p], cx, _mm256_fmadd_ps(py[p], cy, _mm256_fmadd_ps(pz[p], cz, pw[p])));
+                const __m256 r = _mm256_fmadd_ps(ax[p], ex, _mm256_fmadd_ps(ay[p], ey, _mm256_mul_ps(az[p], ez)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, r), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+
+            visible += detail::compact8(table, out + visible, i, _mm256_movemask_ps(inside));
+        }
+#endif
+
+        for(; i < end; i++)
+        {
+            bool inside = true;
+            for(const auto& plane : frustum.planes)
+            {
+                const float d = plane.x * bounds.center_x[i] + plane.y * bounds.center_y[i] + plane.z * bounds.center_z[i] + plane.w;
+                const float r = std::abs(plane.x) * bounds.extent_x[i] + std::abs(plane.y) * bounds.extent_y[i] + std::abs(plane.z) * bounds.extent_z[i];
+                inside = inside && d + r >= 0.0f;
+            }
+            if(inside) out[visible++] = static_cast<uint32_t>(i);
+        }
+
+        return visible;
+    }
+
+    /**
+     * Параллельное отсечение сфер (пакеты распределяются по потокам системы задач)
+     * @param jobs Система задач
+     * @param frustum Пирамида видимости
+     * @param bounds Набор сфер
+     * @param count Кол-во проверяемых сфер (первые count элементов набора)
+     * @param visible Индексы видимых сфер (по возрастанию)
+     * @param batch_size Размер пакета
+     * @return Кол-во видимых
+     */
+    inline size_t cull_spheres(threads::JobSystem& jobs,
+                               const Frustum& frustum,
+                               const SphereBoundsSoA& bounds,
+                               size_t count,
+                               std::vector<uint32_t>& visible,
+                               size_t batch_size = CULL_BATCH_SIZE)
+    {
+        return detail::cull_parallel(jobs, count, visible, batch_size, [&](size_t begin, size_t end, uint32_t* out){
+            return cull_spheres(frustum, bounds, begin, end, out);
+        });
+    }
+
+    /**
+     * Параллельное отсечение прямоугольных объемов (пакеты распределяются по потокам системы задач)
+     * @param jobs Система задач
+     * @param frustum Пирамида видимости
+     * @param bounds Набор объемов
+     * @param count Кол-во проверяемых объемов (первые count элементов набора)
+     * @param visible Индексы видимых объемов (по возрастанию)
+     * @param batch_size Размер пакета
+     * @return Кол-во видимых
+     */
+    inline size_t cull_boxes(threads::JobSystem& jobs,
+                             const Frustum& frustum,
+                             const BoxBoundsSoA& bounds,
+                             size_t count,
+                             std::vector<uint32_t>& visible,
+                             size_t batch_size = CULL_BATCH_SIZE)
+    {
+        return detail::cull_parallel(jobs, count, visible, batch_size, [&](size_t begin, size_t end, uint32_t* out){
+            return cull_boxes(frustum, bounds, begin, end, out);
+        });
+    }
+}
\ No newline at end of file
@@ -1,233 +1,683 @@
 #pragma once
 
 #include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+#include "layout.hpp"
+
 namespace utils::geometry
 {
     /**
-     * Битовая маска для указания необходимых аттрибутов геометрии
+     * Размер генерируемого меша (для выделения буферов перед генерацией)
      */
-    enum EAttrBit : unsigned
+    struct MeshSize
     {
-        POSITION    = 1u << 0,
-        UV          = 1u << 1,
-        NORMAL      = 1u << 2,
-        COLOR       = 1u << 3
+        size_t vertex_count = 0;
+        size_t index_count = 0;
     };
 
+    namespace detail
+    {
+        constexpr float PI = 3.14159265358979323846f;
+
+        /**
+         * Запись аттрибутов в вершину
+         * Поля выбираются по раскладке вершины V::Layout на этапе компиляции (см. layout.hpp)
+         * @tparam V Тип вершины
+         * @param v Вершина
+         * @param pos Положение
+         * @param uv UV координаты
+         * @param normal Нормаль
+         * @param color Цвет
+         */
+        template<typename V>
+        inline void write_vertex(V& v, const glm::vec3& pos, const glm::vec2& uv, const glm::vec3& normal, const glm::vec3& color)
+        {
+            layout_of<V>::write(v, pos, uv, normal, color);
+        }
+
+        /**
+         * Цвет по умолчанию для поверхностей (по направлению нормали)
+         * @param normal Нормаль
+         * @return Цвет
+         */
+        inline glm::vec3 normal_color(const glm::vec3& normal)
+        {
+            return normal * 0.5f + glm::vec3(0.5f);
+        }
+
+        /**
+         * Точка профиля поверхности вращения (в плоскости радиус-высота)
+         */
+        struct ProfilePoint
+        {
+            // Расстояние до оси вращения
+            float radius = 0.0f;
+            // Высота
+            float y = 0.0f;
+            // Нормаль в плоскости профиля (составляющая от оси и вертикальная составляющая)
+            glm::vec2 normal = {1.0f, 0.0f};
+            // V координата текстуры
+            float v = 0.0f;
+        };
+
+        /**
+         * Размер поверхности вращения
+         * Точки профиля на оси (нулевой радиус) на концах профиля дают по одному треугольнику на сегмент
+         * Вырожденный профиль (меньше 2 точек, либо одна полоса между двумя полюсами) не дает треугольников
+         * @param segments Кол-во сегментов вокруг оси
+         * @param points Кол-во точек профиля
+         * @param top_pole Первая точка профиля лежит на оси
+         * @param bottom_pole Последняя точка профиля лежит на оси
+         * @return Размер
+         */
+        inline MeshSize revolve_size(unsigned segments, unsigned points, bool top_pole, bool bottom_pole)
+        {
+            const size_t rows = points > 0 ? points - 1 : 0;
+            const size_t pole_rows = rows > 0 ? (top_pole ? 1 : 0) + (bottom_pole ? 1 : 0) : 0;
+            return {
+                static_cast<size_t>(segments + 1) * points,
+                static_cast<size_t>(segments) * (rows * 2 - pole_rows) * 3
+            };
+        }
+
+        /**
+         * Генерация поверхности вращения профиля вокруг оси Y
+         * Профиль задается сверху вниз (по внешней стороне), передние грани заданы по часовой стрелке
+         * @tparam V Тип вершины
+         * @tparam P Тип функции профиля - ProfilePoint(unsigned index)
+         * @param out_vertices Буфер вершин
+         * @param out_indices Буфер индексов
+         * @param base_vertex Индекс первой вершины поверхности в буфере
+         * @param segments Кол-во сегментов вокруг оси
+         * @param points Кол-во точек профиля
+         * @param profile Функция профиля
+         * @param top_pole Первая точка профиля лежит на оси
+         * @param bottom_pole Последняя точка профиля лежит на оси
+         * @return Кол-во записанных индексов
+         */
+        template<typename V, typename P>
+        inline size_t revolve(V* out_vertices, GLuint* out_indices, GLuint base_vertex,
+                              unsigned segments, unsigned points, const P& profile, bool top_pole, bool bottom_pole)
+        {
+            const unsigned stride = segments + 1;
+
+            for(unsigned p = 0; p < points; p++)
+            {
+                const ProfilePoint point = profile(p);
+                for(unsigned s = 0; s <= segments; s++)
+                {
+                    const float u = static_cast<float>(s) / static_cast<float>(segments);
+                    const float phi = u * 2.0f * PI;
+                    const float sin_phi = std::sin(phi), cos_phi = std::cos(phi);
+
+                    const glm::vec3 pos = {point.radius * sin_phi, point.y, point.radius * cos_phi};
+                    const glm::vec3 normal = glm::normalize(glm::vec3(point.normal.x * sin_phi, point.normal.y, point.normal.x * cos_phi));
+
+                    write_vertex(out_vertices[base_vertex + p * stride + s],
+                                 pos, {u, point.v}, normal, normal_color(normal));
+                }
+            }
+
+            size_t count = 0;
+            for(unsigned p = 0; p + 1 < points; p++)
+            {
+                for(unsigned s = 0; s < segments; s++)
+                {
+                    const GLuint a = base_vertex + p * stride + s;
+                    const GLuint b = a + 1;
+                    const GLuint c = a + stride;
+                    const GLuint d = c + 1;
+
+                    if(!(top_pole && p == 0))
+                    {
+                        out_indices[count++] = a; out_indices[count++] = b; out_indices[count++] = d;
+                    }
+                    if(!(bottom_pole && p + 2 == points))
+                    {
+                        out_indices[count++] = d; out_indices[count++] = c; out_indices[count++] = a;
+                    }
+                }
+            }
+
+            return count;
+        }
+
+        /**
+         * Генерация диска (крышки) в горизонтальной плоскости
+         * @tparam V Тип вершины
+         * @param out_vertices Буфер вершин
+         * @param out_indices Буфер индексов
+         * @param base_vertex Индекс первой вершины диска в буфере
+         * @param radius Радиус
+         * @param y Высота
+         * @param up Нормаль направлена вверх (иначе вниз)
+         * @param segments Кол-во сегментов
+         * @return Кол-во записанных индексов
+         */
+        template<typename V>
+        inline size_t disk(V* out_vertices, GLuint* out_indices, GLuint base_vertex,
+                           float radius, float y, bool up, unsigned segments)
+        {
+            const glm::vec3 normal = {0.0f, up ? 1.0f : -1.0f, 0.0f};
+
+            write_vertex(out_vertices[base_vertex],
+                         {0.0f, y, 0.0f}, {0.5f, 0.5f}, normal, normal_color(normal));
+
+            for(unsigned s = 0; s <= segments; s++)
+            {
+                const float phi = static_cast<float>(s) / static_cast<float>(segments) * 2.0f * PI;
+                const float sin_phi = std::sin(phi), cos_phi = std::cos(phi);
+
+                write_vertex(out_vertices[base_vertex + 1 + s],
+                             {radius * sin_phi, y, radius * cos_phi}, {0.5f + 0.5f * sin_phi, 0.5f + 0.5f * cos_phi}, normal, normal_color(normal));
+            }
+
+            size_t count = 0;
+            for(unsigned s = 0; s < segments; s++)
+            {
+                out_indices[count++] = base_vertex;
+                out_indices[count++] = base_vertex + 1 + (up ? s + 1 : s);
+                out_indices[count++] = base_vertex + 1 + (up ? s : s + 1);
+            }
+
+            return count;
+        }
+    }
+
+    /**
+     * Размер квадрата
+     * @return Размер
+     */
+    inline MeshSize gen_quad_size()
+    {
+        return {4, 6};
+    }
+
+    /**
+     * Генерация квадрата обращенного в сторону камеры/экрана (в буферы вызывающей стороны)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_quad_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_quad_size().index_count, либо nullptr)
+     * @param size Размер стороны квадрата
+     */
+    template<typename V>
+    inline void gen_quad(V* out_vertices, GLuint* out_indices, float size)
+    {
+        constexpr float corners[4][2] = {{-1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, -1.0f}};
+        constexpr float colors[4][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f}};
+
+        for(size_t i = 0; i < 4; i++)
+        {
+            detail::write_vertex(out_vertices[i],
+                                 {corners[i][0] * (size/2.0f), corners[i][1] * (size/2.0f), 0.0f},
+                                 {(corners[i][0] + 1.0f) * 0.5f, (corners[i][1] + 1.0f) * 0.5f},
+                                 {0.0f, 0.0f, 1.0f},
+                                 {colors[i][0], colors[i][1], colors[i][2]});
+        }
+
+        if(out_indices)
+        {
+            constexpr GLuint indices[6] = {0,1,2, 2,3,0};
+            std::copy(indices, indices + 6, out_indices);
+        }
+    }
+
     /**
      * Генерация квадрата обращенного в сторону камеры/экрана
      * @tparam V Тип вершины
      * @param size Размер стороны квадрата
-     * @param req_attr Необходимые аттрибуты
-     * @param pos_offset Сдвиг в структуре для аттрибута "положения"
-     * @param uv_offset Сдвиг в структуре для аттрибута "uv"
-     * @param normal_offset Сдвиг в структуре для аттрибута "нормаль"
-     * @param color_offset Сдвиг а структуре для аттрибута "цвет"
      * @param out_indices Указатель на массив индексов
      * @return Массив вершин
      */
     template<typename V>
-    inline std::vector<V> gen_quad(float size, unsigned req_attr,
-                                   size_t pos_offset = 0,
-                                   size_t uv_offset = 0,
-                                   size_t normal_offset = 0,
-                                   size_t color_offset = 0,
-                                   std::vector<GLuint>* out_indices = nullptr)
-    {
-        std::vector<glm::vec3> positions = {
-                {-(size/2.0f), -(size/2.0f), 0.0f},
-                {-(size/2.0f), (size/2.0f), 0.0f},
-                {(size/2.0f), (size/2.0f), 0.0f},
-                {(size/2.0f), -(size/2.0f), 0.0f}
+    inline std::vector<V> gen_quad(float size, std::vector<GLuint>* out_indices = nullptr)
+    {
+        const MeshSize mesh = gen_quad_size();
+        std::vector<V> vertices(mesh.vertex_count);
+        if(out_indices) out_indices->resize(mesh.index_count);
+
+        gen_quad(vertices.data(), out_indices ? out_indices->data() : nullptr, size);
+
+        return vertices;
+    }
+
+    /**
+     * Размер куба
+     * @return Размер
+     */
+    inline MeshSize gen_cube_size()
+    {
+        return {24, 36};
+    }
+
+    /**
+     * Генерация куба (в буферы вызывающей стороны)
+     * Каждая грань имеет собственные вершины, цвета углов грани совпадают с цветами квадрата
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_cube_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_cube_size().index_count, либо nullptr)
+     * @param size Размер стороны куба
+     */
+    template<typename V>
+    inline void gen_cube(V* out_vertices, GLuint* out_indices, float size)
+    {
+        // Нормаль грани и оси, вдоль которых откладываются углы грани (u - вправо, v - вверх, если смотреть на грань)
+        constexpr float faces[6][3][3] = {
+                {{0.0f, 0.0f, 1.0f},  {1.0f, 0.0f, 0.0f},  {0.0f, 1.0f, 0.0f}},
+                {{1.0f, 0.0f, 0.0f},  {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+                {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+                {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f},  {0.0f, 1.0f, 0.0f}},
+                {{0.0f, 1.0f, 0.0f},  {1.0f, 0.0f, 0.0f},  {0.0f, 0.0f, -1.0f}},
+                {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f},  {0.0f, 0.0f, 1.0f}}
+        };
+        constexpr float corners[4][2] = {{-1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, -1.0f}};
+        constexpr float colors[4][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f}};
+
+        for(size_t f = 0; f < 6; f++)
+        {
+            const glm::vec3 n = {faces[f][0][0], faces[f][0][1], faces[f][0][2]};
+            const glm::vec3 u = {faces[f][1][0], faces[f][1][1], faces[f][1][2]};
+            const glm::vec3 v = {faces[f][2][0], faces[f][2][1], faces[f][2][2]};
+
+            for(size_t i = 0; i < 4; i++)
+            {
+                detail::write_vertex(out_vertices[f * 4 + i],
+                                     (n + u * corners[i][0] + v * corners[i][1]) * (size/2.0f),
+                                     {(corners[i][0] + 1.0f) * 0.5f, (corners[i][1] + 1.0f) * 0.5f},
+                                     n,
+                                     {colors[i][0], colors[i][1], colors[i][2]});
+            }
+
+            if(out_indices)
+            {
+                const auto b = static_cast<GLuint>(f * 4);
+                const GLuint indices[6] = {b, b + 1, b + 2, b + 2, b + 3, b};
+                std::copy(indices, indices + 6, out_indices + f * 6);
+            }
+        }
+    }
+
+    /**
+     * Генерация куба
+     * @tparam V Тип вершины
+     * @param size Размер стороны куба
+     * @param out_indices Указатель на массив индексов
+     * @return Массив вершин
+     */
+    template<typename V>
+    inline std::vector<V> gen_cube(float size, std::vector<GLuint>* out_indices = nullptr)
+    {
+        const MeshSize mesh = gen_cube_size();
+        std::vector<V> vertices(mesh.vertex_count);
+        if(out_indices) out_indices->resize(mesh.index_count);
+
+        gen_cube(vertices.data(), out_indices ? out_indices->data() : nullptr, size);
+
+        return vertices;
+    }
+
+    /**
+     * Размер UV сферы
+     * @param segments Кол-во сегментов по долготе (не менее 3)
+     * @param rings Кол-во колец по широте (не менее 2)
+     * @return Размер
+     */
+    inline MeshSize gen_sphere_uv_size(unsigned segments, unsigned rings)
+    {
+        return detail::revolve_size(segments, rings + 1, true, true);
+    }
+
+    /**
+     * Генерация UV сферы (сетка по долготе и широте)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_sphere_uv_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_sphere_uv_size().index_count)
+     * @param radius Радиус
+     * @param segments Кол-во сегментов по долготе (не менее 3)
+     * @param rings Кол-во колец по широте (не менее 2)
+     */
+    template<typename V>
+    inline void gen_sphere_uv(V* out_vertices, GLuint* out_indices, float radius, unsigned segments, unsigned rings)
+    {
+        auto profile = [&](unsigned p) -> detail::ProfilePoint
+        {
+            const float t = static_cast<float>(p) / static_cast<float>(rings);
+            const float theta = t * detail::PI;
+            const float s = p == 0 || p == rings ? 0.0f : std::sin(theta);
+            return {radius * s, radius * std::cos(theta), {s, std::cos(theta)}, 1.0f - t};
         };
-        std::vector<glm::vec2> uvs = {
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f}
+
+        detail::revolve(out_vertices, out_indices, 0, segments, rings + 1, profile, true, true);
+    }
+
+    /**
+     * Размер икосферы
+     * @param subdivisions Кол-во подразбиений икосаэдра (каждое увеличивает кол-во треугольников в 4 раза)
+     * @return Размер
+     */
+    inline MeshSize gen_sphere_ico_size(unsigned subdivisions)
+    {
+        const size_t faces = static_cast<size_t>(20) << (2 * subdivisions);
+        return {faces / 2 + 2, faces * 3};
+    }
+
+    /**
+     * Генерация икосферы (подразбиение икосаэдра, треугольники примерно одинаковой площади)
+     * Вершины общие для соседних треугольников, поэтому на шве UV координат возможны искажения
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_sphere_ico_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_sphere_ico_size().index_count)
+     * @param radius Радиус
+     * @param subdivisions Кол-во подразбиений икосаэдра
+     */
+    template<typename V>
+    inline void gen_sphere_ico(V* out_vertices, GLuint* out_indices, float radius, unsigned subdivisions)
+    {
+        const MeshSize mesh = gen_sphere_ico_size(subdivisions);
+
+        // Направления вершин (нормали) - единственный промежуточный массив, нужен для поиска середин ребер
+        std::vector<glm::vec3> directions;
+        directions.reserve(mesh.vertex_count);
+
+        const float g = (1.0f + std::sqrt(5.0f)) * 0.5f;
+        const float base[12][3] = {
+                {-1, g, 0}, {1, g, 0}, {-1, -g, 0}, {1, -g, 0},
+                {0, -1, g}, {0, 1, g}, {0, -1, -g}, {0, 1, -g},
+                {g, 0, -1}, {g, 0, 1}, {-g, 0, -1}, {-g, 0, 1}
         };
-        std::vector<glm::vec3> normals = {
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f}
+        for(const auto& b : base) directions.push_back(glm::normalize(glm::vec3(b[0], b[1], b[2])));
+
+        // Индексы строятся на месте в буфере вызывающей стороны (каждый уровень пишется в конец буфера)
+        constexpr GLuint faces[20][3] = {
+                {0, 5, 11}, {0, 1, 5}, {0, 7, 1}, {0, 10, 7}, {0, 11, 10},
+                {1, 9, 5}, {5, 4, 11}, {11, 2, 10}, {10, 6, 7}, {7, 8, 1},
+                {3, 4, 9}, {3, 2, 4}, {3, 6, 2}, {3, 8, 6}, {3, 9, 8},
+                {4, 5, 9}, {2, 11, 4}, {6, 10, 2}, {8, 7, 6}, {9, 1, 8}
         };
-        std::vector<glm::vec3> colors = {
-                {1.0f, 0.0f,0.0f},
-                {0.0f, 1.0f,0.0f},
-                {0.0f, 0.0f,1.0f},
-                {1.0f, 1.0f,0.0f}
+
+        size_t face_count = 20;
+        GLuint* current = out_indices + (mesh.index_count - face_count * 3);
+        for(size_t f = 0; f < face_count; f++)
+        {
+            for(size_t k = 0; k < 3; k++) current[f * 3 + k] = faces[f][k];
+        }
+
+        std::unordered_map<uint64_t, GLuint> midpoints;
+        auto midpoint = [&](GLuint a, GLuint b) -> GLuint
+        {
+            const uint64_t key = a < b ? (static_cast<uint64_t>(a) << 32u) | b : (static_cast<uint64_t>(b) << 32u) | a;
+            if(auto it = midpoints.find(key); it != midpoints.end()) return it->second;
+
+            directions.push_back(glm::normalize(directions[a] + directions[b]));
+            const auto index = static_cast<GLuint>(directions.size() - 1);
+            midpoints.emplace(key, index);
+            return index;
         };
 
-        std::vector<V> vertices(4);
-        for(size_t i = 0; i < vertices.size(); i++)
+        for(unsigned level = 0; level < subdivisions; level++)
         {
-            auto& v = vertices[i];
-            auto* pos = (glm::vec3*)((char*)(&(v)) + pos_offset);
-            auto* uv = (glm::vec2*)((char*)(&(v)) + uv_offset);
-            auto* normal = (glm::vec3*)((char*)(&(v)) + normal_offset);
-            auto* color = (glm::vec3*)((char*)(&(v)) + color_offset);
+            // Новый уровень в 4 раза больше и заканчивается в конце буфера, поэтому треугольники
+            // читаются раньше, чем перезаписываются (результат пишется с начала нового диапазона)
+            GLuint* next = out_indices + (mesh.index_count - face_count * 12);
+            for(size_t f = 0; f < face_count; f++)
+            {
+                const GLuint a = current[f * 3], b = current[f * 3 + 1], c = current[f * 3 + 2];
+                const GLuint ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                const GLuint result[12] = {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca};
+                std::copy(result, result + 12, next + f * 12);
+            }
 
-            if(req_attr & EAttrBit::POSITION) *pos = positions[i];
-            if(req_attr & EAttrBit::UV) *uv = uvs[i];
-            if(req_attr & EAttrBit::NORMAL) *normal = normals[i];
-            if(req_attr & EAttrBit::COLOR) *color = colors[i];
+            midpoints.clear();
+            face_count *= 4;
+            current = next;
         }
 
-        if(out_indices)
+        for(size_t i = 0; i < directions.size(); i++)
         {
-            *out_indices = {0,1,2, 2,3,0};
+            const glm::vec3& n = directions[i];
+            const glm::vec2 uv = {0.5f + std::atan2(n.x, n.z) / (2.0f * detail::PI), 0.5f + std::asin(n.y) / detail::PI};
+            detail::write_vertex(out_vertices[i],
+                                 n * radius, uv, n, detail::normal_color(n));
         }
+    }
 
-        return vertices;
+    /**
+     * Размер цилиндра
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param stacks Кол-во сегментов по высоте (не менее 1)
+     * @param caps Генерировать крышки
+     * @return Размер
+     */
+    inline MeshSize gen_cylinder_size(unsigned segments, unsigned stacks, bool caps = true)
+    {
+        MeshSize size = detail::revolve_size(segments, stacks + 1, false, false);
+        if(caps)
+        {
+            size.vertex_count += 2 * static_cast<size_t>(segments + 2);
+            size.index_count += 2 * static_cast<size_t>(segments) * 3;
+        }
+        return size;
     }
 
     /**
-     * Генерация куба
+     * Генерация цилиндра (ось Y, центр в начале координат)
      * @tparam V Тип вершины
-     * @param size Размер стороны куба
-     * @param req_attr Необходимые аттрибуты
-     * @param pos_offset Сдвиг в структуре для аттрибута "положения"
-     * @param uv_offset Сдвиг в структуре для аттрибута "uv"
-     * @param normal_offset Сдвиг в структуре для аттрибута "нормаль"
-     * @param color_offset Сдвиг а структуре для аттрибута "цвет"
-     * @param out_indices Указатель на массив индексов
-     * @return Массив вершин
+     * @param out_vertices Буфер вершин (не менее gen_cylinder_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_cylinder_size().index_count)
+     * @param radius Радиус
+     * @param height Высота
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param stacks Кол-во сегментов по высоте (не менее 1)
+     * @param caps Генерировать крышки
      */
     template<typename V>
-    inline std::vector<V> gen_cube(float size, unsigned req_attr,
-                                   size_t pos_offset = 0,
-                                   size_t uv_offset = 0,
-                                   size_t normal_offset = 0,
-                                   size_t color_offset = 0,
-                                   std::vector<GLuint>* out_indices = nullptr)
-    {
-        std::vector<glm::vec3> positions = {
-                {-(size/2.0f), -(size/2.0f), (size/2.0f)},
-                {-(size/2.0f), (size/2.0f), (size/2.0f)},
-                {(size/2.0f), (size/2.0f), (size/2.0f)},
-                {(size/2.0f), -(size/2.0f), (size/2.0f)},
-
-                {(size/2.0f), -(size/2.0f), (size/2.0f)},
-                {(size/2.0f), (size/2.0f), (size/2.0f)},
-                {(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {(size/2.0f), -(size/2.0f), -(size/2.0f)},
-
-                {(size/2.0f), -(size/2.0f), -(size/2.0f)},
-                {(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {-(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {-(size/2.0f), -(size/2.0f), -(size/2.0f)},
-
-                {-(size/2.0f), -(size/2.0f), -(size/2.0f)},
-                {-(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {-(size/2.0f), (size/2.0f), (size/2.0f)},
-                {-(size/2.0f), -(size/2.0f), (size/2.0f)},
-
-                {-(size/2.0f), (size/2.0f), (size/2.0f)},
-                {-(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {(size/2.0f), (size/2.0f), -(size/2.0f)},
-                {(size/2.0f), (size/2.0f), (size/2.0f)},
-
-                {-(size/2.0f), -(size/2.0f), -(size/2.0f)},
-                {-(size/2.0f), -(size/2.0f), (size/2.0f)},
-                {(size/2.0f), -(size/2.0f), (size/2.0f)},
-                {(size/2.0f), -(size/2.0f), -(size/2.0f)},
+    inline void gen_cylinder(V* out_vertices, GLuint* out_indices, float radius, float height, unsigned segments, unsigned stacks, bool caps = true)
+    {
+        auto profile = [&](unsigned p) -> detail::ProfilePoint
+        {
+            const float t = static_cast<float>(p) / static_cast<float>(stacks);
+            return {radius, height * (0.5f - t), {1.0f, 0.0f}, 1.0f - t};
         };
-        std::vector<glm::vec2> uvs = {
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f},
-
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f},
-
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f},
-
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f},
-
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f},
-
-                {0.0f, 0.0f},
-                {0.0f, 1.0f},
-                {1.0f, 1.0f},
-                {1.0f, 0.0f}
+
+        const MeshSize side = detail::revolve_size(segments, stacks + 1, false, false);
+        size_t count = detail::revolve(out_vertices, out_indices, 0, segments, stacks + 1, profile, false, false);
+
+        if(caps)
+        {
+            const auto top = static_cast<GLuint>(side.vertex_count);
+            const auto bottom = static_cast<GLuint>(top + segments + 2);
+            count += detail::disk(out_vertices, out_indices + count, top, radius, height * 0.5f, true, segments);
+            detail::disk(out_vertices, out_indices + count, bottom, radius, -height * 0.5f, false, segments);
+        }
+    }
+
+    /**
+     * Размер конуса
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param stacks Кол-во сегментов по высоте (не менее 1)
+     * @param cap Генерировать основание
+     * @return Размер
+     */
+    inline MeshSize gen_cone_size(unsigned segments, unsigned stacks, bool cap = true)
+    {
+        MeshSize size = detail::revolve_size(segments, stacks + 1, true, false);
+        if(cap)
+        {
+            size.vertex_count += static_cast<size_t>(segments + 2);
+            size.index_count += static_cast<size_t>(segments) * 3;
+        }
+        return size;
+    }
+
+    /**
+     * Генерация конуса (ось Y, вершина сверху, центр высоты в начале координат)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_cone_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_cone_size().index_count)
+     * @param radius Радиус основания
+     * @param height Высота
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param stacks Кол-во сегментов по высоте (не менее 1)
+     * @param cap Генерировать основание
+     */
+    template<typename V>
+    inline void gen_cone(V* out_vertices, GLuint* out_indices, float radius, float height, unsigned segments, unsigned stacks, bool cap = true)
+    {
+        // Нормаль боковой поверхности перпендикулярна образующей
+        const glm::vec2 normal = glm::normalize(glm::vec2(height, radius));
+
+        auto profile = [&](unsigned p) -> detail::ProfilePoint
+        {
+            const float t = static_cast<float>(p) / static_cast<float>(stacks);
+            return {radius * t, height * (0.5f - t), normal, 1.0f - t};
         };
-        std::vector<glm::vec3> normals = {
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f},
-                {0.0f, 0.0f, 1.0f},
-
-                {1.0f, 0.0f, 0.0f},
-                {1.0f, 0.0f, 0.0f},
-                {1.0f, 0.0f, 0.0f},
-                {1.0f, 0.0f, 0.0f},
-
-                {0.0f, 0.0f, -1.0f},
-                {0.0f, 0.0f, -1.0f},
-                {0.0f, 0.0f, -1.0f},
-                {0.0f, 0.0f, -1.0f},
-
-                {-1.0f, 0.0f, 0.0f},
-                {-1.0f, 0.0f, 0.0f},
-                {-1.0f, 0.0f, 0.0f},
-                {-1.0f, 0.0f, 0.0f},
-
-                {0.0f, 1.0f, 0.0f},
-                {0.0f, 1.0f, 0.0f},
-                {0.0f, 1.0f, 0.0f},
-                {0.0f, 1.0f, 0.0f},
-
-                {0.0f, -1.0f, 0.0f},
-                {0.0f, -1.0f, 0.0f},
-                {0.0f, -1.0f, 0.0f},
-                {0.0f, -1.0f, 0.0f}
+
+        const MeshSize side = detail::revolve_size(segments, stacks + 1, true, false);
+        const size_t count = detail::revolve(out_vertices, out_indices, 0, segments, stacks + 1, profile, true, false);
+
+        if(cap)
+        {
+            detail::disk(out_vertices, out_indices + count, static_cast<GLuint>(side.vertex_count), radius, -height * 0.5f, false, segments);
+        }
+    }
+
+    /**
+     * Размер тора
+     * @param segments Кол-во сегментов вокруг оси тора (не менее 3)
+     * @param sides Кол-во сегментов вокруг трубки (не менее 3)
+     * @return Размер
+     */
+    inline MeshSize gen_torus_size(unsigned segments, unsigned sides)
+    {
+        return detail::revolve_size(segments, sides + 1, false, false);
+    }
+
+    /**
+     * Генерация тора (ось Y)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_torus_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_torus_size().index_count)
+     * @param radius Радиус окружности центра трубки
+     * @param tube_radius Радиус трубки
+     * @param segments Кол-во сегментов вокруг оси тора (не менее 3)
+     * @param sides Кол-во сегментов вокруг трубки (не менее 3)
+     */
+    template<typename V>
+    inline void gen_torus(V* out_vertices, GLuint* out_indices, float radius, float tube_radius, unsigned segments, unsigned sides)
+    {
+        // Профиль - окружность трубки, обходится сверху через внешнюю сторону
+        auto profile = [&](unsigned p) -> detail::ProfilePoint
+        {
+            const float t = static_cast<float>(p) / static_cast<float>(sides);
+            const float theta = t * 2.0f * detail::PI;
+            const float s = std::sin(theta), c = std::cos(theta);
+            return {radius + tube_radius * s, tube_radius * c, {s, c}, 1.0f - t};
         };
-        std::vector<glm::vec3> colors = {
+
+        detail::revolve(out_vertices, out_indices, 0, segments, sides + 1, profile, false, false);
+    }
+
+    /**
+     * Размер плоской сетки
+     * @param x_segments Кол-во сегментов по оси X
+     * @param z_segments Кол-во сегментов по оси Z
+     * @return Размер
+     */
+    inline MeshSize gen_plane_size(unsigned x_segments, unsigned z_segments)
+    {
+        return {
+            static_cast<size_t>(x_segments + 1) * (z_segments + 1),
+            static_cast<size_t>(x_segments) * z_segments * 6
         };
+    }
 
-        std::vector<V> vertices(24);
-        for(size_t i = 0; i < vertices.size(); i++)
-        {
-            auto& v = vertices[i];
-            auto* pos = (glm::vec3*)((char*)(&(v)) + pos_offset);
-            auto* uv = (glm::vec2*)((char*)(&(v)) + uv_offset);
-            auto* normal = (glm::vec3*)((char*)(&(v)) + normal_offset);
-            auto* color = (glm::vec3*)((char*)(&(v)) + color_offset);
+    /**
+     * Генерация плоской сетки в плоскости XZ (нормаль направлена вверх)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_plane_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_plane_size().index_count)
+     * @param width Размер по оси X
+     * @param depth Размер по оси Z
+     * @param x_segments Кол-во сегментов по оси X
+     * @param z_segments Кол-во сегментов по оси Z
+     */
+    template<typename V>
+    inline void gen_plane(V* out_vertices, GLuint* out_indices, float width, float depth, unsigned x_segments, unsigned z_segments)
+    {
+        const glm::vec3 normal = {0.0f, 1.0f, 0.0f};
+        const unsigned stride = x_segments + 1;
 
-            if(req_attr & EAttrBit::POSITION) *pos = positions[i];
-            if(req_attr & EAttrBit::UV) *uv = uvs[i];
-            if(req_attr & EAttrBit::NORMAL) *normal = normals[i];
-            if(req_attr & EAttrBit::COLOR) *color = {0.0f, 0.0f, 0.0f};
+        for(unsigned z = 0; z <= z_segments; z++)
+        {
+            for(unsigned x = 0; x <= x_segments; x++)
+            {
+                const float u = static_cast<float>(x) / static_cast<float>(x_segments);
+                const float v = static_cast<float>(z) / static_cast<float>(z_segments);
+                detail::write_vertex(out_vertices[z * stride + x],
+                                     {(u - 0.5f) * width, 0.0f, (0.5f - v) * depth}, {u, v}, normal, {u, v, 1.0f});
+            }
         }
 
-        if(out_indices)
+        size_t count = 0;
+        for(unsigned z = 0; z < z_segments; z++)
         {
-            *out_indices = {
-                    0,1,2, 2,3,0,
-                    4,5,6, 6,7,4,
-                    8,9,10, 10,11,8,
-                    12,13,14, 14,15,12,
-                    16,17,18, 18,19,16,
-                    20,21,22, 22,23,20
-            };
+            for(unsigned x = 0; x < x_segments; x++)
+            {
+                const GLuint a = z * stride + x;
+                const GLuint b = a + 1;
+                const GLuint c = a + stride;
+                const GLuint d = c + 1;
+
+                out_indices[count++] = a; out_indices[count++] = c; out_indices[count++] = d;
+                out_indices[count++] = d; out_indices[count++] = b; out_indices[count++] = a;
+            }
         }
+    }
 
-        return vertices;
+    /**
+     * Размер капсулы
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param rings Кол-во колец на полусферу (не менее 1)
+     * @return Размер
+     */
+    inline MeshSize gen_capsule_size(unsigned segments, unsigned rings)
+    {
+        return detail::revolve_size(segments, 2 * (rings + 1), true, true);
+    }
+
+    /**
+     * Генерация капсулы (цилиндр с полусферами на концах, ось Y)
+     * @tparam V Тип вершины
+     * @param out_vertices Буфер вершин (не менее gen_capsule_size().vertex_count)
+     * @param out_indices Буфер индексов (не менее gen_capsule_size().index_count)
+     * @param radius Радиус
+     * @param height Высота цилиндрической части
+     * @param segments Кол-во сегментов вокруг оси (не менее 3)
+     * @param rings Кол-во колец на полусферу (не менее 1)
+     */
+    template<typename V>
+    inline void gen_capsule(V* out_vertices, GLuint* out_indices, float radius, float height, unsigned segments, unsigned rings)
+    {
+        const float total = height + 2.0f * radius;
+
+        // Верхняя полусфера (кольца 0..rings), затем нижняя (кольца rings..2*rings) - экватор повторяется
+        auto profile = [&](unsigned p) -> detail::ProfilePoint
+        {
+            const bool upper = p <= rings;
+            const unsigned ring = upper ? p : p - 1;
+            const float theta = static_cast<float>(ring) / static_cast<float>(2 * rings) * detail::PI;
+            const float s = ring == 0 || ring == 2 * rings ? 0.0f : std::sin(theta);
+            const float c = std::cos(theta);
+            const float y = radius * c + (upper ? height * 0.5f : -height * 0.5f);
+            return {radius * s, y, {s, c}, 0.5f + y / total};
+        };
+
+        detail::revolve(out_vertices, out_indices, 0, segments, 2 * (rings + 1), profile, true, true);
     }
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <type_traits>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include "pack.hpp"
+#include "../gl/vertex-format.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Смысловое назначение атрибута (какие данные в него пишут генераторы геометрии)
+     */
+    enum EAttrBit : unsigned
+    {
+        NONE        = 0,
+        POSITION    = 1u << 0,
+        UV          = 1u << 1,
+        NORMAL      = 1u << 2,
+        COLOR       = 1u << 3
+    };
+
+    /**
+     * Формат атрибута для шейдера, определяемый типом поля структуры вершины
+     * Специализации заданы для всех поддерживаемых типов (включая упакованные, см. pack.hpp)
+     * @tparam T Тип поля
+     */
+    template<typename T>
+    struct AttributeFormat;
+
+    template<> struct AttributeFormat<float>        { static constexpr GLint components = 1; static constexpr GLenum type = GL_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<glm::vec2>    { static constexpr GLint components = 2; static constexpr GLenum type = GL_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<glm::vec3>    { static constexpr GLint components = 3; static constexpr GLenum type = GL_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<glm::vec4>    { static constexpr GLint components = 4; static constexpr GLenum type = GL_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<glm::mat4>    { static constexpr GLint components = 4; static constexpr GLenum type = GL_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 4; };
+    template<> struct AttributeFormat<Half2>        { static constexpr GLint components = 2; static constexpr GLenum type = GL_HALF_FLOAT; static constexpr GLboolean normalize = GL_FALSE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<Oct16>        { static constexpr GLint components = 2; static constexpr GLenum type = GL_SHORT; static constexpr GLboolean normalize = GL_TRUE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<Snorm1010102> { static constexpr GLint components = 4; static constexpr GLenum type = GL_INT_2_10_10_10_REV; static constexpr GLboolean normalize = GL_TRUE; static constexpr GLuint columns = 1; };
+    template<> struct AttributeFormat<Unorm8x4>     { static constexpr GLint components = 4; static constexpr GLenum type = GL_UNSIGNED_BYTE; static constexpr GLboolean normalize = GL_TRUE; static constexpr GLuint columns = 1; };
+
+    namespace detail
+    {
+        /**
+         * Тип класса и поля по указателю на поле
+         */
+        template<typename M>
+        struct MemberTraits;
+
+        template<typename C, typename T>
+        struct MemberTraits<T C::*>
+        {
+            using Class = C;
+            using Type = T;
+        };
+
+        /**
+         * Запись значения в поле вершины (с упаковкой, если поле упакованного типа)
+         * @param dst Поле
+         * @param value Значение
+         */
+        inline void assign(glm::vec2& dst, const glm::vec2& value) { dst = value; }
+        inline void assign(glm::vec3& dst, const glm::vec3& value) { dst = value; }
+        inline void assign(glm::vec4& dst, const glm::vec3& value) { dst = glm::vec4(value, 1.0f); }
+        inline void assign(Half2& dst, const glm::vec2& value) { dst = pack_half2(value); }
+        inline void assign(Oct16& dst, const glm::vec3& value) { dst = pack_octahedral(value); }
+        inline void assign(Snorm1010102& dst, const glm::vec3& value) { dst = pack_snorm_1010102(value); }
+        inline void assign(Unorm8x4& dst, const glm::vec3& value) { dst = pack_unorm8x4(glm::vec4(value, 1.0f)); }
+    }
+
+    /**
+     * Описание одного атрибута вершины
+     * Формат для шейдера выводится из типа поля, смысл атрибута используется генераторами геометрии
+     * @tparam Semantic Смысловое назначение (EAttrBit::NONE - генераторы не пишут в поле)
+     * @tparam Member Указатель на поле структуры вершины
+     * @tparam Location Номер положения (location у шейдера), для матриц - номер первого столбца
+     */
+    template<EAttrBit Semantic, auto Member, GLuint Location>
+    struct Attribute
+    {
+        using Vertex = typename detail::MemberTraits<decltype(Member)>::Class;
+        using Type = typename detail::MemberTraits<decltype(Member)>::Type;
+        using Format = AttributeFormat<Type>;
+
+        static constexpr EAttrBit semantic = Semantic;
+        static constexpr auto member = Member;
+        static constexpr GLuint location = Location;
+
+        /**
+         * Записать описание атрибута (либо столбцов матрицы, по одному на столбец)
+         * @param out Описания атрибутов (не менее Format::columns элементов)
+         */
+        static void fill(gl::VertexAttributeInfo* out)
+        {
+            // Смещение поля считается по объекту-образцу (offsetof не принимает указатель на поле)
+            static const Vertex sample{};
+            const auto offset = static_cast<GLsizeiptr>(
+                    reinterpret_cast<const char*>(&(sample.*Member)) - reinterpret_cast<const char*>(&sample));
+            const auto column_size = static_cast<GLsizeiptr>(sizeof(Type) / Format::columns);
+
+            for(GLuint c = 0; c < Format::columns; c++)
+            {
+                out[c] = {Location + c, Format::components, Format::type, Format::normalize, offset + column_size * c, 0};
+            }
+        }
+    };
+
+    /**
+     * Описание раскладки вершины (задается один раз для структуры вершины, обычно как вложенный тип Layout)
+     * Из описания строятся атрибуты для шейдера и специализируются генераторы геометрии:
+     * запись в вершину разворачивается на этапе компиляции, без проверок маски и приведений указателей
+     * @tparam A Список атрибутов (Attribute)
+     */
+    template<typename... A>
+    struct VertexLayout
+    {
+        /**
+         * Маска атрибутов, которые заполняют генераторы геометрии
+         */
+        static constexpr unsigned semantics = (0u | ... | static_cast<unsigned>(A::semantic));
+
+        /**
+         * Кол-во описаний атрибутов (матрица занимает по одному на столбец)
+         */
+        static constexpr size_t attribute_count = (size_t{0} + ... + A::Format::columns);
+
+        /**
+         * Описания атрибутов вершины (размер известен на этапе компиляции, массив заполняется однократно)
+         * Смещения полей по указателю на поле в C++17 не вычисляются в constexpr, поэтому массив статический
+         * @return Массив описаний атрибутов
+         */
+        static const std::array<gl::VertexAttributeInfo, attribute_count>& attribute_array()
+        {
+            static const auto result = []()
+            {
+                std::array<gl::VertexAttributeInfo, attribute_count> array = {};
+                size_t i = 0;
+                ((A::fill(array.data() + i), i += A::Format::columns), ...);
+                return array;
+            }();
+            return result;
+        }
+
+        /**
+         * Получить список описаний атрибутов для шейдера (для создания gl::Geometry/gl::VertexFormat)
+         * @param divisor Делитель (0 - атрибуты вершины, N - атрибуты экземпляра)
+         * @return Список описаний атрибутов
+         */
+        static std::vector<gl::VertexAttributeInfo> attributes(GLuint divisor = 0)
+        {
+            std::vector<gl::VertexAttributeInfo> result(attribute_array().begin(), attribute_array().end());
+            for(auto& attribute : result) attribute.divisor = divisor;
+            return result;
+        }
+
+        /**
+         * Записать данные в вершину (только в поля с соответствующим смыслом)
+         * @tparam V Тип вершины
+         * @param v Вершина
+         * @param pos Положение
+         * @param uv UV координаты
+         * @param normal Нормаль
+         * @param color Цвет
+         */
+        template<typename V>
+        static void write(V& v, const glm::vec3& pos, const glm::vec2& uv, const glm::vec3& normal, const glm::vec3& color)
+        {
+            (write_attribute<A>(v, pos, uv, normal, color), ...);
+        }
+
+        /**
+         * Прочитать положение вершины (поле со смыслом POSITION)
+         * @tparam V Тип вершины
+         * @param v Вершина
+         * @return Положение
+         */
+        template<typename V>
+        static glm::vec3 position(const V& v)
+        {
+            static_assert((semantics & EAttrBit::POSITION) != 0, "Vertex layout has no POSITION attribute");
+            glm::vec3 result(0.0f);
+            (read_position<A>(v, result), ...);
+            return result;
+        }
+
+    private:
+        template<typename Attr, typename V>
+        static void write_attribute(V& v, const glm::vec3& pos, const glm::vec2& uv, const glm::vec3& normal, const glm::vec3& color)
+        {
+            constexpr auto member = Attr::member;
+            if constexpr(Attr::semantic == EAttrBit::POSITION) detail::assign(v.*member, pos);
+            else if constexpr(Attr::semantic == EAttrBit::UV) detail::assign(v.*member, uv);
+            else if constexpr(Attr::semantic == EAttrBit::NORMAL) detail::assign(v.*member, normal);
+            else if constexpr(Attr::semantic == EAttrBit::COLOR) detail::assign(v.*member, color);
+        }
+
+        template<typename Attr, typename V>
+        static void read_position(const V& v, glm::vec3& pos)
+        {
+            if constexpr(Attr::semantic == EAttrBit::POSITION) pos = glm::vec3(v.*Attr::member);
+        }
+    };
+
+    /**
+     * Раскладка структуры вершины (вложенный тип V::Layout)
+     */
+    template<typename V>
+    using layout_of = typename V::Layout;
+
+    /**
+     * Положение вершины (для массивов положений - само значение, иначе - по раскладке V::Layout)
+     * @tparam V Тип вершины
+     * @param v Вершина
+     * @return Положение
+     */
+    template<typename V>
+    inline glm::vec3 position_of(const V& v)
+    {
+        if constexpr(std::is_same_v<V, glm::vec3>) return v;
+        else return layout_of<V>::position(v);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include "../gl/vertex-format.hpp"
+#include "../files/mapped-file.hpp"
+#include "bounds.hpp"
+#include "layout.hpp"
+#include "simplify.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Сигнатура файла меша ("GECM")
+     */
+    constexpr uint32_t MESH_FILE_MAGIC = 0x4D434547u;
+
+    /**
+     * Версия формата файла меша
+     */
+    constexpr uint32_t MESH_FILE_VERSION = 1;
+
+    /**
+     * Выравнивание блоков данных в файле (не меньше строки кеша, блоки можно передавать в API без копирования)
+     */
+    constexpr uint64_t MESH_FILE_ALIGNMENT = 64;
+
+    /**
+     * Заголовок файла меша
+     * Файл: заголовок, описания атрибутов, уровни детализации, блок вершин, блок индексов.
+     * Вершины и индексы хранятся в итоговом формате для GPU (упакованные атрибуты, 16-битные индексы
+     * при кол-ве вершин меньше 65536), поэтому загрузка не требует разбора и преобразования данных.
+     * Все значения в порядке байт little-endian
+     */
+    struct MeshFileHeader
+    {
+        // Сигнатура и версия формата
+        uint32_t magic;
+        uint32_t version;
+        // Размер одной вершины (байт)
+        uint32_t vertex_stride;
+        // Кол-во вершин
+        uint32_t vertex_count;
+        // Кол-во индексов (всех уровней детализации)
+        uint32_t index_count;
+        // Тип индексов (GL_UNSIGNED_SHORT или GL_UNSIGNED_INT)
+        uint32_t index_type;
+        // Кол-во описаний атрибутов
+        uint32_t attribute_count;
+        // Кол-во уровней детализации
+        uint32_t lod_count;
+        // Ограничивающая сфера (центр, радиус)
+        float sphere[4];
+        // Ограничивающий прямоугольный объем (минимум, максимум)
+        float aabb_min[4];
+        float aabb_max[4];
+        // Сдвиги блоков от начала файла
+        uint64_t attributes_offset;
+        uint64_t lods_offset;
+        uint64_t vertices_offset;
+        uint64_t indices_offset;
+    };
+
+    /**
+     * Описание атрибута вершины в файле (соответствует gl::VertexAttributeInfo)
+     */
+    struct MeshFileAttribute
+    {
+        // Номер положения (location у шейдера)
+        uint32_t location;
+        // Кол-во компонентов
+        int32_t component_count;
+        // Тип компонентов
+        uint32_t component_type;
+        // Нормализовать перед подачей в шейдер
+        uint32_t normalize;
+        // Сдвиг атрибута в структуре вершины
+        uint32_t offset;
+        // Резерв (выравнивание)
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(MeshFileHeader) == 112, "Unexpected mesh file header size");
+    static_assert(sizeof(MeshFileAttribute) == 24, "Unexpected mesh file attribute size");
+    static_assert(sizeof(MeshLod) == 12, "Unexpected mesh LOD size");
+
+    /**
+     * Представление файла меша в памяти (без копирования данных)
+     * Проверяет заголовок и границы блоков, далее выдает указатели прямо в исходную память
+     */
+    class MeshFileView
+    {
+    public:
+        /**
+         * Конструктор по умолчанию (пустое представление)
+         */
+        MeshFileView() = default;
+
+        /**
+         * Основной конструктор (проверка содержимого)
+         * @param data Содержимое файла (должно оставаться доступным все время использования представления)
+         * @param size Размер содержимого
+         */
+        MeshFileView(const void* data, size_t size)
+            : data_(static_cast<const unsigned char*>(data))
+            , size_(size)
+        {
+            if(!data_ || size_ < sizeof(MeshFileHeader))
+            {
+                throw std::runtime_error("[Mesh] file is too small");
+            }
+
+            const auto& h = header();
+            if(h.magic != MESH_FILE_MAGIC)
+            {
+                throw std::runtime_error("[Mesh] wrong file signature");
+            }
+            if(h.version != MESH_FILE_VERSION)
+            {
+                throw std::runtime_error("[Mesh] unsupported file version " + std::to_string(h.version));
+            }
+            if(h.index_type != GL_UNSIGNED_SHORT && h.index_type != GL_UNSIGNED_INT)
+            {
+                throw std::runtime_error("[Mesh] wrong index type");
+            }
+
+            // Блоки должны быть выровнены и целиком лежать внутри файла
+            auto check_block = [&](uint64_t offset, uint64_t block_size, uint64_t alignment, const char* name)
+            {
+                if(offset % alignment != 0 || offset > size_ || block_size > size_ - offset)
+                {
+                    throw std::runtime_error(std::string("[Mesh] corrupted ") + name + " block");
+                }
+            };
+
+            check_block(h.attributes_offset, uint64_t{h.attribute_count} * sizeof(MeshFileAttribute), alignof(MeshFileAttribute), "attributes");
+            check_block(h.lods_offset, uint64_t{h.lod_count} * sizeof(MeshLod), alignof(MeshLod), "LODs");
+            check_block(h.vertices_offset, vertex_data_size(), MESH_FILE_ALIGNMENT, "vertices");
+            check_block(h.indices_offset, index_data_size(), MESH_FILE_ALIGNMENT, "indices");
+
+            const auto levels = lods();
+            for(size_t i = 0; i < levels.size(); i++)
+            {
+                const auto& lod = levels[i];
+                if(uint64_t{lod.first_index} + lod.index_count > h.index_count)
+                {
+                    throw std::runtime_error("[Mesh] LOD " + std::to_string(i) + " is out of index range");
+                }
+            }
+        }
+
+        /**
+         * Проверить совпадение раскладки вершины в файле с ожидаемой
+         * @tparam N Кол-во атрибутов
+         * @param attributes Ожидаемые описания атрибутов
+         * @param stride Ожидаемый размер вершины
+         * @return Раскладки совпадают
+         */
+        template<size_t N>
+        [[nodiscard]] bool matches(const std::array<gl::VertexAttributeInfo, N>& attributes, size_t stride) const
+        {
+            if(header().vertex_stride != stride || header().attribute_count != attributes.size()) return false;
+
+            for(size_t i = 0; i < attributes.size(); i++)
+            {
+                const auto& a = this->attributes()[i];
+                const auto& b = attributes[i];
+                if(a.location != b.location ||
+                   a.component_count != b.component_count ||
+                   a.component_type != b.component_type ||
+                   (a.normalize != 0) != (b.normalize != GL_FALSE) ||
+                   a.offset != static_cast<uint64_t>(b.offset))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Убедиться, что вершины файла имеют раскладку структуры V (V::Layout)
+         * @tparam V Тип вершины
+         */
+        template<typename V>
+        void validate_layout() const
+        {
+            if(!matches(layout_of<V>::attribute_array(), sizeof(V)))
+            {
+                throw std::runtime_error("[Mesh] vertex layout of the file does not match the vertex type");
+            }
+        }
+
+        /**
+         * Получить заголовок
+         * @return Ссылка на заголовок
+         */
+        [[nodiscard]] const MeshFileHeader& header() const
+        {
+            return *reinterpret_cast<const MeshFileHeader*>(data_);
+        }
+
+        /**
+         * Получить описания атрибутов
+         * @return Указатель на массив (header().attribute_count элементов)
+         */
+        [[nodiscard]] const MeshFileAttribute* attributes() const
+        {
+            return reinterpret_cast<const MeshFileAttribute*>(data_ + header().attributes_offset);
+        }
+
+        /**
+         * Получить описания атрибутов для формата вершин
+         * @param divisor Делитель (0 - атрибуты вершины, N - атрибуты экземпляра)
+         * @return Список описаний
+         */
+        [[nodiscard]] std::vector<gl::VertexAttributeInfo> attribute_infos(GLuint divisor = 0) const
+        {
+            std::vector<gl::VertexAttributeInfo> result;
+            for(uint32_t i = 0; i < header().attribute_count; i++)
+            {
+                const auto& a = attributes()[i];
+                result.push_back({a.location, a.component_count, a.component_type,
+                                  static_cast<GLboolean>(a.normalize ? GL_TRUE : GL_FALSE),
+                                  static_cast<GLsizeiptr>(a.offset), divisor});
+            }
+            return result;
+        }
+
+        /**
+         * Получить уровни детализации
+         * @return Список уровней (уровень 0 - исходный меш)
+         */
+        [[nodiscard]] std::vector<MeshLod> lods() const
+        {
+            const auto* first = reinterpret_cast<const MeshLod*>(data_ + header().lods_offset);
+            return {first, first + header().lod_count};
+        }
+
+        /**
+         * Получить ограничивающую сферу
+         * @return Сфера
+         */
+        [[nodiscard]] BoundingSphere bounding_sphere() const
+        {
+            const auto& s = header().sphere;
+            return {{s[0], s[1], s[2]}, s[3]};
+        }
+
+        /**
+         * Получить данные вершин (в итоговом формате)
+         * @return Указатель на блок вершин
+         */
+        [[nodiscard]] const void* vertex_data() const
+        {
+            return data_ + header().vertices_offset;
+        }
+
+        /**
+         * Получить размер блока вершин
+         * @return Размер в байтах
+         */
+        [[nodiscard]] uint64_t vertex_data_size() const
+        {
+            return uint64_t{header().vertex_stride} * header().vertex_count;
+        }
+
+        /**
+         * Получить данные индексов (в итоговом формате)
+         * @return Указатель на блок индексов
+         */
+        [[nodiscard]] const void* index_data() const
+        {
+            return data_ + header().indices_offset;
+        }
+
+        /**
+         * Получить размер блока индексов
+         * @return Размер в байтах
+         */
+        [[nodiscard]] uint64_t index_data_size() const
+        {
+            return uint64_t{header().index_count} * (header().index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+        }
+
+        /**
+         * Получить кол-во вершин
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei vertex_count() const
+        {
+            return static_cast<GLsizei>(header().vertex_count);
+        }
+
+        /**
+         * Получить кол-во индексов
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei index_count() const
+        {
+            return static_cast<GLsizei>(header().index_count);
+        }
+
+        /**
+         * Получить тип индексов
+         * @return Тип для glDrawElements
+         */
+        [[nodiscard]] GLenum index_type() const
+        {
+            return static_cast<GLenum>(header().index_type);
+        }
+
+    private:
+        // Содержимое файла
+        const unsigned char* data_ = nullptr;
+        // Размер содержимого
+        size_t size_ = 0;
+    };
+
+    /**
+     * Файл меша, отображенный в память
+     * Указатели на данные остаются действительными при перемещении объекта (отображение не меняется)
+     */
+    class MeshFile final : public MeshFileView
+    {
+    public:
+        /**
+         * Конструктор по умолчанию (пустой объект)
+         */
+        MeshFile() = default;
+
+        /**
+         * Основной конструктор (отображение файла и проверка содержимого)
+         * @param path Путь к файлу
+         */
+        explicit MeshFile(const std::string& path)
+            : MeshFileView()
+            , file_(path)
+        {
+            static_cast<MeshFileView&>(*this) = MeshFileView(file_.data(), file_.size());
+        }
+
+        /**
+         * Освободить отображение файла (после загрузки данных в буферы GPU)
+         */
+        void unload()
+        {
+            static_cast<MeshFileView&>(*this) = MeshFileView();
+            file_.unmap();
+        }
+
+        /**
+         * Отображен ли файл
+         * @return Состояние
+         */
+        [[nodiscard]] bool ready() const
+        {
+            return file_.ready();
+        }
+
+    private:
+        // Отображение файла
+        files::MappedFile file_;
+    };
+
+    /**
+     * Запись файла меша (раскладка вершины берется из V::Layout)
+     * Индексы записываются 16-битными, если кол-во вершин меньше 65536 (как в gl::Geometry)
+     * @tparam V Тип вершины
+     * @param path Путь к файлу
+     * @param vertices Массив вершин (в итоговом формате)
+     * @param indices Индексы (всех уровней детализации)
+     * @param lods Уровни детализации (пустой список - один уровень из всех индексов)
+     */
+    template<typename V>
+    inline void write_mesh_file(const std::string& path,
+                                const std::vector<V>& vertices,
+                                const std::vector<GLuint>& indices,
+                                const std::vector<MeshLod>& lods = {})
+    {
+        const size_t vertex_count = vertices.size();
+        const auto& attributes = layout_of<V>::attribute_array();
+        auto position = [&](size_t i) -> glm::vec3
+        {
+            return layout_of<V>::position(vertices[i]);
+        };
+
+        auto align = [](uint64_t offset, uint64_t alignment){ return (offset + alignment - 1) / alignment * alignment; };
+
+        MeshFileHeader header = {};
+        header.magic = MESH_FILE_MAGIC;
+        header.version = MESH_FILE_VERSION;
+        header.vertex_stride = static_cast<uint32_t>(sizeof(V));
+        header.vertex_count = static_cast<uint32_t>(vertex_count);
+        header.index_count = static_cast<uint32_t>(indices.size());
+        header.index_type = vertex_count < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        header.attribute_count = static_cast<uint32_t>(attributes.size());
+
+        std::vector<MeshLod> levels = lods;
+        if(levels.empty()) levels.push_back({0, static_cast<GLuint>(indices.size()), 0.0f});
+        header.lod_count = static_cast<uint32_t>(levels.size());
+
+        // Границы
+        const BoundingSphere sphere = compute_bounding_sphere(vertex_count, position);
+        glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+        for(size_t i = 0; i < vertex_count; i++)
+        {
+            lo = glm::min(lo, position(i));
+            hi = glm::max(hi, position(i));
+        }
+        if(vertex_count == 0) lo = hi = glm::vec3(0.0f);
+
+        header.sphere[0] = sphere.center.x; header.sphere[1] = sphere.center.y; header.sphere[2] = sphere.center.z; header.sphere[3] = sphere.radius;
+        header.aabb_min[0] = lo.x; header.aabb_min[1] = lo.y; header.aabb_min[2] = lo.z;
+        header.aabb_max[0] = hi.x; header.aabb_max[1] = hi.y; header.aabb_max[2] = hi.z;
+
+        // Расположение блоков
+        header.attributes_offset = sizeof(MeshFileHeader);
+        header.lods_offset = header.attributes_offset + sizeof(MeshFileAttribute) * attributes.size();
+        header.vertices_offset = align(header.lods_offset + sizeof(MeshLod) * levels.size(), MESH_FILE_ALIGNMENT);
+        header.indices_offset = align(header.vertices_offset + uint64_t{header.vertex_stride} * vertex_count, MESH_FILE_ALIGNMENT);
+
+        std::vector<MeshFileAttribute> file_attributes;
+        for(const auto& a : attributes)
+        {
+            file_attributes.push_back({a.location, a.component_count, a.component_type,
+                                       a.normalize != GL_FALSE ? 1u : 0u, static_cast<uint32_t>(a.offset), 0u});
+        }
+
+        std::ofstream os(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if(!os.is_open())
+        {
+            throw std::runtime_error("Cant open file \"" + path + "\"");
+        }
+
+        auto pad_to = [&](uint64_t offset)
+        {
+            static const char zeros[MESH_FILE_ALIGNMENT] = {};
+            const auto current = static_cast<uint64_t>(os.tellp());
+            os.write(zeros, static_cast<std::streamsize>(offset - current));
+        };
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(file_attributes.data()), static_cast<std::streamsize>(sizeof(MeshFileAttribute) * file_attributes.size()));
+        os.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(sizeof(MeshLod) * levels.size()));
+
+        pad_to(header.vertices_offset);
+        os.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(sizeof(V) * vertex_count));
+
+        pad_to(header.indices_offset);
+        if(header.index_type == GL_UNSIGNED_SHORT)
+        {
+            const std::vector<GLushort> short_indices(indices.begin(), indices.end());
+            os.write(reinterpret_cast<const char*>(short_indices.data()), static_cast<std::streamsize>(sizeof(GLushort) * short_indices.size()));
+        }
+        else
+        {
+            os.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(sizeof(GLuint) * indices.size()));
+        }
+
+        if(!os.good())
+        {
+            throw std::runtime_error("Cant write file \"" + path + "\"");
+        }
+    }
+}
\ No newline at end of file
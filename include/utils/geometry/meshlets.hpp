@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include "bounds.hpp"
+#include "layout.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Максимальное кол-во вершин кластера
+     */
+    constexpr size_t MESHLET_MAX_VERTICES = 64;
+
+    /**
+     * Максимальное кол-во треугольников кластера
+     */
+    constexpr size_t MESHLET_MAX_TRIANGLES = 124;
+
+    /**
+     * Кластер треугольников (meshlet)
+     * Данные для отсечения расположены в начале структуры, кластеры меша хранятся в одном плоском массиве
+     */
+    struct Meshlet
+    {
+        // Ограничивающая сфера кластера
+        glm::vec3 center = {0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+        // Ось конуса нормалей (направлена наружу от лицевых граней)
+        glm::vec3 cone_axis = {0.0f, 0.0f, 0.0f};
+        // Синус половины угла раствора конуса (1 - конус не позволяет отсечь кластер)
+        float cone_cutoff = 1.0f;
+        // Первый индекс кластера в индексном буфере меша
+        GLuint first_index = 0;
+        // Кол-во индексов кластера
+        GLuint index_count = 0;
+        // Кол-во уникальных вершин кластера
+        GLuint vertex_count = 0;
+    };
+
+    /**
+     * Разбиение меша на кластеры
+     * Треугольники группируются последовательно, поэтому индексный буфер не меняется, а кластер - это непрерывный
+     * участок индексов. Для компактных кластеров индексы стоит предварительно оптимизировать (optimize_vertex_cache),
+     * тогда соседние треугольники в буфере будут соседними и в пространстве.
+     * Лицевыми считаются грани, заданные по часовой стрелке (glFrontFace(GL_CW))
+     * @tparam V Тип вершины
+     * @param indices Массив индексов (треугольники)
+     * @param vertices Массив вершин (положение читается по раскладке V::Layout)
+     * @param max_vertices Максимальное кол-во вершин кластера
+     * @param max_triangles Максимальное кол-во треугольников кластера
+     * @return Массив кластеров
+     */
+    template<typename V>
+    inline std::vector<Meshlet> build_meshlets(const std::vector<GLuint>& indices,
+                                               const std::vector<V>& vertices,
+                                               size_t max_vertices = MESHLET_MAX_VERTICES,
+                                               size_t max_triangles = MESHLET_MAX_TRIANGLES)
+    {
+        std::vector<Meshlet> meshlets;
+        const size_t triangle_count = indices.size() / 3;
+        if(triangle_count == 0 || max_vertices < 3 || max_triangles == 0) return meshlets;
+
+        auto position = [&](GLuint index) -> glm::vec3
+        {
+            return position_of(vertices[index]);
+        };
+
+        // Признак принадлежности вершины текущему кластеру и список вершин кластера (для сброса признака)
+        std::vector<bool> used(vertices.size(), false);
+        std::vector<GLuint> meshlet_vertices;
+        meshlet_vertices.reserve(max_vertices);
+        std::vector<glm::vec3> normals;
+        normals.reserve(max_triangles);
+
+        // Завершение кластера: расчет ограничивающей сферы и конуса нормалей
+        auto finish = [&](size_t first_triangle, size_t end_triangle)
+        {
+            Meshlet meshlet;
+            meshlet.first_index = static_cast<GLuint>(first_triangle * 3);
+            meshlet.index_count = static_cast<GLuint>((end_triangle - first_triangle) * 3);
+            meshlet.vertex_count = static_cast<GLuint>(meshlet_vertices.size());
+
+            const BoundingSphere sphere = compute_bounding_sphere(meshlet_vertices.size(), [&](size_t i){
+                return position(meshlet_vertices[i]);
+            });
+            meshlet.center = sphere.center;
+            meshlet.radius = sphere.radius;
+
+            // Нормали лицевых граней (по часовой стрелке) направлены по cross(c - a, b - a)
+            normals.clear();
+            glm::vec3 axis = {0.0f, 0.0f, 0.0f};
+            for(size_t t = first_triangle; t < end_triangle; t++)
+            {
+                const glm::vec3 a = position(indices[t * 3]);
+                const glm::vec3 b = position(indices[t * 3 + 1]);
+                const glm::vec3 c = position(indices[t * 3 + 2]);
+                const glm::vec3 n = glm::cross(c - a, b - a);
+                const float length = glm::length(n);
+
+                // Вырожденные треугольники не влияют на конус
+                if(length <= 0.0f) continue;
+                normals.push_back(n / length);
+                axis += normals.back();
+            }
+
+            const float axis_length = glm::length(axis);
+            if(!normals.empty() && axis_length > 0.0f)
+            {
+                axis /= axis_length;
+
+                float min_dot = 1.0f;
+                for(const auto& n : normals) min_dot = std::min(min_dot, glm::dot(axis, n));
+
+                // Раствор конуса больше ~84 градусов - отсечение почти никогда не сработает
+                if(min_dot > 0.1f)
+                {
+                    meshlet.cone_axis = axis;
+                    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+                }
+            }
+
+            meshlets.push_back(meshlet);
+
+            for(const GLuint v : meshlet_vertices) used[v] = false;
+            meshlet_vertices.clear();
+        };
+
+        size_t first_triangle = 0;
+        for(size_t t = 0; t < triangle_count; t++)
+        {
+            // Кол-во новых для кластера вершин треугольника
+            size_t new_vertices = 0;
+            for(size_t k = 0; k < 3; k++)
+            {
+                const GLuint v = indices[t * 3 + k];
+                bool repeated = false;
+                for(size_t j = 0; j < k; j++) repeated = repeated || indices[t * 3 + j] == v;
+                if(!used[v] && !repeated) new_vertices++;
+            }
+
+            if(meshlet_vertices.size() + new_vertices > max_vertices || t - first_triangle >= max_triangles)
+            {
+                finish(first_triangle, t);
+                first_triangle = t;
+            }
+
+            for(size_t k = 0; k < 3; k++)
+            {
+                const GLuint v = indices[t * 3 + k];
+                if(!used[v])
+                {
+                    used[v] = true;
+                    meshlet_vertices.push_back(v);
+                }
+            }
+        }
+
+        finish(first_triangle, triangle_count);
+        return meshlets;
+    }
+
+    /**
+     * Проверка видимости кластера (отсечение пирамидой видимости и конусом нормалей)
+     * Все параметры задаются в одном пространстве (обычно в пространстве объекта, тогда пирамида получается
+     * из матрицы projection * view * model, а положение камеры - через обратную матрицу модели)
+     * @param meshlet Кластер
+     * @param frustum Пирамида видимости
+     * @param camera_pos Положение камеры
+     * @param padding Запас для радиуса (например, для смещения вершин в шейдере)
+     * @return Кластер может быть видим
+     */
+    inline bool is_meshlet_visible(const Meshlet& meshlet, const Frustum& frustum, const glm::vec3& camera_pos, float padding = 0.0f)
+    {
+        const float radius = meshlet.radius + padding;
+        if(!sphere_in_frustum(frustum, meshlet.center, radius)) return false;
+
+        // Все грани кластера обращены от камеры, если направление на сферу лежит внутри расширенного конуса
+        const glm::vec3 view = meshlet.center - camera_pos;
+        return glm::dot(view, meshlet.cone_axis) < meshlet.cone_cutoff * glm::length(view) + radius;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,544 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <glm/glm.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../threads/job-system.hpp"
+#include "bounds.hpp"
+#include "layout.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Программный буфер перекрытия (растеризация глубины на CPU)
+     * Несколько крупных перекрывающих мешей (occluders) растеризуются в буфер глубины низкого разрешения,
+     * затем ограничивающие объемы объектов проверяются по нему. Не требует графического API, поэтому подходит
+     * для отсечения без задержки в кадр и для проверок без GL контекста.
+     *
+     * Глубина хранится как в OpenGL (z/w из [-1, 1] переводится в [0, 1], ближе - меньше), строка 0 - низ экрана.
+     * Треугольники отсекаются ближней плоскостью, распределяются по плиткам и растеризуются плитками параллельно
+     * (в каждую плитку пишет одна задача), по 8 пикселей строки за раз (AVX2, либо скалярный вариант).
+     * Покрытие определяется по центрам пикселей, поэтому при проверке прямоугольник объема расширяется на пиксель
+     * (проверка консервативна на силуэтах крупных перекрывающих мешей, но не для мешей тоньше пикселя)
+     */
+    class OcclusionBuffer
+    {
+    public:
+        /**
+         * Размер плитки (пикселей), ширина кратна 8 (ширине пакета пикселей)
+         */
+        constexpr static int TILE_WIDTH = 32;
+        constexpr static int TILE_HEIGHT = 32;
+
+        /**
+         * Треугольник в пространстве экрана (после отсечения ближней плоскостью)
+         */
+        struct ScreenTriangle
+        {
+            // Вершины (пиксели) и глубина
+            glm::vec3 v[3];
+            // Границы на экране (пиксели, включительно)
+            int min_x, min_y, max_x, max_y;
+        };
+
+        /**
+         * Статистика последней растеризации
+         */
+        struct Stats
+        {
+            // Треугольников перекрывающих мешей (до отсечения)
+            size_t triangles_in = 0;
+            // Треугольников на экране (после отсечения)
+            size_t triangles_rasterized = 0;
+        };
+
+    public:
+        /**
+         * Конструктор по умолчанию (буфер 256x128)
+         */
+        OcclusionBuffer() : OcclusionBuffer(256, 128) {}
+
+        /**
+         * Основной конструктор
+         * @param width Ширина (кратна TILE_WIDTH)
+         * @param height Высота (кратна TILE_HEIGHT)
+         */
+        OcclusionBuffer(int width, int height)
+            : width_(width)
+            , height_(height)
+            , tiles_x_(width / TILE_WIDTH)
+            , tiles_y_(height / TILE_HEIGHT)
+            , view_projection_(1.0f)
+        {
+            assert(width_ > 0 && width_ % TILE_WIDTH == 0);
+            assert(height_ > 0 && height_ % TILE_HEIGHT == 0);
+
+            depth_.assign(static_cast<size_t>(width_) * height_, 1.0f);
+            tile_max_depth_.assign(static_cast<size_t>(tiles_x_) * tiles_y_, 1.0f);
+            bins_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+        }
+
+        /**
+         * Начать кадр: очистить буфер и список треугольников
+         * @param view_projection Матрица вида и проекции
+         */
+        void begin(const glm::mat4& view_projection)
+        {
+            view_projection_ = view_projection;
+            triangles_.clear();
+            for(auto& bin : bins_) bin.clear();
+            std::fill(depth_.begin(), depth_.end(), 1.0f);
+            std::fill(tile_max_depth_.begin(), tile_max_depth_.end(), 1.0f);
+            stats_ = {};
+        }
+
+        /**
+         * Добавить перекрывающий меш (треугольники переводятся в пространство экрана, растеризация - в rasterize)
+         * Порядок обхода вершин не важен (задние грани не отбрасываются)
+         * @tparam V Тип вершины (glm::vec3, либо структура с раскладкой V::Layout)
+         * @param vertices Указатель на массив вершин
+         * @param indices Индексы (по 3 на треугольник)
+         * @param index_count Кол-во индексов
+         * @param model Матрица модели
+         */
+        template<typename V>
+        void add_occluder(const V* vertices,
+                          const uint32_t* indices,
+                          size_t index_count,
+                          const glm::mat4& model)
+        {
+            const glm::mat4 mvp = view_projection_ * model;
+
+            // Вершины в пространство отсечения (однократно для всех треугольников)
+            size_t vertex_count = 0;
+            for(size_t i = 0; i < index_count; i++) vertex_count = std::max<size_t>(vertex_count, indices[i] + 1);
+            clip_.resize(vertex_count);
+            for(size_t i = 0; i < vertex_count; i++)
+            {
+                clip_[i] = mvp * glm::vec4(position_of(vertices[i]), 1.0f);
+            }
+
+            for(size_t i = 0; i + 2 < index_count; i += 3)
+            {
+                add_clip_triangle(clip_[indices[i]], clip_[indices[i + 1]], clip_[indices[i + 2]]);
+            }
+        }
+
+        /**
+         * Добавить перекрывающий меш из массива вершин
+         * @tparam V Тип вершины
+         * @param vertices Вершины
+         * @param indices Индексы
+         * @param model Матрица модели
+         */
+        template<typename V>
+        void add_occluder(const std::vector<V>& vertices, const std::vector<uint32_t>& indices, const glm::mat4& model)
+        {
+            add_occluder(vertices.data(), indices.data(), indices.size(), model);
+        }
+
+        /**
+         * Растеризовать добавленные треугольники (каждая плитка - отдельная задача)
+         * @param jobs Система задач
+         */
+        void rasterize(threads::JobSystem& jobs)
+        {
+            bin_triangles();
+            jobs.parallel_for(bins_.size(), 1, [this](size_t begin, size_t end){
+                for(size_t t = begin; t < end; t++) rasterize_tile(t);
+            });
+        }
+
+        /**
+         * Растеризовать добавленные треугольники в текущем потоке
+         */
+        void rasterize()
+        {
+            bin_triangles();
+            for(size_t t = 0; t < bins_.size(); t++) rasterize_tile(t);
+        }
+
+        /**
+         * Проверка видимости ограничивающего объема
+         * Объем скрыт, если его ближайшая глубина дальше глубины каждого покрываемого им пикселя
+         * @param box Объем в мировых координатах
+         * @return Объем (возможно) виден
+         */
+        [[nodiscard]] bool is_visible(const Aabb& box) const
+        {
+            // Проекция 8 углов (прямоугольник на экране и ближайшая глубина)
+            glm::vec2 ndc_min(std::numeric_limits<float>::max()), ndc_max(-std::numeric_limits<float>::max());
+            float depth_min = std::numeric_limits<float>::max();
+            for(int c = 0; c < 8; c++)
+            {
+                const glm::vec4 corner = {(c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z, 1.0f};
+                const glm::vec4 clip = view_projection_ * corner;
+
+                // Объем пересекает ближнюю плоскость (камера рядом или внутри) - считается видимым
+                if(clip.w <= NEAR_W) return true;
+
+                const float inv_w = 1.0f / clip.w;
+                ndc_min = glm::min(ndc_min, glm::vec2(clip.x, clip.y) * inv_w);
+                ndc_max = glm::max(ndc_max, glm::vec2(clip.x, clip.y) * inv_w);
+                depth_min = std::min(depth_min, clip.z * inv_w * 0.5f + 0.5f);
+            }
+
+            // Вне экрана либо за дальней плоскостью
+            if(ndc_max.x < -1.0f || ndc_max.y < -1.0f || ndc_min.x > 1.0f || ndc_min.y > 1.0f || depth_min > 1.0f) return false;
+
+            // Прямоугольник пикселей расширяется на пиксель (покрытие перекрывающих мешей определялось по центрам пикселей)
+            const int x0 = std::clamp(static_cast<int>(std::floor((ndc_min.x * 0.5f + 0.5f) * static_cast<float>(width_))) - 1, 0, width_ - 1);
+            const int y0 = std::clamp(static_cast<int>(std::floor((ndc_min.y * 0.5f + 0.5f) * static_cast<float>(height_))) - 1, 0, height_ - 1);
+            const int x1 = std::clamp(static_cast<int>(std::floor((ndc_max.x * 0.5f + 0.5f) * static_cast<float>(width_))) + 1, 0, width_ - 1);
+            const int y1 = std::clamp(static_cast<int>(std::floor((ndc_max.y * 0.5f + 0.5f) * static_cast<float>(height_))) + 1, 0, height_ - 1);
+
+            // Плитки целиком ближе объема пропускаются без проверки пикселей
+            for(int ty = y0 / TILE_HEIGHT; ty <= y1 / TILE_HEIGHT; ty++)
+            {
+                for(int tx = x0 / TILE_WIDTH; tx <= x1 / TILE_WIDTH; tx++)
+                {
+                    if(tile_max_depth_[static_cast<size_t>(ty) * tiles_x_ + tx] < depth_min) continue;
+
+                    const int px0 = std::max(x0, tx * TILE_WIDTH), px1 = std::min(x1, tx * TILE_WIDTH + TILE_WIDTH - 1);
+                    const int py0 = std::max(y0, ty * TILE_HEIGHT), py1 = std::min(y1, ty * TILE_HEIGHT + TILE_HEIGHT - 1);
+                    for(int y = py0; y <= py1; y++)
+                    {
+                        if(any_not_closer(&depth_[static_cast<size_t>(y) * width_], px0, px1, depth_min)) return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * Проверка видимости набора объемов (пакетами, параллельно)
+         * @param jobs Система задач
+         * @param boxes Объемы
+         * @param visible Результат (1 - виден, 0 - скрыт), размер приводится к кол-ву объемов
+         * @param batch_size Объемов на задачу
+         * @return Кол-во видимых
+         */
+        size_t test(threads::JobSystem& jobs, const std::vector<Aabb>& boxes, std::vector<uint8_t>& visible, size_t batch_size = 1024) const
+        {
+            visible.resize(boxes.size());
+            jobs.parallel_for(boxes.size(), batch_size, [&](size_t begin, size_t end){
+                for(size_t i = begin; i < end; i++) visible[i] = is_visible(boxes[i]) ? 1 : 0;
+            });
+            return static_cast<size_t>(std::count(visible.begin(), visible.end(), uint8_t(1)));
+        }
+
+        /**
+         * Глубина пикселя
+         * @param x Столбец
+         * @param y Строка (0 - низ)
+         * @return Глубина [0, 1]
+         */
+        [[nodiscard]] float depth(int x, int y) const
+        {
+            return depth_[static_cast<size_t>(y) * width_ + x];
+        }
+
+        /**
+         * Буфер глубины (построчно, снизу вверх)
+         * @return Массив глубин
+         */
+        [[nodiscard]] const std::vector<float>& depth_data() const
+        {
+            return depth_;
+        }
+
+        /**
+         * Ширина буфера
+         * @return Ширина
+         */
+        [[nodiscard]] int width() const
+        {
+            return width_;
+        }
+
+        /**
+         * Высота буфера
+         * @return Высота
+         */
+        [[nodiscard]] int height() const
+        {
+            return height_;
+        }
+
+        /**
+         * Статистика последнего кадра
+         * @return Статистика
+         */
+        [[nodiscard]] const Stats& stats() const
+        {
+            return stats_;
+        }
+
+    private:
+        /**
+         * Минимальное значение w после отсечения (ближняя плоскость отсекает z < -w, w там равно z_near > 0)
+         */
+        constexpr static float NEAR_W = 1e-5f;
+
+        /**
+         * Расширение ребер треугольника при растеризации (доля пикселя)
+         */
+        constexpr static float EDGE_EPSILON = 1e-3f;
+
+        /**
+         * Отсечь треугольник ближней плоскостью и добавить получившиеся треугольники
+         * @param a Вершина в пространстве отсечения
+         * @param b Вершина в пространстве отсечения
+         * @param c Вершина в пространстве отсечения
+         */
+        void add_clip_triangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+        {
+            stats_.triangles_in++;
+
+            // Все вершины за одной из плоскостей пирамиды видимости
+            for(int axis = 0; axis < 3; axis++)
+            {
+                if(a[axis] > a.w && b[axis] > b.w && c[axis] > c.w) return;
+                if(a[axis] < -a.w && b[axis] < -b.w && c[axis] < -c.w) return;
+            }
+
+            // Расстояние до ближней плоскости (z + w >= 0 - внутри)
+            const glm::vec4 in[3] = {a, b, c};
+            const float d[3] = {a.z + a.w, b.z + b.w, c.z + c.w};
+            if(d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f)
+            {
+                add_screen_triangle(a, b, c);
+                return;
+            }
+
+            // Отсечение многоугольника плоскостью (Сазерленд-Ходжмен), максимум 4 вершины
+            glm::vec4 out[4];
+            int count = 0;
+            for(int i = 0; i < 3; i++)
+            {
+                const int j = (i + 1) % 3;
+                if(d[i] >= 0.0f) out[count++] = in[i];
+                if((d[i] >= 0.0f) != (d[j] >= 0.0f))
+                {
+                    const float t = d[i] / (d[i] - d[j]);
+                    out[count++] = in[i] + (in[j] - in[i]) * t;
+                }
+            }
+
+            for(int i = 1; i + 1 < count; i++) add_screen_triangle(out[0], out[i], out[i + 1]);
+        }
+
+        /**
+         * Перевести треугольник в пространство экрана и добавить в список (если покрывает хотя бы один центр пикселя)
+         * @param a Вершина в пространстве отсечения
+         * @param b Вершина в пространстве отсечения
+         * @param c Вершина в пространстве отсечения
+         */
+        void add_screen_triangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+        {
+            ScreenTriangle tri = {};
+            const glm::vec4* in[3] = {&a, &b, &c};
+            glm::vec2 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+            for(int i = 0; i < 3; i++)
+            {
+                const float inv_w = 1.0f / std::max(in[i]->w, NEAR_W);
+                tri.v[i] = {
+                        (in[i]->x * inv_w * 0.5f + 0.5f) * static_cast<float>(width_),
+                        (in[i]->y * inv_w * 0.5f + 0.5f) * static_cast<float>(height_),
+                        in[i]->z * inv_w * 0.5f + 0.5f};
+                lo = glm::min(lo, glm::vec2(tri.v[i]));
+                hi = glm::max(hi, glm::vec2(tri.v[i]));
+            }
+
+            // Диапазон пикселей, центры которых могут попасть в треугольник
+            tri.min_x = std::max(static_cast<int>(std::ceil(lo.x - 0.5f)), 0);
+            tri.min_y = std::max(static_cast<int>(std::ceil(lo.y - 0.5f)), 0);
+            tri.max_x = std::min(static_cast<int>(std::floor(hi.x - 0.5f)), width_ - 1);
+            tri.max_y = std::min(static_cast<int>(std::floor(hi.y - 0.5f)), height_ - 1);
+            if(tri.min_x > tri.max_x || tri.min_y > tri.max_y) return;
+
+            triangles_.push_back(tri);
+            stats_.triangles_rasterized++;
+        }
+
+        /**
+         * Распределить треугольники по плиткам (по границам на экране)
+         */
+        void bin_triangles()
+        {
+            for(uint32_t i = 0; i < triangles_.size(); i++)
+            {
+                const auto& tri = triangles_[i];
+                for(int ty = tri.min_y / TILE_HEIGHT; ty <= tri.max_y / TILE_HEIGHT; ty++)
+                {
+                    for(int tx = tri.min_x / TILE_WIDTH; tx <= tri.max_x / TILE_WIDTH; tx++)
+                    {
+                        bins_[static_cast<size_t>(ty) * tiles_x_ + tx].push_back(i);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Растеризовать треугольники плитки и обновить максимальную глубину плитки
+         * @param tile Индекс плитки
+         */
+        void rasterize_tile(size_t tile)
+        {
+            const int tile_x0 = static_cast<int>(tile % tiles_x_) * TILE_WIDTH;
+            const int tile_y0 = static_cast<int>(tile / tiles_x_) * TILE_HEIGHT;
+
+            for(const uint32_t index : bins_[tile])
+            {
+                const auto& tri = triangles_[index];
+                const glm::vec3& v0 = tri.v[0];
+                const glm::vec3& v1 = tri.v[1];
+                const glm::vec3& v2 = tri.v[2];
+
+                // Удвоенная площадь (знак - порядок обхода), вырожденные треугольники пропускаются
+                const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+                if(std::abs(area) < 1e-8f) continue;
+                const float sign = area > 0.0f ? 1.0f : -1.0f;
+
+                // Функции ребер e(x, y) = a * x + b * y + c (неотрицательны внутри при любом порядке обхода)
+                const float ea[3] = {sign * (v1.y - v2.y), sign * (v2.y - v0.y), sign * (v0.y - v1.y)};
+                const float eb[3] = {sign * (v2.x - v1.x), sign * (v0.x - v2.x), sign * (v1.x - v0.x)};
+                float ec[3] = {
+                        sign * (v1.x * v2.y - v2.x * v1.y),
+                        sign * (v2.x * v0.y - v0.x * v2.y),
+                        sign * (v0.x * v1.y - v1.x * v0.y)};
+
+                // Небольшое расширение ребер, чтобы общие ребра соседних треугольников не давали щелей из-за округления
+                for(int e = 0; e < 3; e++) ec[e] += EDGE_EPSILON * (std::abs(ea[e]) + std::abs(eb[e]));
+
+                // Плоскость глубины z(x, y) = za * x + zb * y + zc (z/w линейна в пространстве экрана)
+                const float za = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+                const float zb = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+                const float zc = v0.z - za * v0.x - zb * v0.y;
+
+                // Участок плитки (начало строки выравнивается на 8 пикселей)
+                const int x0 = std::max(tri.min_x, tile_x0) & ~7;
+                const int x1 = std::min(tri.max_x, tile_x0 + TILE_WIDTH - 1);
+                const int y0 = std::max(tri.min_y, tile_y0);
+                const int y1 = std::min(tri.max_y, tile_y0 + TILE_HEIGHT - 1);
+
+                for(int y = y0; y <= y1; y++)
+                {
+                    float* row = &depth_[static_cast<size_t>(y) * width_];
+                    const float py = static_cast<float>(y) + 0.5f;
+                    for(int x = x0; x <= x1; x += 8)
+                    {
+                        rasterize_8(row + x, static_cast<float>(x) + 0.5f, py, ea, eb, ec, za, zb, zc);
+                    }
+                }
+            }
+
+            // Максимальная глубина плитки (для быстрой проверки объемов)
+            float tile_max = 0.0f;
+            for(int y = tile_y0; y < tile_y0 + TILE_HEIGHT; y++)
+            {
+                const float* row = &depth_[static_cast<size_t>(y) * width_ + tile_x0];
+                tile_max = std::max(tile_max, *std::max_element(row, row + TILE_WIDTH));
+            }
+            tile_max_depth_[tile] = tile_max;
+        }
+
+        /**
+         * Растеризовать 8 пикселей строки (минимум глубины по покрытым центрам пикселей)
+         * @param depth Глубина первого из 8 пикселей
+         * @param px Координата X центра первого пикселя
+         * @param py Координата Y центров пикселей
+         * @param ea Коэффициенты X функций ребер
+         * @param eb Коэффициенты Y функций ребер
+         * @param ec Свободные члены функций ребер
+         * @param za Коэффициент X плоскости глубины
+         * @param zb Коэффициент Y плоскости глубины
+         * @param zc Свободный член плоскости глубины
+         */
+        static void rasterize_8(float* depth, float px, float py,
+                                const float* ea, const float* eb, const float* ec,
+                                float za, float zb, float zc)
+        {
+#if defined(__AVX2__)
+            const __m256 x = _mm256_add_ps(_mm256_set1_ps(px), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+            const __m256 zero = _mm256_setzero_ps();
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for(int e = 0; e < 3; e++)
+            {
+                const __m256 value = _mm256_fmadd_ps(_mm256_set1_ps(ea[e]), x, _mm256_set1_ps(eb[e] * py + ec[e]));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(value, zero, _CMP_GE_OQ));
+            }
+            if(_mm256_testz_ps(inside, inside)) return;
+
+            const __m256 z = _mm256_fmadd_ps(_mm256_set1_ps(za), x, _mm256_set1_ps(zb * py + zc));
+            const __m256 current = _mm256_loadu_ps(depth);
+            _mm256_storeu_ps(depth, _mm256_blendv_ps(current, _mm256_min_ps(current, z), inside));
+#else
+            for(int i = 0; i < 8; i++)
+            {
+                const float x = px + static_cast<float>(i);
+                bool inside = true;
+                for(int e = 0; e < 3; e++) inside = inside && ea[e] * x + eb[e] * py + ec[e] >= 0.0f;
+                if(inside) depth[i] = std::min(depth[i], za * x + zb * py + zc);
+            }
+#endif
+        }
+
+        /**
+         * Есть ли в участке строки пиксель не ближе заданной глубины
+         * @param row Строка буфера
+         * @param x0 Первый пиксель
+         * @param x1 Последний пиксель (включительно)
+         * @param depth Глубина
+         * @return Найден пиксель с глубиной >= depth
+         */
+        static bool any_not_closer(const float* row, int x0, int x1, float depth)
+        {
+            int x = x0;
+#if defined(__AVX2__)
+            const __m256 d = _mm256_set1_ps(depth);
+            for(; x + 7 <= x1; x += 8)
+            {
+                if(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(row + x), d, _CMP_GE_OQ)) != 0) return true;
+            }
+#endif
+            for(; x <= x1; x++)
+            {
+                if(row[x] >= depth) return true;
+            }
+            return false;
+        }
+
+        // Размер буфера и кол-во плиток
+        int width_, height_;
+        int tiles_x_, tiles_y_;
+
+        // Матрица вида и проекции текущего кадра
+        glm::mat4 view_projection_;
+
+        // Глубина (построчно) и максимальная глубина каждой плитки
+        std::vector<float> depth_;
+        std::vector<float> tile_max_depth_;
+
+        // Треугольники кадра и их распределение по плиткам
+        std::vector<ScreenTriangle> triangles_;
+        std::vector<std::vector<uint32_t>> bins_;
+
+        // Временный массив вершин в пространстве отсечения
+        std::vector<glm::vec4> clip_;
+
+        // Статистика
+        Stats stats_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include "layout.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Статистика использования кеша пост-трансформации вершин
+     */
+    struct VertexCacheStats
+    {
+        // Average cache miss ratio - кол-во обработок вершин на треугольник (от 0.5 в идеале до 3)
+        float acmr = 0.0f;
+        // Average transform to vertex ratio - кол-во обработок на уникальную вершину (1 в идеале)
+        float atvr = 0.0f;
+        // Кол-во обработок вершин (промахов кеша)
+        size_t transforms = 0;
+    };
+
+    /**
+     * Статистика до и после оптимизации меша
+     */
+    struct MeshOptimizationStats
+    {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    /**
+     * Анализ использования кеша вершин (моделируется FIFO кеш, как у большинства GPU)
+     * @param indices Массив индексов (треугольники)
+     * @param vertex_count Кол-во вершин
+     * @param cache_size Размер моделируемого кеша
+     * @return Статистика
+     */
+    inline VertexCacheStats analyze_vertex_cache(const std::vector<GLuint>& indices, size_t vertex_count, size_t cache_size = 16)
+    {
+        VertexCacheStats stats;
+        if(indices.empty() || vertex_count == 0) return stats;
+
+        // Момент добавления вершины в кеш (по счетчику обработок) - вершина в кеше, если добавлена не раньше cache_size обработок назад
+        std::vector<size_t> timestamps(vertex_count, 0);
+        std::vector<bool> used(vertex_count, false);
+        size_t unique = 0;
+
+        for(const GLuint index : indices)
+        {
+            if(!used[index])
+            {
+                used[index] = true;
+                unique++;
+            }
+
+            if(timestamps[index] == 0 || stats.transforms + 1 - timestamps[index] > cache_size)
+            {
+                stats.transforms++;
+                timestamps[index] = stats.transforms;
+            }
+        }
+
+        stats.acmr = static_cast<float>(stats.transforms) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(stats.transforms) / static_cast<float>(unique);
+        return stats;
+    }
+
+    /**
+     * Переупорядочивание треугольников для эффективного использования кеша вершин (алгоритм Forsyth)
+     * Жадно выбирается треугольник с наибольшей оценкой; оценка вершины растет, если она недавно
+     * попала в кеш и если у нее осталось мало необработанных треугольников
+     * @param indices Массив индексов (треугольники)
+     * @param vertex_count Кол-во вершин
+     * @param cache_size Размер моделируемого LRU кеша (не больше 64)
+     * @return Новый массив индексов
+     */
+    inline std::vector<GLuint> optimize_vertex_cache(const std::vector<GLuint>& indices, size_t vertex_count, size_t cache_size = 32)
+    {
+        const size_t triangle_count = indices.size() / 3;
+        if(triangle_count == 0) return indices;
+
+        cache_size = std::clamp<size_t>(cache_size, 4, 64);
+
+        // Оценка вершины по положению в кеше и кол-ву оставшихся треугольников
+        auto vertex_score = [cache_size](int cache_position, size_t remaining) -> float
+        {
+            if(remaining == 0) return -1.0f;
+
+            float score = 0.0f;
+            if(cache_position >= 0)
+            {
+                // Вершины последнего треугольника получают фиксированную оценку (чтобы не выбирать его соседа сразу)
+                if(cache_position < 3) score = 0.75f;
+                else score = std::pow(1.0f - static_cast<float>(cache_position - 3) / static_cast<float>(cache_size - 3), 1.5f);
+            }
+
+            return score + 2.0f * std::pow(static_cast<float>(remaining), -0.5f);
+        };
+
+        // Смежность вершин и треугольников (списки треугольников вершины в общем массиве)
+        std::vector<size_t> remaining(vertex_count, 0);
+        for(const GLuint index : indices) remaining[index]++;
+
+        std::vector<size_t> offsets(vertex_count + 1, 0);
+        for(size_t v = 0; v < vertex_count; v++) offsets[v + 1] = offsets[v] + remaining[v];
+
+        std::vector<size_t> adjacency(indices.size());
+        {
+            std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+            for(size_t t = 0; t < triangle_count; t++)
+            {
+                for(size_t k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        std::vector<float> vertex_scores(vertex_count);
+        for(size_t v = 0; v < vertex_count; v++) vertex_scores[v] = vertex_score(-1, remaining[v]);
+
+        std::vector<bool> emitted(triangle_count, false);
+        std::vector<GLuint> cache, new_cache;
+        cache.reserve(cache_size + 3);
+        new_cache.reserve(cache_size + 3);
+
+        std::vector<GLuint> result;
+        result.reserve(indices.size());
+
+        size_t best = 0;
+        size_t cursor = 0;
+
+        for(size_t emitted_count = 0; emitted_count < triangle_count; emitted_count++)
+        {
+            // Нет кандидатов среди вершин кеша - следующий необработанный треугольник по порядку
+            if(best == triangle_count)
+            {
+                while(emitted[cursor]) cursor++;
+                best = cursor;
+            }
+
+            const size_t t = best;
+            emitted[t] = true;
+
+            // Вывод треугольника, удаление его из списков смежности вершин
+            for(size_t k = 0; k < 3; k++)
+            {
+                const GLuint v = indices[t * 3 + k];
+                result.push_back(v);
+
+                const size_t begin = offsets[v];
+                const size_t end = begin + remaining[v];
+                for(size_t i = begin; i < end; i++)
+                {
+                    if(adjacency[i] == t)
+                    {
+                        std::swap(adjacency[i], adjacency[end - 1]);
+                        break;
+                    }
+                }
+                remaining[v]--;
+            }
+
+            // Вершины треугольника в начало LRU кеша
+            new_cache.clear();
+            for(size_t k = 0; k < 3; k++)
+            {
+                const GLuint v = indices[t * 3 + k];
+                if(std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end()) new_cache.push_back(v);
+            }
+            for(const GLuint v : cache)
+            {
+                if(v != indices[t * 3] && v != indices[t * 3 + 1] && v != indices[t * 3 + 2]) new_cache.push_back(v);
+            }
+
+            // Вытесненные вершины теряют оценку за положение в кеше
+            for(size_t i = cache_size; i < new_cache.size(); i++)
+            {
+                const GLuint v = new_cache[i];
+                vertex_scores[v] = vertex_score(-1, remaining[v]);
+            }
+            if(new_cache.size() > cache_size) new_cache.resize(cache_size);
+            std::swap(cache, new_cache);
+
+            // Обновление оценок вершин кеша и их треугольников, выбор лучшего кандидата
+            for(size_t i = 0; i < cache.size(); i++)
+            {
+                const GLuint v = cache[i];
+                vertex_scores[v] = vertex_score(static_cast<int>(i), remaining[v]);
+            }
+
+            best = triangle_count;
+            float best_score = -1.0f;
+            for(const GLuint v : cache)
+            {
+                for(size_t i = offsets[v]; i < offsets[v] + remaining[v]; i++)
+                {
+                    const size_t a = adjacency[i];
+                    const float score = vertex_scores[indices[a * 3]] + vertex_scores[indices[a * 3 + 1]] + vertex_scores[indices[a * 3 + 2]];
+                    if(score > best_score)
+                    {
+                        best_score = score;
+                        best = a;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Переупорядочивание кластеров треугольников для уменьшения перерисовки (overdraw)
+     * Последовательность (уже оптимизированная для кеша) делится на кластеры в местах, где кеш полностью
+     * промахивается. Кластеры сортируются так, чтобы первыми рисовались обращенные наружу части меша
+     * (они чаще закрывают остальные). Если сортировка ухудшает ACMR больше чем в threshold раз - порядок не меняется
+     * @tparam V Тип вершины
+     * @param indices Массив индексов (треугольники)
+     * @param vertices Массив вершин (положение читается по раскладке V::Layout)
+     * @param threshold Допустимое ухудшение ACMR
+     * @param cache_size Размер моделируемого FIFO кеша
+     * @return Новый массив индексов
+     */
+    template<typename V>
+    inline std::vector<GLuint> optimize_overdraw(const std::vector<GLuint>& indices,
+                                                 const std::vector<V>& vertices,
+                                                 float threshold = 1.05f,
+                                                 size_t cache_size = 16)
+    {
+        const size_t triangle_count = indices.size() / 3;
+        if(triangle_count < 2) return indices;
+
+        auto position = [&](GLuint index) -> glm::vec3
+        {
+            return position_of(vertices[index]);
+        };
+
+        // Границы кластеров - треугольники, все вершины которых промахиваются мимо кеша
+        std::vector<size_t> clusters;
+        {
+            std::vector<size_t> timestamps(vertices.size(), 0);
+            size_t time = 0;
+            for(size_t t = 0; t < triangle_count; t++)
+            {
+                size_t misses = 0;
+                for(size_t k = 0; k < 3; k++)
+                {
+                    const GLuint v = indices[t * 3 + k];
+                    if(timestamps[v] == 0 || time + 1 - timestamps[v] > cache_size)
+                    {
+                        timestamps[v] = ++time;
+                        misses++;
+                    }
+                }
+                if(misses == 3 || t == 0) clusters.push_back(t);
+            }
+        }
+        if(clusters.size() < 2) return indices;
+        clusters.push_back(triangle_count);
+
+        // Центр меша (среднее по площади)
+        glm::vec3 mesh_center(0.0f);
+        float mesh_area = 0.0f;
+        for(size_t t = 0; t < triangle_count; t++)
+        {
+            const glm::vec3 a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), c = position(indices[t * 3 + 2]);
+            const float area = glm::length(glm::cross(b - a, c - a));
+            mesh_center += (a + b + c) * (area / 3.0f);
+            mesh_area += area;
+        }
+        mesh_center = mesh_area > 0.0f ? mesh_center / mesh_area : glm::vec3(0.0f);
+
+        // Ключ сортировки кластера - насколько кластер обращен от центра меша
+        const size_t cluster_count = clusters.size() - 1;
+        std::vector<float> keys(cluster_count, 0.0f);
+        for(size_t c = 0; c < cluster_count; c++)
+        {
+            glm::vec3 center(0.0f), normal(0.0f);
+            float area_sum = 0.0f;
+            for(size_t t = clusters[c]; t < clusters[c + 1]; t++)
+            {
+                const glm::vec3 a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), d = position(indices[t * 3 + 2]);
+                const glm::vec3 n = glm::cross(b - a, d - a);
+                const float area = glm::length(n);
+                center += (a + b + d) * (area / 3.0f);
+                normal += n;
+                area_sum += area;
+            }
+
+            if(area_sum > 0.0f) center /= area_sum;
+            const float len = glm::length(normal);
+            if(len > 0.0f) normal /= len;
+
+            keys[c] = glm::dot(center - mesh_center, normal);
+        }
+
+        std::vector<size_t> order(cluster_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b){ return keys[a] > keys[b]; });
+
+        std::vector<GLuint> result;
+        result.reserve(indices.size());
+        for(const size_t c : order)
+        {
+            result.insert(result.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusters[c] * 3), indices.begin() + static_cast<std::ptrdiff_t>(clusters[c + 1] * 3));
+        }
+
+        // Не жертвовать эффективностью кеша сверх допустимого
+        const float before = analyze_vertex_cache(indices, vertices.size(), cache_size).acmr;
+        const float after = analyze_vertex_cache(result, vertices.size(), cache_size).acmr;
+        return after <= before * threshold ? result : indices;
+    }
+
+    /**
+     * Переупорядочивание вершин в порядке первого использования (последовательная выборка из памяти)
+     * Неиспользуемые вершины удаляются, индексы переназначаются
+     * @tparam V Тип вершины
+     * @param vertices Массив вершин (изменяется)
+     * @param indices Массив индексов (изменяется)
+     * @return Новое кол-во вершин
+     */
+    template<typename V>
+    inline size_t optimize_vertex_fetch(std::vector<V>& vertices, std::vector<GLuint>& indices)
+    {
+        constexpr GLuint unassigned = ~0u;
+        std::vector<GLuint> remap(vertices.size(), unassigned);
+        std::vector<V> result;
+        result.reserve(vertices.size());
+
+        for(GLuint& index : indices)
+        {
+            if(remap[index] == unassigned)
+            {
+                remap[index] = static_cast<GLuint>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices = std::move(result);
+        return vertices.size();
+    }
+
+    /**
+     * Полный проход оптимизации меша (для офлайн конвейера подготовки ресурсов)
+     * Кеш вершин, затем перерисовка, затем порядок выборки вершин
+     * @tparam V Тип вершины
+     * @param vertices Массив вершин (изменяется)
+     * @param indices Массив индексов (изменяется)
+     * @param overdraw_threshold Допустимое ухудшение ACMR при оптимизации перерисовки
+     * @param cache_size Размер моделируемого кеша для статистики
+     * @return Статистика до и после
+     */
+    template<typename V>
+    inline MeshOptimizationStats optimize_mesh(std::vector<V>& vertices,
+                                               std::vector<GLuint>& indices,
+                                               float overdraw_threshold = 1.05f,
+                                               size_t cache_size = 16)
+    {
+        MeshOptimizationStats stats;
+        stats.before = analyze_vertex_cache(indices, vertices.size(), cache_size);
+
+        indices = optimize_vertex_cache(indices, vertices.size());
+        indices = optimize_overdraw(indices, vertices, overdraw_threshold, cache_size);
+        optimize_vertex_fetch(vertices, indices);
+
+        stats.after = analyze_vertex_cache(indices, vertices.size(), cache_size);
+        return stats;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace utils::geometry
+{
+    /**
+     * Два 16-битных числа с плавающей точкой (GL_HALF_FLOAT, 2 компонента)
+     * Подходит для UV координат в диапазоне [0, 1] и около него
+     */
+    struct Half2
+    {
+        uint16_t x = 0;
+        uint16_t y = 0;
+    };
+
+    /**
+     * Нормаль в октаэдрической проекции (GL_SHORT, 2 компонента, с нормализацией)
+     * В шейдере восстанавливается функцией oct_decode (см. shaders/common/packing.glsl)
+     */
+    struct Oct16
+    {
+        int16_t x = 0;
+        int16_t y = 0;
+    };
+
+    /**
+     * Четыре компонента 10-10-10-2 со знаком (GL_INT_2_10_10_10_REV, 4 компонента, с нормализацией)
+     * Подходит для нормалей и касательных (знак битангенса в w)
+     */
+    struct Snorm1010102
+    {
+        uint32_t bits = 0;
+    };
+
+    /**
+     * Четыре 8-битных компонента без знака (GL_UNSIGNED_BYTE, 4 компонента, с нормализацией)
+     * Подходит для цвета
+     */
+    struct Unorm8x4
+    {
+        uint8_t r = 0;
+        uint8_t g = 0;
+        uint8_t b = 0;
+        uint8_t a = 0;
+    };
+
+    /**
+     * Преобразование 32-битного числа с плавающей точкой в 16-битное (с округлением до ближайшего четного)
+     * @param value Значение
+     * @return Биты 16-битного числа
+     */
+    inline uint16_t pack_half(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const auto sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+        const uint32_t f_exponent = (bits >> 23u) & 0xFFu;
+        const int32_t exponent = static_cast<int32_t>(f_exponent) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        // Бесконечность и NaN
+        if(f_exponent == 0xFFu) return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+        // Переполнение
+        if(exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00u);
+
+        // Денормализованные числа (либо ноль)
+        if(exponent <= 0)
+        {
+            if(exponent < -10) return sign;
+
+            mantissa |= 0x800000u;
+            const auto shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t half = mantissa >> shift;
+            const uint32_t rest = mantissa & ((1u << shift) - 1u);
+            const uint32_t middle = 1u << (shift - 1u);
+            if(rest > middle || (rest == middle && (half & 1u))) half++;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // Перенос при округлении может увеличить экспоненту (вплоть до бесконечности), что корректно
+        uint32_t half = (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+        const uint32_t rest = mantissa & 0x1FFFu;
+        if(rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    /**
+     * Преобразование 16-битного числа с плавающей точкой в 32-битное
+     * @param half Биты 16-битного числа
+     * @return Значение
+     */
+    inline float unpack_half(uint16_t half)
+    {
+        const uint32_t sign = (static_cast<uint32_t>(half) & 0x8000u) << 16u;
+        const uint32_t exponent = (half >> 10u) & 0x1Fu;
+        const uint32_t mantissa = half & 0x3FFu;
+
+        if(exponent == 0)
+        {
+            const float value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -value : value;
+        }
+
+        const uint32_t bits = exponent == 0x1Fu
+                ? sign | 0x7F800000u | (mantissa << 13u)
+                : sign | ((exponent - 15u + 127u) << 23u) | (mantissa << 13u);
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Упаковка двух компонентов в 16-битные числа с плавающей точкой
+     * @param v Вектор
+     * @return Упакованное значение
+     */
+    inline Half2 pack_half2(const glm::vec2& v)
+    {
+        return {pack_half(v.x), pack_half(v.y)};
+    }
+
+    /**
+     * Распаковка двух 16-битных чисел с плавающей точкой
+     * @param h Упакованное значение
+     * @return Вектор
+     */
+    inline glm::vec2 unpack_half2(const Half2& h)
+    {
+        return {unpack_half(h.x), unpack_half(h.y)};
+    }
+
+    /**
+     * Перевод числа из диапазона [-1, 1] в целое со знаком заданной разрядности
+     * @param value Значение
+     * @param max Максимальное целое значение (например 32767 для 16 бит)
+     * @return Целое значение
+     */
+    inline int32_t pack_snorm(float value, int32_t max)
+    {
+        return static_cast<int32_t>(std::round(std::clamp(value, -1.0f, 1.0f) * static_cast<float>(max)));
+    }
+
+    /**
+     * Упаковка единичного вектора в октаэдрическую проекцию
+     * Сфера проецируется на октаэдр, нижняя половина октаэдра разворачивается на углы квадрата
+     * @param n Нормализованный вектор
+     * @return Упакованное значение
+     */
+    inline Oct16 pack_octahedral(const glm::vec3& n)
+    {
+        const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        float x = l1 > 0.0f ? n.x / l1 : 0.0f;
+        float y = l1 > 0.0f ? n.y / l1 : 0.0f;
+
+        if(n.z < 0.0f)
+        {
+            const float ox = x;
+            x = (1.0f - std::abs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+            y = (1.0f - std::abs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        return {static_cast<int16_t>(pack_snorm(x, 32767)), static_cast<int16_t>(pack_snorm(y, 32767))};
+    }
+
+    /**
+     * Распаковка единичного вектора из октаэдрической проекции (то же что oct_decode в шейдере)
+     * @param o Упакованное значение
+     * @return Нормализованный вектор
+     */
+    inline glm::vec3 unpack_octahedral(const Oct16& o)
+    {
+        const float x = std::max(static_cast<float>(o.x) / 32767.0f, -1.0f);
+        const float y = std::max(static_cast<float>(o.y) / 32767.0f, -1.0f);
+
+        glm::vec3 n = {x, y, 1.0f - std::abs(x) - std::abs(y)};
+        const float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    /**
+     * Упаковка вектора в формат 10-10-10-2 со знаком
+     * @param v Вектор (компоненты в диапазоне [-1, 1])
+     * @param w Четвертый компонент (-1, 0 или 1)
+     * @return Упакованное значение
+     */
+    inline Snorm1010102 pack_snorm_1010102(const glm::vec3& v, float w = 0.0f)
+    {
+        const auto x = static_cast<uint32_t>(pack_snorm(v.x, 511)) & 0x3FFu;
+        const auto y = static_cast<uint32_t>(pack_snorm(v.y, 511)) & 0x3FFu;
+        const auto z = static_cast<uint32_t>(pack_snorm(v.z, 511)) & 0x3FFu;
+        const auto a = static_cast<uint32_t>(pack_snorm(w, 1)) & 0x3u;
+        return {x | (y << 10u) | (z << 20u) | (a << 30u)};
+    }
+
+    /**
+     * Распаковка вектора из формата 10-10-10-2 со знаком (первые три компонента)
+     * @param p Упакованное значение
+     * @return Вектор
+     */
+    inline glm::vec3 unpack_snorm_1010102(const Snorm1010102& p)
+    {
+        // Расширение знака 10-битного значения
+        auto component = [](uint32_t bits) -> float
+        {
+            const int32_t value = static_cast<int32_t>(bits << 22u) >> 22;
+            return std::max(static_cast<float>(value) / 511.0f, -1.0f);
+        };
+
+        return {component(p.bits & 0x3FFu), component((p.bits >> 10u) & 0x3FFu), component((p.bits >> 20u) & 0x3FFu)};
+    }
+
+    /**
+     * Упаковка цвета в 8-битные компоненты
+     * @param c Цвет (компоненты в диапазоне [0, 1])
+     * @return Упакованное значение
+     */
+    inline Unorm8x4 pack_unorm8x4(const glm::vec4& c)
+    {
+        auto component = [](float value) -> uint8_t
+        {
+            return static_cast<uint8_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        };
+
+        return {component(c.x), component(c.y), component(c.z), component(c.w)};
+    }
+
+    /**
+     * Распаковка цвета из 8-битных компонентов
+     * @param p Упакованное значение
+     * @return Цвет
+     */
+    inline glm::vec4 unpack_unorm8x4(const Unorm8x4& p)
+    {
+        return glm::vec4(p.r, p.g, p.b, p.a) / 255.0f;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include "optimize.hpp"
+#include "layout.hpp"
+
+namespace utils::geometry
+{
+    /**
+     * Уровень детализации меша (участок общего индексного буфера цепочки)
+     */
+    struct MeshLod
+    {
+        // Первый индекс уровня
+        GLuint first_index = 0;
+        // Кол-во индексов уровня
+        GLuint index_count = 0;
+        // Геометрическая ошибка уровня относительно исходного меша (в единицах пространства меша)
+        float error = 0.0f;
+    };
+
+    namespace detail
+    {
+        /**
+         * Квадрика ошибки (симметричная матрица 4x4 суммы квадратов расстояний до плоскостей)
+         * Хранятся 10 уникальных элементов и суммарный вес плоскостей
+         */
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+            double a11 = 0, a12 = 0, a13 = 0;
+            double a22 = 0, a23 = 0;
+            double a33 = 0;
+            double weight = 0;
+
+            /**
+             * Квадрика плоскости (n, d) с весом
+             * @param n Нормализованная нормаль плоскости
+             * @param d Расстояние (dot(n, p) + d = 0 для точек плоскости)
+             * @param w Вес
+             * @return Квадрика
+             */
+            static Quadric plane(const glm::vec3& n, float d, double w)
+            {
+                const double x = n.x, y = n.y, z = n.z, c = d;
+                Quadric q;
+                q.a00 = w * x * x; q.a01 = w * x * y; q.a02 = w * x * z; q.a03 = w * x * c;
+                q.a11 = w * y * y; q.a12 = w * y * z; q.a13 = w * y * c;
+                q.a22 = w * z * z; q.a23 = w * z * c;
+                q.a33 = w * c * c;
+                q.weight = w;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& o)
+            {
+                a00 += o.a00; a01 += o.a01; a02 += o.a02; a03 += o.a03;
+                a11 += o.a11; a12 += o.a12; a13 += o.a13;
+                a22 += o.a22; a23 += o.a23;
+                a33 += o.a33;
+                weight += o.weight;
+                return *this;
+            }
+
+            /**
+             * Средний квадрат расстояния от точки до плоскостей квадрики
+             * @param p Точка
+             * @return Ошибка
+             */
+            [[nodiscard]] double error(const glm::vec3& p) const
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                const double e =
+                        a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                        2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+                return weight > 0.0 ? std::abs(e) / weight : 0.0;
+            }
+        };
+
+        /**
+         * Тип вершины для упрощения
+         */
+        enum EVertexKind : unsigned char
+        {
+            // Внутренняя вершина (может быть перенесена в любую соседнюю)
+            MANIFOLD = 0,
+            // Вершина на границе меша (переносится только вдоль границы)
+            BORDER,
+            // Вершина на шве атрибутов или в вырожденной топологии (не переносится)
+            LOCKED
+        };
+    }
+
+    /**
+     * Упрощение меша методом квадрик ошибки (Garland-Heckbert, схлопывание ребер в одну из вершин)
+     * Вершины не перемещаются и не удаляются: результат - новый индексный буфер для того же массива вершин,
+     * поэтому все уровни детализации могут использовать общий вершинный буфер. Вершины швов атрибутов
+     * (одинаковое положение, разные UV/нормали) не переносятся, граничные вершины переносятся только вдоль границы
+     * @tparam V Тип вершины
+     * @param indices Массив индексов (треугольники)
+     * @param vertices Массив вершин (положение читается по раскладке V::Layout)
+     * @param target_index_count Целевое кол-во индексов
+     * @param target_error Максимальная допустимая ошибка (в единицах пространства меша)
+     * @param out_error Достигнутая ошибка (может быть nullptr)
+     * @return Новый массив индексов
+     */
+    template<typename V>
+    inline std::vector<GLuint> simplify(const std::vector<GLuint>& indices,
+                                        const std::vector<V>& vertices,
+                                        size_t target_index_count,
+                                        float target_error = std::numeric_limits<float>::max(),
+                                        float* out_error = nullptr)
+    {
+        std::vector<GLuint> result = indices;
+        if(out_error) *out_error = 0.0f;
+        if(result.size() <= target_index_count || vertices.empty()) return result;
+
+        const size_t vertex_count = vertices.size();
+        std::vector<glm::vec3> positions(vertex_count);
+        for(size_t i = 0; i < vertex_count; i++) positions[i] = position_of(vertices[i]);
+
+        // Вершины с одинаковым положением (швы атрибутов) блокируются
+        std::vector<detail::EVertexKind> kinds(vertex_count, detail::MANIFOLD);
+        {
+            struct Hash
+            {
+                size_t operator()(const glm::vec3& p) const
+                {
+                    uint32_t h[3];
+                    std::memcpy(h, &p, sizeof(h));
+                    return (h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u);
+                }
+            };
+            struct Equal
+            {
+                bool operator()(const glm::vec3& a, const glm::vec3& b) const
+                {
+                    return a.x == b.x && a.y == b.y && a.z == b.z;
+                }
+            };
+
+            std::unordered_map<glm::vec3, GLuint, Hash, Equal> first;
+            first.reserve(vertex_count);
+            for(GLuint i = 0; i < static_cast<GLuint>(vertex_count); i++)
+            {
+                auto [it, inserted] = first.emplace(positions[i], i);
+                if(!inserted)
+                {
+                    kinds[i] = detail::LOCKED;
+                    kinds[it->second] = detail::LOCKED;
+                }
+            }
+        }
+
+        // Ребра (ключ - пара вершин по возрастанию) и кол-во использующих их треугольников
+        auto edge_key = [](GLuint a, GLuint b) -> uint64_t
+        {
+            return a < b ? (static_cast<uint64_t>(a) << 32u) | b : (static_cast<uint64_t>(b) << 32u) | a;
+        };
+
+        std::unordered_map<uint64_t, unsigned> edge_use;
+        edge_use.reserve(result.size());
+        for(size_t t = 0; t < result.size(); t += 3)
+        {
+            for(size_t k = 0; k < 3; k++) edge_use[edge_key(result[t + k], result[t + (k + 1) % 3])]++;
+        }
+
+        // Квадрики: плоскости треугольников (вес - площадь) и плоскости вдоль граничных ребер (сохраняют контур)
+        std::vector<detail::Quadric> quadrics(vertex_count);
+        for(size_t t = 0; t < result.size(); t += 3)
+        {
+            const GLuint i[3] = {result[t], result[t + 1], result[t + 2]};
+            const glm::vec3 a = positions[i[0]], b = positions[i[1]], c = positions[i[2]];
+            const glm::vec3 n = glm::cross(b - a, c - a);
+            const float area2 = glm::length(n);
+            if(area2 <= 0.0f) continue;
+
+            const glm::vec3 normal = n / area2;
+            const auto face = detail::Quadric::plane(normal, -glm::dot(normal, a), area2 * 0.5);
+            for(const GLuint v : i) quadrics[v] += face;
+
+            for(size_t k = 0; k < 3; k++)
+            {
+                const GLuint v0 = i[k], v1 = i[(k + 1) % 3];
+                const unsigned use = edge_use[edge_key(v0, v1)];
+
+                // Ребро с более чем двумя треугольниками - неманифолдная топология
+                if(use > 2)
+                {
+                    kinds[v0] = detail::LOCKED;
+                    kinds[v1] = detail::LOCKED;
+                }
+                if(use != 1) continue;
+
+                for(const GLuint v : {v0, v1}) if(kinds[v] == detail::MANIFOLD) kinds[v] = detail::BORDER;
+
+                // Плоскость через ребро перпендикулярно треугольнику (с большим весом)
+                const glm::vec3 edge = positions[v1] - positions[v0];
+                const float length = glm::length(edge);
+                if(length <= 0.0f) continue;
+                const glm::vec3 side = glm::normalize(glm::cross(edge, normal));
+                const auto border = detail::Quadric::plane(side, -glm::dot(side, positions[v0]), length * length * 10.0);
+                quadrics[v0] += border;
+                quadrics[v1] += border;
+            }
+        }
+
+        // Проход: сбор ребер, сортировка по стоимости, схлопывание дешевых ребер (вершины затронутые в проходе блокируются)
+        struct Collapse
+        {
+            GLuint from;
+            GLuint to;
+            float cost;
+        };
+
+        std::vector<GLuint> remap(vertex_count);
+        std::vector<bool> touched(vertex_count);
+        std::vector<size_t> adjacency_offsets(vertex_count + 1);
+        std::vector<GLuint> adjacency;
+        std::vector<Collapse> collapses;
+        float max_error = 0.0f;
+
+        while(result.size() > target_index_count)
+        {
+            // Треугольники, использующие каждую вершину
+            std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+            for(const GLuint v : result) adjacency_offsets[v + 1]++;
+            std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+            adjacency.resize(result.size());
+            {
+                std::vector<size_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+                for(size_t t = 0; t < result.size(); t += 3)
+                {
+                    for(size_t k = 0; k < 3; k++) adjacency[fill[result[t + k]]++] = static_cast<GLuint>(t / 3);
+                }
+            }
+
+            // Граничные ребра текущего меша (граничная вершина переносится только вдоль них)
+            edge_use.clear();
+            for(size_t t = 0; t < result.size(); t += 3)
+            {
+                for(size_t k = 0; k < 3; k++) edge_use[edge_key(result[t + k], result[t + (k + 1) % 3])]++;
+            }
+
+            collapses.clear();
+            for(size_t t = 0; t < result.size(); t += 3)
+            {
+                for(size_t k = 0; k < 3; k++)
+                {
+                    const GLuint a = result[t + k], b = result[t + (k + 1) % 3];
+                    const bool border_edge = edge_use[edge_key(a, b)] == 1;
+
+                    // Внутреннее ребро учитывается одним из двух треугольников
+                    if(!border_edge && a > b) continue;
+
+                    for(const auto& [from, to] : {std::pair<GLuint, GLuint>{a, b}, std::pair<GLuint, GLuint>{b, a}})
+                    {
+                        if(kinds[from] == detail::LOCKED) continue;
+                        if(kinds[from] == detail::BORDER && !border_edge) continue;
+
+                        detail::Quadric q = quadrics[from];
+                        q += quadrics[to];
+                        collapses.push_back({from, to, static_cast<float>(std::sqrt(q.error(positions[to])))});
+                    }
+                }
+            }
+
+            if(collapses.empty()) break;
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r){ return l.cost < r.cost; });
+
+            std::iota(remap.begin(), remap.end(), 0);
+            std::fill(touched.begin(), touched.end(), false);
+
+            // Удаляется не больше треугольников, чем требуется (каждое схлопывание удаляет ~2 треугольника)
+            const size_t triangles_needed = (result.size() - target_index_count) / 3;
+            size_t triangles_removed = 0;
+            size_t collapsed = 0;
+
+            for(const auto& c : collapses)
+            {
+                if(triangles_removed >= std::max<size_t>(triangles_needed, 1)) break;
+                if(c.cost > target_error) break;
+                if(touched[c.from] || touched[c.to]) continue;
+
+                // Проверка переворота треугольников вокруг переносимой вершины
+                bool valid = true;
+                size_t removed = 0;
+                for(size_t a = adjacency_offsets[c.from]; a < adjacency_offsets[c.from + 1] && valid; a++)
+                {
+                    const size_t t = adjacency[a] * 3;
+                    GLuint tri[3] = {remap[result[t]], remap[result[t + 1]], remap[result[t + 2]]};
+                    if(tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+                    {
+                        removed++;
+                        continue;
+                    }
+
+                    const glm::vec3 n_before = glm::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+                    for(auto& v : tri) if(v == c.from) v = c.to;
+                    const glm::vec3 n_after = glm::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+
+                    // Новый треугольник должен сохранить ориентацию и не выродиться
+                    const float before = glm::length(n_before), after = glm::length(n_after);
+                    valid = after > 0.0f && glm::dot(n_before, n_after) > 0.25f * before * after;
+                }
+                if(!valid || removed == 0) continue;
+
+                remap[c.from] = c.to;
+                touched[c.from] = true;
+                touched[c.to] = true;
+                quadrics[c.to] += quadrics[c.from];
+
+                triangles_removed += removed;
+                max_error = std::max(max_error, c.cost);
+                collapsed++;
+            }
+
+            if(collapsed == 0) break;
+
+            // Применить переносы и убрать вырожденные треугольники
+            size_t write = 0;
+            for(size_t t = 0; t < result.size(); t += 3)
+            {
+                const GLuint a = remap[result[t]], b = remap[result[t + 1]], c = remap[result[t + 2]];
+                if(a == b || b == c || c == a) continue;
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if(out_error) *out_error = max_error;
+        return result;
+    }
+
+    /**
+     * Построение цепочки уровней детализации
+     * Каждый уровень получается упрощением исходного меша до заданной доли треугольников и оптимизируется
+     * для кеша вершин. Индексы всех уровней записываются в общий массив подряд (уровень 0 - исходный меш)
+     * @tparam V Тип вершины
+     * @param indices Массив индексов (на входе - исходный меш, на выходе - все уровни подряд)
+     * @param vertices Массив вершин (общий для всех уровней)
+     * @param ratios Доли треугольников исходного меша для уровней 1..N (по убыванию)
+     * @return Уровни детализации (ошибка не убывает с номером уровня)
+     */
+    template<typename V>
+    inline std::vector<MeshLod> generate_lod_chain(std::vector<GLuint>& indices,
+                                                   const std::vector<V>& vertices,
+                                                   const std::vector<float>& ratios = {0.5f, 0.25f, 0.125f, 0.0625f})
+    {
+        const std::vector<GLuint> source = indices;
+        std::vector<MeshLod> lods;
+        lods.push_back({0, static_cast<GLuint>(source.size()), 0.0f});
+
+        for(const float ratio : ratios)
+        {
+            const auto target = static_cast<size_t>(static_cast<float>(source.size() / 3) * ratio) * 3;
+
+            float error = 0.0f;
+            std::vector<GLuint> lod = simplify(source, vertices, target, std::numeric_limits<float>::max(), &error);
+
+            // Упрощение остановилось (ограничения топологии) - следующие уровни не имеют смысла
+            if(lod.size() >= lods.back().index_count) break;
+
+            lod = optimize_vertex_cache(lod, vertices.size());
+
+            MeshLod level;
+            level.first_index = static_cast<GLuint>(indices.size());
+            level.index_count = static_cast<GLuint>(lod.size());
+            level.error = std::max(error, lods.back().error);
+            lods.push_back(level);
+
+            indices.insert(indices.end(), lod.begin(), lod.end());
+        }
+
+        return lods;
+    }
+
+    /**
+     * Выбор уровня детализации по размеру ошибки на экране
+     * Выбирается самый грубый уровень, ошибка которого в проекции не превышает порога
+     * @param lods Уровни детализации
+     * @param distance Расстояние от камеры до объекта
+     * @param scale Масштаб объекта (переводит ошибку из пространства меша в мировое)
+     * @param projection_scale Элемент [1][1] матрицы проекции (1 / tan(fov / 2))
+     * @param screen_height Высота экрана (пикселей)
+     * @param max_pixel_error Допустимая ошибка (пикселей)
+     * @return Индекс уровня
+     */
+    inline size_t select_lod(const std::vector<MeshLod>& lods,
+                             float distance,
+                             float scale,
+                             float projection_scale,
+                             float screen_height,
+                             float max_pixel_error = 1.0f)
+    {
+        // Кол-во пикселей на единицу мирового пространства на данном расстоянии
+        const float pixels_per_unit = projection_scale * screen_height * 0.5f / std::max(distance, 1e-4f);
+
+        size_t selected = 0;
+        for(size_t i = 1; i < lods.size(); i++)
+        {
+            if(lods[i].error * scale * pixels_per_unit > max_pixel_error) break;
+            selected = i;
+        }
+        return selected;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cassert>
+
+#include "resource.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Иерархический буфер глубины (Hi-Z)
+     * Текстура R32F с полной цепочкой mip-уровней: уровень 0 - копия буфера глубины, каждый следующий уровень
+     * хранит максимум (самую дальнюю глубину) соответствующей области предыдущего уровня.
+     * Прямоугольник объекта на экране покрывается 2x2 текселями уровня, размер текселя которого не меньше
+     * размера прямоугольника, поэтому проверка перекрытия стоит 4 выборки независимо от размера объекта
+     */
+    class DepthPyramid final : public Resource
+    {
+    public:
+        /**
+         * Размер рабочей группы вычислительных шейдеров построения (по каждой оси)
+         * Должен совпадать с local_size_x/local_size_y в шейдерах
+         */
+        constexpr static GLuint GROUP_SIZE = 8;
+
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        DepthPyramid()
+            : Resource()
+            , texture_id_(0)
+            , width_(0)
+            , height_(0)
+            , levels_(0)
+        {}
+
+        /**
+         * Основной конструктор (создает текстуру пирамиды)
+         * @param width Ширина уровня 0 (совпадает с шириной буфера глубины)
+         * @param height Высота уровня 0 (совпадает с высотой буфера глубины)
+         */
+        DepthPyramid(GLsizei width, GLsizei height)
+            : Resource()
+            , texture_id_(0)
+            , width_(width)
+            , height_(height)
+            , levels_(1)
+        {
+            assert(width_ > 0 && height_ > 0);
+
+            // Уровни до размера 1x1 (по большей стороне)
+            for(GLsizei size = std::max(width_, height_); size > 1; size /= 2) levels_++;
+
+            glCreateTextures(GL_TEXTURE_2D, 1, &texture_id_);
+            glTextureStorage2D(texture_id_, levels_, GL_R32F, width_, height_);
+            glTextureParameteri(texture_id_, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+            glTextureParameteri(texture_id_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTextureParameteri(texture_id_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(texture_id_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        DepthPyramid(const DepthPyramid& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        DepthPyramid(DepthPyramid&& other) noexcept
+            : Resource(std::move(other))
+            , texture_id_(other.texture_id_)
+            , width_(other.width_)
+            , height_(other.height_)
+            , levels_(other.levels_)
+        {
+            other.texture_id_ = 0;
+            other.width_ = 0;
+            other.height_ = 0;
+            other.levels_ = 0;
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~DepthPyramid() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        DepthPyramid& operator=(const DepthPyramid& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        DepthPyramid& operator=(DepthPyramid&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(texture_id_, other.texture_id_);
+            std::swap(width_, other.width_);
+            std::swap(height_, other.height_);
+            std::swap(levels_, other.levels_);
+
+            return *this;
+        }
+
+        /**
+         * Построить пирамиду из буфера глубины
+         * Программа копирования читает глубину через sampler (текстурный блок 0) и пишет уровень 0 через image (блок 0),
+         * программа уменьшения читает предыдущий уровень через image (блок 0) и пишет следующий (блок 1).
+         * Обе программы вычислительные, с рабочей группой GROUP_SIZE x GROUP_SIZE
+         * @param depth_texture_id Текстура глубины (размер совпадает с размером уровня 0)
+         * @param copy_program_id Программа копирования глубины
+         * @param reduce_program_id Программа построения следующего уровня
+         */
+        void build(GLuint depth_texture_id, GLuint copy_program_id, GLuint reduce_program_id) const
+        {
+            assert(loaded_);
+
+            // Уровень 0 - копия глубины (форматы глубины недоступны для image-операций)
+            glUseProgram(copy_program_id);
+            glBindTextureUnit(0, depth_texture_id);
+            glBindImageTexture(0, texture_id_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            glDispatchCompute(group_count(width_), group_count(height_), 1);
+
+            // Каждый следующий уровень - максимум по области предыдущего
+            glUseProgram(reduce_program_id);
+            for(GLint level = 1; level < levels_; level++)
+            {
+                glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+                glBindImageTexture(0, texture_id_, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+                glBindImageTexture(1, texture_id_, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+                glDispatchCompute(group_count(level_width(level)), group_count(level_height(level)), 1);
+            }
+
+            // Результат будет читаться выборкой из текстуры
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+            glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindTextureUnit(0, 0);
+            glUseProgram(0);
+        }
+
+        /**
+         * Получить OpenGL дескриптор текстуры
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint texture_id() const
+        {
+            return texture_id_;
+        }
+
+        /**
+         * Получить ширину уровня 0
+         * @return Ширина
+         */
+        [[nodiscard]] GLsizei width() const
+        {
+            return width_;
+        }
+
+        /**
+         * Получить высоту уровня 0
+         * @return Высота
+         */
+        [[nodiscard]] GLsizei height() const
+        {
+            return height_;
+        }
+
+        /**
+         * Получить кол-во уровней
+         * @return Кол-во
+         */
+        [[nodiscard]] GLint levels() const
+        {
+            return levels_;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            if(texture_id_) glDeleteTextures(1, &texture_id_);
+
+            texture_id_ = 0;
+            width_ = 0;
+            height_ = 0;
+            levels_ = 0;
+            loaded_ = false;
+        }
+
+    private:
+        /**
+         * Ширина уровня (правило OpenGL для mip-уровней)
+         * @param level Уровень
+         * @return Ширина
+         */
+        [[nodiscard]] GLsizei level_width(GLint level) const
+        {
+            return std::max(width_ >> level, 1);
+        }
+
+        /**
+         * Высота уровня (правило OpenGL для mip-уровней)
+         * @param level Уровень
+         * @return Высота
+         */
+        [[nodiscard]] GLsizei level_height(GLint level) const
+        {
+            return std::max(height_ >> level, 1);
+        }
+
+        /**
+         * Кол-во рабочих групп для покрытия размера
+         * @param size Размер (текселей)
+         * @return Кол-во групп
+         */
+        static GLuint group_count(GLsizei size)
+        {
+            return (static_cast<GLuint>(size) + GROUP_SIZE - 1) / GROUP_SIZE;
+        }
+
+        GLuint texture_id_;     // OpenGL дескриптор текстуры пирамиды
+        GLsizei width_;         // Ширина уровня 0
+        GLsizei height_;        // Высота уровня 0
+        GLint levels_;          // Кол-во уровней
+    };
+}
\ No newline at end of file
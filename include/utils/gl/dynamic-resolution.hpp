@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace utils::gl
+{
+    /**
+     * Настройки регулятора динамического разрешения
+     */
+    struct DynamicResolutionSettings
+    {
+        // Целевое время кадра на GPU (мс)
+        float target_ms = 8.0f;
+        // Пределы масштаба (доля от размера итогового буфера по каждой оси)
+        float min_scale = 0.25f;
+        float max_scale = 1.0f;
+        // Вес нового замера в сглаженном времени (экспоненциальное среднее, 1 - без сглаживания)
+        float smoothing = 0.15f;
+        // Зона нечувствительности (доля от целевого времени, в пределах которой масштаб не меняется)
+        float hysteresis = 0.1f;
+        // Наибольшее изменение масштаба за одну коррекцию
+        float max_step = 0.1f;
+        // Кол-во замеров, пропускаемых после коррекции (замеры запаздывают на несколько кадров)
+        unsigned cooldown = 4;
+    };
+
+    /**
+     * Регулятор динамического разрешения
+     * По замерам времени GPU подбирает масштаб разрешения, удерживающий целевое время кадра.
+     * Время считается пропорциональным кол-ву пикселей (квадрату масштаба), поэтому желаемый масштаб -
+     * текущий, умноженный на sqrt(цель / время). Замеры сглаживаются, мелкие отклонения (в зоне нечувствительности)
+     * игнорируются, после коррекции несколько замеров пропускаются - это исключает колебания масштаба
+     */
+    class DynamicResolution
+    {
+    public:
+        /**
+         * Конструктор
+         * @param settings Настройки
+         */
+        explicit DynamicResolution(const DynamicResolutionSettings& settings = {})
+            : settings_(settings)
+            , scale_(settings.max_scale)
+            , smoothed_ms_(-1.0f)
+            , cooldown_(0)
+        {}
+
+        /**
+         * Учесть замер и скорректировать масштаб
+         * @param gpu_ms Время кадра на GPU (мс)
+         * @return Масштаб
+         */
+        float update(float gpu_ms)
+        {
+            assert(settings_.target_ms > 0.0f);
+            assert(settings_.min_scale > 0.0f && settings_.min_scale <= settings_.max_scale);
+
+            smoothed_ms_ = smoothed_ms_ < 0.0f ? gpu_ms : smoothed_ms_ + (gpu_ms - smoothed_ms_) * settings_.smoothing;
+
+            if(cooldown_ > 0)
+            {
+                cooldown_--;
+                return scale_;
+            }
+
+            const float ratio = smoothed_ms_ / settings_.target_ms;
+            if(ratio <= 1.0f + settings_.hysteresis && ratio >= 1.0f - settings_.hysteresis) return scale_;
+
+            float desired = scale_ * std::sqrt(1.0f / std::max(ratio, 0.01f));
+            desired = std::clamp(desired, scale_ - settings_.max_step, scale_ + settings_.max_step);
+            desired = std::clamp(desired, settings_.min_scale, settings_.max_scale);
+            if(std::abs(desired - scale_) < 0.001f) return scale_;
+
+            // Сглаженное время приводится к ожидаемому при новом масштабе (иначе старые замеры тянут регулятор назад)
+            smoothed_ms_ *= (desired * desired) / (scale_ * scale_);
+            scale_ = desired;
+            cooldown_ = settings_.cooldown;
+            return scale_;
+        }
+
+        /**
+         * Сбросить состояние
+         * @param scale Начальный масштаб
+         */
+        void reset(float scale)
+        {
+            scale_ = std::clamp(scale, settings_.min_scale, settings_.max_scale);
+            smoothed_ms_ = -1.0f;
+            cooldown_ = 0;
+        }
+
+        /**
+         * Текущий масштаб
+         * @return Масштаб
+         */
+        [[nodiscard]] float scale() const
+        {
+            return scale_;
+        }
+
+        /**
+         * Сглаженное время кадра на GPU
+         * @return Время (мс), отрицательное до первого замера
+         */
+        [[nodiscard]] float smoothed_ms() const
+        {
+            return smoothed_ms_;
+        }
+
+        /**
+         * Настройки (допустимо менять между вызовами update)
+         * @return Ссылка на настройки
+         */
+        DynamicResolutionSettings& settings()
+        {
+            return settings_;
+        }
+
+    private:
+        // Настройки
+        DynamicResolutionSettings settings_;
+        // Текущий масштаб
+        float scale_;
+        // Сглаженное время (мс)
+        float smoothed_ms_;
+        // Оставшееся кол-во пропускаемых замеров
+        unsigned cooldown_;
+    };
+}
\ No newline at end of file
@@ -5,12 +5,14 @@
 #include <vector>
 
 #include "resource.hpp"
+#include "texture-format.hpp"
 
 namespace utils::gl
 {
     /**
-     * Информация о цветовом вложении кадрового буфера
-     * Для каждого вложения будет создана текстура
+     * Информация о текстурном вложении кадрового буфера
+     * Для каждого вложения будет создана текстура (в т.ч. для глубины - GL_DEPTH_COMPONENT32F и GL_DEPTH_ATTACHMENT,
+     * если глубина нужна для выборки в шейдере)
      */
     struct FrameBufferAttachmentInfo
     {
@@ -71,13 +73,13 @@ namespace utils::gl
             , width_(width)
             , height_(height)
         {
-            // Добавление текстурных вложений
+            // Добавление текстурных вложений (тип данных определяется внутренним форматом)
             for(const auto& info: tx_att_infos)
             {
                 GLuint id;
                 glGenTextures(1, &id);
                 glBindTexture(GL_TEXTURE_2D, id);
-                glTexImage2D(GL_TEXTURE_2D, 0, info.internal_format, width_, height_, 0, info.format, GL_FLOAT, nullptr);
+                glTexImage2D(GL_TEXTURE_2D, 0, info.internal_format, width_, height_, 0, info.format, texture_upload_type(info.internal_format), nullptr);
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, info.filtering);
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, info.filtering);
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -123,11 +125,13 @@ namespace utils::gl
                 glFramebufferRenderbuffer(GL_FRAMEBUFFER, bindings_rb_[i], GL_RENDERBUFFER, attachments_rb_[i]);
             }
 
-            // Указать доступные для записи в текущем проходе вложения (по умолчанию - все текстурные вложения)
-            if(!bindings_tx_.empty())
+            // Указать доступные для записи в текущем проходе вложения (по умолчанию - все цветовые текстурные вложения)
+            std::vector<GLenum> draw_buffers;
+            for(const auto& binding : bindings_tx_)
             {
-                glDrawBuffers((GLsizei)bindings_tx_.size(), bindings_tx_.data());
+                if(binding >= GL_COLOR_ATTACHMENT0 && binding <= GL_COLOR_ATTACHMENT31) draw_buffers.push_back(binding);
             }
+            glDrawBuffers((GLsizei)draw_buffers.size(), draw_buffers.data());
 
             // Завершение работы с кадровым буфером
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -217,6 +221,20 @@ namespace utils::gl
             return attachments_tx_;
         }
 
+        /**
+         * Получить OpenGL дескриптор текстурного вложения по его привязке
+         * @param binding Привязка (GL_COLOR_ATTACHMENT0, GL_DEPTH_ATTACHMENT и т.д.)
+         * @return Дескриптор (0 если вложения с такой привязкой нет)
+         */
+        [[nodiscard]] GLuint attachment_tx(GLuint binding) const
+        {
+            for(size_t i = 0; i < bindings_tx_.size(); i++)
+            {
+                if(bindings_tx_[i] == binding) return attachments_tx_[i];
+            }
+            return 0;
+        }
+
         /**
          * Получить список OpenGL дескрипторов вложений рендер-буфера
          * @return Константная ссылка на список
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+
+#include "resource.hpp"
+#include "vertex-format.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Команда непрямого рисования (формат определен OpenGL, см. glMultiDrawElementsIndirect)
+     */
+    struct DrawElementsIndirectCommand
+    {
+        // Кол-во индексов
+        GLuint count = 0;
+        // Кол-во экземпляров
+        GLuint instance_count = 0;
+        // Первый индекс в общем индексном буфере
+        GLuint first_index = 0;
+        // Смещение добавляемое к индексам (первая вершина меша в общем вершинном буфере)
+        GLint base_vertex = 0;
+        // Первый экземпляр (смещение для атрибутов экземпляра)
+        GLuint base_instance = 0;
+    };
+
+    /**
+     * Расположение меша в общих буферах пула
+     */
+    struct MeshRange
+    {
+        // Первый индекс в общем индексном буфере
+        GLuint first_index = 0;
+        // Кол-во индексов
+        GLuint index_count = 0;
+        // Первая вершина в общем вершинном буфере
+        GLint base_vertex = 0;
+        // Кол-во вершин
+        GLuint vertex_count = 0;
+    };
+
+    /**
+     * Пул геометрии
+     * Множество мешей с одинаковым форматом вершин размещается в общих (больших) буферах вершин и индексов.
+     * Вызовы рисования записываются в буфер команд и отправляются одним вызовом glMultiDrawElementsIndirect,
+     * таким образом для рисования всех мешей пула достаточно одной привязки VAO
+     * @tparam V Структура вершины
+     */
+    template <class V>
+    class GeometryPool final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        GeometryPool()
+            : Resource()
+            , vbo_id_(0)
+            , ebo_id_(0)
+            , indirect_id_(0)
+            , instance_vbo_id_(0)
+            , max_vertices_(0)
+            , max_indices_(0)
+            , max_draws_(0)
+            , vertex_count_(0)
+            , index_count_(0)
+            , instance_count_(0)
+        {}
+
+        /**
+         * Основной конструктор (создает OpenGL ресурсы)
+         * @param max_vertices Емкость вершинного буфера (кол-во вершин)
+         * @param max_indices Емкость индексного буфера (кол-во индексов)
+         * @param max_draws Емкость буфера команд (кол-во команд рисования за одну отправку)
+         * @param attributes Список описаний атрибутов вершины для шейдера
+         */
+        GeometryPool(GLsizei max_vertices, GLsizei max_indices, GLsizei max_draws, const std::vector<VertexAttributeInfo>& attributes)
+            : Resource()
+            , vbo_id_(0)
+            , ebo_id_(0)
+            , indirect_id_(0)
+            , instance_vbo_id_(0)
+            , max_vertices_(max_vertices)
+            , max_indices_(max_indices)
+            , max_draws_(max_draws)
+            , vertex_count_(0)
+            , index_count_(0)
+            , instance_count_(0)
+        {
+            // Убелиться в корректности данных
+            assert(max_vertices_ > 0);
+            assert(max_indices_ > 0);
+            assert(max_draws_ > 0);
+
+            // Неизменяемые хранилища общих буферов (данные мешей добавляются позже через glNamedBufferSubData)
+            glCreateBuffers(1, &vbo_id_);
+            glNamedBufferStorage(vbo_id_, static_cast<GLsizeiptr>(sizeof(V) * max_vertices_), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+            glCreateBuffers(1, &ebo_id_);
+            glNamedBufferStorage(ebo_id_, static_cast<GLsizeiptr>(sizeof(GLuint) * max_indices_), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+            // Буфер команд (перезаписывается при каждой отправке)
+            glCreateBuffers(1, &indirect_id_);
+            glNamedBufferStorage(indirect_id_, static_cast<GLsizeiptr>(sizeof(DrawElementsIndirectCommand) * max_draws_), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+            // Формат вершин, общие буферы подключаются к нему единожды
+            format_ = VertexFormat(attributes, static_cast<GLsizei>(sizeof(V)));
+            format_.set_vertex_buffer(vbo_id_);
+            format_.set_index_buffer(ebo_id_);
+
+            commands_.reserve(max_draws_);
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        GeometryPool(const GeometryPool& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        GeometryPool(GeometryPool&& other) noexcept
+            : GeometryPool()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~GeometryPool() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        GeometryPool& operator=(const GeometryPool& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        GeometryPool& operator=(GeometryPool&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(vbo_id_, other.vbo_id_);
+            std::swap(ebo_id_, other.ebo_id_);
+            std::swap(format_, other.format_);
+            std::swap(indirect_id_, other.indirect_id_);
+            std::swap(instance_vbo_id_, other.instance_vbo_id_);
+            std::swap(max_vertices_, other.max_vertices_);
+            std::swap(max_indices_, other.max_indices_);
+            std::swap(max_draws_, other.max_draws_);
+            std::swap(vertex_count_, other.vertex_count_);
+            std::swap(index_count_, other.index_count_);
+            std::swap(instance_count_, other.instance_count_);
+            std::swap(commands_, other.commands_);
+
+            return *this;
+        }
+
+        /**
+         * Добавить меш в пул (данные копируются в свободную часть общих буферов)
+         * @param vertices Массив вершин
+         * @param indices Массив индексов (относительно первой вершины меша)
+         * @return Расположение меша в пуле
+         */
+        MeshRange add(const std::vector<V>& vertices, const std::vector<GLuint>& indices)
+        {
+            assert(loaded_);
+            assert(!vertices.empty() && !indices.empty());
+
+            if(vertex_count_ + static_cast<GLsizei>(vertices.size()) > max_vertices_ ||
+               index_count_ + static_cast<GLsizei>(indices.size()) > max_indices_)
+            {
+                throw std::runtime_error("[GL] geometry pool is out of memory");
+            }
+
+            MeshRange range;
+            range.first_index = static_cast<GLuint>(index_count_);
+            range.index_count = static_cast<GLuint>(indices.size());
+            range.base_vertex = static_cast<GLint>(vertex_count_);
+            range.vertex_count = static_cast<GLuint>(vertices.size());
+
+            glNamedBufferSubData(vbo_id_,
+                                 static_cast<GLintptr>(sizeof(V) * vertex_count_),
+                                 static_cast<GLsizeiptr>(sizeof(V) * vertices.size()),
+                                 vertices.data());
+
+            glNamedBufferSubData(ebo_id_,
+                                 static_cast<GLintptr>(sizeof(GLuint) * index_count_),
+                                 static_cast<GLsizeiptr>(sizeof(GLuint) * indices.size()),
+                                 indices.data());
+
+            vertex_count_ += static_cast<GLsizei>(vertices.size());
+            index_count_ += static_cast<GLsizei>(indices.size());
+
+            return range;
+        }
+
+        /**
+         * Задать буфер данных экземпляров
+         * Команда рисования выбирает свои данные через base_instance (атрибуты с делителем больше нуля)
+         * @tparam I Структура данных экземпляра
+         * @param instances Массив данных экземпляров
+         * @param attributes Список описаний атрибутов экземпляра для шейдера
+         * @param flags Флаги хранилища буфера
+         */
+        template <class I>
+        void set_instances(const std::vector<I>& instances, const std::vector<VertexAttributeInfo>& attributes, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT)
+        {
+            assert(loaded_);
+
+            if(instance_vbo_id_ == 0) format_.set_instance_attributes(attributes, static_cast<GLsizei>(sizeof(I)));
+            else glDeleteBuffers(1, &instance_vbo_id_);
+
+            instance_count_ = static_cast<GLsizei>(instances.size());
+
+            glCreateBuffers(1, &instance_vbo_id_);
+            glNamedBufferStorage(instance_vbo_id_, static_cast<GLsizeiptr>(sizeof(I) * instances.size()), instances.data(), flags);
+            format_.set_instance_buffer(instance_vbo_id_);
+        }
+
+        /**
+         * Очистить список записанных команд
+         */
+        void clear_draws()
+        {
+            commands_.clear();
+        }
+
+        /**
+         * Записать команду рисования меша
+         * @param mesh Расположение меша в пуле
+         * @param instance_count Кол-во экземпляров
+         * @param base_instance Первый экземпляр в буфере экземпляров
+         * @throws std::runtime_error Буфер команд заполнен (кол-во команд достигло max_draws)
+         */
+        void draw(const MeshRange& mesh, GLuint instance_count = 1, GLuint base_instance = 0)
+        {
+            if(commands_.size() >= static_cast<size_t>(max_draws_))
+            {
+                throw std::runtime_error("[GL] geometry pool draw command buffer is full");
+            }
+            commands_.push_back({mesh.index_count, instance_count, mesh.first_index, mesh.base_vertex, base_instance});
+        }
+
+        /**
+         * Отправить записанные команды одним вызовом рисования
+         * VAO пула привязывается единожды на все команды
+         * @param mode Тип примитивов
+         */
+        void submit(GLenum mode = GL_TRIANGLES) const
+        {
+            if(commands_.empty()) return;
+
+            glNamedBufferSubData(indirect_id_, 0,
+                                 static_cast<GLsizeiptr>(sizeof(DrawElementsIndirectCommand) * commands_.size()),
+                                 commands_.data());
+
+            glBindVertexArray(format_.id());
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_id_);
+            glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands_.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        /**
+         * Получить записанные команды
+         * @return Константная ссылка на список команд
+         */
+        [[nodiscard]] const std::vector<DrawElementsIndirectCommand>& commands() const
+        {
+            return commands_;
+        }
+
+        /**
+         * Получить OpenGL дескриптор vertex array object
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint vao_id() const
+        {
+            return format_.id();
+        }
+
+        /**
+         * Получить OpenGL дескриптор буфера команд
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint indirect_id() const
+        {
+            return indirect_id_;
+        }
+
+        /**
+         * Получить кол-во занятых вершин
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei vertex_count() const
+        {
+            return vertex_count_;
+        }
+
+        /**
+         * Получить кол-во занятых индексов
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei index_count() const
+        {
+            return index_count_;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            if (vbo_id_) glDeleteBuffers(1, &vbo_id_);
+            if (ebo_id_) glDeleteBuffers(1, &ebo_id_);
+            if (indirect_id_) glDeleteBuffers(1, &indirect_id_);
+            if (instance_vbo_id_) glDeleteBuffers(1, &instance_vbo_id_);
+            format_.unload();
+
+            vbo_id_ = 0;
+            ebo_id_ = 0;
+            indirect_id_ = 0;
+            instance_vbo_id_ = 0;
+            max_vertices_ = 0;
+            max_indices_ = 0;
+            max_draws_ = 0;
+            vertex_count_ = 0;
+            index_count_ = 0;
+            instance_count_ = 0;
+            commands_.clear();
+
+            loaded_ = false;
+        }
+
+    private:
+        GLuint vbo_id_;             // OpenGL дескриптор общего вершинного буфера
+        GLuint ebo_id_;             // OpenGL дескриптор общего индексного буфера
+        VertexFormat format_;       // Формат вершин (VAO)
+        GLuint indirect_id_;        // OpenGL дескриптор буфера команд
+        GLuint instance_vbo_id_;    // OpenGL дескриптор буфера экземпляров
+        GLsizei max_vertices_;      // Емкость вершинного буфера
+        GLsizei max_indices_;       // Емкость индексного буфера
+        GLsizei max_draws_;         // Емкость буфера команд
+        GLsizei vertex_count_;      // Кол-во занятых вершин
+        GLsizei index_count_;       // Кол-во занятых индексов
+        GLsizei instance_count_;    // Кол-во экземпляров
+
+        std::vector<DrawElementsIndirectCommand> commands_;     // Записанные команды рисования
+    };
+}
\ No newline at end of file
@@ -1,29 +1,14 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <vector>
+#include <cassert>
 
 #include "resource.hpp"
+#include "vertex-format.hpp"
 
 namespace utils::gl
 {
-
-    /**
-     * Описание атрибута вершины для шейдера
-     */
-    struct VertexAttributeInfo
-    {
-        // Номер положения (location у шейдера)
-        GLuint location = 0;
-        // Кол-во компонентов (например, для vec3 будет 3 компонента)
-        GLint component_count = 0;
-        // Тип компонентов (float, int, прочие)
-        GLenum component_type = GL_FLOAT;
-        // Автоматически нормализовать перед подачей в шейдер
-        GLboolean normalize = GL_FALSE;
-        // Сдвиг для атрибута в одной структуре вершины
-        GLsizeiptr offset = 0;
-    };
-
     /**
      * Обертка над буфером геометрии (вершины, индексы)
      * @tparam V Структура вершины
@@ -40,9 +25,14 @@ namespace utils::gl
             : Resource()
             , vbo_id_(0)
             , ebo_id_(0)
-            , vao_id_(0)
             , vertex_count_(0)
             , index_count_(0)
+            , index_type_(GL_UNSIGNED_INT)
+            , instance_vbo_id_(0)
+            , instance_count_(0)
+            , instance_capacity_(0)
+            , instance_flags_(0)
+            , instance_stride_(0)
         {}
 
         /**
@@ -52,12 +42,31 @@ namespace utils::gl
          * @param attributes Список описаний атрибутов вершины для шейдера
          */
         Geometry(const std::vector<V>& vertices, const std::vector<GLuint>& indices, const std::vector<VertexAttributeInfo>& attributes)
+            : Geometry(vertices, indices)
+        {
+            // Собственный формат вершин, буферы геометрии подключаются к нему единожды
+            format_ = VertexFormat(attributes, static_cast<GLsizei>(sizeof(V)));
+            attach(format_);
+        }
+
+        /**
+         * Конструктор без формата вершин (создает только буферы)
+         * Для рисования буферы подключаются к общему формату вершин (см. attach)
+         * @param vertices Массив вершин
+         * @param indices Массив индексов
+         */
+        Geometry(const std::vector<V>& vertices, const std::vector<GLuint>& indices)
             : Resource()
             , vbo_id_(0)
             , ebo_id_(0)
-            , vao_id_(0)
             , vertex_count_(0)
             , index_count_(0)
+            , index_type_(GL_UNSIGNED_INT)
+            , instance_vbo_id_(0)
+            , instance_count_(0)
+            , instance_capacity_(0)
+            , instance_flags_(0)
+            , instance_stride_(0)
         {
             // Информация для дальнейшего использования (например, при рисовании)
             vertex_count_ = static_cast<GLsizei>(vertices.size());
@@ -67,30 +76,73 @@ namespace utils::gl
             assert(vertex_count_ > 0);
             assert(index_count_ > 0);
 
-            // Генерация необходимых ресурсов OpenGL (vertex buffer, element buffer, vertex array object)
-            glGenBuffers(1, &vbo_id_);
-            glGenBuffers(1, &ebo_id_);
-            glGenVertexArrays(1, &vao_id_);
+            // Неизменяемые буферы вершин и индексов (данные задаются при создании, привязка к контексту не нужна)
+            glCreateBuffers(1, &vbo_id_);
+            glNamedBufferStorage(vbo_id_, static_cast<GLsizeiptr>(sizeof(V) * vertex_count_), vertices.data(), 0);
 
-            // Работа с VAO
-            glBindVertexArray(vao_id_);
+            // Если все индексы помещаются в 16 бит, индексный буфер занимает вдвое меньше памяти
+            glCreateBuffers(1, &ebo_id_);
+            if(vertex_count_ < 65536)
+            {
+                const std::vector<GLushort> short_indices(indices.begin(), indices.end());
+                glNamedBufferStorage(ebo_id_, static_cast<GLsizeiptr>(sizeof(GLushort) * index_count_), short_indices.data(), 0);
+                index_type_ = GL_UNSIGNED_SHORT;
+            }
+            else
+            {
+                glNamedBufferStorage(ebo_id_, static_cast<GLsizeiptr>(sizeof(GLuint) * index_count_), indices.data(), 0);
+                index_type_ = GL_UNSIGNED_INT;
+            }
 
-            // Привязка буфера вершин
-            glBindBuffer(GL_ARRAY_BUFFER, vbo_id_);
-            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(V) * vertex_count_), vertices.data(), GL_STATIC_DRAW);
+            // Готово к использованию
+            loaded_ = true;
+        }
 
-            // Привязка буфера индексов
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_id_);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * index_count_), indices.data(), GL_STATIC_DRAW);
+        /**
+         * Конструктор из готовых блоков данных (создает OpenGL ресурсы)
+         * Данные передаются в буферы как есть, без преобразования (например, прямо из отображенного в память файла)
+         * @param vertex_data Вершины (vertex_count структур V)
+         * @param vertex_count Кол-во вершин
+         * @param index_data Индексы (index_count значений типа index_type)
+         * @param index_count Кол-во индексов
+         * @param index_type Тип индексов (GL_UNSIGNED_SHORT или GL_UNSIGNED_INT)
+         * @param attributes Список описаний атрибутов вершины для шейдера
+         */
+        Geometry(const void* vertex_data,
+                 GLsizei vertex_count,
+                 const void* index_data,
+                 GLsizei index_count,
+                 GLenum index_type,
+                 const std::vector<VertexAttributeInfo>& attributes)
+            : Resource()
+            , vbo_id_(0)
+            , ebo_id_(0)
+            , vertex_count_(vertex_count)
+            , index_count_(index_count)
+            , index_type_(index_type)
+            , instance_vbo_id_(0)
+            , instance_count_(0)
+            , instance_capacity_(0)
+            , instance_flags_(0)
+            , instance_stride_(0)
+        {
+            // Убелиться в корректности данных
+            assert(vertex_count_ > 0);
+            assert(index_count_ > 0);
+            assert(index_type_ == GL_UNSIGNED_SHORT || index_type_ == GL_UNSIGNED_INT);
 
-            // Пояснения шейдеру как понимать данные из активного VBO (буфера вершин) в контексте активного VAO
-            setup_vertex_attributes(attributes);
+            // Неизменяемые буферы (данные уже в итоговом формате, копируются драйвером напрямую)
+            glCreateBuffers(1, &vbo_id_);
+            glNamedBufferStorage(vbo_id_, static_cast<GLsizeiptr>(sizeof(V) * vertex_count_), vertex_data, 0);
 
-            // Завершение работы с VAO
-            glBindVertexArray(0);
+            glCreateBuffers(1, &ebo_id_);
+            glNamedBufferStorage(ebo_id_, static_cast<GLsizeiptr>(index_size() * index_count_), index_data, 0);
 
-            // Готово к использованию
             loaded_ = true;
+
+            // Собственный формат вершин
+            format_ = VertexFormat(attributes, static_cast<GLsizei>(sizeof(V)));
+            attach(format_);
         }
 
         /**
@@ -107,16 +159,27 @@ namespace utils::gl
             : Resource(std::move(other))
             , vbo_id_(other.vbo_id_)
             , ebo_id_(other.ebo_id_)
-            , vao_id_(other.vao_id_)
+            , format_(std::move(other.format_))
             , vertex_count_(other.vertex_count_)
             , index_count_(other.index_count_)
+            , index_type_(other.index_type_)
+            , instance_vbo_id_(other.instance_vbo_id_)
+            , instance_count_(other.instance_count_)
+            , instance_capacity_(other.instance_capacity_)
+            , instance_flags_(other.instance_flags_)
+            , instance_stride_(other.instance_stride_)
         {
 
-            other.vao_id_ = 0;
+            other.vbo_id_ = 0;
             other.ebo_id_ = 0;
-            other.vao_id_ = 0;
             other.vertex_count_ = 0;
             other.index_count_ = 0;
+            other.index_type_ = GL_UNSIGNED_INT;
+            other.instance_vbo_id_ = 0;
+            other.instance_count_ = 0;
+            other.instance_capacity_ = 0;
+            other.instance_flags_ = 0;
+            other.instance_stride_ = 0;
         }
 
         /**
@@ -148,13 +211,109 @@ namespace utils::gl
             std::swap(loaded_, other.loaded_);
             std::swap(vbo_id_, other.vbo_id_);
             std::swap(ebo_id_, other.ebo_id_);
-            std::swap(vao_id_, other.vao_id_);
+            std::swap(format_, other.format_);
             std::swap(vertex_count_, other.vertex_count_);
             std::swap(index_count_, other.index_count_);
+            std::swap(index_type_, other.index_type_);
+            std::swap(instance_vbo_id_, other.instance_vbo_id_);
+            std::swap(instance_count_, other.instance_count_);
+            std::swap(instance_capacity_, other.instance_capacity_);
+            std::swap(instance_flags_, other.instance_flags_);
+            std::swap(instance_stride_, other.instance_stride_);
 
             return *this;
         }
 
+        /**
+         * Подключить буферы геометрии к формату вершин
+         * Позволяет использовать один формат (VAO) для всех мешей с одинаковой раскладкой вершин
+         * @param format Формат вершин
+         */
+        void attach(const VertexFormat& format) const
+        {
+            assert(loaded_);
+            assert(format.vertex_stride() == static_cast<GLsizei>(sizeof(V)));
+
+            format.set_vertex_buffer(vbo_id_);
+            format.set_index_buffer(ebo_id_);
+        }
+
+        /**
+         * Задать буфер данных экземпляров (для instanced рисования)
+         * Атрибуты экземпляра описываются единожды при первом вызове, с делителем (divisor) больше нуля.
+         * Хранилище буфера пересоздается только если данные не помещаются в текущее.
+         * Пустой массив только обнуляет кол-во экземпляров (хранилище нулевого размера создать нельзя)
+         * @tparam I Структура данных экземпляра
+         * @param instances Массив данных экземпляров
+         * @param attributes Список описаний атрибутов экземпляра для шейдера
+         * @param flags Флаги хранилища (GL_DYNAMIC_STORAGE_BIT - для обновления через update_instances)
+         */
+        template <class I>
+        void set_instances(const std::vector<I>& instances, const std::vector<VertexAttributeInfo>& attributes, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT)
+        {
+            assert(loaded_);
+            assert(format_.ready());
+            assert(instance_vbo_id_ == 0 || instance_stride_ == static_cast<GLsizei>(sizeof(I)));
+
+            if(instances.empty())
+            {
+                instance_count_ = 0;
+                return;
+            }
+
+            const bool first = instance_stride_ == 0;
+            instance_count_ = static_cast<GLsizei>(instances.size());
+            instance_stride_ = static_cast<GLsizei>(sizeof(I));
+
+            if(first) format_.set_instance_attributes(attributes, instance_stride_);
+
+            // Данные помещаются в существующее хранилище
+            if(instance_vbo_id_ && instance_count_ <= instance_capacity_ && flags == instance_flags_ && (flags & GL_DYNAMIC_STORAGE_BIT))
+            {
+                update_instances(instances);
+                return;
+            }
+
+            // Новое неизменяемое хранилище
+            if(instance_vbo_id_) glDeleteBuffers(1, &instance_vbo_id_);
+            glCreateBuffers(1, &instance_vbo_id_);
+            glNamedBufferStorage(instance_vbo_id_, static_cast<GLsizeiptr>(sizeof(I) * instances.size()), instances.data(), flags);
+            instance_capacity_ = instance_count_;
+            instance_flags_ = flags;
+
+            format_.set_instance_buffer(instance_vbo_id_);
+        }
+
+        /**
+         * Обновить данные экземпляров (кол-во не должно превышать заданного в set_instances)
+         * @tparam I Структура данных экземпляра
+         * @param instances Массив данных экземпляров
+         * @param first Индекс первого обновляемого экземпляра
+         */
+        template <class I>
+        void update_instances(const std::vector<I>& instances, GLsizei first = 0)
+        {
+            assert(instance_vbo_id_ != 0);
+            assert(instance_stride_ == static_cast<GLsizei>(sizeof(I)));
+            assert(first + static_cast<GLsizei>(instances.size()) <= instance_count_);
+
+            glNamedBufferSubData(instance_vbo_id_,
+                                 static_cast<GLintptr>(sizeof(I) * first),
+                                 static_cast<GLsizeiptr>(sizeof(I) * instances.size()),
+                                 instances.data());
+        }
+
+        /**
+         * Нарисовать несколько экземпляров геометрии одним вызовом
+         * VAO геометрии должен быть привязан
+         * @param count Кол-во экземпляров (по умолчанию - все заданные в буфере экземпляров)
+         * @param mode Тип примитивов
+         */
+        void draw_instanced(GLsizei count = -1, GLenum mode = GL_TRIANGLES) const
+        {
+            glDrawElementsInstanced(mode, index_count_, index_type_, nullptr, count < 0 ? instance_count_ : count);
+        }
+
         /**
          * Получить OpenGL дескриптор vertex buffer object
          * @return Дескриптор ресурса
@@ -179,7 +338,16 @@ namespace utils::gl
          */
         [[nodiscard]] GLuint vao_id() const
         {
-            return vao_id_;
+            return format_.id();
+        }
+
+        /**
+         * Получить собственный формат вершин (пуст, если геометрия создана без описания атрибутов)
+         * @return Константная ссылка на формат
+         */
+        [[nodiscard]] const VertexFormat& format() const
+        {
+            return format_;
         }
 
         /**
@@ -200,6 +368,42 @@ namespace utils::gl
             return index_count_;
         }
 
+        /**
+         * Получить тип индексов (GL_UNSIGNED_SHORT если кол-во вершин меньше 65536, иначе GL_UNSIGNED_INT)
+         * @return Тип для glDrawElements
+         */
+        [[nodiscard]] GLenum index_type() const
+        {
+            return index_type_;
+        }
+
+        /**
+         * Получить размер одного индекса (для смещения начала участка индексного буфера в glDrawElements)
+         * @return Размер в байтах
+         */
+        [[nodiscard]] size_t index_size() const
+        {
+            return index_type_ == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        }
+
+        /**
+         * Получить OpenGL дескриптор буфера экземпляров
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint instance_vbo_id() const
+        {
+            return instance_vbo_id_;
+        }
+
+        /**
+         * Получить кол-во экземпляров в буфере экземпляров
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei instance_count() const
+        {
+            return instance_count_;
+        }
+
         /**
          * Выгрузка ресурса
          */
@@ -207,48 +411,34 @@ namespace utils::gl
         {
             if (vbo_id_) glDeleteBuffers(1, &vbo_id_);
             if (ebo_id_) glDeleteBuffers(1, &ebo_id_);
-            if (vao_id_) glDeleteVertexArrays(1, &vao_id_);
+            if (instance_vbo_id_) glDeleteBuffers(1, &instance_vbo_id_);
+            format_.unload();
 
             vbo_id_ = 0;
             ebo_id_ = 0;
-            vao_id_ = 0;
             vertex_count_ = 0;
             index_count_ = 0;
+            index_type_ = GL_UNSIGNED_INT;
+            instance_vbo_id_ = 0;
+            instance_count_ = 0;
+            instance_capacity_ = 0;
+            instance_flags_ = 0;
+            instance_stride_ = 0;
 
             loaded_ = false;
         }
 
-    protected:
-        /**
-         * Пояснить как соотносить данные вершины и атрибуты в шейдере
-         * @param attributes Массив с информацией об атрибутах вершины
-         */
-        void setup_vertex_attributes(const std::vector<VertexAttributeInfo>& attributes) const
-        {
-            for(const auto&[
-                    location
-                    , component_count
-                    , component_type
-                    , normalize
-                    , offset] : attributes)
-            {
-                glVertexAttribPointer(location
-                    , component_count
-                    , component_type
-                    , normalize
-                    , sizeof(V)
-                    , reinterpret_cast<const void*>(offset)
-                    );
-
-                glEnableVertexArrayAttrib(vao_id_, location);
-            }
-        }
-
     private:
         GLuint vbo_id_;             // OpenGL дескриптор вершинного буфера
         GLuint ebo_id_;             // OpenGL дескриптор индексного буфера
-        GLuint vao_id_;             // OpenGL дескриптор VAO объекта
+        VertexFormat format_;       // Собственный формат вершин (VAO)
         GLsizei vertex_count_;      // Кол-во вершин
         GLsizei index_count_;       // Кол-во индексов
+        GLenum index_type_;         // Тип индексов
+        GLuint instance_vbo_id_;    // OpenGL дескриптор буфера экземпляров
+        GLsizei instance_count_;    // Кол-во экземпляров
+        GLsizei instance_capacity_; // Емкость хранилища буфера экземпляров
+        GLbitfield instance_flags_; // Флаги хранилища буфера экземпляров
+        GLsizei instance_stride_;   // Размер структуры экземпляра
     };
 }
\ No newline at end of file
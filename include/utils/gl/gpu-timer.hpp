@@ -0,0 +1,185 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cassert>
+
+#include "resource.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Таймер GPU (запросы GL_TIME_ELAPSED)
+     * Запросы образуют кольцо: каждый кадр использует следующий запрос, результат читается через несколько кадров,
+     * когда он уже доступен - чтение никогда не ожидает GPU. Если все запросы кольца еще не готовы,
+     * самый старый перезапускается и его результат теряется
+     */
+    class GpuTimer final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        GpuTimer()
+            : Resource()
+            , current_(0)
+            , oldest_(0)
+            , pending_(0)
+            , running_(false)
+        {}
+
+        /**
+         * Основной конструктор (создает OpenGL ресурсы)
+         * @param latency Кол-во запросов в кольце (через сколько кадров ожидается результат)
+         */
+        explicit GpuTimer(size_t latency)
+            : Resource()
+            , queries_(latency, 0)
+            , current_(0)
+            , oldest_(0)
+            , pending_(0)
+            , running_(false)
+        {
+            assert(latency > 0);
+            glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(queries_.size()), queries_.data());
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        GpuTimer(const GpuTimer& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        GpuTimer(GpuTimer&& other) noexcept
+            : GpuTimer()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~GpuTimer() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        GpuTimer& operator=(const GpuTimer& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        GpuTimer& operator=(GpuTimer&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(queries_, other.queries_);
+            std::swap(current_, other.current_);
+            std::swap(oldest_, other.oldest_);
+            std::swap(pending_, other.pending_);
+            std::swap(running_, other.running_);
+
+            return *this;
+        }
+
+        /**
+         * Начать измерение (запросы не вкладываются - между begin и end не должно быть других GL_TIME_ELAPSED запросов)
+         */
+        void begin()
+        {
+            assert(loaded_ && !running_);
+
+            // Кольцо заполнено - самый старый результат теряется
+            if(pending_ == queries_.size())
+            {
+                oldest_ = (oldest_ + 1) % queries_.size();
+                pending_--;
+            }
+
+            glBeginQuery(GL_TIME_ELAPSED, queries_[current_]);
+            running_ = true;
+        }
+
+        /**
+         * Завершить измерение
+         */
+        void end()
+        {
+            assert(loaded_ && running_);
+
+            glEndQuery(GL_TIME_ELAPSED);
+            current_ = (current_ + 1) % queries_.size();
+            pending_++;
+            running_ = false;
+        }
+
+        /**
+         * Прочитать готовые результаты без ожидания (запросы завершаются по порядку)
+         * @param ms Самый свежий из готовых результатов (мс), не меняется если готовых нет
+         * @return Есть ли новый результат
+         */
+        bool fetch(double& ms)
+        {
+            bool fetched = false;
+            while(pending_ > 0)
+            {
+                GLint available = GL_FALSE;
+                glGetQueryObjectiv(queries_[oldest_], GL_QUERY_RESULT_AVAILABLE, &available);
+                if(!available) break;
+
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(queries_[oldest_], GL_QUERY_RESULT, &ns);
+                ms = static_cast<double>(ns) / 1000000.0;
+                fetched = true;
+
+                oldest_ = (oldest_ + 1) % queries_.size();
+                pending_--;
+            }
+            return fetched;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            if(running_) glEndQuery(GL_TIME_ELAPSED);
+            if(!queries_.empty()) glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+
+            queries_.clear();
+            current_ = 0;
+            oldest_ = 0;
+            pending_ = 0;
+            running_ = false;
+            loaded_ = false;
+        }
+
+    private:
+        // Кольцо запросов
+        std::vector<GLuint> queries_;
+        // Следующий запускаемый запрос, самый старый незавершенный и кол-во незавершенных
+        size_t current_;
+        size_t oldest_;
+        size_t pending_;
+        // Измерение начато
+        bool running_;
+    };
+}
\ No newline at end of file
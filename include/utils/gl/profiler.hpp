@@ -0,0 +1,574 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include "resource.hpp"
+#include "../threads/trace.hpp"
+
+namespace utils::gl
+{
+    /**
+     * История замеров (кольцевой буфер фиксированного размера)
+     */
+    class ProfilerHistory
+    {
+    public:
+        /**
+         * Конструктор
+         * @param size Кол-во хранимых замеров
+         */
+        explicit ProfilerHistory(size_t size = 0)
+            : samples_(size, 0.0f)
+            , next_(0)
+            , count_(0)
+        {}
+
+        /**
+         * Добавить замер (самый старый вытесняется)
+         * @param value Значение
+         */
+        void push(float value)
+        {
+            if(samples_.empty()) return;
+            samples_[next_] = value;
+            next_ = (next_ + 1) % samples_.size();
+            count_ = std::min(count_ + 1, samples_.size());
+        }
+
+        /**
+         * Последний замер
+         * @return Значение (0 если замеров нет)
+         */
+        [[nodiscard]] float last() const
+        {
+            return count_ > 0 ? samples_[(next_ + samples_.size() - 1) % samples_.size()] : 0.0f;
+        }
+
+        /**
+         * Среднее значение
+         * @return Значение (0 если замеров нет)
+         */
+        [[nodiscard]] float average() const
+        {
+            if(count_ == 0) return 0.0f;
+            float sum = 0.0f;
+            for(size_t i = 0; i < count_; i++) sum += samples_[i];
+            return sum / static_cast<float>(count_);
+        }
+
+        /**
+         * Процентиль (ближайший ранг)
+         * @param p Доля (0.5 - медиана, 0.99 - 99-й процентиль)
+         * @return Значение (0 если замеров нет)
+         */
+        [[nodiscard]] float percentile(float p) const
+        {
+            if(count_ == 0) return 0.0f;
+            std::vector<float> sorted(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(count_));
+            const auto rank = static_cast<size_t>(std::clamp(p, 0.0f, 1.0f) * static_cast<float>(count_ - 1) + 0.5f);
+            std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.end());
+            return sorted[rank];
+        }
+
+        /**
+         * Замеры (кольцевой буфер, начало - offset)
+         * @return Массив значений
+         */
+        [[nodiscard]] const std::vector<float>& samples() const
+        {
+            return samples_;
+        }
+
+        /**
+         * Индекс самого старого замера в кольцевом буфере (для графика в хронологическом порядке)
+         * @return Индекс
+         */
+        [[nodiscard]] size_t offset() const
+        {
+            return count_ < samples_.size() ? 0 : next_;
+        }
+
+        /**
+         * Кол-во замеров
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t count() const
+        {
+            return count_;
+        }
+
+    private:
+        std::vector<float> samples_;
+        size_t next_;
+        size_t count_;
+    };
+
+    /**
+     * Замеряемый участок кадра (по имени, вложенность определяется при первом появлении)
+     */
+    struct ProfilerEntry
+    {
+        std::string name;
+        // Уровень вложенности
+        unsigned depth = 0;
+        // Последний кадр, в котором участок выполнялся
+        size_t last_frame = 0;
+        // История времени CPU и GPU (мс)
+        ProfilerHistory cpu;
+        ProfilerHistory gpu;
+    };
+
+    /**
+     * Профилировщик кадра (CPU и GPU)
+     * Участки кадра отмечаются парами begin/end (допускается вложенность). Время CPU замеряется часами,
+     * время GPU - парой запросов GL_TIMESTAMP. Запросы кадра берутся из кольца на несколько кадров вперед,
+     * результаты читаются, когда готовы (обычно через 2-3 кадра), поэтому профилировщик не ожидает GPU.
+     * Если GPU отстает больше чем на длину кольца, результаты самого старого кадра отбрасываются.
+     * Во время записи временной шкалы (trace.hpp) участки CPU и прочитанные замеры GPU попадают и в нее
+     */
+    class Profiler final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        Profiler()
+            : Resource()
+            , max_scopes_(0)
+            , history_size_(0)
+            , frame_(0)
+            , oldest_(0)
+            , dropped_frames_(0)
+            , trace_calibrated_(false)
+            , trace_clock_offset_(0)
+        {}
+
+        /**
+         * Основной конструктор (создает OpenGL ресурсы)
+         * @param max_scopes Наибольшее кол-во участков за кадр (участки сверх этого кол-ва не замеряются)
+         * @param latency Кол-во кадров в кольце запросов
+         * @param history_size Кол-во хранимых замеров каждого участка
+         */
+        Profiler(size_t max_scopes, size_t latency, size_t history_size)
+            : Resource()
+            , max_scopes_(max_scopes)
+            , history_size_(history_size)
+            , frame_(0)
+            , oldest_(0)
+            , dropped_frames_(0)
+            , trace_calibrated_(false)
+            , trace_clock_offset_(0)
+            , frames_(latency)
+            , frame_cpu_(history_size)
+            , frame_gpu_(history_size)
+        {
+            assert(max_scopes_ > 0 && latency > 0);
+
+            for(auto& frame : frames_)
+            {
+                frame.queries.resize(max_scopes_ * 2);
+                glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        Profiler(const Profiler& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        Profiler(Profiler&& other) noexcept
+            : Profiler()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~Profiler() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        Profiler& operator=(const Profiler& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        Profiler& operator=(Profiler&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(max_scopes_, other.max_scopes_);
+            std::swap(history_size_, other.history_size_);
+            std::swap(frame_, other.frame_);
+            std::swap(oldest_, other.oldest_);
+            std::swap(dropped_frames_, other.dropped_frames_);
+            std::swap(trace_calibrated_, other.trace_calibrated_);
+            std::swap(trace_clock_offset_, other.trace_clock_offset_);
+            std::swap(frames_, other.frames_);
+            std::swap(entries_, other.entries_);
+            std::swap(stack_, other.stack_);
+            std::swap(frame_start_, other.frame_start_);
+            std::swap(frame_cpu_, other.frame_cpu_);
+            std::swap(frame_gpu_, other.frame_gpu_);
+
+            return *this;
+        }
+
+        /**
+         * Начало кадра (чтение готовых результатов прошлых кадров)
+         */
+        void begin_frame()
+        {
+            TRACE_BEGIN("Frame");
+            if(!loaded_) return;
+            assert(stack_.empty());
+
+            // Сопоставление часов GPU с часами записи (один раз за запись, чтобы участки GPU не смещались)
+            if(TRACE_ACTIVE() && !trace_calibrated_)
+            {
+                GLint64 gpu_now = 0;
+                glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+                trace_clock_offset_ = static_cast<int64_t>(TRACE_NOW()) - gpu_now;
+                trace_calibrated_ = true;
+            }
+            else if(!TRACE_ACTIVE())
+            {
+                trace_calibrated_ = false;
+            }
+
+            resolve();
+
+            // Кадр кольца еще не прочитан - GPU отстает, результаты отбрасываются
+            FrameQueries& frame = frames_[frame_ % frames_.size()];
+            if(frame.pending)
+            {
+                frame.pending = false;
+                oldest_++;
+                dropped_frames_++;
+            }
+
+            frame.scopes.clear();
+            frame.last_query = NONE;
+            frame_start_ = std::chrono::high_resolution_clock::now();
+        }
+
+        /**
+         * Конец кадра (время CPU всего кадра, запросы кадра ожидают готовности)
+         */
+        void end_frame()
+        {
+            TRACE_END();
+            if(!loaded_) return;
+            assert(stack_.empty());
+
+            const auto now = std::chrono::high_resolution_clock::now();
+            frame_cpu_.push(std::chrono::duration<float, std::milli>(now - frame_start_).count());
+
+            FrameQueries& frame = frames_[frame_ % frames_.size()];
+            frame.pending = !frame.scopes.empty();
+            frame_++;
+        }
+
+        /**
+         * Начать участок
+         * @param name Имя (участки с одинаковым именем накапливают общую историю)
+         */
+        void begin(const char* name)
+        {
+            TRACE_BEGIN(name);
+            if(!loaded_) return;
+
+            OpenScope scope;
+            scope.entry = find_entry(name, static_cast<unsigned>(stack_.size()));
+            entries_[scope.entry].last_frame = frame_;
+            scope.start = std::chrono::high_resolution_clock::now();
+
+            FrameQueries& frame = frames_[frame_ % frames_.size()];
+            if(frame.scopes.size() < max_scopes_)
+            {
+                scope.gpu_scope = frame.scopes.size();
+                frame.scopes.push_back({scope.entry, 0.0f});
+                glQueryCounter(frame.queries[scope.gpu_scope * 2], GL_TIMESTAMP);
+                frame.last_query = scope.gpu_scope * 2;
+            }
+
+            stack_.push_back(scope);
+        }
+
+        /**
+         * Завершить последний начатый участок
+         */
+        void end()
+        {
+            TRACE_END();
+            if(!loaded_) return;
+            assert(!stack_.empty());
+
+            const OpenScope scope = stack_.back();
+            stack_.pop_back();
+
+            if(scope.gpu_scope != NONE)
+            {
+                FrameQueries& frame = frames_[frame_ % frames_.size()];
+                glQueryCounter(frame.queries[scope.gpu_scope * 2 + 1], GL_TIMESTAMP);
+                frame.last_query = scope.gpu_scope * 2 + 1;
+            }
+
+            // Каждое выполнение участка - отдельный замер истории
+            const auto now = std::chrono::high_resolution_clock::now();
+            entries_[scope.entry].cpu.push(std::chrono::duration<float, std::milli>(now - scope.start).count());
+        }
+
+        /**
+         * Участки (в порядке первого появления)
+         * @return Список участков
+         */
+        [[nodiscard]] const std::vector<ProfilerEntry>& entries() const
+        {
+            return entries_;
+        }
+
+        /**
+         * Номер текущего кадра
+         * @return Номер
+         */
+        [[nodiscard]] size_t frame() const
+        {
+            return frame_;
+        }
+
+        /**
+         * История времени CPU всего кадра (от begin_frame до end_frame)
+         * @return История
+         */
+        [[nodiscard]] const ProfilerHistory& frame_cpu() const
+        {
+            return frame_cpu_;
+        }
+
+        /**
+         * История времени GPU всего кадра (сумма участков верхнего уровня)
+         * @return История
+         */
+        [[nodiscard]] const ProfilerHistory& frame_gpu() const
+        {
+            return frame_gpu_;
+        }
+
+        /**
+         * Кол-во кадров, результаты GPU которых отброшены (GPU отстает больше чем на длину кольца)
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t dropped_frames() const
+        {
+            return dropped_frames_;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            for(auto& frame : frames_)
+            {
+                if(!frame.queries.empty()) glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+
+            frames_.clear();
+            entries_.clear();
+            stack_.clear();
+            frame_ = 0;
+            oldest_ = 0;
+            dropped_frames_ = 0;
+            loaded_ = false;
+        }
+
+    private:
+        /**
+         * Отсутствующий индекс
+         */
+        constexpr static size_t NONE = std::numeric_limits<size_t>::max();
+
+        /**
+         * Замер GPU участка в кадре
+         */
+        struct GpuScope
+        {
+            size_t entry;
+            float ms;
+        };
+
+        /**
+         * Запросы одного кадра кольца (пара запросов на участок)
+         */
+        struct FrameQueries
+        {
+            std::vector<GLuint> queries;
+            std::vector<GpuScope> scopes;
+            // Последний отправленный запрос (участки вложены - конец внешнего участка отправляется после вложенных)
+            size_t last_query = NONE;
+            bool pending = false;
+        };
+
+        /**
+         * Открытый участок
+         */
+        struct OpenScope
+        {
+            size_t entry = NONE;
+            size_t gpu_scope = NONE;
+            std::chrono::high_resolution_clock::time_point start;
+        };
+
+        /**
+         * Найти либо добавить участок
+         * @param name Имя
+         * @param depth Уровень вложенности
+         * @return Индекс участка
+         */
+        size_t find_entry(const char* name, unsigned depth)
+        {
+            for(size_t i = 0; i < entries_.size(); i++)
+            {
+                if(entries_[i].name == name) return i;
+            }
+
+            ProfilerEntry entry;
+            entry.name = name;
+            entry.depth = depth;
+            entry.cpu = ProfilerHistory(history_size_);
+            entry.gpu = ProfilerHistory(history_size_);
+            entries_.push_back(std::move(entry));
+            return entries_.size() - 1;
+        }
+
+        /**
+         * Прочитать результаты готовых кадров (по порядку, без ожидания)
+         */
+        void resolve()
+        {
+            while(oldest_ < frame_)
+            {
+                FrameQueries& frame = frames_[oldest_ % frames_.size()];
+                if(!frame.pending)
+                {
+                    oldest_++;
+                    continue;
+                }
+
+                // Запросы завершаются в порядке отправки - достаточно проверить последний отправленный
+                GLint available = GL_FALSE;
+                glGetQueryObjectiv(frame.queries[frame.last_query], GL_QUERY_RESULT_AVAILABLE, &available);
+                if(!available) break;
+
+                float total = 0.0f;
+                for(size_t i = 0; i < frame.scopes.size(); i++)
+                {
+                    GLuint64 start = 0, end = 0;
+                    glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+                    glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+                    const float ms = static_cast<float>(end - start) / 1000000.0f;
+                    auto& entry = entries_[frame.scopes[i].entry];
+                    entry.gpu.push(ms);
+                    if(entry.depth == 0) total += ms;
+
+                    if(trace_calibrated_)
+                    {
+                        TRACE_GPU(entry.name.c_str(), static_cast<uint64_t>(static_cast<int64_t>(start) + trace_clock_offset_), end - start);
+                    }
+                }
+
+                frame_gpu_.push(total);
+                frame.pending = false;
+                oldest_++;
+            }
+        }
+
+        // Наибольшее кол-во участков за кадр и размер истории
+        size_t max_scopes_;
+        size_t history_size_;
+
+        // Текущий кадр и самый старый непрочитанный кадр (номера кадров)
+        size_t frame_;
+        size_t oldest_;
+
+        // Кол-во отброшенных кадров
+        size_t dropped_frames_;
+
+        // Часы GPU сопоставлены с часами записи временной шкалы и разница часов (нс)
+        bool trace_calibrated_;
+        int64_t trace_clock_offset_;
+
+        // Кольцо запросов
+        std::vector<FrameQueries> frames_;
+
+        // Участки и стек открытых участков
+        std::vector<ProfilerEntry> entries_;
+        std::vector<OpenScope> stack_;
+
+        // Начало кадра и история времени кадра
+        std::chrono::high_resolution_clock::time_point frame_start_;
+        ProfilerHistory frame_cpu_;
+        ProfilerHistory frame_gpu_;
+    };
+
+    /**
+     * Участок профилировщика на время жизни объекта
+     */
+    class ProfilerScope
+    {
+    public:
+        /**
+         * Начать участок
+         * @param profiler Профилировщик
+         * @param name Имя участка
+         */
+        ProfilerScope(Profiler& profiler, const char* name)
+            : profiler_(profiler)
+        {
+            profiler_.begin(name);
+        }
+
+        /**
+         * Завершить участок
+         */
+        ~ProfilerScope()
+        {
+            profiler_.end();
+        }
+
+        ProfilerScope(const ProfilerScope& other) = delete;
+        ProfilerScope& operator=(const ProfilerScope& other) = delete;
+
+    private:
+        Profiler& profiler_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,590 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include "resource.hpp"
+#include "texture-format.hpp"
+#include "render-target-pool.hpp"
+#include "profiler.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Описание текстуры графа кадра (совпадает с ключом пула целей рендеринга)
+     */
+    using RenderGraphTextureDesc = RenderTargetDesc;
+
+    /**
+     * Статистика компиляции графа
+     */
+    struct RenderGraphStats
+    {
+        // Объявлено проходов и выполняется после отсечения
+        size_t passes_declared = 0;
+        size_t passes_executed = 0;
+        // Временных текстур (используемых проходами) и созданных под них текстур OpenGL
+        size_t transient_textures = 0;
+        size_t physical_textures = 0;
+        // Память временных текстур без совмещения и с совмещением (байт)
+        size_t bytes_unaliased = 0;
+        size_t bytes_aliased = 0;
+    };
+
+    /**
+     * Граф кадра (render graph)
+     * Проходы объявляют читаемые и записываемые ресурсы, граф по этим зависимостям:
+     * - отсекает проходы, результат которых не нужен (не ведет к записи во внешний ресурс - итоговый кадровый буфер),
+     * - упорядочивает проходы (запись ресурса раньше его чтения, при отсутствии зависимостей - в порядке объявления),
+     * - совмещает временные текстуры с непересекающимися временами жизни (один объект текстуры на несколько ресурсов).
+     * OpenGL не дает управлять памятью текстур напрямую, поэтому совмещение - повторное использование текстуры
+     * того же размера и формата. Граф объявляется заново при изменении набора проходов или размеров (unload + объявление + compile),
+     * при компиляции с пулом целей рендеринга текстуры берутся из пула и возвращаются в него при выгрузке
+     */
+    class RenderGraph final : public Resource
+    {
+    public:
+        /**
+         * Дескриптор ресурса графа
+         */
+        using Handle = uint32_t;
+
+        /**
+         * Функция выполнения прохода (получает граф для доступа к текстурам ресурсов)
+         */
+        using ExecuteFn = std::function<void(const RenderGraph&)>;
+
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой граф
+         */
+        RenderGraph()
+            : Resource()
+            , pool_(nullptr)
+            , area_width_(0)
+            , area_height_(0)
+        {}
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        RenderGraph(const RenderGraph& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        RenderGraph(RenderGraph&& other) noexcept
+            : Resource(std::move(other))
+            , resources_(std::move(other.resources_))
+            , passes_(std::move(other.passes_))
+            , order_(std::move(other.order_))
+            , physical_textures_(std::move(other.physical_textures_))
+            , pool_(other.pool_)
+            , area_width_(other.area_width_)
+            , area_height_(other.area_height_)
+            , stats_(other.stats_)
+        {
+            other.pool_ = nullptr;
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~RenderGraph() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RenderGraph& operator=(const RenderGraph& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RenderGraph& operator=(RenderGraph&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(resources_, other.resources_);
+            std::swap(passes_, other.passes_);
+            std::swap(order_, other.order_);
+            std::swap(physical_textures_, other.physical_textures_);
+            std::swap(pool_, other.pool_);
+            std::swap(area_width_, other.area_width_);
+            std::swap(area_height_, other.area_height_);
+            std::swap(stats_, other.stats_);
+
+            return *this;
+        }
+
+        /**
+         * Объявить временную текстуру (создается при компиляции, может совмещаться с другими)
+         * @param name Имя (для отладки)
+         * @param desc Описание
+         * @return Дескриптор ресурса
+         */
+        Handle create_texture(const std::string& name, const RenderGraphTextureDesc& desc)
+        {
+            ResourceNode node;
+            node.name = name;
+            node.desc = desc;
+            resources_.push_back(node);
+            return static_cast<Handle>(resources_.size() - 1);
+        }
+
+        /**
+         * Объявить внешний кадровый буфер (запись в него - конечный результат графа)
+         * @param name Имя (для отладки)
+         * @param frame_buffer_id Дескриптор кадрового буфера (0 - основной)
+         * @param width Ширина
+         * @param height Высота
+         * @return Дескриптор ресурса
+         */
+        Handle import_frame_buffer(const std::string& name, GLuint frame_buffer_id, GLsizei width, GLsizei height)
+        {
+            ResourceNode node;
+            node.name = name;
+            node.desc = {width, height, GL_NONE, 1};
+            node.imported = true;
+            node.frame_buffer_id = frame_buffer_id;
+            resources_.push_back(node);
+            return static_cast<Handle>(resources_.size() - 1);
+        }
+
+        /**
+         * Объявить проход
+         * Проход пишет либо во временные текстуры (вложения кадрового буфера прохода, глубина определяется по формату),
+         * либо во внешний кадровый буфер. Перед выполнением привязывается кадровый буфер прохода и область вывода
+         * @param name Имя (для отладки и статистики)
+         * @param reads Читаемые ресурсы
+         * @param writes Записываемые ресурсы
+         * @param execute Функция выполнения
+         */
+        void add_pass(const std::string& name, const std::vector<Handle>& reads, const std::vector<Handle>& writes, ExecuteFn execute)
+        {
+            PassNode node;
+            node.name = name;
+            node.reads = reads;
+            node.writes = writes;
+            node.execute = std::move(execute);
+            passes_.push_back(std::move(node));
+        }
+
+        /**
+         * Компиляция графа: отсечение, упорядочивание, назначение текстур, создание кадровых буферов проходов
+         * @param pool Пул целей рендеринга (nullptr - текстуры создаются и удаляются графом)
+         * @throws std::runtime_error При некорректном графе (несколько записей ресурса, цикл, неполный кадровый буфер)
+         */
+        void compile(RenderTargetPool* pool = nullptr)
+        {
+            assert(!loaded_);
+            assert(!pool || pool->ready());
+            pool_ = pool;
+
+            // Проход, записывающий каждый ресурс
+            std::vector<size_t> writer(resources_.size(), NONE);
+            for(size_t p = 0; p < passes_.size(); p++)
+            {
+                for(Handle h : passes_[p].writes)
+                {
+                    if(writer[h] != NONE) throw std::runtime_error("[RenderGraph] resource \"" + resources_[h].name + "\" is written by several passes");
+                    writer[h] = p;
+                }
+            }
+
+            // Отсечение: живы проходы, пишущие во внешние ресурсы, и (рекурсивно) писатели читаемых ими ресурсов
+            std::vector<size_t> stack;
+            for(size_t p = 0; p < passes_.size(); p++)
+            {
+                for(Handle h : passes_[p].writes)
+                {
+                    if(resources_[h].imported && !passes_[p].alive)
+                    {
+                        passes_[p].alive = true;
+                        stack.push_back(p);
+                    }
+                }
+            }
+            while(!stack.empty())
+            {
+                const size_t p = stack.back();
+                stack.pop_back();
+                for(Handle h : passes_[p].reads)
+                {
+                    const size_t w = writer[h];
+                    if(w != NONE && !passes_[w].alive)
+                    {
+                        passes_[w].alive = true;
+                        stack.push_back(w);
+                    }
+                }
+            }
+
+            // Упорядочивание (топологическая сортировка, среди готовых - первый объявленный)
+            std::vector<size_t> dependencies(passes_.size(), 0);
+            for(size_t p = 0; p < passes_.size(); p++)
+            {
+                if(!passes_[p].alive) continue;
+                for(Handle h : passes_[p].reads) if(writer[h] != NONE && writer[h] != p) dependencies[p]++;
+            }
+
+            order_.clear();
+            std::vector<bool> scheduled(passes_.size(), false);
+            const size_t alive_count = static_cast<size_t>(std::count_if(passes_.begin(), passes_.end(), [](const PassNode& n){ return n.alive; }));
+            while(order_.size() < alive_count)
+            {
+                size_t next = NONE;
+                for(size_t p = 0; p < passes_.size() && next == NONE; p++)
+                {
+                    if(passes_[p].alive && !scheduled[p] && dependencies[p] == 0) next = p;
+                }
+                if(next == NONE) throw std::runtime_error("[RenderGraph] dependency cycle");
+
+                scheduled[next] = true;
+                order_.push_back(next);
+
+                // Читатели ресурсов прохода становятся ближе к готовности
+                for(Handle h : passes_[next].writes)
+                {
+                    for(size_t p = 0; p < passes_.size(); p++)
+                    {
+                        if(!passes_[p].alive || p == next) continue;
+                        for(Handle r : passes_[p].reads) if(r == h) dependencies[p]--;
+                    }
+                }
+            }
+
+            // Время жизни временных ресурсов (первый и последний проход в порядке выполнения)
+            for(size_t i = 0; i < order_.size(); i++)
+            {
+                const PassNode& pass = passes_[order_[i]];
+                for(const auto* list : {&pass.reads, &pass.writes})
+                {
+                    for(Handle h : *list)
+                    {
+                        auto& res = resources_[h];
+                        res.first_use = std::min(res.first_use, i);
+                        res.last_use = res.last_use == NONE ? i : std::max(res.last_use, i);
+                    }
+                }
+            }
+
+            // Совмещение: ресурсы по возрастанию начала жизни, текстура свободна после конца жизни прежнего владельца
+            std::vector<Handle> transient;
+            for(Handle h = 0; h < resources_.size(); h++)
+            {
+                if(!resources_[h].imported && resources_[h].last_use != NONE) transient.push_back(h);
+            }
+            std::stable_sort(transient.begin(), transient.end(), [&](Handle a, Handle b){
+                return resources_[a].first_use < resources_[b].first_use;
+            });
+
+            std::vector<size_t> busy_until;
+            for(Handle h : transient)
+            {
+                auto& res = resources_[h];
+                size_t slot = NONE;
+                for(size_t t = 0; t < physical_textures_.size() && slot == NONE; t++)
+                {
+                    if(physical_textures_[t].desc == res.desc && busy_until[t] < res.first_use) slot = t;
+                }
+
+                if(slot == NONE)
+                {
+                    PhysicalTexture texture;
+                    texture.desc = res.desc;
+                    if(pool_)
+                    {
+                        texture.id = pool_->acquire(res.desc);
+                    }
+                    else if(res.desc.samples > 1)
+                    {
+                        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &texture.id);
+                        glTextureStorage2DMultisample(texture.id, res.desc.samples, res.desc.internal_format, res.desc.width, res.desc.height, GL_TRUE);
+                    }
+                    else
+                    {
+                        glCreateTextures(GL_TEXTURE_2D, 1, &texture.id);
+                        glTextureStorage2D(texture.id, 1, res.desc.internal_format, res.desc.width, res.desc.height);
+                        glTextureParameteri(texture.id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                        glTextureParameteri(texture.id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                        glTextureParameteri(texture.id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                        glTextureParameteri(texture.id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    }
+
+                    slot = physical_textures_.size();
+                    physical_textures_.push_back(texture);
+                    busy_until.push_back(0);
+                }
+
+                busy_until[slot] = res.last_use;
+                res.texture_id = physical_textures_[slot].id;
+            }
+
+            // Кадровые буферы проходов (вложения - записываемые временные текстуры)
+            for(size_t index : order_)
+            {
+                PassNode& pass = passes_[index];
+                std::vector<GLenum> draw_buffers;
+                for(Handle h : pass.writes)
+                {
+                    const auto& res = resources_[h];
+                    if(res.imported)
+                    {
+                        if(pass.writes.size() > 1) throw std::runtime_error("[RenderGraph] pass \"" + pass.name + "\" writes an imported frame buffer and other resources");
+                        pass.frame_buffer_id = res.frame_buffer_id;
+                        pass.width = res.desc.width;
+                        pass.height = res.desc.height;
+                        break;
+                    }
+
+                    if(!pass.owns_frame_buffer)
+                    {
+                        glCreateFramebuffers(1, &pass.frame_buffer_id);
+                        pass.owns_frame_buffer = true;
+                        pass.width = res.desc.width;
+                        pass.height = res.desc.height;
+                    }
+
+                    const GLenum attachment = texture_depth_attachment(res.desc.internal_format);
+                    if(attachment != GL_NONE)
+                    {
+                        glNamedFramebufferTexture(pass.frame_buffer_id, attachment, res.texture_id, 0);
+                    }
+                    else
+                    {
+                        const auto color_attachment = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + draw_buffers.size());
+                        glNamedFramebufferTexture(pass.frame_buffer_id, color_attachment, res.texture_id, 0);
+                        draw_buffers.push_back(color_attachment);
+                    }
+                }
+
+                if(pass.owns_frame_buffer)
+                {
+                    glNamedFramebufferDrawBuffers(pass.frame_buffer_id, static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+                    if(glCheckNamedFramebufferStatus(pass.frame_buffer_id, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                    {
+                        throw std::runtime_error("[RenderGraph] frame buffer of pass \"" + pass.name + "\" is incomplete");
+                    }
+                }
+            }
+
+            // Статистика
+            stats_ = {};
+            stats_.passes_declared = passes_.size();
+            stats_.passes_executed = order_.size();
+            stats_.transient_textures = transient.size();
+            stats_.physical_textures = physical_textures_.size();
+            for(Handle h : transient) stats_.bytes_unaliased += texture_bytes(resources_[h].desc);
+            for(const auto& texture : physical_textures_) stats_.bytes_aliased += texture_bytes(texture.desc);
+
+            loaded_ = true;
+        }
+
+        /**
+         * Задать область рендеринга временных текстур (динамическое разрешение)
+         * Проходы, пишущие во временные текстуры, рисуют только в левый нижний участок заданного размера,
+         * текстуры при этом не пересоздаются. Проходы, пишущие во внешний буфер, используют его полный размер
+         * @param width Ширина (0 - полный размер текстур)
+         * @param height Высота (0 - полный размер текстур)
+         */
+        void set_render_area(GLsizei width, GLsizei height)
+        {
+            area_width_ = width;
+            area_height_ = height;
+        }
+
+        /**
+         * Выполнить проходы в порядке компиляции
+         * Область вывода и отсечения (scissor test включен на время выполнения) - размер прохода, либо область рендеринга
+         * @param profiler Профилировщик (каждый проход - отдельный участок с именем прохода), nullptr - без замеров
+         */
+        void execute(Profiler* profiler = nullptr) const
+        {
+            assert(loaded_);
+
+            glEnable(GL_SCISSOR_TEST);
+            for(size_t index : order_)
+            {
+                const PassNode& pass = passes_[index];
+                const GLsizei width = pass.owns_frame_buffer && area_width_ > 0 ? std::min(area_width_, pass.width) : pass.width;
+                const GLsizei height = pass.owns_frame_buffer && area_height_ > 0 ? std::min(area_height_, pass.height) : pass.height;
+
+                glBindFramebuffer(GL_FRAMEBUFFER, pass.frame_buffer_id);
+                glViewport(0, 0, width, height);
+                glScissor(0, 0, width, height);
+
+                if(profiler) profiler->begin(pass.name.c_str());
+                pass.execute(*this);
+                if(profiler) profiler->end();
+            }
+            glDisable(GL_SCISSOR_TEST);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        /**
+         * Получить текстуру ресурса (допустимо при выполнении проходов)
+         * @param handle Дескриптор ресурса
+         * @return OpenGL дескриптор текстуры (0 - ресурс не используется выполняемыми проходами)
+         */
+        [[nodiscard]] GLuint texture(Handle handle) const
+        {
+            return resources_[handle].texture_id;
+        }
+
+        /**
+         * Получить описание ресурса
+         * @param handle Дескриптор ресурса
+         * @return Описание
+         */
+        [[nodiscard]] const RenderGraphTextureDesc& desc(Handle handle) const
+        {
+            return resources_[handle].desc;
+        }
+
+        /**
+         * Имена выполняемых проходов (в порядке выполнения)
+         * @return Список имен
+         */
+        [[nodiscard]] std::vector<std::string> executed_passes() const
+        {
+            std::vector<std::string> names;
+            for(size_t index : order_) names.push_back(passes_[index].name);
+            return names;
+        }
+
+        /**
+         * Статистика компиляции
+         * @return Статистика
+         */
+        [[nodiscard]] const RenderGraphStats& stats() const
+        {
+            return stats_;
+        }
+
+        /**
+         * Выгрузка ресурса (кадровые буферы удаляются, текстуры возвращаются в пул либо удаляются,
+         * объявления проходов и ресурсов очищаются)
+         */
+        void unload() override
+        {
+            for(auto& pass : passes_)
+            {
+                if(pass.owns_frame_buffer) glDeleteFramebuffers(1, &pass.frame_buffer_id);
+            }
+            for(auto& texture : physical_textures_)
+            {
+                if(pool_) pool_->release(texture.id);
+                else glDeleteTextures(1, &texture.id);
+            }
+
+            resources_.clear();
+            passes_.clear();
+            order_.clear();
+            physical_textures_.clear();
+            pool_ = nullptr;
+            stats_ = {};
+            loaded_ = false;
+        }
+
+    private:
+        /**
+         * Отсутствующий индекс
+         */
+        constexpr static size_t NONE = std::numeric_limits<size_t>::max();
+
+        /**
+         * Ресурс графа
+         */
+        struct ResourceNode
+        {
+            std::string name;
+            RenderGraphTextureDesc desc;
+            // Внешний кадровый буфер
+            bool imported = false;
+            GLuint frame_buffer_id = 0;
+            // Назначенная текстура и время жизни (индексы в порядке выполнения)
+            GLuint texture_id = 0;
+            size_t first_use = NONE;
+            size_t last_use = NONE;
+        };
+
+        /**
+         * Проход графа
+         */
+        struct PassNode
+        {
+            std::string name;
+            std::vector<Handle> reads;
+            std::vector<Handle> writes;
+            ExecuteFn execute;
+            // Не отсечен
+            bool alive = false;
+            // Кадровый буфер прохода и его размер
+            GLuint frame_buffer_id = 0;
+            bool owns_frame_buffer = false;
+            GLsizei width = 0;
+            GLsizei height = 0;
+        };
+
+        /**
+         * Текстура OpenGL (общая для совмещенных ресурсов)
+         */
+        struct PhysicalTexture
+        {
+            GLuint id = 0;
+            RenderGraphTextureDesc desc;
+        };
+
+        /**
+         * Приблизительный размер текстуры в памяти
+         * @param desc Описание
+         * @return Размер (байт)
+         */
+        static size_t texture_bytes(const RenderGraphTextureDesc& desc)
+        {
+            return texture_pixel_size(desc.internal_format) *
+                   static_cast<size_t>(desc.samples) *
+                   static_cast<size_t>(desc.width) *
+                   static_cast<size_t>(desc.height);
+        }
+
+        // Объявленные ресурсы и проходы
+        std::vector<ResourceNode> resources_;
+        std::vector<PassNode> passes_;
+
+        // Порядок выполнения (индексы живых проходов)
+        std::vector<size_t> order_;
+
+        // Созданные текстуры
+        std::vector<PhysicalTexture> physical_textures_;
+
+        // Пул, из которого получены текстуры (nullptr - текстуры принадлежат графу)
+        RenderTargetPool* pool_;
+
+        // Область рендеринга временных текстур (0 - полный размер)
+        GLsizei area_width_;
+        GLsizei area_height_;
+
+        // Статистика компиляции
+        RenderGraphStats stats_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+namespace utils::gl
+{
+    /**
+     * Разрядность полей ключа сортировки (от старших бит к младшим: проход, шейдер, материал, глубина)
+     */
+    constexpr unsigned SORT_KEY_PASS_BITS = 4;
+    constexpr unsigned SORT_KEY_SHADER_BITS = 12;
+    constexpr unsigned SORT_KEY_MATERIAL_BITS = 16;
+    constexpr unsigned SORT_KEY_DEPTH_BITS = 32;
+
+    /**
+     * Сформировать 64-битный ключ сортировки команды рисования
+     * Старшие поля важнее младших: команды группируются по проходу, внутри прохода - по шейдеру, затем по материалу,
+     * внутри одного состояния упорядочиваются по глубине. Идентификаторы шейдера и материала назначаются приложением
+     * (небольшие числа, не OpenGL дескрипторы).
+     * Для прозрачных объектов порядок по глубине важнее смены состояний - для них следует отдельный проход
+     * с нулевыми идентификаторами шейдера и материала (либо одинаковыми у всех команд прохода)
+     * @param pass Проход (порядок проходов в кадре)
+     * @param shader Идентификатор шейдера
+     * @param material Идентификатор материала (текстуры, геометрии и т.д.)
+     * @param depth Расстояние до камеры (неотрицательное)
+     * @param back_to_front Порядок от дальних к ближним (иначе от ближних к дальним)
+     * @return Ключ
+     */
+    inline uint64_t make_sort_key(uint32_t pass, uint32_t shader, uint32_t material, float depth, bool back_to_front = false)
+    {
+        assert(pass < (1u << SORT_KEY_PASS_BITS));
+        assert(shader < (1u << SORT_KEY_SHADER_BITS));
+        assert(material < (1u << SORT_KEY_MATERIAL_BITS));
+
+        // Двоичное представление неотрицательного float возрастает вместе с его значением
+        uint32_t depth_bits = 0;
+        const float d = std::max(depth, 0.0f);
+        std::memcpy(&depth_bits, &d, sizeof(float));
+        if(back_to_front) depth_bits = ~depth_bits;
+
+        return (static_cast<uint64_t>(pass) << (SORT_KEY_SHADER_BITS + SORT_KEY_MATERIAL_BITS + SORT_KEY_DEPTH_BITS))
+               | (static_cast<uint64_t>(shader) << (SORT_KEY_MATERIAL_BITS + SORT_KEY_DEPTH_BITS))
+               | (static_cast<uint64_t>(material) << SORT_KEY_DEPTH_BITS)
+               | static_cast<uint64_t>(depth_bits);
+    }
+
+    /**
+     * Команда рисования (пакет)
+     * Содержит все состояние, необходимое для вызова, поэтому команды выполняются в любом порядке
+     */
+    struct DrawPacket
+    {
+        // Программа, VAO и текстура (текстурный блок 0, 0 - без текстуры)
+        GLuint program_id = 0;
+        GLuint vao_id = 0;
+        GLuint texture_id = 0;
+        // Участок индексного буфера
+        GLenum index_type = GL_UNSIGNED_INT;
+        GLsizei index_count = 0;
+        GLuint first_index = 0;
+        GLint base_vertex = 0;
+        // Данные приложения (например индекс объекта для uniform-переменных вызова)
+        uint32_t user_data = 0;
+    };
+
+    /**
+     * Счетчики смен состояния за кадр
+     */
+    struct RenderQueueStats
+    {
+        size_t draws = 0;
+        size_t program_changes = 0;
+        size_t vao_changes = 0;
+        size_t texture_changes = 0;
+
+        /**
+         * Общее кол-во смен состояния
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t state_changes() const
+        {
+            return program_changes + vao_changes + texture_changes;
+        }
+    };
+
+    /**
+     * Очередь рисования
+     * Команды добавляются в произвольном порядке вместе с ключом, сортируются поразрядно (radix sort) по ключу
+     * и выполняются по порядку, состояние OpenGL меняется только при отличии от текущего
+     */
+    class RenderQueue
+    {
+    public:
+        /**
+         * Очистить очередь (в начале кадра)
+         */
+        void clear()
+        {
+            keys_.clear();
+            packets_.clear();
+            order_.clear();
+        }
+
+        /**
+         * Добавить команду
+         * @param key Ключ сортировки
+         * @param packet Команда
+         */
+        void submit(uint64_t key, const DrawPacket& packet)
+        {
+            order_.push_back(static_cast<uint32_t>(packets_.size()));
+            keys_.push_back(key);
+            packets_.push_back(packet);
+        }
+
+        /**
+         * Упорядочить команды по ключу
+         * Поразрядная сортировка (LSD, 8 проходов по байту ключа), устойчива - команды с равными ключами
+         * сохраняют порядок добавления. Проходы по байтам, одинаковым у всех ключей, пропускаются
+         */
+        void sort()
+        {
+            const size_t count = keys_.size();
+            sorted_keys_.assign(keys_.begin(), keys_.end());
+            for(size_t i = 0; i < count; i++) order_[i] = static_cast<uint32_t>(i);
+
+            temp_keys_.resize(count);
+            temp_order_.resize(count);
+
+            for(unsigned shift = 0; shift < 64; shift += 8)
+            {
+                size_t histogram[256] = {};
+                for(size_t i = 0; i < count; i++) histogram[(sorted_keys_[i] >> shift) & 0xFF]++;
+
+                // Все ключи имеют одинаковый байт - порядок не меняется
+                if(count == 0 || histogram[(sorted_keys_[0] >> shift) & 0xFF] == count) continue;
+
+                size_t offset = 0;
+                for(auto& bucket : histogram)
+                {
+                    const size_t n = bucket;
+                    bucket = offset;
+                    offset += n;
+                }
+
+                for(size_t i = 0; i < count; i++)
+                {
+                    const size_t dst = histogram[(sorted_keys_[i] >> shift) & 0xFF]++;
+                    temp_keys_[dst] = sorted_keys_[i];
+                    temp_order_[dst] = order_[i];
+                }
+
+                std::swap(sorted_keys_, temp_keys_);
+                std::swap(order_, temp_order_);
+            }
+        }
+
+        /**
+         * Подсчитать смены состояния при выполнении команд в текущем порядке (без вызовов OpenGL)
+         * @param sorted Порядок после сортировки (иначе - порядок добавления)
+         * @return Счетчики
+         */
+        [[nodiscard]] RenderQueueStats count_state_changes(bool sorted = true) const
+        {
+            RenderQueueStats stats;
+            const DrawPacket* current = nullptr;
+            for(size_t i = 0; i < packets_.size(); i++)
+            {
+                const DrawPacket& packet = packets_[sorted ? order_[i] : i];
+                count_changes(current, packet, stats);
+                current = &packet;
+            }
+            return stats;
+        }
+
+        /**
+         * Выполнить команды (в порядке после сортировки, либо в порядке добавления)
+         * @tparam P Тип обработчика смены программы
+         * @tparam D Тип обработчика команды
+         * @param on_program Вызывается после смены программы (uniform-переменные кадра), аргумент - дескриптор программы
+         * @param on_draw Вызывается перед каждым вызовом рисования (uniform-переменные объекта), аргумент - команда
+         * @param sorted Порядок после сортировки (иначе - порядок добавления)
+         * @return Счетчики смен состояния
+         */
+        template<typename P, typename D>
+        RenderQueueStats execute(const P& on_program, const D& on_draw, bool sorted = true) const
+        {
+            RenderQueueStats stats;
+            const DrawPacket* current = nullptr;
+            for(size_t i = 0; i < packets_.size(); i++)
+            {
+                const DrawPacket& packet = packets_[sorted ? order_[i] : i];
+                const RenderQueueStats before = stats;
+                count_changes(current, packet, stats);
+                current = &packet;
+
+                if(stats.program_changes != before.program_changes)
+                {
+                    glUseProgram(packet.program_id);
+                    on_program(packet.program_id);
+                }
+                if(stats.vao_changes != before.vao_changes) glBindVertexArray(packet.vao_id);
+                if(stats.texture_changes != before.texture_changes) glBindTextureUnit(0, packet.texture_id);
+
+                on_draw(packet);
+                glDrawElementsBaseVertex(
+                        GL_TRIANGLES,
+                        packet.index_count,
+                        packet.index_type,
+                        reinterpret_cast<const void*>(static_cast<size_t>(packet.first_index) * index_size(packet.index_type)),
+                        packet.base_vertex);
+            }
+
+            // Сброс
+            glBindTextureUnit(0, 0);
+            glBindVertexArray(0);
+            glUseProgram(0);
+
+            return stats;
+        }
+
+        /**
+         * Кол-во команд
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t size() const
+        {
+            return packets_.size();
+        }
+
+        /**
+         * Ключи команд (в порядке добавления)
+         * @return Массив ключей
+         */
+        [[nodiscard]] const std::vector<uint64_t>& keys() const
+        {
+            return keys_;
+        }
+
+        /**
+         * Команды (в порядке добавления)
+         * @return Массив команд
+         */
+        [[nodiscard]] const std::vector<DrawPacket>& packets() const
+        {
+            return packets_;
+        }
+
+        /**
+         * Порядок выполнения (индексы команд, после sort - по возрастанию ключа)
+         * @return Массив индексов
+         */
+        [[nodiscard]] const std::vector<uint32_t>& order() const
+        {
+            return order_;
+        }
+
+    private:
+        /**
+         * Учесть смены состояния при переходе от текущей команды к следующей
+         * @param current Текущая команда (nullptr - состояние не задано, первая команда задает все)
+         * @param next Следующая команда
+         * @param stats Счетчики
+         */
+        static void count_changes(const DrawPacket* current, const DrawPacket& next, RenderQueueStats& stats)
+        {
+            stats.draws++;
+            if(!current || current->program_id != next.program_id) stats.program_changes++;
+            if(!current || current->vao_id != next.vao_id) stats.vao_changes++;
+            if(!current || current->texture_id != next.texture_id) stats.texture_changes++;
+        }
+
+        /**
+         * Размер индекса
+         * @param index_type Тип индекса (GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT)
+         * @return Размер в байтах
+         */
+        static size_t index_size(GLenum index_type)
+        {
+            switch(index_type)
+            {
+                case GL_UNSIGNED_BYTE: return 1;
+                case GL_UNSIGNED_SHORT: return 2;
+                default: return 4;
+            }
+        }
+
+        // Ключи и команды (в порядке добавления), порядок выполнения
+        std::vector<uint64_t> keys_;
+        std::vector<DrawPacket> packets_;
+        std::vector<uint32_t> order_;
+
+        // Рабочие массивы сортировки (сохраняются между кадрами, чтобы не выделять память)
+        std::vector<uint64_t> sorted_keys_;
+        std::vector<uint64_t> temp_keys_;
+        std::vector<uint32_t> temp_order_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "resource.hpp"
+#include "texture-format.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Описание цели рендеринга (ключ пула)
+     */
+    struct RenderTargetDesc
+    {
+        // Размер
+        GLsizei width = 0;
+        GLsizei height = 0;
+        // Внутренний формат (только форматы с явным размером, например GL_RGBA8, GL_DEPTH32F_STENCIL8)
+        GLenum internal_format = GL_RGBA8;
+        // Кол-во выборок (больше 1 - GL_TEXTURE_2D_MULTISAMPLE)
+        GLsizei samples = 1;
+
+        bool operator==(const RenderTargetDesc& other) const
+        {
+            return width == other.width && height == other.height &&
+                   internal_format == other.internal_format && samples == other.samples;
+        }
+
+        bool operator!=(const RenderTargetDesc& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Статистика пула
+     */
+    struct RenderTargetPoolStats
+    {
+        // Запросов, удовлетворенных созданием новой текстуры и повторным использованием свободной
+        size_t created = 0;
+        size_t reused = 0;
+        // Удалено свободных текстур (давно не использовались либо размер вышел из списка недавних)
+        size_t evicted = 0;
+        // Текстур в пуле (занятых и свободных) и их память (байт)
+        size_t textures = 0;
+        size_t textures_in_use = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * Пул целей рендеринга
+     * Текстуры выдаются по описанию (размер, формат, кол-во выборок) и после освобождения остаются в пуле,
+     * повторный запрос с тем же описанием получает уже созданную текстуру вместо выделения памяти.
+     * Свободные текстуры удаляются, если не запрашивались заданное кол-во кадров, либо если их размер не входит
+     * в несколько последних запрошенных размеров (при плавном изменении размера окна не копятся промежуточные размеры,
+     * но возврат к недавнему размеру или масштабу обходится без выделения памяти)
+     */
+    class RenderTargetPool final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        RenderTargetPool()
+            : Resource()
+            , max_sizes_(0)
+            , max_idle_frames_(0)
+            , frame_(0)
+        {}
+
+        /**
+         * Основной конструктор (текстуры создаются по запросу)
+         * @param max_sizes Кол-во последних запрошенных размеров, свободные текстуры которых сохраняются
+         * @param max_idle_frames Кол-во кадров, в течении которых сохраняется не запрашиваемая свободная текстура
+         */
+        explicit RenderTargetPool(size_t max_sizes, size_t max_idle_frames = 300)
+            : Resource()
+            , max_sizes_(max_sizes)
+            , max_idle_frames_(max_idle_frames)
+            , frame_(0)
+        {
+            assert(max_sizes_ > 0);
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        RenderTargetPool(const RenderTargetPool& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        RenderTargetPool(RenderTargetPool&& other) noexcept
+            : RenderTargetPool()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~RenderTargetPool() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RenderTargetPool& operator=(const RenderTargetPool& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RenderTargetPool& operator=(RenderTargetPool&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(max_sizes_, other.max_sizes_);
+            std::swap(max_idle_frames_, other.max_idle_frames_);
+            std::swap(frame_, other.frame_);
+            std::swap(entries_, other.entries_);
+            std::swap(recent_sizes_, other.recent_sizes_);
+            std::swap(stats_, other.stats_);
+
+            return *this;
+        }
+
+        /**
+         * Получить текстуру (свободную из пула с тем же описанием, либо новую)
+         * @param desc Описание
+         * @return OpenGL дескриптор текстуры (занята до вызова release)
+         */
+        GLuint acquire(const RenderTargetDesc& desc)
+        {
+            assert(loaded_);
+            assert(desc.width > 0 && desc.height > 0 && desc.samples > 0);
+
+            touch_size(desc.width, desc.height);
+
+            for(auto& entry : entries_)
+            {
+                if(!entry.in_use && entry.desc == desc)
+                {
+                    entry.in_use = true;
+                    entry.last_frame = frame_;
+                    stats_.reused++;
+                    return entry.id;
+                }
+            }
+
+            Entry entry;
+            entry.desc = desc;
+            entry.in_use = true;
+            entry.last_frame = frame_;
+
+            if(desc.samples > 1)
+            {
+                glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &entry.id);
+                glTextureStorage2DMultisample(entry.id, desc.samples, desc.internal_format, desc.width, desc.height, GL_TRUE);
+            }
+            else
+            {
+                glCreateTextures(GL_TEXTURE_2D, 1, &entry.id);
+                glTextureStorage2D(entry.id, 1, desc.internal_format, desc.width, desc.height);
+                glTextureParameteri(entry.id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTextureParameteri(entry.id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTextureParameteri(entry.id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(entry.id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            }
+
+            entries_.push_back(entry);
+            stats_.created++;
+            return entry.id;
+        }
+
+        /**
+         * Вернуть текстуру в пул (содержимое не сохраняется, текстура может быть выдана другому запросу)
+         * @param texture_id OpenGL дескриптор, полученный от acquire
+         */
+        void release(GLuint texture_id)
+        {
+            for(auto& entry : entries_)
+            {
+                if(entry.id == texture_id)
+                {
+                    assert(entry.in_use);
+                    entry.in_use = false;
+                    entry.last_frame = frame_;
+                    return;
+                }
+            }
+            assert(false && "texture does not belong to the pool");
+        }
+
+        /**
+         * Завершение кадра (удаление давно не используемых свободных текстур)
+         * Вызывается один раз за кадр
+         */
+        void next_frame()
+        {
+            frame_++;
+            trim();
+        }
+
+        /**
+         * Удалить свободные текстуры, не запрашиваемые дольше заданного кол-ва кадров, либо с размером вне списка недавних
+         */
+        void trim()
+        {
+            auto it = std::remove_if(entries_.begin(), entries_.end(), [this](Entry& entry){
+                if(entry.in_use) return false;
+
+                const bool idle = frame_ - entry.last_frame > max_idle_frames_;
+                const bool recent = std::any_of(recent_sizes_.begin(), recent_sizes_.end(), [&](const Size& size){
+                    return size.width == entry.desc.width && size.height == entry.desc.height;
+                });
+                if(!idle && recent) return false;
+
+                glDeleteTextures(1, &entry.id);
+                stats_.evicted++;
+                return true;
+            });
+            entries_.erase(it, entries_.end());
+        }
+
+        /**
+         * Статистика (счетчики запросов накапливаются с момента создания)
+         * @return Статистика
+         */
+        [[nodiscard]] RenderTargetPoolStats stats() const
+        {
+            RenderTargetPoolStats stats = stats_;
+            stats.textures = entries_.size();
+            for(const auto& entry : entries_)
+            {
+                if(entry.in_use) stats.textures_in_use++;
+                stats.bytes += texture_pixel_size(entry.desc.internal_format) *
+                               static_cast<size_t>(entry.desc.samples) *
+                               static_cast<size_t>(entry.desc.width) *
+                               static_cast<size_t>(entry.desc.height);
+            }
+            return stats;
+        }
+
+        /**
+         * Выгрузка ресурса (удаляются все текстуры, в т.ч. занятые)
+         */
+        void unload() override
+        {
+            for(auto& entry : entries_)
+            {
+                glDeleteTextures(1, &entry.id);
+            }
+
+            entries_.clear();
+            recent_sizes_.clear();
+            stats_ = {};
+            frame_ = 0;
+            loaded_ = false;
+        }
+
+    private:
+        /**
+         * Текстура пула
+         */
+        struct Entry
+        {
+            GLuint id = 0;
+            RenderTargetDesc desc;
+            bool in_use = false;
+            // Кадр последней выдачи либо освобождения
+            uint64_t last_frame = 0;
+        };
+
+        /**
+         * Размер (элемент списка недавних размеров)
+         */
+        struct Size
+        {
+            GLsizei width = 0;
+            GLsizei height = 0;
+        };
+
+        /**
+         * Поднять размер в начало списка недавних (список ограничен max_sizes_)
+         * @param width Ширина
+         * @param height Высота
+         */
+        void touch_size(GLsizei width, GLsizei height)
+        {
+            auto it = std::find_if(recent_sizes_.begin(), recent_sizes_.end(), [&](const Size& size){
+                return size.width == width && size.height == height;
+            });
+            if(it != recent_sizes_.end()) recent_sizes_.erase(it);
+
+            recent_sizes_.insert(recent_sizes_.begin(), {width, height});
+            if(recent_sizes_.size() > max_sizes_) recent_sizes_.resize(max_sizes_);
+        }
+
+        // Кол-во сохраняемых размеров и кадров простоя
+        size_t max_sizes_;
+        size_t max_idle_frames_;
+
+        // Текущий кадр
+        uint64_t frame_;
+
+        // Текстуры (занятые и свободные)
+        std::vector<Entry> entries_;
+
+        // Недавно запрошенные размеры (от последнего к более ранним)
+        std::vector<Size> recent_sizes_;
+
+        // Счетчики запросов и удалений
+        RenderTargetPoolStats stats_;
+    };
+}
\ No newline at end of file
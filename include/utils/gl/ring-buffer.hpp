@@ -0,0 +1,313 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstring>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+
+#include "resource.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Выделенный участок кольцевого буфера
+     */
+    struct RingAllocation
+    {
+        // Указатель для записи (отображенная память буфера)
+        void* ptr = nullptr;
+        // Смещение участка от начала буфера (для glBindBufferRange и т.д.)
+        GLintptr offset = 0;
+        // Размер участка
+        GLsizeiptr size = 0;
+    };
+
+    /**
+     * Кольцевой буфер для потоковой передачи данных кадра (матрицы, источники света, вершины UI)
+     * Буфер неизменяемого размера постоянно отображен в память (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+     * и разделен на несколько областей - по одной на кадр. Пока GPU читает данные предыдущих кадров,
+     * CPU пишет в свободную область без синхронизации с драйвером. Область становится доступной
+     * для повторной записи после срабатывания барьера (fence), установленного в конце её кадра
+     */
+    class RingBuffer final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        RingBuffer()
+            : Resource()
+            , id_(0)
+            , data_(nullptr)
+            , region_size_(0)
+            , region_(0)
+            , head_(0)
+            , stalls_(0)
+        {}
+
+        /**
+         * Основной конструктор (создает OpenGL ресурсы)
+         * @param region_size Размер области одного кадра (байт)
+         * @param region_count Кол-во областей (кадров, которые могут одновременно находиться в обработке)
+         */
+        explicit RingBuffer(GLsizeiptr region_size, size_t region_count = 3)
+            : Resource()
+            , id_(0)
+            , data_(nullptr)
+            , region_size_(region_size)
+            , region_(0)
+            , head_(0)
+            , stalls_(0)
+            , fences_(region_count, nullptr)
+        {
+            // Убедиться в корректности данных
+            assert(region_size_ > 0);
+            assert(region_count > 0);
+
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const auto size = static_cast<GLsizeiptr>(region_size_ * region_count);
+
+            // Неизменяемое хранилище (размер и флаги нельзя поменять после создания)
+            glCreateBuffers(1, &id_);
+            glNamedBufferStorage(id_, size, nullptr, flags);
+
+            // Отобразить буфер единожды на все время жизни
+            data_ = static_cast<unsigned char*>(glMapNamedBufferRange(id_, 0, size, flags));
+            if(!data_)
+            {
+                glDeleteBuffers(1, &id_);
+                id_ = 0;
+                throw std::runtime_error("[GL] can't map ring buffer");
+            }
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        RingBuffer(const RingBuffer& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        RingBuffer(RingBuffer&& other) noexcept
+            : RingBuffer()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~RingBuffer() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RingBuffer& operator=(const RingBuffer& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        RingBuffer& operator=(RingBuffer&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(id_, other.id_);
+            std::swap(data_, other.data_);
+            std::swap(region_size_, other.region_size_);
+            std::swap(region_, other.region_);
+            std::swap(head_, other.head_);
+            std::swap(stalls_, other.stalls_);
+            std::swap(fences_, other.fences_);
+
+            return *this;
+        }
+
+        /**
+         * Начать кадр (перейти к следующей области)
+         * Если GPU еще не закончил читать область, выполняется ожидание её барьера
+         */
+        void begin_frame()
+        {
+            assert(loaded_);
+
+            region_ = (region_ + 1) % fences_.size();
+            head_ = 0;
+
+            GLsync& fence = fences_[region_];
+            if(fence)
+            {
+                // Проверка без ожидания, затем ожидание с отправкой команд (иначе барьер может не сработать никогда)
+                GLenum result = glClientWaitSync(fence, 0, 0);
+                if(result == GL_TIMEOUT_EXPIRED)
+                {
+                    stalls_++;
+                    do
+                    {
+                        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+                    }
+                    while(result == GL_TIMEOUT_EXPIRED);
+                }
+
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        /**
+         * Завершить кадр (установить барьер после всех команд, использующих текущую область)
+         */
+        void end_frame()
+        {
+            assert(loaded_);
+            assert(fences_[region_] == nullptr);
+
+            fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        /**
+         * Выделить участок в области текущего кадра
+         * @param size Размер участка (байт)
+         * @param alignment Выравнивание смещения (например GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+         * @return Выделенный участок
+         */
+        RingAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16)
+        {
+            assert(loaded_);
+            assert(alignment > 0);
+
+            const GLsizeiptr offset = (head_ + alignment - 1) / alignment * alignment;
+            if(offset + size > region_size_)
+            {
+                throw std::runtime_error("[GL] ring buffer region overflow");
+            }
+            head_ = offset + size;
+
+            const GLsizeiptr global = region_size_ * static_cast<GLsizeiptr>(region_) + offset;
+
+            RingAllocation allocation;
+            allocation.ptr = data_ + global;
+            allocation.offset = static_cast<GLintptr>(global);
+            allocation.size = size;
+            return allocation;
+        }
+
+        /**
+         * Скопировать массив в область текущего кадра
+         * @tparam T Тип элемента
+         * @param data Массив данных
+         * @param alignment Выравнивание смещения
+         * @return Выделенный участок
+         */
+        template <class T>
+        RingAllocation write(const std::vector<T>& data, GLsizeiptr alignment = 16)
+        {
+            const auto size = static_cast<GLsizeiptr>(sizeof(T) * data.size());
+            const RingAllocation allocation = allocate(size, alignment);
+            std::memcpy(allocation.ptr, data.data(), static_cast<size_t>(size));
+            return allocation;
+        }
+
+        /**
+         * Привязать участок к индексированной точке привязки
+         * @param target Точка привязки (GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER)
+         * @param index Индекс точки привязки
+         * @param allocation Выделенный участок
+         */
+        void bind_range(GLenum target, GLuint index, const RingAllocation& allocation) const
+        {
+            glBindBufferRange(target, index, id_, allocation.offset, allocation.size);
+        }
+
+        /**
+         * Получить OpenGL дескриптор буфера
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint id() const
+        {
+            return id_;
+        }
+
+        /**
+         * Получить размер области одного кадра
+         * @return Размер (байт)
+         */
+        [[nodiscard]] GLsizeiptr region_size() const
+        {
+            return region_size_;
+        }
+
+        /**
+         * Получить кол-во байт, занятых в области текущего кадра
+         * @return Размер (байт)
+         */
+        [[nodiscard]] GLsizeiptr used() const
+        {
+            return head_;
+        }
+
+        /**
+         * Получить кол-во ожиданий GPU (CPU опередил GPU больше чем на кол-во областей)
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t stalls() const
+        {
+            return stalls_;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            for(auto& fence : fences_)
+            {
+                if(fence) glDeleteSync(fence);
+                fence = nullptr;
+            }
+
+            if (id_)
+            {
+                glUnmapNamedBuffer(id_);
+                glDeleteBuffers(1, &id_);
+            }
+
+            id_ = 0;
+            data_ = nullptr;
+            region_size_ = 0;
+            region_ = 0;
+            head_ = 0;
+            stalls_ = 0;
+            fences_.clear();
+
+            loaded_ = false;
+        }
+
+    private:
+        GLuint id_;                     // OpenGL дескриптор буфера
+        unsigned char* data_;           // Отображенная память буфера
+        GLsizeiptr region_size_;        // Размер области одного кадра
+        size_t region_;                 // Индекс области текущего кадра
+        GLsizeiptr head_;               // Занятая часть области текущего кадра
+        size_t stalls_;                 // Кол-во ожиданий GPU
+
+        std::vector<GLsync> fences_;    // Барьеры областей (nullptr - область свободна)
+    };
+}
\ No newline at end of file
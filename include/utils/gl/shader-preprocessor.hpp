@@ -0,0 +1,393 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../files/load.hpp"
+#include "../threads/job-system.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Препроцессор исходников GLSL
+     * Раскрывает директивы #include "file", поддерживает #pragma once и ведет граф зависимостей файлов.
+     * Результат кешируется по хешу содержимого всех файлов участвующих в сборке исходника.
+     * Для каждого корневого исходника хранится только последний результат (устаревшие вытесняются при пересборке).
+     * Методы потокобезопасны, исходники могут обрабатываться параллельно (см. process_all)
+     */
+    class ShaderPreprocessor
+    {
+    public:
+        /**
+         * Основной конструктор
+         * @param include_dirs Каталоги для поиска подключаемых файлов (после каталога подключающего файла)
+         */
+        explicit ShaderPreprocessor(std::vector<std::string> include_dirs = {})
+            : include_dirs_(std::move(include_dirs))
+        {}
+
+        /**
+         * Обработать исходник
+         * @param path Путь к файлу исходника
+         * @return Исходный текст с раскрытыми директивами #include
+         */
+        std::string process(const std::string& path)
+        {
+            const std::string root = normalize(path);
+
+            // Ключ результата - хеш содержимого корневого файла и всех его зависимостей
+            std::vector<std::string> files;
+            collect_dependencies(root, files);
+
+            uint64_t key = kFnvOffset;
+            for(const auto& f : files) key = hash_combine(key, file(f)->hash);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(auto it = outputs_.find(key); it != outputs_.end())
+                {
+                    bind_output(root, key);
+                    return it->second;
+                }
+            }
+
+            // Раскрыть подключения (индекс файла в списке используется директивой #line)
+            std::string output;
+            std::unordered_set<std::string> once;
+            std::vector<std::string> stack;
+            expand(root, files, once, stack, output);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            outputs_.emplace(key, output);
+            bind_output(root, key);
+            return output;
+        }
+
+        /**
+         * Обработать набор исходников параллельно в рабочих потоках
+         * @param jobs Система задач
+         * @param paths Пути к файлам исходников
+         * @return Обработанные исходники (в порядке путей)
+         */
+        std::vector<std::string> process_all(threads::JobSystem& jobs, const std::vector<std::string>& paths)
+        {
+            std::vector<std::string> results(paths.size());
+            jobs.parallel_for(paths.size(), 1, [&](size_t begin, size_t end)
+            {
+                for(size_t i = begin; i < end; i++) results[i] = process(paths[i]);
+            });
+            return results;
+        }
+
+        /**
+         * Получить список всех файлов, от которых зависит исходник (включая его самого)
+         * @param path Путь к файлу исходника
+         * @return Список путей (корневой файл первый)
+         */
+        std::vector<std::string> dependencies(const std::string& path)
+        {
+            std::vector<std::string> files;
+            collect_dependencies(normalize(path), files);
+            return files;
+        }
+
+        /**
+         * Получить список обработанных ранее исходников, затронутых изменением файла
+         * Используется для выборочной пересборки программ (горячая перезагрузка, кеш бинарников)
+         * @param path Путь к измененному файлу
+         * @return Список путей корневых исходников
+         */
+        std::vector<std::string> affected(const std::string& path)
+        {
+            const std::string changed = normalize(path);
+
+            std::vector<std::string> roots;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for(const auto& [root, key] : roots_) roots.push_back(root);
+            }
+
+            std::vector<std::string> result;
+            for(const auto& root : roots)
+            {
+                for(const auto& dep : dependencies(root))
+                {
+                    if(dep == changed)
+                    {
+                        result.push_back(root);
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Сбросить закешированное содержимое файла (при следующем обращении файл будет перечитан)
+         * Если содержимое не изменилось, обработанные исходники будут взяты из кеша (хеш совпадет)
+         * @param path Путь к файлу
+         * @return Список путей корневых исходников, затронутых изменением
+         */
+        std::vector<std::string> invalidate(const std::string& path)
+        {
+            auto result = affected(path);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            files_.erase(normalize(path));
+            return result;
+        }
+
+        /**
+         * Хеш строки (FNV-1a, 64 бит)
+         * @param text Строка
+         * @return Значение хеша
+         */
+        static uint64_t hash(const std::string& text)
+        {
+            uint64_t h = kFnvOffset;
+            for(const unsigned char c : text)
+            {
+                h ^= c;
+                h *= kFnvPrime;
+            }
+            return h;
+        }
+
+    protected:
+        /**
+         * Закешированный файл
+         */
+        struct File
+        {
+            // Содержимое файла
+            std::string text;
+            // Хеш содержимого
+            uint64_t hash = 0;
+            // Нормализованные пути подключаемых файлов (прямые зависимости, в порядке подключения)
+            std::vector<std::string> includes;
+            // Номера строк с директивами #include (соответствуют includes)
+            std::vector<size_t> include_lines;
+            // Файл помечен #pragma once
+            bool once = false;
+        };
+
+        /**
+         * Нормализация пути (используется как ключ в кешах и графе)
+         * @param path Путь
+         * @return Нормализованный путь
+         */
+        static std::string normalize(const std::string& path)
+        {
+            return std::filesystem::path(path).lexically_normal().generic_string();
+        }
+
+        /**
+         * Разобрать строку на предмет директивы препроцессора
+         * @param line Строка
+         * @param directive Имя директивы (без #)
+         * @param argument Аргумент директивы (остаток строки)
+         * @return Найдена ли директива
+         */
+        static bool parse_directive(const std::string& line, const std::string& directive, std::string* argument)
+        {
+            size_t i = line.find_first_not_of(" \t");
+            if(i == std::string::npos || line[i] != '#') return false;
+            i = line.find_first_not_of(" \t", i + 1);
+            if(i == std::string::npos || line.compare(i, directive.size(), directive) != 0) return false;
+            i += directive.size();
+            if(i < line.size() && line[i] != ' ' && line[i] != '\t') return false;
+            if(argument)
+            {
+                const size_t b = line.find_first_not_of(" \t", i);
+                const size_t e = line.find_last_not_of(" \t\r");
+                *argument = (b == std::string::npos || e < b) ? "" : line.substr(b, e - b + 1);
+            }
+            return true;
+        }
+
+        /**
+         * Найти подключаемый файл
+         * @param from Путь подключающего файла
+         * @param name Имя из директивы #include
+         * @return Нормализованный путь
+         */
+        [[nodiscard]] std::string resolve(const std::string& from, const std::string& name) const
+        {
+            const auto local = std::filesystem::path(from).parent_path() / name;
+            if(std::filesystem::exists(local)) return normalize(local.string());
+
+            for(const auto& dir : include_dirs_)
+            {
+                const auto candidate = std::filesystem::path(dir) / name;
+                if(std::filesystem::exists(candidate)) return normalize(candidate.string());
+            }
+
+            throw std::runtime_error("[GLSL] cant resolve include \"" + name + "\" in \"" + from + "\"");
+        }
+
+        /**
+         * Получить файл из кеша (при отсутствии - загрузить и разобрать)
+         * @param path Нормализованный путь
+         * @return Указатель на неизменяемую запись кеша
+         */
+        std::shared_ptr<const File> file(const std::string& path)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(auto it = files_.find(path); it != files_.end()) return it->second;
+            }
+
+            // Загрузка и разбор выполняются без блокировки (файлы могут читаться параллельно)
+            auto entry = std::make_shared<File>();
+            entry->text = files::load_as_text(path);
+            entry->hash = hash(entry->text);
+
+            std::istringstream stream(entry->text);
+            std::string line, argument;
+            for(size_t n = 1; std::getline(stream, line); n++)
+            {
+                if(parse_directive(line, "include", &argument))
+                {
+                    if(argument.size() < 2 || argument.front() != '"' || argument.back() != '"')
+                    {
+                        throw std::runtime_error("[GLSL] malformed include in \"" + path + "\" (line " + std::to_string(n) + ")");
+                    }
+                    entry->includes.push_back(resolve(path, argument.substr(1, argument.size() - 2)));
+                    entry->include_lines.push_back(n);
+                }
+                else if(parse_directive(line, "pragma", &argument) && argument == "once")
+                {
+                    entry->once = true;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            return files_.emplace(path, std::move(entry)).first->second;
+        }
+
+        /**
+         * Собрать список файлов, от которых зависит исходник (обход графа в глубину)
+         * @param path Нормализованный путь
+         * @param out_files Список файлов (каждый файл единожды, в порядке обхода)
+         */
+        void collect_dependencies(const std::string& path, std::vector<std::string>& out_files)
+        {
+            if(std::find(out_files.begin(), out_files.end(), path) != out_files.end()) return;
+            out_files.push_back(path);
+
+            for(const auto& inc : file(path)->includes)
+            {
+                collect_dependencies(inc, out_files);
+            }
+        }
+
+        /**
+         * Раскрыть подключения файла
+         * @param path Нормализованный путь
+         * @param files Список всех файлов исходника (индекс файла - номер источника для #line)
+         * @param once Файлы с #pragma once, которые уже были подключены
+         * @param stack Стек подключений (для обнаружения циклов)
+         * @param output Итоговый текст
+         */
+        void expand(const std::string& path,
+                    const std::vector<std::string>& files,
+                    std::unordered_set<std::string>& once,
+                    std::vector<std::string>& stack,
+                    std::string& output)
+        {
+            // Повторное подключение файла с #pragma once пропускается (в том числе взаимное подключение)
+            const auto entry = file(path);
+            if(entry->once && !once.insert(path).second) return;
+
+            if(std::find(stack.begin(), stack.end(), path) != stack.end())
+            {
+                throw std::runtime_error("[GLSL] circular include of \"" + path + "\"");
+            }
+
+            stack.push_back(path);
+            const size_t index = std::find(files.begin(), files.end(), path) - files.begin();
+
+            std::istringstream stream(entry->text);
+            std::string line;
+            size_t include_index = 0;
+            for(size_t n = 1; std::getline(stream, line); n++)
+            {
+                if(include_index < entry->include_lines.size() && entry->include_lines[include_index] == n)
+                {
+                    // Содержимое подключаемого файла, затем восстановление нумерации текущего файла
+                    const auto& inc = entry->includes[include_index++];
+                    const size_t inc_index = std::find(files.begin(), files.end(), inc) - files.begin();
+                    output += "#line 1 " + std::to_string(inc_index) + "\n";
+                    expand(inc, files, once, stack, output);
+                    output += "#line " + std::to_string(n + 1) + " " + std::to_string(index) + "\n";
+                }
+                else if(parse_directive(line, "pragma", nullptr) && line.find("once") != std::string::npos)
+                {
+                    output += "\n";
+                }
+                else
+                {
+                    output += line;
+                    output += "\n";
+                }
+            }
+
+            stack.pop_back();
+        }
+
+        /**
+         * Связать корневой исходник с результатом (вызывается под блокировкой)
+         * Прежний результат исходника удаляется, если на него не ссылаются другие исходники
+         * @param root Нормализованный путь корневого исходника
+         * @param key Ключ результата
+         */
+        void bind_output(const std::string& root, uint64_t key)
+        {
+            auto [it, inserted] = roots_.try_emplace(root, key);
+            if(inserted || it->second == key) return;
+
+            const uint64_t stale = it->second;
+            it->second = key;
+            for(const auto& [other, other_key] : roots_)
+            {
+                if(other_key == stale) return;
+            }
+            outputs_.erase(stale);
+        }
+
+        /**
+         * Комбинирование хешей
+         * @param seed Текущее значение
+         * @param value Добавляемое значение
+         * @return Новое значение
+         */
+        static uint64_t hash_combine(uint64_t seed, uint64_t value)
+        {
+            for(int i = 0; i < 8; i++)
+            {
+                seed ^= (value >> (i * 8)) & 0xFFu;
+                seed *= kFnvPrime;
+            }
+            return seed;
+        }
+
+    private:
+        static constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+        static constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+        std::vector<std::string> include_dirs_;                                  // Каталоги поиска подключаемых файлов
+        std::unordered_map<std::string, std::shared_ptr<const File>> files_;     // Кеш файлов (узлы графа зависимостей)
+        std::unordered_map<uint64_t, std::string> outputs_;                      // Кеш результатов (по хешу содержимого)
+        std::unordered_map<std::string, uint64_t> roots_;                        // Обработанные корневые исходники (ключи результатов)
+        std::mutex mutex_;                                                       // Защита кешей
+    };
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cassert>
+#include <stdexcept>
+
+#include "shader.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Набор вариантов (перестановок) шейдерной программы
+     * Все варианты собираются из одних исходников, но с разными макро-определениями.
+     * Вариант компилируется при первом запросе и далее хранится в кеше программ.
+     * Размер кеша ограничен: при переполнении выгружается вариант, который дольше всех не запрашивался.
+     * Вариант, который не удалось собрать, запоминается (повторно не компилируется), вместо него
+     * возвращается последний успешно полученный вариант.
+     * @tparam L Структура с идентификаторами uniform-переменных
+     * @tparam T Тип полей вышеупомянутой структуры
+     */
+    template <class L, typename T>
+    class ShaderVariants final : public Resource
+    {
+    public:
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурс OpenGL, создает пустой объект
+         */
+        ShaderVariants()
+            : Resource()
+            , max_variants_(0)
+            , use_counter_(0)
+        {}
+
+        /**
+         * Основной конструктор
+         * Ресурсы OpenGL не создаются, программы компилируются по мере запроса вариантов
+         * @param sources Ассоциативный массив исходников (тип - исходник)
+         * @param uniforms Наименования uniform переменных в шейдере (с учетом порядка и кол-ва в структуре L)
+         * @param max_variants Наибольшее кол-во одновременно хранимых вариантов
+         */
+        ShaderVariants(std::unordered_map<GLuint, std::string> sources, std::vector<std::string> uniforms, size_t max_variants = 32)
+            : Resource()
+            , sources_(std::move(sources))
+            , uniforms_(std::move(uniforms))
+            , max_variants_(max_variants)
+            , use_counter_(0)
+        {
+            assert(max_variants_ > 0);
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        ShaderVariants(const ShaderVariants& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        ShaderVariants(ShaderVariants&& other) noexcept
+            : Resource(std::move(other))
+            , sources_(std::move(other.sources_))
+            , uniforms_(std::move(other.uniforms_))
+            , max_variants_(other.max_variants_)
+            , use_counter_(other.use_counter_)
+            , variants_(std::move(other.variants_))
+            , failed_(std::move(other.failed_))
+            , fallback_(std::move(other.fallback_))
+            , stale_(std::move(other.stale_))
+        {}
+
+        /**
+         * Уничтожает OpenGL ресурсы всех скомпилированных вариантов
+         */
+        ~ShaderVariants() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        ShaderVariants& operator=(const ShaderVariants& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        ShaderVariants& operator=(ShaderVariants&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(sources_, other.sources_);
+            std::swap(uniforms_, other.uniforms_);
+            std::swap(max_variants_, other.max_variants_);
+            std::swap(use_counter_, other.use_counter_);
+            std::swap(variants_, other.variants_);
+            std::swap(failed_, other.failed_);
+            std::swap(fallback_, other.fallback_);
+            std::swap(stale_, other.stale_);
+
+            return *this;
+        }
+
+        /**
+         * Получить вариант программы для набора макро-определений
+         * Если вариант еще не был собран - он компилируется и помещается в кеш (при переполнении кеша
+         * вытесняя самый давно запрошенный вариант).
+         * Если вариант не собирается - ошибка запоминается и возвращается последний успешно полученный вариант.
+         * Ссылка остается действительной до следующего вызова get, reload либо выгрузки набора
+         * @param defines Макро-определения
+         * @return Ссылка на шейдерную программу
+         * @throws std::runtime_error Вариант не собирается, а успешно полученных вариантов еще нет
+         */
+        const Shader<L, T>& get(const ShaderDefines& defines)
+        {
+            assert(loaded_);
+
+            const std::string key = make_key(defines);
+            auto it = variants_.find(key);
+            if(it == variants_.end())
+            {
+                const auto failed = failed_.find(key);
+                if(failed != failed_.end()) return get_fallback(failed->second);
+
+                try
+                {
+                    Shader<L, T> shader(sources_, uniforms_, defines);
+                    if(variants_.size() >= max_variants_) evict();
+                    it = variants_.emplace(key, Variant{std::move(shader), 0}).first;
+                    stale_ = Shader<L, T>();
+                }
+                catch(const std::runtime_error& ex)
+                {
+                    return get_fallback(failed_.emplace(key, ex.what()).first->second);
+                }
+            }
+
+            it->second.last_use = ++use_counter_;
+            fallback_ = key;
+            return it->second.shader;
+        }
+
+        /**
+         * Заменить исходники (горячая перезагрузка)
+         * Все скомпилированные варианты выгружаются и будут собраны из новых исходников при запросе.
+         * Последний успешно полученный вариант сохраняется как запасной, пока не соберется хотя бы один новый
+         * @param sources Ассоциативный массив исходников (тип - исходник)
+         */
+        void reload(std::unordered_map<GLuint, std::string> sources)
+        {
+            assert(loaded_);
+            sources_ = std::move(sources);
+
+            const auto it = variants_.find(fallback_);
+            if(it != variants_.end()) stale_ = std::move(it->second.shader);
+
+            variants_.clear();
+            failed_.clear();
+        }
+
+        /**
+         * Кол-во скомпилированных вариантов
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t variant_count() const
+        {
+            return variants_.size();
+        }
+
+        /**
+         * Варианты, которые не удалось собрать
+         * @return Ассоциативный массив (ключ варианта - текст ошибки)
+         */
+        [[nodiscard]] const std::unordered_map<std::string, std::string>& failures() const
+        {
+            return failed_;
+        }
+
+        /**
+         * Выгрузка ресурса (всех скомпилированных вариантов)
+         */
+        void unload() override
+        {
+            variants_.clear();
+            failed_.clear();
+            fallback_.clear();
+            stale_ = Shader<L, T>();
+            sources_.clear();
+            uniforms_.clear();
+            loaded_ = false;
+        }
+
+    protected:
+        /**
+         * Получить ключ варианта по набору макро-определений
+         * @param defines Макро-определения
+         * @return Строка-ключ
+         */
+        static std::string make_key(const ShaderDefines& defines)
+        {
+            std::string key;
+            for(const auto& [name, value] : defines)
+            {
+                key += name;
+                key += '=';
+                key += value;
+                key += ';';
+            }
+            return key;
+        }
+
+        /**
+         * Последний успешно полученный вариант (вместо несобираемого)
+         * @param error Ошибка сборки запрошенного варианта
+         * @return Ссылка на шейдерную программу
+         * @throws std::runtime_error Успешно полученных вариантов еще нет
+         */
+        const Shader<L, T>& get_fallback(const std::string& error)
+        {
+            const auto it = variants_.find(fallback_);
+            if(it == variants_.end())
+            {
+                if(stale_.ready()) return stale_;
+                throw std::runtime_error(error);
+            }
+
+            it->second.last_use = ++use_counter_;
+            return it->second.shader;
+        }
+
+        /**
+         * Выгрузить вариант, который дольше всех не запрашивался (кроме запасного)
+         */
+        void evict()
+        {
+            auto oldest = variants_.begin();
+            for(auto it = variants_.begin(); it != variants_.end(); ++it)
+            {
+                if(it->first != fallback_ && (oldest->first == fallback_ || it->second.last_use < oldest->second.last_use)) oldest = it;
+            }
+            if(oldest != variants_.end()) variants_.erase(oldest);
+        }
+
+    private:
+        /**
+         * Скомпилированный вариант
+         */
+        struct Variant
+        {
+            Shader<L, T> shader;
+            // Номер последнего запроса варианта
+            uint64_t last_use;
+        };
+
+        std::unordered_map<GLuint, std::string> sources_;             // Исходники программы
+        std::vector<std::string> uniforms_;                           // Наименования uniform-переменных
+        size_t max_variants_;                                         // Наибольшее кол-во хранимых вариантов
+        uint64_t use_counter_;                                        // Счетчик запросов (для вытеснения)
+        std::unordered_map<std::string, Variant> variants_;           // Кеш скомпилированных вариантов
+        std::unordered_map<std::string, std::string> failed_;         // Несобираемые варианты (ключ - ошибка)
+        std::string fallback_;                                        // Ключ последнего успешно полученного варианта
+        Shader<L, T> stale_;                                          // Запасной вариант из прежних исходников
+    };
+}
\ No newline at end of file
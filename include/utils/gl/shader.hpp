@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <map>
 #include <unordered_map>
 #include <cassert>
 
@@ -13,6 +14,12 @@
 
 namespace utils::gl
 {
+    /**
+     * Набор макро-определений для специализации шейдера (имя - значение)
+     * Упорядоченный контейнер дает одинаковый порядок (и ключ) для одинаковых наборов
+     */
+    using ShaderDefines = std::map<std::string, std::string>;
+
     /**
      * Обертка над шейдерной программой
      * @tparam L Структура с идентификаторами uniform-переменных
@@ -36,8 +43,11 @@ namespace utils::gl
          * Основной конструктор
          * @param sources Ассоциативный массив исходников (тип - исходник)
          * @param uniforms Наименования uniform переменных в шейдере (с учетом порядка и кол-ва в структуре L)
+         * @param defines Макро-определения, добавляемые в каждый исходник (специализация шейдера)
          */
-        Shader(const std::unordered_map<GLuint, std::string>& sources, const std::vector<std::string>& uniforms)
+        Shader(const std::unordered_map<GLuint, std::string>& sources,
+               const std::vector<std::string>& uniforms,
+               const ShaderDefines& defines = {})
             : Resource()
             , id_(0)
             , locations_({})
@@ -49,7 +59,7 @@ namespace utils::gl
             std::vector<GLuint> shader_ids;
             for(auto& [type, source] : sources)
             {
-                GLuint sid = compile_shader_source(type, source);
+                GLuint sid = compile_shader_source(type, defines.empty() ? source : inject_defines(source, defines));
                 glAttachShader(this->id_, sid);
                 shader_ids.push_back(sid);
             }
@@ -171,6 +181,40 @@ namespace utils::gl
             locations_ = {};
         }
 
+        /**
+         * Добавить макро-определения в исходный текст шейдера
+         * Определения вставляются сразу после директивы #version (она должна быть первой в исходнике),
+         * директива #line сохраняет исходную нумерацию строк в сообщениях об ошибках
+         * @param source Исходный текст шейдера
+         * @param defines Макро-определения
+         * @return Исходный текст с определениями
+         */
+        static std::string inject_defines(const std::string& source, const ShaderDefines& defines)
+        {
+            // Позиция начала строки, следующей за #version (либо начало исходника, если директивы нет)
+            size_t insert_pos = 0;
+            size_t line = 1;
+            if(const size_t version_pos = source.find("#version"); version_pos != std::string::npos)
+            {
+                const size_t eol = source.find('\n', version_pos);
+                insert_pos = eol == std::string::npos ? source.size() : eol + 1;
+                for(size_t i = 0; i < insert_pos; i++) if(source[i] == '\n') line++;
+            }
+
+            std::string block;
+            for(const auto& [name, value] : defines)
+            {
+                block += "#define " + name + " " + value + "\n";
+            }
+            block += "#line " + std::to_string(line) + "\n";
+
+            std::string result = source.substr(0, insert_pos);
+            if(!result.empty() && result.back() != '\n') result += '\n';
+            result += block;
+            result += source.substr(insert_pos);
+            return result;
+        }
+
     protected:
         /**
          * Получить указатель на поле в структуре uniform-переменных
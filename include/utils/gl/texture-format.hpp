@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace utils::gl
+{
+    /**
+     * Тип данных для загрузки (glTexImage2D) по внутреннему формату
+     * Тип должен быть совместим с форматом даже при отсутствии данных (nullptr), иначе GL_INVALID_OPERATION
+     * (например GL_FLOAT недопустим для целочисленных форматов и GL_DEPTH_STENCIL)
+     * @param internal_format Внутренний формат
+     * @return Тип данных
+     */
+    inline GLenum texture_upload_type(GLint internal_format)
+    {
+        switch(internal_format)
+        {
+            // Целочисленные
+            case GL_R8UI: case GL_RG8UI: case GL_RGB8UI: case GL_RGBA8UI:
+                return GL_UNSIGNED_BYTE;
+            case GL_R16UI: case GL_RG16UI: case GL_RGB16UI: case GL_RGBA16UI:
+                return GL_UNSIGNED_SHORT;
+            case GL_R32UI: case GL_RG32UI: case GL_RGB32UI: case GL_RGBA32UI:
+                return GL_UNSIGNED_INT;
+            case GL_R8I: case GL_RG8I: case GL_RGB8I: case GL_RGBA8I:
+                return GL_BYTE;
+            case GL_R16I: case GL_RG16I: case GL_RGB16I: case GL_RGBA16I:
+                return GL_SHORT;
+            case GL_R32I: case GL_RG32I: case GL_RGB32I: case GL_RGBA32I:
+                return GL_INT;
+
+            // С плавающей точкой
+            case GL_R16F: case GL_RG16F: case GL_RGB16F: case GL_RGBA16F:
+                return GL_HALF_FLOAT;
+            case GL_R32F: case GL_RG32F: case GL_RGB32F: case GL_RGBA32F:
+            case GL_R11F_G11F_B10F: case GL_RGB9_E5:
+                return GL_FLOAT;
+
+            // Упакованные
+            case GL_RGB10_A2: case GL_RGB10_A2UI:
+                return GL_UNSIGNED_INT_2_10_10_10_REV;
+
+            // Глубина и трафарет
+            case GL_DEPTH_COMPONENT16:
+                return GL_UNSIGNED_SHORT;
+            case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32:
+                return GL_UNSIGNED_INT;
+            case GL_DEPTH_COMPONENT: case GL_DEPTH_COMPONENT32F:
+                return GL_FLOAT;
+            case GL_DEPTH_STENCIL: case GL_DEPTH24_STENCIL8:
+                return GL_UNSIGNED_INT_24_8;
+            case GL_DEPTH32F_STENCIL8:
+                return GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+
+            // Нормализованные (GL_RGBA8, GL_SRGB8_ALPHA8, GL_RGBA и т.д.)
+            default:
+                return GL_UNSIGNED_BYTE;
+        }
+    }
+
+    /**
+     * Вложение глубины для формата
+     * @param internal_format Внутренний формат
+     * @return GL_DEPTH_ATTACHMENT, GL_DEPTH_STENCIL_ATTACHMENT, либо GL_NONE для цветовых форматов
+     */
+    inline GLenum texture_depth_attachment(GLenum internal_format)
+    {
+        switch(internal_format)
+        {
+            case GL_DEPTH_COMPONENT16:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32:
+            case GL_DEPTH_COMPONENT32F:
+                return GL_DEPTH_ATTACHMENT;
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH32F_STENCIL8:
+                return GL_DEPTH_STENCIL_ATTACHMENT;
+            default:
+                return GL_NONE;
+        }
+    }
+
+    /**
+     * Приблизительный размер пикселя в памяти
+     * @param internal_format Внутренний формат (с явным размером)
+     * @return Размер (байт)
+     */
+    inline size_t texture_pixel_size(GLenum internal_format)
+    {
+        switch(internal_format)
+        {
+            case GL_R8: case GL_R8UI: case GL_R8I:
+                return 1;
+            case GL_RG8: case GL_R16F: case GL_R16UI: case GL_R16I: case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGB16F:
+                return 6;
+            case GL_RGBA16F: case GL_RG32F: case GL_RGBA16UI: case GL_RG32UI: case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGB32F:
+                return 12;
+            case GL_RGBA32F: case GL_RGBA32UI:
+                return 16;
+            default:
+                return 4;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cassert>
+
+#include "resource.hpp"
+
+namespace utils::gl
+{
+    /**
+     * Описание атрибута вершины для шейдера
+     */
+    struct VertexAttributeInfo
+    {
+        // Номер положения (location у шейдера)
+        GLuint location = 0;
+        // Кол-во компонентов (например, для vec3 будет 3 компонента)
+        GLint component_count = 0;
+        // Тип компонентов (float, int, прочие, в т.ч. упакованные - GL_HALF_FLOAT, GL_INT_2_10_10_10_REV)
+        GLenum component_type = GL_FLOAT;
+        // Автоматически нормализовать перед подачей в шейдер
+        GLboolean normalize = GL_FALSE;
+        // Сдвиг для атрибута в одной структуре вершины
+        GLsizeiptr offset = 0;
+        // Делитель (0 - атрибут вершины, N - атрибут экземпляра, меняется каждые N экземпляров)
+        GLuint divisor = 0;
+    };
+
+    /**
+     * Формат вершин (vertex array object без привязки к конкретным буферам)
+     * Описание атрибутов отделено от буферов: атрибуты вершины читаются из точки привязки VERTEX_BINDING,
+     * атрибуты экземпляра - из INSTANCE_BINDING. Буферы подключаются к точкам привязки отдельно,
+     * поэтому один объект может использоваться для всех мешей с одинаковой раскладкой вершин.
+     * Все вызовы используют DSA и не меняют текущих привязок контекста
+     */
+    class VertexFormat final : public Resource
+    {
+    public:
+        /**
+         * Точка привязки буфера вершин
+         */
+        constexpr static GLuint VERTEX_BINDING = 0;
+
+        /**
+         * Точка привязки буфера экземпляров
+         */
+        constexpr static GLuint INSTANCE_BINDING = 1;
+
+        /**
+         * Конструктор по умолчанию
+         * Не создает ресурсов OpenGL, создает пустой объект
+         */
+        VertexFormat()
+            : Resource()
+            , vao_id_(0)
+            , vertex_stride_(0)
+            , instance_stride_(0)
+        {}
+
+        /**
+         * Основной конструктор (создает OpenGL ресурсы)
+         * @param attributes Список описаний атрибутов вершины для шейдера
+         * @param stride Размер структуры вершины
+         */
+        VertexFormat(const std::vector<VertexAttributeInfo>& attributes, GLsizei stride)
+            : Resource()
+            , vao_id_(0)
+            , vertex_stride_(stride)
+            , instance_stride_(0)
+        {
+            assert(vertex_stride_ > 0);
+
+            glCreateVertexArrays(1, &vao_id_);
+            setup_attributes(attributes, VERTEX_BINDING);
+
+            // Готово к использованию
+            loaded_ = true;
+        }
+
+        /**
+         * Запрет копирования через конструктор (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         */
+        VertexFormat(const VertexFormat& other) = delete;
+
+        /**
+         * Перемещение через конструктор (при конструировании из rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         */
+        VertexFormat(VertexFormat&& other) noexcept
+            : Resource(std::move(other))
+            , vao_id_(other.vao_id_)
+            , vertex_stride_(other.vertex_stride_)
+            , instance_stride_(other.instance_stride_)
+        {
+            other.vao_id_ = 0;
+            other.vertex_stride_ = 0;
+            other.instance_stride_ = 0;
+        }
+
+        /**
+         * Уничтожает OpenGL ресурсы
+         */
+        ~VertexFormat() override
+        {
+            unload();
+        }
+
+        /**
+         * Запрет копирования через присвоение (нет смысла копировать многократно используемый ресурс)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        VertexFormat& operator=(const VertexFormat& other) = delete;
+
+        /**
+         * Перемещение через присвоение (при присвоении rvalue-значения возможен обмен ресурса)
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        VertexFormat& operator=(VertexFormat&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unload();
+
+            std::swap(loaded_, other.loaded_);
+            std::swap(vao_id_, other.vao_id_);
+            std::swap(vertex_stride_, other.vertex_stride_);
+            std::swap(instance_stride_, other.instance_stride_);
+
+            return *this;
+        }
+
+        /**
+         * Добавить описание атрибутов экземпляра (читаются из INSTANCE_BINDING)
+         * Делитель задается для точки привязки целиком и берется из первого атрибута
+         * @param attributes Список описаний атрибутов экземпляра для шейдера
+         * @param stride Размер структуры экземпляра
+         */
+        void set_instance_attributes(const std::vector<VertexAttributeInfo>& attributes, GLsizei stride)
+        {
+            assert(loaded_);
+            assert(stride > 0);
+
+            instance_stride_ = stride;
+            setup_attributes(attributes, INSTANCE_BINDING);
+            glVertexArrayBindingDivisor(vao_id_, INSTANCE_BINDING, attributes.empty() ? 1 : attributes[0].divisor);
+        }
+
+        /**
+         * Подключить буфер вершин
+         * @param vbo_id OpenGL дескриптор буфера
+         * @param offset Смещение первой вершины в буфере (байт)
+         */
+        void set_vertex_buffer(GLuint vbo_id, GLintptr offset = 0) const
+        {
+            glVertexArrayVertexBuffer(vao_id_, VERTEX_BINDING, vbo_id, offset, vertex_stride_);
+        }
+
+        /**
+         * Подключить буфер экземпляров
+         * @param vbo_id OpenGL дескриптор буфера
+         * @param offset Смещение первого экземпляра в буфере (байт)
+         */
+        void set_instance_buffer(GLuint vbo_id, GLintptr offset = 0) const
+        {
+            assert(instance_stride_ > 0);
+            glVertexArrayVertexBuffer(vao_id_, INSTANCE_BINDING, vbo_id, offset, instance_stride_);
+        }
+
+        /**
+         * Подключить буфер индексов
+         * @param ebo_id OpenGL дескриптор буфера
+         */
+        void set_index_buffer(GLuint ebo_id) const
+        {
+            glVertexArrayElementBuffer(vao_id_, ebo_id);
+        }
+
+        /**
+         * Получить OpenGL дескриптор vertex array object
+         * @return Дескриптор ресурса
+         */
+        [[nodiscard]] GLuint id() const
+        {
+            return vao_id_;
+        }
+
+        /**
+         * Получить размер структуры вершины
+         * @return Размер (байт)
+         */
+        [[nodiscard]] GLsizei vertex_stride() const
+        {
+            return vertex_stride_;
+        }
+
+        /**
+         * Выгрузка ресурса
+         */
+        void unload() override
+        {
+            if (vao_id_) glDeleteVertexArrays(1, &vao_id_);
+
+            vao_id_ = 0;
+            vertex_stride_ = 0;
+            instance_stride_ = 0;
+
+            loaded_ = false;
+        }
+
+    protected:
+        /**
+         * Пояснить как соотносить данные вершины (экземпляра) и атрибуты в шейдере
+         * @param attributes Массив с информацией об атрибутах
+         * @param binding Точка привязки буфера, из которого читаются атрибуты
+         */
+        void setup_attributes(const std::vector<VertexAttributeInfo>& attributes, GLuint binding) const
+        {
+            for(const auto&[
+                    location
+                    , component_count
+                    , component_type
+                    , normalize
+                    , offset
+                    , divisor] : attributes)
+            {
+                glVertexArrayAttribFormat(vao_id_
+                    , location
+                    , component_count
+                    , component_type
+                    , normalize
+                    , static_cast<GLuint>(offset)
+                    );
+
+                glVertexArrayAttribBinding(vao_id_, location, binding);
+                glEnableVertexArrayAttrib(vao_id_, location);
+            }
+        }
+
+    private:
+        GLuint vao_id_;             // OpenGL дескриптор VAO объекта
+        GLsizei vertex_stride_;     // Размер структуры вершины
+        GLsizei instance_stride_;   // Размер структуры экземпляра
+    };
+}
\ No newline at end of file
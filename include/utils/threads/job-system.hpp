@@ -0,0 +1,223 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <condition_variable>
+#include <algorithm>
+#include <string>
+#include <exception>
+
+#include "trace.hpp"
+
+namespace utils::threads
+{
+    /**
+     * Простая система задач (пул рабочих потоков с общей очередью)
+     * Задачи выполняются в порядке поступления любым свободным потоком
+     */
+    class JobSystem
+    {
+    public:
+        /**
+         * Основной конструктор
+         * @param thread_count Кол-во рабочих потоков (0 - по кол-ву аппаратных потоков минус основной)
+         */
+        explicit JobSystem(size_t thread_count = 0)
+            : stop_(false)
+        {
+            if(thread_count == 0)
+            {
+                const size_t hw = std::thread::hardware_concurrency();
+                thread_count = hw > 1 ? hw - 1 : 1;
+            }
+
+            workers_.reserve(thread_count);
+            for(size_t i = 0; i < thread_count; i++)
+            {
+                workers_.emplace_back([this, i](){ worker_loop(i); });
+            }
+        }
+
+        /**
+         * Запрет копирования через конструктор
+         * @param other Другой объект
+         */
+        JobSystem(const JobSystem& other) = delete;
+
+        /**
+         * Запрет копирования через присвоение
+         * @param other Другой объект
+         * @return Ссылка на текущий объект
+         */
+        JobSystem& operator=(const JobSystem& other) = delete;
+
+        /**
+         * Завершает работу потоков (задачи оставшиеся в очереди будут выполнены)
+         */
+        ~JobSystem()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_all();
+
+            for(auto& w : workers_)
+            {
+                if(w.joinable()) w.join();
+            }
+        }
+
+        /**
+         * Добавить задачу в очередь
+         * @tparam F Тип функции (функтора)
+         * @param func Функция задачи
+         * @return Future объект для ожидания результата
+         */
+        template <typename F>
+        auto submit(F&& func) -> std::future<decltype(func())>
+        {
+            using R = decltype(func());
+
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+            std::future<R> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.emplace([task](){ (*task)(); });
+            }
+            condition_.notify_one();
+
+            return result;
+        }
+
+        /**
+         * Параллельная обработка диапазона [0, count) пакетами
+         * Вызывающий поток участвует в обработке, поэтому вызов безопасен и из рабочих потоков.
+         * Исключение, выброшенное функцией в любом потоке, перебрасывается вызывающему потоку после завершения
+         * всех начатых пакетов (оставшиеся пакеты не обрабатываются)
+         * @param count Кол-во элементов
+         * @param batch_size Размер пакета (кол-во элементов обрабатываемых одной задачей)
+         * @param func Функция обработки пакета - func(begin, end)
+         * @throws Первое исключение, выброшенное функцией обработки
+         */
+        void parallel_for(size_t count, size_t batch_size, const std::function<void(size_t, size_t)>& func)
+        {
+            if(count == 0) return;
+            batch_size = std::max<size_t>(batch_size, 1);
+
+            const size_t batch_count = (count + batch_size - 1) / batch_size;
+            if(batch_count == 1)
+            {
+                func(0, count);
+                return;
+            }
+
+            // Общее состояние разделяется между вызывающим потоком и задачами
+            // (задачи могут начать выполнение уже после того, как вся работа разобрана).
+            // Исключение пакета сохраняется, пакет все равно считается завершенным - иначе вызывающий поток
+            // вернется раньше, чем задачи перестанут использовать func
+            struct State
+            {
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> done{0};
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+                std::mutex error_mutex;
+            };
+            auto state = std::make_shared<State>();
+
+            auto run = [state, count, batch_size, batch_count, &func]()
+            {
+                for(size_t b = state->next++; b < batch_count; b = state->next++)
+                {
+                    if(!state->failed.load())
+                    {
+                        TRACE_SCOPE("Batch");
+                        try
+                        {
+                            const size_t begin = b * batch_size;
+                            func(begin, std::min(begin + batch_size, count));
+                        }
+                        catch(...)
+                        {
+                            std::lock_guard<std::mutex> lock(state->error_mutex);
+                            if(!state->error) state->error = std::current_exception();
+                            state->failed = true;
+                        }
+                    }
+                    state->done++;
+                }
+            };
+
+            // Задачи для рабочих потоков (не больше чем потоков и пакетов)
+            const size_t helpers = std::min(workers_.size(), batch_count - 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for(size_t i = 0; i < helpers; i++)
+                {
+                    jobs_.emplace([state, batch_count, run]()
+                    {
+                        if(state->next.load() < batch_count) run();
+                    });
+                }
+            }
+            condition_.notify_all();
+
+            // Вызывающий поток также разбирает пакеты, затем дожидается завершения взятых другими
+            run();
+            while(state->done.load() < batch_count)
+            {
+                std::this_thread::yield();
+            }
+
+            if(state->error) std::rethrow_exception(state->error);
+        }
+
+        /**
+         * Кол-во рабочих потоков
+         * @return Кол-во
+         */
+        [[nodiscard]] size_t thread_count() const
+        {
+            return workers_.size();
+        }
+
+    protected:
+        /**
+         * Цикл рабочего потока
+         * @param index Индекс потока
+         */
+        void worker_loop([[maybe_unused]] size_t index)
+        {
+            TRACE_THREAD_NAME("Worker " + std::to_string(index));
+
+            for(;;)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condition_.wait(lock, [this](){ return stop_ || !jobs_.empty(); });
+                    if(stop_ && jobs_.empty()) return;
+
+                    job = std::move(jobs_.front());
+                    jobs_.pop();
+                }
+
+                TRACE_SCOPE("Job");
+                job();
+            }
+        }
+
+    private:
+        std::vector<std::thread> workers_;              // Рабочие потоки
+        std::queue<std::function<void()>> jobs_;        // Очередь задач
+        std::mutex mutex_;                              // Защита очереди
+        std::condition_variable condition_;             // Оповещение о новых задачах
+        bool stop_;                                     // Завершение работы
+    };
+}
\ No newline at end of file
@@ -0,0 +1,406 @@
+#pragma once
+
+/**
+ * Запись временной шкалы кадров в формате Chrome trace (JSON, открывается в Perfetto и chrome://tracing)
+ * Инструментирование - макросами, без ENABLE_TRACE макросы не порождают кода:
+ * - TRACE_SCOPE(name) - участок до конца блока,
+ * - TRACE_BEGIN(name) / TRACE_END() - участок парой вызовов,
+ * - TRACE_GPU(name, start_ns, duration_ns) - участок на дорожке GPU (время в шкале TRACE_NOW()),
+ * - TRACE_THREAD_NAME(name) - имя дорожки текущего потока,
+ * - TRACE_CAPTURE(frames, path) - начать запись заданного кол-ва кадров (false - запись недоступна либо уже идет),
+ * - TRACE_FRAME() - конец кадра (true - запись завершена и сохранена в файл),
+ * - TRACE_DROPPED() - кол-во событий последней сохраненной записи, не поместившихся в буферы потоков,
+ * - TRACE_ACTIVE() - идет ли запись, TRACE_NOW() - текущее время (нс).
+ * Имена участков копируются (до 31 символа), поэтому допустимы и временные строки
+ */
+#ifdef ENABLE_TRACE
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+namespace utils::threads
+{
+    /**
+     * Событие (участок) временной шкалы
+     */
+    struct TraceEvent
+    {
+        // Имя (копия, обрезается)
+        char name[32];
+        // Начало и длительность (нс)
+        uint64_t start_ns;
+        uint64_t duration_ns;
+        // Дорожка GPU (иначе - дорожка потока-владельца буфера)
+        bool gpu;
+    };
+
+    /**
+     * Буфер событий одного потока
+     * Пишет только поток-владелец, читает поток сохранения после окончания записи:
+     * номер записи и кол-во событий публикуются атомарно (release), поэтому синхронизация не требуется
+     */
+    struct TraceBuffer
+    {
+        // События записи и их кол-во
+        std::vector<TraceEvent> events;
+        std::atomic<size_t> count{0};
+        // Запись, к которой относятся события (при смене записи владелец сбрасывает буфер)
+        std::atomic<uint32_t> capture{0};
+        // Открытые участки (TRACE_BEGIN без TRACE_END)
+        std::vector<TraceEvent> stack;
+        // Кол-во отброшенных событий (буфер заполнен)
+        std::atomic<size_t> dropped{0};
+        // Имя дорожки (защищено мьютексом реестра)
+        std::string thread_name;
+    };
+
+    /**
+     * Запись временной шкалы (единственный экземпляр на процесс)
+     */
+    class Tracer
+    {
+    public:
+        /**
+         * Кол-во событий в буфере потока за одну запись
+         */
+        constexpr static size_t BUFFER_CAPACITY = 1 << 16;
+
+        /**
+         * Единственный экземпляр
+         * @return Ссылка на экземпляр
+         */
+        static Tracer& instance()
+        {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        Tracer(const Tracer& other) = delete;
+        Tracer& operator=(const Tracer& other) = delete;
+
+        /**
+         * Текущее время
+         * @return Время (нс)
+         */
+        static uint64_t now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * Идет ли запись
+         * @return Статус
+         */
+        [[nodiscard]] bool active() const
+        {
+            return capturing_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Номер текущей (либо последней) записи
+         * @return Номер
+         */
+        [[nodiscard]] uint32_t capture_id() const
+        {
+            return capture_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Кол-во отброшенных событий последней сохраненной записи (буферы потоков были заполнены)
+         * @return Кол-во событий
+         */
+        [[nodiscard]] size_t dropped() const
+        {
+            return dropped_;
+        }
+
+        /**
+         * Начать запись (вызывается между кадрами потоком, вызывающим frame)
+         * @param frames Кол-во кадров
+         * @param path Путь к файлу результата
+         * @return Запись начата (false - запись уже идет)
+         */
+        bool capture(size_t frames, const std::string& path)
+        {
+            if(active() || frames == 0) return false;
+
+            frames_left_ = frames;
+            path_ = path;
+            start_ns_ = now();
+            capture_.fetch_add(1, std::memory_order_relaxed);
+            capturing_.store(true, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Конец кадра
+         * @return Запись завершена на этом кадре и сохранена
+         * @throws std::runtime_error Ошибка записи файла
+         */
+        bool frame()
+        {
+            if(!active() || --frames_left_ > 0) return false;
+
+            capturing_.store(false, std::memory_order_release);
+            save();
+            return true;
+        }
+
+        /**
+         * Начать участок текущего потока
+         * @param name Имя
+         */
+        void begin(const char* name)
+        {
+            if(!active()) return;
+            TraceBuffer& buffer = local_buffer();
+            buffer.stack.push_back(make_event(name, now(), 0, false));
+        }
+
+        /**
+         * Завершить последний начатый участок текущего потока
+         */
+        void end()
+        {
+            if(!active()) return;
+            TraceBuffer& buffer = local_buffer();
+            if(buffer.stack.empty()) return;
+
+            TraceEvent event = buffer.stack.back();
+            buffer.stack.pop_back();
+            event.duration_ns = now() - event.start_ns;
+            push(buffer, event);
+        }
+
+        /**
+         * Добавить завершенный участок на дорожку GPU
+         * @param name Имя
+         * @param start_ns Начало (в шкале now)
+         * @param duration_ns Длительность (нс)
+         */
+        void gpu(const char* name, uint64_t start_ns, uint64_t duration_ns)
+        {
+            if(!active()) return;
+            push(local_buffer(), make_event(name, start_ns, duration_ns, true));
+        }
+
+        /**
+         * Задать имя дорожки текущего потока
+         * @param name Имя
+         */
+        void set_thread_name(const std::string& name)
+        {
+            TraceBuffer& buffer = local_buffer();
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffer.thread_name = name;
+        }
+
+    private:
+        Tracer()
+            : capturing_(false)
+            , capture_(0)
+            , frames_left_(0)
+            , start_ns_(0)
+            , dropped_(0)
+        {}
+
+        /**
+         * Буфер текущего потока (создается и регистрируется при первом обращении потока)
+         * @return Ссылка на буфер
+         */
+        TraceBuffer& local_buffer()
+        {
+            thread_local TraceBuffer* buffer = nullptr;
+            if(!buffer)
+            {
+                auto created = std::make_unique<TraceBuffer>();
+                created->events.resize(BUFFER_CAPACITY);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                created->thread_name = "Thread " + std::to_string(buffers_.size());
+                buffer = created.get();
+                buffers_.push_back(std::move(created));
+            }
+
+            // Первое событие новой записи - сброс (пишет только владелец)
+            const uint32_t capture = capture_.load(std::memory_order_relaxed);
+            if(buffer->capture.load(std::memory_order_relaxed) != capture)
+            {
+                buffer->count.store(0, std::memory_order_relaxed);
+                buffer->dropped.store(0, std::memory_order_relaxed);
+                buffer->stack.clear();
+                buffer->capture.store(capture, std::memory_order_release);
+            }
+            return *buffer;
+        }
+
+        /**
+         * Сформировать событие
+         * @param name Имя
+         * @param start_ns Начало
+         * @param duration_ns Длительность
+         * @param gpu Дорожка GPU
+         * @return Событие
+         */
+        static TraceEvent make_event(const char* name, uint64_t start_ns, uint64_t duration_ns, bool gpu)
+        {
+            TraceEvent event{};
+            std::strncpy(event.name, name, sizeof(event.name) - 1);
+            event.start_ns = start_ns;
+            event.duration_ns = duration_ns;
+            event.gpu = gpu;
+            return event;
+        }
+
+        /**
+         * Добавить событие в буфер (при заполнении - отбросить)
+         * @param buffer Буфер текущего потока
+         * @param event Событие
+         */
+        static void push(TraceBuffer& buffer, const TraceEvent& event)
+        {
+            const size_t count = buffer.count.load(std::memory_order_relaxed);
+            if(count >= buffer.events.size())
+            {
+                buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                return;
+            }
+            buffer.events[count] = event;
+            buffer.count.store(count + 1, std::memory_order_release);
+        }
+
+        /**
+         * Экранирование строки JSON
+         * @param text Строка
+         * @return Строка в кавычках
+         */
+        static std::string quoted(const char* text)
+        {
+            std::string result = "\"";
+            for(const char* c = text; *c; c++)
+            {
+                if(*c == '"' || *c == '\\') result += '\\';
+                if(static_cast<unsigned char>(*c) >= 0x20) result += *c;
+            }
+            return result + "\"";
+        }
+
+        /**
+         * Сохранить события записи в файл (события потоков, еще не закончивших запись, не учитываются)
+         * Отброшенные события потока отмечаются мгновенным событием в конце его дорожки
+         * @throws std::runtime_error Ошибка записи файла
+         */
+        void save()
+        {
+            std::ofstream file(path_);
+            if(!file) throw std::runtime_error("[Trace] can't open \"" + path_ + "\" for writing");
+
+            const uint32_t capture = capture_.load(std::memory_order_relaxed);
+            const uint64_t end_ns = now();
+            const auto us = [&](uint64_t ns){ return std::to_string(static_cast<double>(ns) / 1000.0); };
+
+            // Дорожка 0 - GPU, дорожки потоков начинаются с 1
+            file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+            file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            dropped_ = 0;
+            for(size_t t = 0; t < buffers_.size(); t++)
+            {
+                const TraceBuffer& buffer = *buffers_[t];
+                const size_t tid = t + 1;
+                file << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid
+                     << ",\"args\":{\"name\":" << quoted(buffer.thread_name.c_str()) << "}}";
+
+                if(buffer.capture.load(std::memory_order_acquire) != capture) continue;
+                const size_t count = buffer.count.load(std::memory_order_acquire);
+                for(size_t i = 0; i < count; i++)
+                {
+                    const TraceEvent& event = buffer.events[i];
+                    if(event.start_ns < start_ns_) continue;
+
+                    file << ",\n{\"ph\":\"X\",\"name\":" << quoted(event.name)
+                         << ",\"pid\":1,\"tid\":" << (event.gpu ? 0 : tid)
+                         << ",\"ts\":" << us(event.start_ns - start_ns_)
+                         << ",\"dur\":" << us(event.duration_ns) << "}";
+                }
+
+                const size_t dropped = buffer.dropped.load(std::memory_order_acquire);
+                if(dropped > 0)
+                {
+                    file << ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"Dropped events\",\"pid\":1,\"tid\":" << tid
+                         << ",\"ts\":" << us(end_ns - start_ns_)
+                         << ",\"args\":{\"count\":" << dropped << "}}";
+                    dropped_ += dropped;
+                }
+            }
+            file << "\n]}\n";
+        }
+
+        // Идет ли запись и ее номер
+        std::atomic<bool> capturing_;
+        std::atomic<uint32_t> capture_;
+
+        // Оставшееся кол-во кадров, файл результата и начало записи
+        size_t frames_left_;
+        std::string path_;
+        uint64_t start_ns_;
+
+        // Кол-во отброшенных событий последней сохраненной записи
+        size_t dropped_;
+
+        // Буферы потоков (не удаляются до завершения процесса - потоки могут писать в любой момент)
+        std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+        std::mutex mutex_;
+    };
+
+    /**
+     * Участок на время жизни объекта
+     */
+    class TraceScope
+    {
+    public:
+        explicit TraceScope(const char* name) { Tracer::instance().begin(name); }
+        ~TraceScope() { Tracer::instance().end(); }
+        TraceScope(const TraceScope& other) = delete;
+        TraceScope& operator=(const TraceScope& other) = delete;
+    };
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) utils::threads::TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_BEGIN(name) utils::threads::Tracer::instance().begin(name)
+#define TRACE_END() utils::threads::Tracer::instance().end()
+#define TRACE_GPU(name, start_ns, duration_ns) utils::threads::Tracer::instance().gpu(name, start_ns, duration_ns)
+#define TRACE_THREAD_NAME(name) utils::threads::Tracer::instance().set_thread_name(name)
+#define TRACE_CAPTURE(frames, path) utils::threads::Tracer::instance().capture(frames, path)
+#define TRACE_FRAME() utils::threads::Tracer::instance().frame()
+#define TRACE_DROPPED() utils::threads::Tracer::instance().dropped()
+#define TRACE_ACTIVE() utils::threads::Tracer::instance().active()
+#define TRACE_NOW() utils::threads::Tracer::now()
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END() ((void)0)
+#define TRACE_GPU(name, start_ns, duration_ns) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_CAPTURE(frames, path) false
+#define TRACE_FRAME() false
+#define TRACE_DROPPED() size_t(0)
+#define TRACE_ACTIVE() false
+#define TRACE_NOW() uint64_t(0)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace benchmarks
+{
+    /**
+     * Замер времени выполнения функции
+     * Функция выполняется несколько раз, возвращается лучшее время (меньше всего зависит от помех со стороны системы)
+     * @tparam F Тип функции
+     * @param fn Функция
+     * @param repeats Кол-во повторов
+     * @return Время одного выполнения (мс)
+     */
+    template<typename F>
+    inline double measure_ms(const F& fn, size_t repeats = 10)
+    {
+        double best = std::numeric_limits<double>::max();
+        for(size_t i = 0; i < repeats; i++)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            const auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    /**
+     * Вывод результата замера
+     * @param name Название замера
+     * @param ms Время (мс)
+     * @param items Кол-во обработанных элементов
+     * @param unit Название элементов
+     */
+    inline void report(const char* name, double ms, double items, const char* unit)
+    {
+        std::cout << std::left << std::setw(40) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << ms << " ms"
+                  << std::setprecision(0) << std::setw(16) << (ms > 0.0 ? items / ms : 0.0) << " " << unit << "/ms"
+                  << std::endl;
+    }
+
+    /**
+     * Разбиение на кластеры и отсечение кластеров
+     */
+    void run_meshlets();
+
+    /**
+     * Упрощение меша и построение цепочки уровней детализации
+     */
+    void run_simplify();
+
+    /**
+     * Отсечение ограничивающих объемов пирамидой видимости
+     */
+    void run_culling();
+
+    /**
+     * Иерархия ограничивающих объемов (построение, пересчет, запросы)
+     */
+    void run_bvh();
+
+    /**
+     * Программная растеризация перекрывающих мешей и проверка перекрытия объемов
+     */
+    void run_occlusion();
+}
\ No newline at end of file
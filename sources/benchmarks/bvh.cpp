@@ -0,0 +1,164 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <utils/geometry/bvh.hpp>
+#include <random>
+
+#include "benchmark.h"
+
+namespace benchmarks
+{
+    /**
+     * Иерархия ограничивающих объемов
+     * 100 тыс. объемов в кубе 200x200x200. Замеряется построение, полный и частичный (10% объектов) пересчет,
+     * а также пропускная способность запросов (пирамида видимости, лучи, пересечения) в сравнении с перебором
+     */
+    void run_bvh()
+    {
+        const size_t count = 100000;
+        const size_t ray_count = 1000;
+        const size_t overlap_count = 1000;
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.1f, 2.0f);
+        std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+        std::vector<utils::geometry::Aabb> bounds(count);
+        for(auto& box : bounds)
+        {
+            const glm::vec3 center = {position(rng), position(rng), position(rng)};
+            const float radius = size(rng);
+            box.min = center - radius;
+            box.max = center + radius;
+        }
+
+        utils::geometry::Bvh bvh;
+
+        // Построение
+        const double build_ms = measure_ms([&](){ bvh.build(bounds); }, 5);
+        report("build (SAH, 16 bins)", build_ms, static_cast<double>(count), "objects");
+        const float build_cost = bvh.sah_cost();
+
+        // Смещение всех объектов и полный пересчет
+        std::vector<utils::geometry::Aabb> moved = bounds;
+        for(auto& box : moved)
+        {
+            const glm::vec3 d = {offset(rng), offset(rng), offset(rng)};
+            box.min += d;
+            box.max += d;
+        }
+        const double refit_ms = measure_ms([&](){ bvh.refit(moved); });
+        report("refit (all objects)", refit_ms, static_cast<double>(count), "objects");
+
+        // Частичный пересчет (смещен каждый 10-й объект)
+        std::vector<uint32_t> changed;
+        for(uint32_t i = 0; i < count; i += 10)
+        {
+            const glm::vec3 d = {offset(rng), offset(rng), offset(rng)};
+            moved[i].min += d;
+            moved[i].max += d;
+            changed.push_back(i);
+        }
+        const double partial_ms = measure_ms([&](){ bvh.refit(moved, changed); });
+        report("refit (10% of objects)", partial_ms, static_cast<double>(changed.size()), "objects");
+
+        // Запросы выполняются к исходным объемам
+        bvh.build(bounds);
+
+        // Пирамида видимости
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const auto frustum = utils::geometry::extract_frustum(projection * view);
+
+        std::vector<uint32_t> visible;
+        visible.reserve(count);
+
+        const double frustum_linear_ms = measure_ms([&](){
+            visible.clear();
+            for(uint32_t i = 0; i < count; i++)
+            {
+                if(utils::geometry::classify_aabb(frustum, bounds[i]) != utils::geometry::EContainment::OUTSIDE) visible.push_back(i);
+            }
+        });
+        report("frustum, linear", frustum_linear_ms, static_cast<double>(count), "objects");
+        const size_t linear_visible = visible.size();
+
+        const double frustum_bvh_ms = measure_ms([&](){
+            visible.clear();
+            bvh.query_frustum(frustum, [&](uint32_t object){ visible.push_back(object); });
+        });
+        report("frustum, BVH", frustum_bvh_ms, static_cast<double>(count), "objects");
+        const size_t bvh_visible = visible.size();
+
+        // Лучи (ближайшее пересечение)
+        std::vector<utils::geometry::Ray> rays(ray_count);
+        for(auto& ray : rays)
+        {
+            ray.origin = {position(rng), position(rng), position(rng)};
+            ray.direction = glm::normalize(glm::vec3(offset(rng), offset(rng), offset(rng)));
+        }
+
+        size_t hits = 0;
+        const double ray_linear_ms = measure_ms([&](){
+            hits = 0;
+            for(const auto& ray : rays)
+            {
+                const glm::vec3 inv_direction = 1.0f / ray.direction;
+                float nearest = 1000.0f;
+                bool hit = false;
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const float t = utils::geometry::intersect_ray_aabb(bounds[i], ray.origin, inv_direction, nearest);
+                    if(t >= 0.0f && t < nearest)
+                    {
+                        nearest = t;
+                        hit = true;
+                    }
+                }
+                hits += hit ? 1 : 0;
+            }
+        }, 1);
+        report("rays, linear", ray_linear_ms, static_cast<double>(ray_count), "rays");
+        const size_t linear_hits = hits;
+
+        const double ray_bvh_ms = measure_ms([&](){
+            hits = 0;
+            for(const auto& ray : rays)
+            {
+                const glm::vec3 inv_direction = 1.0f / ray.direction;
+                const auto hit = bvh.raycast(ray, 1000.0f, [&](uint32_t object, float max_distance){
+                    return utils::geometry::intersect_ray_aabb(bounds[object], ray.origin, inv_direction, max_distance);
+                });
+                hits += hit.hit() ? 1 : 0;
+            }
+        });
+        report("rays, BVH", ray_bvh_ms, static_cast<double>(ray_count), "rays");
+
+        // Пересечения с объемами объектов (поиск соседей)
+        size_t overlaps = 0;
+        const double overlap_linear_ms = measure_ms([&](){
+            overlaps = 0;
+            for(size_t q = 0; q < overlap_count; q++)
+            {
+                for(uint32_t i = 0; i < count; i++) overlaps += bounds[i].overlaps(bounds[q]) ? 1 : 0;
+            }
+        }, 1);
+        report("overlap, linear", overlap_linear_ms, static_cast<double>(overlap_count), "queries");
+        const size_t linear_overlaps = overlaps;
+
+        const double overlap_bvh_ms = measure_ms([&](){
+            overlaps = 0;
+            for(size_t q = 0; q < overlap_count; q++)
+            {
+                bvh.query_overlap(bounds[q], [&](uint32_t object){ overlaps += bounds[object].overlaps(bounds[q]) ? 1 : 0; });
+            }
+        });
+        report("overlap, BVH", overlap_bvh_ms, static_cast<double>(overlap_count), "queries");
+
+        std::cout << "nodes: " << bvh.nodes().size()
+                  << ", SAH cost: " << std::setprecision(1) << build_cost
+                  << ", visible: " << linear_visible << " (BVH: " << bvh_visible << ")"
+                  << ", ray hits: " << linear_hits << " (BVH: " << hits << ")"
+                  << ", overlaps: " << linear_overlaps << " (BVH: " << overlaps << ")" << std::endl;
+    }
+}
\ No newline at end of file
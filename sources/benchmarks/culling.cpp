@@ -0,0 +1,88 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <utils/geometry/culling.hpp>
+#include <random>
+
+#include "benchmark.h"
+
+namespace benchmarks
+{
+    /**
+     * Отсечение ограничивающих объемов пирамидой видимости
+     * 1 млн. сфер и прямоугольных объемов в кубе 200x200x200, камера в центре (видимо ~10%).
+     * Сравнивается скалярная проверка массива структур, SIMD проверка структуры массивов и ее параллельный вариант
+     */
+    void run_culling()
+    {
+        const size_t count = 1000000;
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.1f, 2.0f);
+
+        std::vector<utils::geometry::BoundingSphere> spheres(count);
+        utils::geometry::SphereBoundsSoA sphere_bounds;
+        utils::geometry::BoxBoundsSoA box_bounds;
+        for(auto& sphere : spheres)
+        {
+            sphere.center = {position(rng), position(rng), position(rng)};
+            sphere.radius = size(rng);
+            sphere_bounds.push_back(sphere);
+            box_bounds.push_back(sphere.center - sphere.radius, sphere.center + sphere.radius);
+        }
+
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const auto frustum = utils::geometry::extract_frustum(projection * view);
+
+        std::vector<uint32_t> visible(count);
+        size_t visible_count = 0;
+
+        // Скалярная проверка (массив структур, ветвление на каждую сферу)
+        const double scalar_ms = measure_ms([&](){
+            visible_count = 0;
+            for(size_t i = 0; i < count; i++)
+            {
+                if(utils::geometry::sphere_in_frustum(frustum, spheres[i].center, spheres[i].radius))
+                {
+                    visible[visible_count++] = static_cast<uint32_t>(i);
+                }
+            }
+        });
+        report("spheres scalar (AoS)", scalar_ms, static_cast<double>(count), "spheres");
+        const size_t scalar_visible = visible_count;
+
+        // Структура массивов, один поток
+        const double simd_ms = measure_ms([&](){
+            visible_count = utils::geometry::cull_spheres(frustum, sphere_bounds, 0, count, visible.data());
+        });
+        report("spheres SoA, 1 thread", simd_ms, static_cast<double>(count), "spheres");
+
+        const double box_ms = measure_ms([&](){
+            visible_count = utils::geometry::cull_boxes(frustum, box_bounds, 0, count, visible.data());
+        });
+        report("boxes SoA, 1 thread", box_ms, static_cast<double>(count), "boxes");
+
+        // Структура массивов, все потоки
+        utils::threads::JobSystem jobs;
+        std::vector<uint32_t> visible_parallel;
+        const double parallel_ms = measure_ms([&](){
+            utils::geometry::cull_spheres(jobs, frustum, sphere_bounds, count, visible_parallel);
+        });
+        report("spheres SoA, job system", parallel_ms, static_cast<double>(count), "spheres");
+
+        const double parallel_box_ms = measure_ms([&](){
+            utils::geometry::cull_boxes(jobs, frustum, box_bounds, count, visible_parallel);
+        });
+        report("boxes SoA, job system", parallel_box_ms, static_cast<double>(count), "boxes");
+
+#if defined(__AVX2__)
+        std::cout << "AVX2: on";
+#else
+        std::cout << "AVX2: off";
+#endif
+        std::cout << ", threads: " << jobs.thread_count() + 1
+                  << ", visible spheres: " << scalar_visible << " (" << std::setprecision(1)
+                  << 100.0 * static_cast<double>(scalar_visible) / static_cast<double>(count) << "%)" << std::endl;
+    }
+}
\ No newline at end of file
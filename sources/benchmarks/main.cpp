@@ -0,0 +1,44 @@
+#include <iostream>
+#include <cstring>
+
+#include "benchmark.h"
+
+/**
+ * Описание замера
+ */
+struct Benchmark
+{
+    const char* name;
+    void (*run)();
+};
+
+/**
+ * Точка входа
+ * Без аргументов выполняются все замеры, иначе - только указанные по имени
+ * @param argc Кол-во аргументов
+ * @param argv Аргументы
+ * @return Код выполнения
+ */
+int main(int argc, char* argv[])
+{
+    const Benchmark benchmarks[] = {
+            {"meshlets", benchmarks::run_meshlets},
+            {"simplify", benchmarks::run_simplify},
+            {"culling", benchmarks::run_culling},
+            {"bvh", benchmarks::run_bvh},
+            {"occlusion", benchmarks::run_occlusion}
+    };
+
+    for(const auto& benchmark : benchmarks)
+    {
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; i++) selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+        if(!selected) continue;
+
+        std::cout << "[" << benchmark.name << "]" << std::endl;
+        benchmark.run();
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
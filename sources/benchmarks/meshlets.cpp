@@ -0,0 +1,108 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <utils/geometry/generate.hpp>
+#include <utils/geometry/optimize.hpp>
+#include <utils/geometry/meshlets.hpp>
+#include <random>
+
+#include "benchmark.h"
+
+namespace benchmarks
+{
+    /**
+     * Вершина тестового меша
+     */
+    struct MeshletVertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+
+        using Layout = utils::geometry::VertexLayout<
+                utils::geometry::Attribute<utils::geometry::POSITION, &MeshletVertex::position, 0>,
+                utils::geometry::Attribute<utils::geometry::NORMAL, &MeshletVertex::normal, 1>>;
+    };
+
+    /**
+     * Разбиение на кластеры и отсечение кластеров
+     * Тесселированный тор (~260 тыс. треугольников) осматривается с разных точек, для каждой точки
+     * кластеры отсекаются пирамидой видимости и конусом нормалей
+     */
+    void run_meshlets()
+    {
+        const unsigned segments = 512, sides = 256;
+        const auto size = utils::geometry::gen_torus_size(segments, sides);
+
+        std::vector<MeshletVertex> vertices(size.vertex_count);
+        std::vector<GLuint> indices(size.index_count);
+        utils::geometry::gen_torus(vertices.data(), indices.data(), 1.0f, 0.3f, segments, sides);
+        indices = utils::geometry::optimize_vertex_cache(indices, vertices.size());
+
+        const double triangle_count = static_cast<double>(indices.size() / 3);
+
+        // Построение кластеров
+        std::vector<utils::geometry::Meshlet> meshlets;
+        const double build_ms = measure_ms([&](){
+            meshlets = utils::geometry::build_meshlets(indices, vertices);
+        }, 3);
+        report("build meshlets", build_ms, triangle_count, "tris");
+
+        // Точки обзора вокруг меша (фиксированное зерно - одинаковый набор для всех запусков)
+        struct View
+        {
+            utils::geometry::Frustum frustum;
+            glm::vec3 camera;
+        };
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> height(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> target(-1.0f, 1.0f);
+
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        std::vector<View> views(64);
+        for(auto& view : views)
+        {
+            const float a = angle(rng);
+            view.camera = {std::sin(a) * 2.5f, height(rng), std::cos(a) * 2.5f};
+            const glm::vec3 look_at = {target(rng), 0.0f, target(rng)};
+            view.frustum = utils::geometry::extract_frustum(projection * glm::lookAt(view.camera, look_at, {0.0f, 1.0f, 0.0f}));
+        }
+
+        // Отсечение (только пирамида видимости, затем пирамида и конус)
+        size_t frustum_culled = 0, culled = 0;
+        const double frustum_ms = measure_ms([&](){
+            frustum_culled = 0;
+            for(const auto& view : views)
+            {
+                for(const auto& meshlet : meshlets)
+                {
+                    if(!utils::geometry::sphere_in_frustum(view.frustum, meshlet.center, meshlet.radius)) frustum_culled += meshlet.index_count / 3;
+                }
+            }
+        });
+
+        const double cull_ms = measure_ms([&](){
+            culled = 0;
+            for(const auto& view : views)
+            {
+                for(const auto& meshlet : meshlets)
+                {
+                    if(!utils::geometry::is_meshlet_visible(meshlet, view.frustum, view.camera)) culled += meshlet.index_count / 3;
+                }
+            }
+        });
+
+        const double tested = static_cast<double>(meshlets.size() * views.size());
+        std::cout << "meshlets: " << meshlets.size()
+                  << ", avg triangles: " << std::setprecision(1) << triangle_count / static_cast<double>(meshlets.size())
+                  << ", views: " << views.size() << std::endl;
+
+        report("frustum (meshlets)", frustum_ms, tested, "meshlets");
+        report("frustum (culled triangles)", frustum_ms, static_cast<double>(frustum_culled), "tris");
+        report("frustum + cone (meshlets)", cull_ms, tested, "meshlets");
+        report("frustum + cone (culled triangles)", cull_ms, static_cast<double>(culled), "tris");
+
+        std::cout << "culled: frustum " << std::setprecision(1) << 100.0 * static_cast<double>(frustum_culled) / (triangle_count * static_cast<double>(views.size()))
+                  << "%, frustum + cone " << 100.0 * static_cast<double>(culled) / (triangle_count * static_cast<double>(views.size())) << "%" << std::endl;
+    }
+}
\ No newline at end of file
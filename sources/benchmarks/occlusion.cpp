@@ -0,0 +1,106 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <utils/geometry/occlusion-buffer.hpp>
+#include <random>
+
+#include "benchmark.h"
+
+namespace benchmarks
+{
+    /**
+     * Программное отсечение перекрытых объектов
+     * Сетка 16x16 "зданий" (кубов, 12 треугольников каждый) перед камерой и 100 тыс. объемов между ними.
+     * Замеряется подготовка треугольников, растеризация буфера 256x128 и проверка объемов (один поток и все потоки)
+     */
+    void run_occlusion()
+    {
+        const size_t count = 100000;
+        const int grid = 16;
+
+        // Единичный куб (8 вершин, 12 треугольников)
+        const std::vector<glm::vec3> cube_vertices = {
+                {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+                {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}};
+        const std::vector<uint32_t> cube_indices = {
+                0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6,
+                0, 4, 5, 0, 5, 1, 3, 2, 6, 3, 6, 7,
+                0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2};
+
+        // Здания в квадрате 200x200 перед камерой (между ними проходы)
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> height(5.0f, 30.0f);
+        std::vector<glm::mat4> buildings;
+        for(int z = 0; z < grid; z++)
+        {
+            for(int x = 0; x < grid; x++)
+            {
+                const float h = height(rng);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), {static_cast<float>(x - grid / 2) * 12.0f, h * 0.5f, -10.0f - static_cast<float>(z) * 12.0f});
+                buildings.push_back(glm::scale(model, {8.0f, h, 8.0f}));
+            }
+        }
+
+        std::uniform_real_distribution<float> position_x(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> position_z(-200.0f, -5.0f);
+        std::uniform_real_distribution<float> position_y(0.5f, 4.0f);
+        std::uniform_real_distribution<float> size(0.2f, 1.0f);
+        std::vector<utils::geometry::Aabb> boxes(count);
+        for(auto& box : boxes)
+        {
+            const glm::vec3 center = {position_x(rng), position_y(rng), position_z(rng)};
+            const float radius = size(rng);
+            box.min = center - radius;
+            box.max = center + radius;
+        }
+
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 300.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(0.0f, 3.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 view_projection = projection * view;
+
+        utils::threads::JobSystem jobs;
+        utils::geometry::OcclusionBuffer buffer(256, 128);
+
+        const auto add_occluders = [&](){
+            buffer.begin(view_projection);
+            for(const auto& model : buildings) buffer.add_occluder(cube_vertices, cube_indices, model);
+        };
+
+        // Перевод в пространство экрана и отсечение ближней плоскостью
+        const double setup_ms = measure_ms(add_occluders);
+        report("occluder setup", setup_ms, static_cast<double>(buffer.stats().triangles_in), "triangles");
+
+        // Растеризация
+        const double raster_ms = measure_ms([&](){ add_occluders(); buffer.rasterize(); }) - setup_ms;
+        report("rasterize 256x128, 1 thread", raster_ms, static_cast<double>(buffer.stats().triangles_rasterized), "triangles");
+
+        const double raster_parallel_ms = measure_ms([&](){ add_occluders(); buffer.rasterize(jobs); }) - setup_ms;
+        report("rasterize 256x128, job system", raster_parallel_ms, static_cast<double>(buffer.stats().triangles_rasterized), "triangles");
+
+        // Проверка объемов
+        size_t visible_count = 0;
+        const double test_ms = measure_ms([&](){
+            visible_count = 0;
+            for(const auto& box : boxes) visible_count += buffer.is_visible(box) ? 1 : 0;
+        });
+        report("test boxes, 1 thread", test_ms, static_cast<double>(count), "boxes");
+
+        std::vector<uint8_t> visible;
+        size_t parallel_visible_count = 0;
+        const double test_parallel_ms = measure_ms([&](){ parallel_visible_count = buffer.test(jobs, boxes, visible); });
+        report("test boxes, job system", test_parallel_ms, static_cast<double>(count), "boxes");
+
+        // Для сравнения - видимые без учета перекрытия
+        const auto frustum = utils::geometry::extract_frustum(view_projection);
+        size_t frustum_count = 0;
+        for(const auto& box : boxes) frustum_count += utils::geometry::classify_aabb(frustum, box) != utils::geometry::EContainment::OUTSIDE ? 1 : 0;
+
+#if defined(__AVX2__)
+        std::cout << "AVX2: on";
+#else
+        std::cout << "AVX2: off";
+#endif
+        std::cout << ", threads: " << jobs.thread_count() + 1
+                  << ", in frustum: " << frustum_count
+                  << ", not occluded: " << visible_count << " (job system: " << parallel_visible_count << ")" << std::endl;
+    }
+}
\ No newline at end of file
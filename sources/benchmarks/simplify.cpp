@@ -0,0 +1,54 @@
+#include <glm/glm.hpp>
+#include <utils/geometry/generate.hpp>
+#include <utils/geometry/simplify.hpp>
+
+#include "benchmark.h"
+
+namespace benchmarks
+{
+    /**
+     * Вершина тестового меша
+     */
+    struct SimplifyVertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 uv;
+
+        using Layout = utils::geometry::VertexLayout<
+                utils::geometry::Attribute<utils::geometry::POSITION, &SimplifyVertex::position, 0>,
+                utils::geometry::Attribute<utils::geometry::NORMAL, &SimplifyVertex::normal, 1>,
+                utils::geometry::Attribute<utils::geometry::UV, &SimplifyVertex::uv, 2>>;
+    };
+
+    /**
+     * Упрощение меша и построение цепочки уровней детализации
+     * Тесселированный тор (~65 тыс. треугольников) упрощается до нескольких долей исходного кол-ва треугольников
+     */
+    void run_simplify()
+    {
+        const unsigned segments = 256, sides = 128;
+        const auto size = utils::geometry::gen_torus_size(segments, sides);
+
+        std::vector<SimplifyVertex> vertices(size.vertex_count);
+        std::vector<GLuint> source(size.index_count);
+        utils::geometry::gen_torus(vertices.data(), source.data(), 1.0f, 0.3f, segments, sides);
+
+        const double triangle_count = static_cast<double>(source.size() / 3);
+
+        // Цепочка уровней (каждый уровень упрощается из исходного меша)
+        std::vector<GLuint> indices;
+        std::vector<utils::geometry::MeshLod> lods;
+        const double chain_ms = measure_ms([&](){
+            indices = source;
+            lods = utils::geometry::generate_lod_chain(indices, vertices, {0.5f, 0.25f, 0.125f, 0.0625f});
+        }, 3);
+        report("lod chain (source triangles)", chain_ms, triangle_count, "tris");
+
+        for(size_t i = 0; i < lods.size(); i++)
+        {
+            std::cout << "lod " << i << ": " << lods[i].index_count / 3 << " tris, error "
+                      << std::setprecision(5) << lods[i].error << std::endl;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+// Реализация библиотеки чтения glTF (в единственной единице трансляции)
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include <cgltf.h>
+#include <stdexcept>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "source-mesh.h"
+
+namespace converter
+{
+    /**
+     * Чтение меша из файла glTF 2.0 (.gltf или .glb, все примитивы-треугольники сцены с учетом трансформаций узлов)
+     * Вершины примитивов переводятся в пространство сцены, примитивы объединяются в один меш
+     * @param path Путь к файлу
+     * @return Меш
+     */
+    SourceMesh load_gltf(const std::string& path)
+    {
+        cgltf_options options = {};
+        cgltf_data* data = nullptr;
+
+        if(cgltf_parse_file(&options, path.c_str(), &data) != cgltf_result_success)
+        {
+            throw std::runtime_error("Cant parse glTF file \"" + path + "\"");
+        }
+        if(cgltf_load_buffers(&options, data, path.c_str()) != cgltf_result_success)
+        {
+            cgltf_free(data);
+            throw std::runtime_error("Cant load glTF buffers of \"" + path + "\"");
+        }
+        if(cgltf_validate(data) != cgltf_result_success)
+        {
+            cgltf_free(data);
+            throw std::runtime_error("Invalid glTF file \"" + path + "\"");
+        }
+
+        SourceMesh mesh;
+
+        for(cgltf_size n = 0; n < data->nodes_count; n++)
+        {
+            const cgltf_node& node = data->nodes[n];
+            if(!node.mesh) continue;
+
+            // Мировая матрица узла (нормали преобразуются обратной транспонированной)
+            glm::mat4 world(1.0f);
+            cgltf_node_transform_world(&node, glm::value_ptr(world));
+            const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(world)));
+
+            for(cgltf_size p = 0; p < node.mesh->primitives_count; p++)
+            {
+                const cgltf_primitive& primitive = node.mesh->primitives[p];
+                if(primitive.type != cgltf_primitive_type_triangles) continue;
+
+                const cgltf_accessor* positions = nullptr;
+                const cgltf_accessor* normals = nullptr;
+                const cgltf_accessor* uvs = nullptr;
+                for(cgltf_size a = 0; a < primitive.attributes_count; a++)
+                {
+                    const auto& attribute = primitive.attributes[a];
+                    if(attribute.type == cgltf_attribute_type_position) positions = attribute.data;
+                    else if(attribute.type == cgltf_attribute_type_normal) normals = attribute.data;
+                    else if(attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0) uvs = attribute.data;
+                }
+                if(!positions) continue;
+
+                const auto base = static_cast<GLuint>(mesh.positions.size());
+                for(cgltf_size v = 0; v < positions->count; v++)
+                {
+                    glm::vec3 position(0.0f), normal(0.0f);
+                    glm::vec2 uv(0.0f);
+                    cgltf_accessor_read_float(positions, v, glm::value_ptr(position), 3);
+                    if(normals) cgltf_accessor_read_float(normals, v, glm::value_ptr(normal), 3);
+                    if(uvs) cgltf_accessor_read_float(uvs, v, glm::value_ptr(uv), 2);
+
+                    mesh.positions.emplace_back(world * glm::vec4(position, 1.0f));
+                    mesh.normals.push_back(normals ? glm::normalize(normal_matrix * normal) : glm::vec3(0.0f));
+                    mesh.uvs.push_back(uv);
+                }
+
+                mesh.has_uvs = mesh.has_uvs || uvs;
+                mesh.has_normals = mesh.has_normals || normals;
+
+                // Без индексов - каждые 3 вершины образуют треугольник
+                const cgltf_size index_count = primitive.indices ? primitive.indices->count : positions->count;
+                for(cgltf_size i = 0; i + 2 < index_count; i += 3)
+                {
+                    for(cgltf_size k = 0; k < 3; k++)
+                    {
+                        const cgltf_size index = primitive.indices ? cgltf_accessor_read_index(primitive.indices, i + k) : i + k;
+                        if(index >= positions->count)
+                        {
+                            cgltf_free(data);
+                            throw std::runtime_error("Wrong vertex index in \"" + path + "\" (node " + std::to_string(n) + ", primitive " + std::to_string(p) + ")");
+                        }
+                        mesh.indices.push_back(base + static_cast<GLuint>(index));
+                    }
+                }
+
+                // Зеркальная трансформация меняет направление обхода треугольников
+                if(glm::determinant(glm::mat3(world)) < 0.0f)
+                {
+                    for(size_t i = mesh.indices.size() - (index_count / 3) * 3; i < mesh.indices.size(); i += 3)
+                    {
+                        std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+                    }
+                }
+            }
+        }
+
+        cgltf_free(data);
+        return mesh;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <iostream>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <utils/geometry/layout.hpp>
+#include <utils/geometry/optimize.hpp>
+#include <utils/geometry/simplify.hpp>
+#include <utils/geometry/mesh-file.hpp>
+
+#include "source-mesh.h"
+
+namespace converter
+{
+    /**
+     * Вершина с упакованными UV и нормалью (совпадает с вершиной сцены освещения)
+     */
+    struct LitVertex
+    {
+        glm::vec3 position;
+        utils::geometry::Half2 uv;
+        utils::geometry::Oct16 normal;
+
+        using Layout = utils::geometry::VertexLayout<
+                utils::geometry::Attribute<utils::geometry::POSITION, &LitVertex::position, 0>,
+                utils::geometry::Attribute<utils::geometry::UV, &LitVertex::uv, 1>,
+                utils::geometry::Attribute<utils::geometry::NORMAL, &LitVertex::normal, 2>>;
+    };
+
+    /**
+     * Вершина с положением и UV (совпадает с вершинами сцен текстурирования и перспективы)
+     */
+    struct TexturedVertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+
+        using Layout = utils::geometry::VertexLayout<
+                utils::geometry::Attribute<utils::geometry::POSITION, &TexturedVertex::position, 0>,
+                utils::geometry::Attribute<utils::geometry::UV, &TexturedVertex::uv, 1>>;
+    };
+
+    /**
+     * Вершина без упаковки атрибутов
+     */
+    struct FullVertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+        glm::vec3 normal;
+
+        using Layout = utils::geometry::VertexLayout<
+                utils::geometry::Attribute<utils::geometry::POSITION, &FullVertex::position, 0>,
+                utils::geometry::Attribute<utils::geometry::UV, &FullVertex::uv, 1>,
+                utils::geometry::Attribute<utils::geometry::NORMAL, &FullVertex::normal, 2>>;
+    };
+
+    /**
+     * Параметры конвертации
+     */
+    struct Options
+    {
+        std::string input;
+        std::string output;
+        std::string layout = "lit";
+        std::vector<float> lod_ratios = {0.5f, 0.25f, 0.125f};
+        bool optimize = true;
+    };
+
+    /**
+     * Упаковка вершин в итоговый формат, оптимизация, построение уровней детализации и запись файла
+     * @tparam V Тип вершины
+     * @param mesh Исходный меш (треугольники по часовой стрелке)
+     * @param options Параметры
+     */
+    template<typename V>
+    void convert(const SourceMesh& mesh, const Options& options)
+    {
+        std::vector<V> vertices(mesh.positions.size());
+        for(size_t i = 0; i < vertices.size(); i++)
+        {
+            utils::geometry::layout_of<V>::write(vertices[i], mesh.positions[i], mesh.uvs[i], mesh.normals[i], glm::vec3(1.0f));
+        }
+
+        std::vector<GLuint> indices = mesh.indices;
+        if(options.optimize)
+        {
+            const auto stats = utils::geometry::optimize_mesh(vertices, indices);
+            std::cout << "ACMR: " << stats.before.acmr << " -> " << stats.after.acmr << std::endl;
+        }
+
+        const auto lods = utils::geometry::generate_lod_chain(indices, vertices, options.lod_ratios);
+        for(size_t i = 0; i < lods.size(); i++)
+        {
+            std::cout << "LOD " << i << ": " << lods[i].index_count / 3 << " triangles, error " << lods[i].error << std::endl;
+        }
+
+        utils::geometry::write_mesh_file(options.output, vertices, indices, lods);
+        std::cout << "Written \"" << options.output << "\" (" << std::filesystem::file_size(options.output) << " bytes)" << std::endl;
+    }
+
+    /**
+     * Разбор списка долей через запятую ("0.5,0.25")
+     * @param list Строка
+     * @return Доли
+     */
+    std::vector<float> parse_ratios(const std::string& list)
+    {
+        std::vector<float> result;
+        size_t start = 0;
+        while(start < list.size())
+        {
+            const size_t end = std::min(list.find(',', start), list.size());
+            if(end > start) result.push_back(std::stof(list.substr(start, end - start)));
+            start = end + 1;
+        }
+        return result;
+    }
+}
+
+/**
+ * Точка входа
+ * mesh-converter <input.obj|input.gltf|input.glb> <output.mesh> [--layout lit|textured|full] [--lods 0.5,0.25] [--no-optimize]
+ * @param argc Кол-во аргументов
+ * @param argv Аргументы
+ * @return Код выполнения
+ */
+int main(int argc, char* argv[])
+{
+    converter::Options options;
+    std::vector<std::string> positional;
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--layout") == 0 && i + 1 < argc) options.layout = argv[++i];
+        else if(std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc) options.lod_ratios = converter::parse_ratios(argv[++i]);
+        else if(std::strcmp(argv[i], "--no-optimize") == 0) options.optimize = false;
+        else positional.emplace_back(argv[i]);
+    }
+
+    if(positional.size() != 2)
+    {
+        std::cerr << "Usage: mesh-converter <input.obj|input.gltf|input.glb> <output.mesh> "
+                     "[--layout lit|textured|full] [--lods 0.5,0.25] [--no-optimize]" << std::endl;
+        return 1;
+    }
+    options.input = positional[0];
+    options.output = positional[1];
+
+    try
+    {
+        // Чтение исходного файла (формат по расширению)
+        auto extension = std::filesystem::path(options.input).extension().string();
+        for(auto& c : extension) c = static_cast<char>(std::tolower(c));
+
+        converter::SourceMesh mesh;
+        if(extension == ".obj") mesh = converter::load_obj(options.input);
+        else if(extension == ".gltf" || extension == ".glb") mesh = converter::load_gltf(options.input);
+        else throw std::runtime_error("Unsupported input format \"" + extension + "\"");
+
+        if(mesh.indices.empty())
+        {
+            throw std::runtime_error("No triangles in \"" + options.input + "\"");
+        }
+
+        std::cout << "Loaded \"" << options.input << "\": " << mesh.positions.size() << " vertices, "
+                  << mesh.indices.size() / 3 << " triangles" << std::endl;
+
+        // Недостающие нормали, затем смена обхода (в OBJ и glTF лицевые грани заданы против часовой стрелки, в сценах - по часовой)
+        converter::compute_normals(mesh);
+        for(size_t i = 0; i + 2 < mesh.indices.size(); i += 3) std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+
+        if(options.layout == "lit") converter::convert<converter::LitVertex>(mesh, options);
+        else if(options.layout == "textured") converter::convert<converter::TexturedVertex>(mesh, options);
+        else if(options.layout == "full") converter::convert<converter::FullVertex>(mesh, options);
+        else throw std::runtime_error("Unknown vertex layout \"" + options.layout + "\"");
+    }
+    catch(std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
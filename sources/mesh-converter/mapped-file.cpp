@@ -0,0 +1,3 @@
+// Реализация отображения файлов в память для Windows (в единственной единице трансляции)
+#define MAPPED_FILE_IMPLEMENTATION
+#include <utils/files/mapped-file.hpp>
\ No newline at end of file
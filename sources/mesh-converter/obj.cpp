@@ -0,0 +1,120 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "source-mesh.h"
+
+namespace converter
+{
+    /**
+     * Чтение меша из файла Wavefront OBJ (все объекты и группы объединяются в один меш)
+     * Многоугольники разбиваются веером, вершины с одинаковой тройкой индексов (v/vt/vn) объединяются
+     * @param path Путь к файлу
+     * @return Меш
+     */
+    SourceMesh load_obj(const std::string& path)
+    {
+        std::ifstream is(path);
+        if(!is.is_open())
+        {
+            throw std::runtime_error("Cant open file \"" + path + "\"");
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec3> normals;
+
+        SourceMesh mesh;
+        std::unordered_map<std::string, GLuint> unique;
+        std::vector<GLuint> polygon;
+
+        // Индекс OBJ (с единицы, отрицательный - от конца списка) в индекс массива
+        auto resolve = [](long index, size_t count) -> long
+        {
+            return index < 0 ? static_cast<long>(count) + index : index - 1;
+        };
+
+        std::string line;
+        size_t line_number = 0;
+        while(std::getline(is, line))
+        {
+            line_number++;
+            std::istringstream ls(line);
+            std::string type;
+            ls >> type;
+
+            if(type == "v")
+            {
+                glm::vec3 p(0.0f);
+                ls >> p.x >> p.y >> p.z;
+                positions.push_back(p);
+            }
+            else if(type == "vt")
+            {
+                glm::vec2 uv(0.0f);
+                ls >> uv.x >> uv.y;
+                // В OBJ начало координат текстуры - нижний левый угол
+                uvs.emplace_back(uv.x, 1.0f - uv.y);
+            }
+            else if(type == "vn")
+            {
+                glm::vec3 n(0.0f);
+                ls >> n.x >> n.y >> n.z;
+                normals.push_back(n);
+            }
+            else if(type == "f")
+            {
+                polygon.clear();
+                std::string corner;
+                while(ls >> corner)
+                {
+                    // Формат угла: v, v/vt, v//vn, v/vt/vn
+                    long v = 0, vt = 0, vn = 0;
+                    const size_t s1 = corner.find('/');
+                    const size_t s2 = s1 == std::string::npos ? std::string::npos : corner.find('/', s1 + 1);
+                    v = std::stol(corner.substr(0, s1));
+                    if(s1 != std::string::npos && s2 != s1 + 1) vt = std::stol(corner.substr(s1 + 1, s2 - s1 - 1));
+                    if(s2 != std::string::npos) vn = std::stol(corner.substr(s2 + 1));
+
+                    const long pi = resolve(v, positions.size());
+                    const long ti = vt != 0 ? resolve(vt, uvs.size()) : -1;
+                    const long ni = vn != 0 ? resolve(vn, normals.size()) : -1;
+                    if(pi < 0 || pi >= static_cast<long>(positions.size()) ||
+                       ti >= static_cast<long>(uvs.size()) ||
+                       ni >= static_cast<long>(normals.size()))
+                    {
+                        throw std::runtime_error("Wrong face index in \"" + path + "\" (line " + std::to_string(line_number) + ")");
+                    }
+
+                    // Вершина с такой же тройкой индексов уже есть
+                    const std::string key = std::to_string(pi) + "/" + std::to_string(ti) + "/" + std::to_string(ni);
+                    if(auto found = unique.find(key); found != unique.end())
+                    {
+                        polygon.push_back(found->second);
+                        continue;
+                    }
+
+                    const auto index = static_cast<GLuint>(mesh.positions.size());
+                    mesh.positions.push_back(positions[pi]);
+                    mesh.uvs.push_back(ti >= 0 ? uvs[ti] : glm::vec2(0.0f));
+                    mesh.normals.push_back(ni >= 0 ? normals[ni] : glm::vec3(0.0f));
+                    mesh.has_uvs = mesh.has_uvs || ti >= 0;
+                    mesh.has_normals = mesh.has_normals || ni >= 0;
+
+                    unique.emplace(key, index);
+                    polygon.push_back(index);
+                }
+
+                for(size_t i = 2; i < polygon.size(); i++)
+                {
+                    mesh.indices.push_back(polygon[0]);
+                    mesh.indices.push_back(polygon[i - 1]);
+                    mesh.indices.push_back(polygon[i]);
+                }
+            }
+        }
+
+        return mesh;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "source-mesh.h"
+
+namespace converter
+{
+    /**
+     * Расчет сглаженных нормалей (взвешенных по площади треугольников)
+     * Рассчитываются только отсутствующие (нулевые) нормали, треугольники заданы против часовой стрелки
+     * @param mesh Меш
+     */
+    void compute_normals(SourceMesh& mesh)
+    {
+        std::vector<glm::vec3> accumulated(mesh.positions.size(), glm::vec3(0.0f));
+        for(size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const GLuint a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+            const glm::vec3 n = glm::cross(mesh.positions[b] - mesh.positions[a], mesh.positions[c] - mesh.positions[a]);
+            accumulated[a] += n;
+            accumulated[b] += n;
+            accumulated[c] += n;
+        }
+
+        for(size_t i = 0; i < mesh.normals.size(); i++)
+        {
+            if(glm::dot(mesh.normals[i], mesh.normals[i]) > 0.0f) continue;
+            const float length = glm::length(accumulated[i]);
+            mesh.normals[i] = length > 0.0f ? accumulated[i] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+namespace converter
+{
+    /**
+     * Исходный меш (после чтения файла, до упаковки в итоговый формат вершин)
+     * Все массивы атрибутов имеют одинаковый размер (атрибуты уже сведены в общие вершины)
+     */
+    struct SourceMesh
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec3> normals;
+        std::vector<GLuint> indices;
+
+        // Присутствовали ли атрибуты в исходном файле
+        bool has_uvs = false;
+        bool has_normals = false;
+    };
+
+    /**
+     * Чтение меша из файла Wavefront OBJ (все объекты и группы объединяются в один меш)
+     * @param path Путь к файлу
+     * @return Меш
+     */
+    SourceMesh load_obj(const std::string& path);
+
+    /**
+     * Чтение меша из файла glTF 2.0 (.gltf или .glb, все примитивы-треугольники сцены с учетом трансформаций узлов)
+     * @param path Путь к файлу
+     * @return Меш
+     */
+    SourceMesh load_gltf(const std::string& path);
+
+    /**
+     * Расчет отсутствующих нормалей (сглаженных, взвешенных по площади треугольников)
+     * @param mesh Меш
+     */
+    void compute_normals(SourceMesh& mesh);
+}
\ No newline at end of file
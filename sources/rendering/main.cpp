@@ -1,8 +1,19 @@
 #include <iostream>
 #include <chrono>
+#include <cfloat>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <sstream>
 #include <functional>
+#include <algorithm>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <utils/threads/job-system.hpp>
+#include <utils/threads/trace.hpp>
+#include <utils/gl/shader-preprocessor.hpp>
+#include <utils/gl/profiler.hpp>
 
 // Интерфейс ImGUI
 #include <imgui.h>
@@ -16,6 +27,10 @@
 #include "scenes/04-perspective/perspective.h"
 #include "scenes/05-passes/passes.h"
 #include "scenes/06-lighting/lighting.h"
+#include "scenes/07-instancing/instancing.h"
+#include "scenes/08-multi-draw/multi-draw.h"
+#include "scenes/09-streaming/streaming.h"
+#include "scenes/10-draw-order/draw-order.h"
 
 // Экран
 float g_screen_aspect = 1.0f;
@@ -27,6 +42,52 @@ int g_fps = 0;
 std::string g_fps_str;
 float g_fps_until_next_update = 1.0f;
 
+// Система задач (рабочие потоки)
+utils::threads::JobSystem g_jobs;
+
+// Препроцессор шейдеров (общий кеш исходников для всех сцен)
+utils::gl::ShaderPreprocessor g_shader_preprocessor({"../content/shaders/common"});
+
+// Профилировщик кадра (участки CPU и GPU) и его панель
+utils::gl::Profiler g_profiler;
+bool g_show_profiler = true;
+size_t g_profiler_selected = 0;
+
+// Запись временной шкалы (кол-во кадров и файл результата, задаются аргументом --trace либо по умолчанию для клавиши T)
+size_t g_trace_frames = 120;
+std::string g_trace_path = "trace.json";
+
+/**
+ * Настройки режима замера производительности (--bench)
+ */
+struct BenchmarkSettings
+{
+    // Сцена: номер (с 1), название либо "all"
+    std::string scene;
+    // Кол-во замеряемых кадров и кадров разогрева (не учитываются)
+    size_t frames = 300;
+    size_t warmup = 30;
+    // Разрешение
+    int width = 1280;
+    int height = 720;
+    // Файл результата (пустой - стандартный вывод)
+    std::string output;
+};
+
+// Режим замера производительности (скрытое окно, без UI, фиксированный шаг времени и путь камеры)
+bool g_bench_mode = false;
+BenchmarkSettings g_bench;
+
+// Фиксированный шаг обновления сцен: частота (Гц) и наибольшее кол-во шагов за кадр
+// (при слишком долгих кадрах остаток времени отбрасывается - иначе шаги удлиняют кадры и отставание только растет)
+int g_tick_rate = 60;
+unsigned g_max_ticks = 5;
+// Допустимый диапазон частоты (общий для командной строки и настроек UI)
+const int g_tick_rate_min = 10;
+const int g_tick_rate_max = 240;
+// Накопленное, но еще не обработанное шагами время (с)
+float g_tick_accumulator = 0.0f;
+
 // Список сцен
 std::vector<scenes::Scene*> g_scenes = {};
 // Индекс текущей активной сцены
@@ -85,16 +146,108 @@ void init_ui(GLFWwindow* window);
  */
 void update_ui();
 
+/**
+ * Панель профилировщика (ImGUI)
+ */
+void update_profiler_ui();
+
+/**
+ * Начать запись временной шкалы кадров (Chrome trace)
+ */
+void start_trace();
+
+/**
+ * Конец кадра записи временной шкалы (после последнего кадра записи сохраняется файл)
+ */
+void finish_trace_frame();
+
+/**
+ * Обновление выбранной сцены фиксированными шагами и ее рендеринг (вместе с UI, если он используется)
+ * @param delta Разница в секундах между кадрами
+ */
+void update_and_render(float delta);
+
+/**
+ * Строка JSON (в кавычках, с экранированием)
+ * @param text Строка
+ * @return Строка JSON
+ */
+std::string json_string(const std::string& text);
+
+/**
+ * Замер производительности сцен (результат - статистика времени кадра в JSON)
+ * @param window Окно GLFW
+ * @return Код выполнения
+ */
+int run_benchmark(GLFWwindow* window);
+
 /**
  * Точка входа
  * @param argc Кол-во аргументов
  * @param argv Аргументы
  * @return Код выполнения
  */
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+int main(int argc, char* argv[])
 {
-    // Попытка инициализации GLFW
-    if(!glfwInit())
+    // Аргументы командной строки:
+    // --trace <кол-во кадров> [файл]
+    // --bench <сцена|all> [--frames N] [--warmup N] [--resolution WxH] [--output файл]
+    // --tick-rate <Гц> (10..240)
+    bool trace_at_start = false;
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--trace" && i + 1 < argc)
+        {
+            g_trace_frames = std::strtoul(argv[++i], nullptr, 10);
+            if(i + 1 < argc && argv[i + 1][0] != '-') g_trace_path = argv[++i];
+            trace_at_start = true;
+        }
+        else if(arg == "--bench" && i + 1 < argc)
+        {
+            g_bench.scene = argv[++i];
+            g_bench_mode = true;
+        }
+        else if(arg == "--frames" && i + 1 < argc)
+        {
+            g_bench.frames = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if(arg == "--warmup" && i + 1 < argc)
+        {
+            g_bench.warmup = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if(arg == "--resolution" && i + 1 < argc)
+        {
+            if(std::sscanf(argv[++i], "%dx%d", &g_bench.width, &g_bench.height) != 2) g_bench.width = 0;
+        }
+        else if(arg == "--output" && i + 1 < argc)
+        {
+            g_bench.output = argv[++i];
+        }
+        else if(arg == "--tick-rate" && i + 1 < argc)
+        {
+            g_tick_rate = std::clamp(std::atoi(argv[++i]), g_tick_rate_min, g_tick_rate_max);
+        }
+    }
+
+    if(g_bench_mode && (g_bench.frames == 0 || g_bench.width <= 0 || g_bench.height <= 0))
+    {
+        std::cout << "Usage: --bench <scene|all> [--frames N] [--warmup N] [--resolution WxH] [--output file]" << std::endl;
+        return -1;
+    }
+
+    TRACE_THREAD_NAME("Main");
+
+    // Попытка инициализации GLFW (для замера без дисплея - платформа без окон)
+    bool initialized = glfwInit();
+    bool headless = false;
+    if(!initialized && g_bench_mode)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        initialized = glfwInit();
+        headless = initialized;
+    }
+    if(!initialized)
     {
         std::cout << "Failed to init GLFW" << std::endl;
         return -1;
@@ -104,9 +257,26 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Создать основное окно
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Rendering", nullptr, nullptr);
+    if(g_bench_mode) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // Платформа без окон по умолчанию создает контекст через OSMesa (в современных сборках Mesa отсутствует),
+    // поэтому сначала используется контекст EGL без поверхности, OSMesa - запасной вариант
+    std::vector<int> context_apis = {GLFW_NATIVE_CONTEXT_API};
+    if(headless) context_apis = {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API};
+
+    // Создать основное окно (программная реализация llvmpipe может не поддерживать 4.6, примерам достаточно 4.5)
+    const int window_width = g_bench_mode ? g_bench.width : 800;
+    const int window_height = g_bench_mode ? g_bench.height : 600;
+    GLFWwindow* window = nullptr;
+    for(size_t i = 0; i < context_apis.size() && !window; i++)
+    {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, context_apis[i]);
+        for(int minor = 6; minor >= 5 && !window; minor--)
+        {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+            window = glfwCreateWindow(window_width, window_height, "Rendering", nullptr, nullptr);
+        }
+    }
     if(!window)
     {
         std::cout << "Failed to create GLFW window" << std::endl;
@@ -136,6 +306,9 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     // Инициализация UI (ImGUI)
     init_ui(window);
 
+    // Профилировщик (до 64 участков за кадр, кольцо запросов на 4 кадра, история на 240 кадров)
+    g_profiler = utils::gl::Profiler(64, 4, 240);
+
     // Список сцен
     g_scenes.push_back(new scenes::Triangle());
     g_scenes.push_back(new scenes::Uniforms());
@@ -143,6 +316,10 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     g_scenes.push_back(new scenes::Perspective());
     g_scenes.push_back(new scenes::Passes());
     g_scenes.push_back(new scenes::Lighting());
+    g_scenes.push_back(new scenes::Instancing());
+    g_scenes.push_back(new scenes::MultiDraw());
+    g_scenes.push_back(new scenes::Streaming());
+    g_scenes.push_back(new scenes::DrawOrder());
 
     // Загрузить необходимые ресурсы сцен-примеров
     try
@@ -158,12 +335,26 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
         return -1;
     }
 
+    // Запись временной шкалы с первого кадра (если задана аргументом)
+    if(trace_at_start) start_trace();
+
+    // Режим замера выполняется вместо интерактивного цикла
+    int result = 0;
+    if(g_bench_mode)
+    {
+        result = run_benchmark(window);
+        glfwSetWindowShouldClose(window, true);
+    }
+
     // Время предыдущего кадра
     auto previous_frame = std::chrono::high_resolution_clock::now();
 
     // Покуда окно не должно быть закрыто
     while(!glfwWindowShouldClose(window))
     {
+        // Начало кадра профилировщика (чтение готовых замеров GPU прошлых кадров)
+        g_profiler.begin_frame();
+
         // Опрос оконных событий
         glfwPollEvents();
 
@@ -191,6 +382,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
         // Обновление UI (если нужно)
         if(g_use_ui)
         {
+            utils::gl::ProfilerScope scope(g_profiler, "UI");
+
             // Начало кадра ImGUI
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
@@ -203,34 +396,16 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
             g_scenes[g_scene_index]->update_ui(delta);
         }
 
-        // Обновление данных выбранной сцены
-        g_scenes[g_scene_index]->update(delta);
-
-        // Сброс смещения курсора мыши
-        g_mouse_delta_x = 0.0f;
-        g_mouse_delta_y = 0.0f;
-
-        // Р Е Н Д Е Р И Н Г
-        {
-            // Сброс всех состояний и очистка экрана
-            glViewport(0, 0, g_screen_width, g_screen_height);
-            glScissor(0, 0, g_screen_width, g_screen_height);
-            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            // Рендеринг выбранного примера
-            g_scenes[g_scene_index]->render();
-
-            // Рендеринг UI элементов (ImGUI)
-            if(g_use_ui)
-            {
-                ImGui::Render();
-                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-            }
-        }
+        // Обновление и рендеринг выбранной сцены
+        update_and_render(delta);
 
         // Смена буферов
+        g_profiler.begin("Swap");
         glfwSwapBuffers(window);
+        g_profiler.end();
+
+        g_profiler.end_frame();
+        finish_trace_frame();
     }
 
     // Выгрузить все OpenGL ресурсы сцен
@@ -240,6 +415,9 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
         delete s;
     }
 
+    // Выгрузить запросы профилировщика (до уничтожения контекста)
+    g_profiler.unload();
+
     // Завершить работу с ImGUI
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -247,7 +425,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 
     // Завершить работу с GLFW
     glfwTerminate();
-    return 0;
+    return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -288,6 +466,11 @@ void keyboard_callback([[maybe_unused]] GLFWwindow *window, int key, [[maybe_unu
                 glfwSetWindowShouldClose(window, true);
                 break;
             }
+            case GLFW_KEY_T:
+            {
+                start_trace();
+                break;
+            }
             case GLFW_KEY_W:
             {
                 g_key_forward = true;
@@ -372,8 +555,9 @@ void mouse_pos_callback([[maybe_unused]] GLFWwindow *window, double x_pos, doubl
 {
     static double prev_x = x_pos;
     static double prev_y = y_pos;
-    g_mouse_delta_x = static_cast<float>(x_pos - prev_x);
-    g_mouse_delta_y = static_cast<float>(y_pos - prev_y);
+    // Смещение накапливается до ближайшего шага обновления сцены (в кадре может не быть ни одного шага)
+    g_mouse_delta_x += static_cast<float>(x_pos - prev_x);
+    g_mouse_delta_y += static_cast<float>(y_pos - prev_y);
     prev_x = x_pos;
     prev_y = y_pos;
 }
@@ -471,10 +655,15 @@ void init_ui([[maybe_unused]] GLFWwindow* window)
  */
 void update_ui()
 {
+    // Панель профилировщика справа от настроек
+    if(g_show_profiler) update_profiler_ui();
+
     ImGui::Begin("Settings", nullptr);
     ImGui::SetWindowPos({0.0f, 0.0f}, ImGuiCond_Once);
-    ImGui::SetWindowSize({150.0f, 100.0f}, ImGuiCond_Once);
+    ImGui::SetWindowSize({150.0f, 125.0f}, ImGuiCond_Once);
     ImGui::Text("FPS: %s", g_fps_str.c_str());
+    ImGui::Checkbox("Profiler", &g_show_profiler);
+    ImGui::SliderInt("Tick (Hz)", &g_tick_rate, g_tick_rate_min, g_tick_rate_max);
 
     if(ImGui::BeginCombo("Scene", g_scenes[g_scene_index]->name()))
     {
@@ -490,3 +679,287 @@ void update_ui()
     ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + ImGui::GetWindowHeight() }, ImGuiCond_Once);
     ImGui::End();
 }
+
+/**
+ * Панель профилировщика (ImGUI)
+ * Время кадра и участков (CPU и GPU) с процентилями, история выбранного участка
+ */
+void update_profiler_ui()
+{
+    ImGui::Begin("Profiler", &g_show_profiler);
+    ImGui::SetWindowPos({155.0f, 0.0f}, ImGuiCond_Once);
+    ImGui::SetWindowSize({440.0f, 360.0f}, ImGuiCond_Once);
+
+    // Время кадра
+    const auto plot = [](const char* label, const utils::gl::ProfilerHistory& history){
+        ImGui::PlotLines(label, history.samples().data(), static_cast<int>(history.count()), static_cast<int>(history.offset()),
+                         nullptr, 0.0f, FLT_MAX, {0.0f, 40.0f});
+    };
+    const auto& frame_cpu = g_profiler.frame_cpu();
+    const auto& frame_gpu = g_profiler.frame_gpu();
+    ImGui::Text("Frame CPU: %.2f ms (p50 %.2f, p95 %.2f, p99 %.2f)",
+                frame_cpu.average(), frame_cpu.percentile(0.5f), frame_cpu.percentile(0.95f), frame_cpu.percentile(0.99f));
+    plot("CPU", frame_cpu);
+    ImGui::Text("Frame GPU: %.2f ms (p50 %.2f, p95 %.2f, p99 %.2f)",
+                frame_gpu.average(), frame_gpu.percentile(0.5f), frame_gpu.percentile(0.95f), frame_gpu.percentile(0.99f));
+    plot("GPU", frame_gpu);
+    if(g_profiler.dropped_frames() > 0) ImGui::Text("Dropped GPU frames: %u", static_cast<unsigned>(g_profiler.dropped_frames()));
+
+    // Участки, выполнявшиеся в прошлом кадре (средние значения и процентили по истории)
+    const auto& entries = g_profiler.entries();
+    if(ImGui::BeginTable("Scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp))
+    {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("CPU");
+        ImGui::TableSetupColumn("GPU");
+        ImGui::TableSetupColumn("GPU p95");
+        ImGui::TableSetupColumn("GPU p99");
+        ImGui::TableHeadersRow();
+
+        for(size_t i = 0; i < entries.size(); i++)
+        {
+            const auto& entry = entries[i];
+            if(entry.last_frame + 1 < g_profiler.frame()) continue;
+
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Indent(static_cast<float>(entry.depth) * 8.0f + 1.0f);
+            if(ImGui::Selectable(entry.name.c_str(), g_profiler_selected == i, ImGuiSelectableFlags_SpanAllColumns)) g_profiler_selected = i;
+            ImGui::Unindent(static_cast<float>(entry.depth) * 8.0f + 1.0f);
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%.3f", entry.cpu.average());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.3f", entry.gpu.average());
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%.3f", entry.gpu.percentile(0.95f));
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%.3f", entry.gpu.percentile(0.99f));
+        }
+        ImGui::EndTable();
+    }
+
+    // История выбранного участка
+    if(g_profiler_selected < entries.size())
+    {
+        const auto& entry = entries[g_profiler_selected];
+        ImGui::Text("%s (ms)", entry.name.c_str());
+        plot("CPU##scope", entry.cpu);
+        plot("GPU##scope", entry.gpu);
+    }
+
+    ImGui::End();
+}
+
+/**
+ * Начать запись временной шкалы кадров (Chrome trace)
+ */
+void start_trace()
+{
+    if(TRACE_CAPTURE(g_trace_frames, g_trace_path))
+    {
+        std::cout << "Trace capture started (" << g_trace_frames << " frames)" << std::endl;
+    }
+    else
+    {
+        std::cout << "Trace capture is unavailable (build with USE_TRACE) or already running" << std::endl;
+    }
+}
+
+/**
+ * Конец кадра записи временной шкалы (после последнего кадра записи сохраняется файл)
+ */
+void finish_trace_frame()
+{
+    try
+    {
+        if(TRACE_FRAME())
+        {
+            std::cout << "Trace saved to " << g_trace_path << std::endl;
+            if(const size_t dropped = TRACE_DROPPED(); dropped > 0)
+            {
+                std::cout << "Trace dropped " << dropped << " events (thread buffers were full)" << std::endl;
+            }
+        }
+    }
+    catch(std::exception& ex)
+    {
+        std::cout << ex.what() << std::endl;
+    }
+}
+
+/**
+ * Обновление выбранной сцены фиксированными шагами и ее рендеринг (вместе с UI, если он используется)
+ * Кадр выполняет столько шагов, сколько их накопилось с прошлого кадра (но не более g_max_ticks),
+ * рендеринг получает долю шага, прошедшую после последнего шага (для интерполяции состояния сцены)
+ * @param delta Разница в секундах между кадрами
+ */
+void update_and_render(float delta)
+{
+    const float step = 1.0f / static_cast<float>(g_tick_rate);
+    g_tick_accumulator += delta;
+
+    // Обновление данных выбранной сцены
+    g_profiler.begin("Update");
+    for(unsigned ticks = 0; g_tick_accumulator >= step && ticks < g_max_ticks; ticks++)
+    {
+        g_scenes[g_scene_index]->update(step);
+        g_tick_accumulator -= step;
+
+        // Сброс смещения курсора мыши (смещение учитывается первым шагом)
+        g_mouse_delta_x = 0.0f;
+        g_mouse_delta_y = 0.0f;
+    }
+    g_profiler.end();
+
+    // Шагов не хватило - время сверх доли шага отбрасывается
+    if(g_tick_accumulator >= step) g_tick_accumulator = std::fmod(g_tick_accumulator, step);
+    const float alpha = g_tick_accumulator / step;
+
+    // Р Е Н Д Е Р И Н Г
+    {
+        // Сброс всех состояний и очистка экрана
+        glViewport(0, 0, g_screen_width, g_screen_height);
+        glScissor(0, 0, g_screen_width, g_screen_height);
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Рендеринг выбранного примера
+        g_profiler.begin("Render");
+        g_scenes[g_scene_index]->render(alpha);
+        g_profiler.end();
+
+        // Рендеринг UI элементов (ImGUI)
+        if(g_use_ui)
+        {
+            utils::gl::ProfilerScope scope(g_profiler, "UI render");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+    }
+}
+
+/**
+ * Строка JSON (в кавычках, с экранированием)
+ * @param text Строка
+ * @return Строка JSON
+ */
+std::string json_string(const std::string& text)
+{
+    std::string result = "\"";
+    for(char ch : text)
+    {
+        if(ch == '"' || ch == '\\') result += '\\';
+        result += ch;
+    }
+    return result + "\"";
+}
+
+/**
+ * Замер производительности сцен (результат - статистика времени кадра в JSON)
+ * Ввод заменяется детерминированным путем камеры (плавный поворот, движение вперед, затем назад),
+ * время кадра для сцены равно шагу обновления (ровно один шаг на кадр) - каждый запуск рисует одинаковую
+ * последовательность кадров.
+ * Время кадра - от начала кадра до завершения всех команд GPU (glFinish)
+ * @param window Окно GLFW
+ * @return Код выполнения
+ */
+int run_benchmark(GLFWwindow* window)
+{
+    // Время кадра для сцены (с) - ровно один шаг обновления
+    const float delta = 1.0f / static_cast<float>(g_tick_rate);
+    constexpr float pi = 3.14159265f;
+
+    // Сцены замера (все, по номеру либо по названию)
+    std::vector<size_t> indices;
+    for(size_t i = 0; i < g_scenes.size(); i++)
+    {
+        if(g_bench.scene == "all" || g_bench.scene == std::to_string(i + 1) || g_bench.scene == g_scenes[i]->name())
+        {
+            indices.push_back(i);
+        }
+    }
+
+    if(indices.empty())
+    {
+        std::cout << "Unknown benchmark scene \"" << g_bench.scene << "\", available:" << std::endl;
+        for(size_t i = 0; i < g_scenes.size(); i++) std::cout << "  " << i + 1 << ": " << g_scenes[i]->name() << std::endl;
+        return -1;
+    }
+
+    // Управление камерой сцен работает только без UI
+    g_use_ui = false;
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"renderer\": " << json_string(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << ",\n";
+    json << "  \"resolution\": [" << g_screen_width << ", " << g_screen_height << "],\n";
+    json << "  \"frames\": " << g_bench.frames << ",\n";
+    json << "  \"warmup\": " << g_bench.warmup << ",\n";
+    json << "  \"scenes\": [";
+
+    for(size_t n = 0; n < indices.size(); n++)
+    {
+        g_scene_index = indices[n];
+        g_tick_accumulator = 0.0f;
+
+        // Время замеряемых кадров (мс)
+        utils::gl::ProfilerHistory frame_ms(g_bench.frames);
+
+        const size_t total = g_bench.warmup + g_bench.frames;
+        for(size_t frame = 0; frame < total && !glfwWindowShouldClose(window); frame++)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            g_profiler.begin_frame();
+            glfwPollEvents();
+
+            // Путь камеры (имитация мыши и клавиш, за весь замер камера поворачивается и возвращается)
+            const float t = static_cast<float>(frame) / static_cast<float>(total);
+            g_mouse_delta_x = 4.0f * std::sin(t * 2.0f * pi);
+            g_mouse_delta_y = 0.5f * std::cos(t * 2.0f * pi);
+            g_key_forward = t < 0.5f;
+            g_key_backward = t >= 0.5f;
+
+            update_and_render(delta);
+
+            g_profiler.begin("Swap");
+            glfwSwapBuffers(window);
+            glFinish();
+            g_profiler.end();
+
+            g_profiler.end_frame();
+            finish_trace_frame();
+
+            const auto end = std::chrono::high_resolution_clock::now();
+            if(frame >= g_bench.warmup) frame_ms.push(std::chrono::duration<float, std::milli>(end - start).count());
+        }
+
+        g_key_forward = false;
+        g_key_backward = false;
+
+        json << (n > 0 ? "," : "") << "\n    {";
+        json << "\"name\": " << json_string(g_scenes[g_scene_index]->name());
+        json << ", \"frames\": " << frame_ms.count();
+        json << ", \"mean_ms\": " << frame_ms.average();
+        json << ", \"p50_ms\": " << frame_ms.percentile(0.5f);
+        json << ", \"p95_ms\": " << frame_ms.percentile(0.95f);
+        json << ", \"p99_ms\": " << frame_ms.percentile(0.99f);
+        json << ", \"max_ms\": " << frame_ms.percentile(1.0f);
+        json << "}";
+    }
+    json << "\n  ]\n}\n";
+
+    if(g_bench.output.empty())
+    {
+        std::cout << json.str();
+        return 0;
+    }
+
+    std::ofstream file(g_bench.output);
+    if(!file)
+    {
+        std::cout << "Failed to write benchmark results to " << g_bench.output << std::endl;
+        return -1;
+    }
+    file << json.str();
+    return 0;
+}
\ No newline at end of file
@@ -30,14 +30,8 @@ namespace scenes
                 {{1.0f, -1.0f, 0.0f},{0.0f, 0.0f,1.0f}},
         };
 
-        // Описание атрибутов шейдера
-        const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                {0,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, position)},
-                {1,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, color)}
-        };
-
-        // Создать OpenGL ресурс геометрических буферов из данных
-        geometry_ =  utils::gl::Geometry<Vertex>(vertices, indices, attributes);
+        // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+        geometry_ =  utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
 
         assert(shader_.ready());
         assert(geometry_.ready());
@@ -69,15 +63,16 @@ namespace scenes
     /**
      * Рисование сцены
      * В данном примере всего один вызов отрисовки
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Triangle::render()
+    void Triangle::render([[maybe_unused]] float alpha)
     {
         // Использовать шейдер
         glUseProgram(shader_.id());
         // Привязать геометрию
         glBindVertexArray(geometry_.vao_id());
         // Нарисовать геометрию
-        glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
     }
 
     /**
@@ -36,23 +36,11 @@ namespace scenes
         shader_ = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources,{"transform", "projection"});
 
         // Данные о геометрии (обычно загружается из файлов)
-        using utils::geometry::EAttrBit;
         std::vector<GLuint> indices = {};
-        std::vector<Vertex> vertices = utils::geometry::gen_quad<Vertex>(
-                2.0f,
-                EAttrBit::POSITION|EAttrBit::COLOR,
-                offsetof(Vertex, position),0,0,
-                offsetof(Vertex, color),
-                &indices);
-
-        // Описание атрибутов шейдера
-        const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                {0,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, position)},
-                {1,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, color)}
-        };
+        std::vector<Vertex> vertices = utils::geometry::gen_quad<Vertex>(2.0f, &indices);
 
-        // Создать OpenGL ресурс геометрических буферов из данных
-        geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, attributes);
+        // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+        geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
 
         assert(shader_.ready());
         assert(geometry_.ready());
@@ -112,8 +100,9 @@ namespace scenes
     /**
      * Рисование сцены
      * В данном примере рисуются 2 квадрата с разными цветами вершин
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Uniforms::render()
+    void Uniforms::render([[maybe_unused]] float alpha)
     {
         // Использовать шейдер
         glUseProgram(shader_.id());
@@ -123,12 +112,12 @@ namespace scenes
         // Нарисовать геометрию используя проекцию и трансформацию 1
         glUniformMatrix4fv(shader_.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
         glUniformMatrix4fv(shader_.uniforms().transform, 1, GL_FALSE, glm::value_ptr(transforms_[0]));
-        glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
 
         // Нарисовать геометрию используя проекцию и трансформацию 2
         glUniformMatrix4fv(shader_.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
         glUniformMatrix4fv(shader_.uniforms().transform, 1, GL_FALSE, glm::value_ptr(transforms_[1]));
-        glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
     }
 
     /**
@@ -2,6 +2,7 @@
 
 #include "utils/gl/shader.hpp"
 #include "utils/gl/geometry.hpp"
+#include "utils/geometry/layout.hpp"
 
 #include "../scene.h"
 
@@ -22,6 +23,11 @@ namespace scenes
         {
             glm::vec3 position;
             glm::vec3 color;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::COLOR, &Vertex::color, 1>>;
         };
 
         /**
@@ -64,8 +70,9 @@ namespace scenes
         /**
          * Рисование сцены
          * В данном примере рисуются 2 квадрата с разными цветами вершин
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
          */
-        void render() override;
+        void render(float alpha) override;
 
         /**
          * Имя примера
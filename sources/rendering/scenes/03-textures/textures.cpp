@@ -51,23 +51,11 @@ namespace scenes
         // Геометрия
         {
             // Данные о геометрии (обычно загружается из файлов)
-            using utils::geometry::EAttrBit;
             std::vector<GLuint> indices = {};
-            std::vector<Vertex> vertices = utils::geometry::gen_quad<Vertex>(
-                    2.0f,
-                    EAttrBit::POSITION|EAttrBit::UV,
-                    offsetof(Vertex, position),
-                    offsetof(Vertex, uv),0,0,
-                    &indices);
-
-            // Описание атрибутов шейдера
-            const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                    {0, 3, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, position)},
-                    {1, 2, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, uv)}
-            };
+            std::vector<Vertex> vertices = utils::geometry::gen_quad<Vertex>(2.0f, &indices);
 
-            // Создать OpenGL ресурс геометрических буферов из данных
-            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, attributes);
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
         }
 
         // Текстуры
@@ -172,8 +160,9 @@ namespace scenes
     /**
      * Рисование сцены
      * В данном примере рисуются 2 квадрата с разными текстурами
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Textures::render()
+    void Textures::render([[maybe_unused]] float alpha)
     {
         // Использовать шейдер
         glUseProgram(shader_.id());
@@ -194,7 +183,7 @@ namespace scenes
             glUniformMatrix4fv(shader_.uniforms().transform, 1, GL_FALSE, glm::value_ptr(transforms_[i]));
             glUniformMatrix3fv(shader_.uniforms().texture_mapping, 1, GL_FALSE, glm::value_ptr(uv_transform_[i]));
             glUniform1i(shader_.uniforms().texture, (GLint)i);
-            glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+            glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
 
             // Сброс
             glActiveTexture(GL_TEXTURE0 + i);
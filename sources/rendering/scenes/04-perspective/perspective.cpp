@@ -2,7 +2,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
 #include <utils/files/load.hpp>
-#include <utils/geometry/generate.hpp>
+#include <utils/geometry/mesh-file.hpp>
 #include <stb_image.h>
 
 #include "perspective.h"
@@ -31,6 +31,10 @@ namespace scenes
             , object_pos_{glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f)}
             , object_scale_{glm::vec3(1.0f),glm::vec3(1.0f, 1.0f, 1.0f)}
             , object_rotation_{glm::vec3(0.0f),glm::vec3(0.0f)}
+            , prev_camera_pos_(camera_pos_)
+            , prev_cam_yaw_(0.0f)
+            , prev_cam_pitch_(0.0f)
+            , prev_object_rotation_{glm::vec3(0.0f),glm::vec3(0.0f)}
             , z_far_(100.0f)
             , z_near_(0.1f)
             , fov_(45.0f)
@@ -45,7 +49,7 @@ namespace scenes
 
     /**
      * Загрузка шейдеров, геометрии
-     * Геометрия в данном примере hardcoded, остальное загружается из файлов
+     * Геометрия загружается из файла меша (отображением в память), остальное - из файлов шейдеров и текстур
      */
     void Perspective::load()
     {
@@ -68,24 +72,16 @@ namespace scenes
 
         // Геометрия
         {
-            // Данные о геометрии (хардкод, обычно загружается из файлов)
-            using utils::geometry::EAttrBit;
-            std::vector<GLuint> indices = {};
-            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(
-                    1.0f,
-                    EAttrBit::POSITION|EAttrBit::UV,
-                    offsetof(Vertex, position),
-                    offsetof(Vertex, uv),0,0,
-                    &indices);
-
-            // Описание атрибутов шейдера
-            const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                    {0, 3, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, position)},
-                    {1, 2, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, uv)}
-            };
-
-            // Создать OpenGL ресурс геометрических буферов из данных
-            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, attributes);
+            // Отобразить файл меша (подготовлен конвертером) в память и проверить раскладку вершин
+            utils::geometry::MeshFile file("../content/meshes/cube.mesh");
+            file.validate_layout<Vertex>();
+
+            // Создать OpenGL ресурс геометрических буферов прямо из отображенных данных (без копирования)
+            geometry_ = utils::gl::Geometry<Vertex>(
+                    file.vertex_data(), file.vertex_count(),
+                    file.index_data(), file.index_count(),
+                    file.index_type(), Vertex::Layout::attributes());
+            file.unload();
         }
 
         // Текстуры
@@ -122,6 +118,12 @@ namespace scenes
      */
     void Perspective::update([[maybe_unused]] float delta)
     {
+        // Состояние предыдущего шага
+        prev_camera_pos_ = camera_pos_;
+        prev_cam_yaw_ = cam_yaw_;
+        prev_cam_pitch_ = cam_pitch_;
+        for(unsigned i = 0; i < 2; i++) prev_object_rotation_[i] = object_rotation_[i];
+
         // Вращение объектов
         object_rotation_[0].y += delta * 45.0f;
         object_rotation_[1].y -= delta * 45.0f;
@@ -159,26 +161,7 @@ namespace scenes
             glm::vec3 d = glm::length2(h) > 0.0f ? glm::normalize(glm::vec3(h.x, 0.0f, h.y)) : glm::vec3(0.0f);
             glm::vec4 d_rot = cam_rotation * glm::vec4(d, 0.0f);
             camera_pos_ += (glm::vec3(d_rot.x, d_rot.y + cam_movement_.y, d_rot.z) * cam_speed_ * delta);
-
-            // Смещение камеры
-            glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), camera_pos_);
-
-            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
-            view_ = glm::inverse(cam_translate * cam_rotation);
-        }
-
-
-        // Матрицы моделей для двух объектов
-        for(unsigned i = 0; i < 2; i++)
-        {
-            model_[i] =
-                    glm::translate(glm::mat4(1.0f),object_pos_[i]) *
-                    glm::rotate(glm::mat4(1.0f), glm::radians(object_rotation_[i].x),glm::vec3(1.0f,0.0f,0.0f)) *
-                    glm::rotate(glm::mat4(1.0f), glm::radians(object_rotation_[i].y),glm::vec3(0.0f,1.0f,0.0f)) *
-                    glm::rotate(glm::mat4(1.0f), glm::radians(object_rotation_[i].z),glm::vec3(0.0f,0.0f,1.0f)) *
-                    glm::scale(glm::mat4(1.0f),object_scale_[i]);
         }
-
     }
 
     /**
@@ -191,9 +174,37 @@ namespace scenes
     /**
      * Рисование сцены
      * В данном примере рисуются 2 квадрата с разными цветами вершин
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Perspective::render()
+    void Perspective::render(float alpha)
     {
+        // Матрицы вида и моделей строятся по состоянию между двумя последними шагами обновления
+        // (поворот камеры тоже интерполируется - иначе при частоте кадров выше частоты шагов он меняется рывками)
+        {
+            // Поворот камеры
+            const glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_yaw_, cam_yaw_, alpha)),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_pitch_, cam_pitch_, alpha)),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Смещение камеры
+            glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), glm::mix(prev_camera_pos_, camera_pos_, alpha));
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            view_ = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        // Матрицы моделей для двух объектов
+        for(unsigned i = 0; i < 2; i++)
+        {
+            const glm::vec3 rotation = glm::mix(prev_object_rotation_[i], object_rotation_[i], alpha);
+            model_[i] =
+                    glm::translate(glm::mat4(1.0f),object_pos_[i]) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x),glm::vec3(1.0f,0.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(rotation.y),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z),glm::vec3(0.0f,0.0f,1.0f)) *
+                    glm::scale(glm::mat4(1.0f),object_scale_[i]);
+        }
+
         // Считать передние грани заданными по часовой стрелке
         glFrontFace(GL_CW);
         // Отбрасывать задние грани
@@ -219,7 +230,7 @@ namespace scenes
             // Нарисовать геометрию используя матрицу модели и текстуру
             glUniformMatrix4fv(shader_.uniforms().model, 1, GL_FALSE, glm::value_ptr(m));
             glUniform1i(shader_.uniforms().texture, 0);
-            glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+            glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
         }
 
         // Сброс
@@ -3,6 +3,7 @@
 #include "utils/gl/shader.hpp"
 #include "utils/gl/geometry.hpp"
 #include "utils/gl/texture-2d.hpp"
+#include "utils/geometry/layout.hpp"
 
 #include "../scene.h"
 
@@ -23,6 +24,11 @@ namespace scenes
         {
             glm::vec3 position;
             glm::vec2 uv;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::UV, &Vertex::uv, 1>>;
         };
 
         /**
@@ -67,8 +73,9 @@ namespace scenes
         /**
          * Рисование сцены
          * В данном примере всего один вызов отрисовки
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
          */
-        void render() override;
+        void render(float alpha) override;
 
         /**
          * Имя примера
@@ -93,6 +100,11 @@ namespace scenes
         glm::vec3 object_scale_[2];
         glm::vec3 object_rotation_[2];
 
+        // Положение и поворот камеры, поворот объектов на предыдущем шаге обновления (для интерполяции)
+        glm::vec3 prev_camera_pos_;
+        GLfloat prev_cam_yaw_, prev_cam_pitch_;
+        glm::vec3 prev_object_rotation_[2];
+
         // Параметры для построения матрицы проекции
         GLfloat z_far_, z_near_, fov_;
 
@@ -1,4 +1,5 @@
 #include <utils/files/load.hpp>
+#include <cmath>
 #include <imgui.h>
 
 #include "passes.h"
@@ -7,17 +8,29 @@
 extern int g_screen_width;
 extern int g_screen_height;
 
+// Профилировщик кадра
+extern utils::gl::Profiler g_profiler;
+
 namespace scenes
 {
     Passes::Passes()
             : prev_width_(g_screen_width)
             , prev_height_(g_screen_height)
-            , prev_scale_index_(0)
+            , prev_blur_(true)
+            , prev_vignette_(true)
             , scale_index_(0)
             , scales_{1.0f, 0.75f, 0.5f, 0.25f, 0.1f}
             , scale_names_{"100%","75%","50%","25%","10%"}
+            , dynamic_scale_(true)
+            , scale_(1.0f)
+            , render_width_(0)
+            , render_height_(0)
+            , gpu_ms_(0.0)
             , render_(false)
-            , filter_(false)
+            , upscale_filter_(BICUBIC)
+            , upscale_filter_names_{"Nearest","Bilinear","Bicubic"}
+            , blur_(true)
+            , vignette_(true)
             , resolution_("0x0")
     {}
 
@@ -48,14 +61,8 @@ namespace scenes
                     {{1.0f, -1.0f, 0.0f},{0.0f, 0.0f,1.0f}},
             };
 
-            // Описание атрибутов шейдера
-            const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                    {0,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(VertexPrimary, position)},
-                    {1,3,GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(VertexPrimary, color)}
-            };
-
-            // Создать OpenGL ресурс геометрических буферов из данных
-            geometry_primary_ = utils::gl::Geometry<VertexPrimary>(vertices, indices, attributes);
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_primary_ = utils::gl::Geometry<VertexPrimary>(vertices, indices, VertexPrimary::Layout::attributes());
         }
 
         // Р Е С У Р С Ы  П Р О Х Р Д А  2
@@ -67,7 +74,7 @@ namespace scenes
             };
 
             // Создать OpenGL ресурс шейдера из исходников
-            shader_secondary_ = utils::gl::Shader<ShaderUniformsSecondary, GLint>(shader_sources, {"frame_texture"});
+            shader_secondary_ = utils::gl::Shader<ShaderUniformsSecondary, GLint>(shader_sources, {"frame_texture", "uv_scale", "bicubic"});
 
             // Данные о геометрии (обычно загружается из файлов)
             const std::vector<GLuint> indices = {0,1,2, 2,3,0};
@@ -78,37 +85,37 @@ namespace scenes
                     {{1.0f, -1.0f, 0.0f},{1.0f, 0.0f}},
             };
 
-            // Описание атрибутов шейдера
-            const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                    {0, 3, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(VertexSecondary, position)},
-                    {1, 2, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(VertexSecondary, uv)}
-            };
-
-            // Создать OpenGL ресурс геометрических буферов из данных
-            geometry_secondary_ = utils::gl::Geometry<VertexSecondary>(vertices, indices, attributes);
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_secondary_ = utils::gl::Geometry<VertexSecondary>(vertices, indices, VertexSecondary::Layout::attributes());
         }
 
-        // Создать первичный кадровый буфер (первого прохода)
-        utils::gl::FrameBufferAttachmentInfo color{GL_RGBA, GL_RGBA, GL_COLOR_ATTACHMENT0, GL_NEAREST};
-        utils::gl::RenderBufferAttachmentInfo depth_stencil{GL_DEPTH32F_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT};
-        frame_buffer_primary_ = utils::gl::FrameBuffer(
-                g_screen_width,
-                g_screen_height,
-                {color},
-                {depth_stencil});
+        // Р Е С У Р С Ы  П О С Т - О Б Р А Б О Т К И (вершинный шейдер и геометрия общие со вторым проходом)
+        {
+            const std::unordered_map<GLuint, std::string> shader_sources = {
+                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/passes/secondary.vert")},
+                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/passes/post.frag")}
+            };
 
-        // Обновить строчку с разрешением
-        resolution_ = std::to_string(frame_buffer_primary_.width()) +
-                "x" + std::to_string(frame_buffer_primary_.height());
+            shaders_post_[BLUR_HORIZONTAL] = utils::gl::Shader<ShaderUniformsPost, GLint>(shader_sources, {"source_texture", "uv_scale"}, {{"BLUR_HORIZONTAL", "1"}});
+            shaders_post_[BLUR_VERTICAL] = utils::gl::Shader<ShaderUniformsPost, GLint>(shader_sources, {"source_texture", "uv_scale"}, {{"BLUR_VERTICAL", "1"}});
+            shaders_post_[VIGNETTE] = utils::gl::Shader<ShaderUniformsPost, GLint>(shader_sources, {"source_texture", "uv_scale"}, {{"VIGNETTE", "1"}});
+        }
 
         assert(shader_primary_.ready());
         assert(geometry_primary_.ready());
         assert(shader_secondary_.ready());
         assert(geometry_secondary_.ready());
-        assert(frame_buffer_primary_.ready());
+        for(const auto& shader : shaders_post_) assert(shader.ready());
+
+        // Пул целей рендеринга (сохраняются текстуры трех последних размеров)
+        pool_ = utils::gl::RenderTargetPool(3);
+
+        // Таймер GPU (результат читается через 4 кадра) и начальный масштаб
+        gpu_timer_ = utils::gl::GpuTimer(4);
+        dynamic_resolution_.reset(dynamic_resolution_.settings().max_scale);
 
-        // Рендеринг возможен
-        render_ = true;
+        // Объявить граф кадра под текущее разрешение (рендеринг возможен после компиляции)
+        on_resolution_change();
     }
 
     /**
@@ -120,23 +127,53 @@ namespace scenes
         shader_secondary_.unload();
         geometry_primary_.unload();
         geometry_secondary_.unload();
+        for(auto& shader : shaders_post_) shader.unload();
+        graph_.unload();
+        pool_.unload();
+        gpu_timer_.unload();
+        render_ = false;
     }
 
     /**
-     * Отслеживание изменения разрешения во время обновления
+     * Отслеживание изменения разрешения и набора эффектов во время обновления, подбор масштаба разрешения
      * @param delta Временная дельта кадра
      */
     void Passes::update([[maybe_unused]] float delta)
     {
         if(g_screen_height != prev_height_
            || g_screen_width != prev_width_
-           || scale_index_ != prev_scale_index_)
+           || blur_ != prev_blur_
+           || vignette_ != prev_vignette_)
         {
             on_resolution_change();
+        }
+
+        // Масштаб по готовому замеру времени GPU (замер запаздывает на несколько кадров, ожидания нет)
+        if(gpu_timer_.fetch(gpu_ms_) && dynamic_scale_)
+        {
+            dynamic_resolution_.update(static_cast<float>(gpu_ms_));
+        }
+        scale_ = dynamic_scale_ ? dynamic_resolution_.scale() : scales_[scale_index_];
+        update_render_area();
+
+        // Удаление давно не используемых текстур пула
+        pool_.next_frame();
+    }
 
-            prev_width_ = g_screen_width;
-            prev_height_ = g_screen_height;
-            prev_scale_index_ = scale_index_;
+    /**
+     * Задать графу область рендеринга по текущему масштабу (если она изменилась)
+     */
+    void Passes::update_render_area()
+    {
+        // Область рендеринга внутри текстур полного размера
+        const GLsizei width = std::max(static_cast<GLsizei>(std::lround(static_cast<float>(g_screen_width) * scale_)), 1);
+        const GLsizei height = std::max(static_cast<GLsizei>(std::lround(static_cast<float>(g_screen_height) * scale_)), 1);
+        if(width != render_width_ || height != render_height_)
+        {
+            render_width_ = width;
+            render_height_ = height;
+            graph_.set_render_area(render_width_, render_height_);
+            resolution_ = std::to_string(render_width_) + "x" + std::to_string(render_height_);
         }
     }
 
@@ -148,7 +185,14 @@ namespace scenes
     {
         if(ImGui::Begin("Frame buffer", nullptr))
         {
-            if(ImGui::BeginCombo("Scale", scale_names_[scale_index_]))
+            ImGui::Checkbox("Dynamic", &dynamic_scale_);
+            if(dynamic_scale_)
+            {
+                auto& settings = dynamic_resolution_.settings();
+                ImGui::SliderFloat("Target (ms)", &settings.target_ms, 0.5f, 33.0f, "%.1f");
+                ImGui::SliderFloat("Min scale", &settings.min_scale, 0.1f, settings.max_scale, "%.2f");
+            }
+            else if(ImGui::BeginCombo("Scale", scale_names_[scale_index_]))
             {
                 for(size_t i = 0; i < scale_names_.size(); i++)
                 {
@@ -159,68 +203,65 @@ namespace scenes
                 ImGui::EndCombo();
             }
 
-            ImGui::Text("Resolution: %s", resolution_.c_str());
-            ImGui::Checkbox("Filtering", &filter_);
+            ImGui::Text("Resolution: %s (%.0f%%)", resolution_.c_str(), scale_ * 100.0f);
+            ImGui::Text("GPU: %.2f ms", gpu_ms_);
+
+            if(ImGui::BeginCombo("Upscale", upscale_filter_names_[upscale_filter_]))
+            {
+                for(size_t i = 0; i < upscale_filter_names_.size(); i++)
+                {
+                    bool is_selected = upscale_filter_ == (int)i;
+                    if(ImGui::Selectable(upscale_filter_names_[i], is_selected)) upscale_filter_ = (int)i;
+                    if(is_selected) ImGui::SetItemDefaultFocus();
+                }
+                ImGui::EndCombo();
+            }
+
+            ImGui::Checkbox("Blur", &blur_);
+            ImGui::Checkbox("Vignette", &vignette_);
+
+            ImGui::SetWindowSize({250.0f, 220.0f}, ImGuiCond_Once);
+            ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + 220.0f }, ImGuiCond_Once);
+        }
+        ImGui::End();
 
-            ImGui::SetWindowSize({200.0f, 100.0f}, ImGuiCond_Once);
-            ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + 100.0f }, ImGuiCond_Once);
+        if(ImGui::Begin("Render graph", nullptr))
+        {
+            // Проходы после отсечения (в порядке выполнения) и память временных текстур
+            const auto& stats = graph_.stats();
+            ImGui::Text("Passes: %u / %u", (unsigned)stats.passes_executed, (unsigned)stats.passes_declared);
+            for(const auto& pass : graph_.executed_passes()) ImGui::BulletText("%s", pass.c_str());
+            ImGui::Text("Textures: %u (transient resources: %u)", (unsigned)stats.physical_textures, (unsigned)stats.transient_textures);
+            ImGui::Text("Memory: %.2f MB (without aliasing: %.2f MB)",
+                        (double)stats.bytes_aliased / (1024.0 * 1024.0),
+                        (double)stats.bytes_unaliased / (1024.0 * 1024.0));
+
+            // Пул целей рендеринга
+            const auto pool_stats = pool_.stats();
+            ImGui::Separator();
+            ImGui::Text("Pool: %u textures (%u in use), %.2f MB",
+                        (unsigned)pool_stats.textures, (unsigned)pool_stats.textures_in_use,
+                        (double)pool_stats.bytes / (1024.0 * 1024.0));
+            ImGui::Text("Requests: %u reused, %u created, %u evicted",
+                        (unsigned)pool_stats.reused, (unsigned)pool_stats.created, (unsigned)pool_stats.evicted);
+
+            ImGui::SetWindowSize({300.0f, 240.0f}, ImGuiCond_Once);
         }
         ImGui::End();
     }
 
     /**
      * Рисование сцены
-     * В данном примере всего один вызов отрисовки
+     * Проходы выполняются графом (кадровые буферы и области вывода привязываются перед каждым проходом)
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Passes::render()
+    void Passes::render([[maybe_unused]] float alpha)
     {
         if(!render_) return;
 
-        // П Р О Х О Д  - 1
-
-        // Использовать первичный кадровый буфер
-        glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_primary_.id());
-        // Указать область кадра доступную для отрисовки
-        glScissor(0, 0, frame_buffer_primary_.width(), frame_buffer_primary_.height());
-        glViewport(0, 0, frame_buffer_primary_.width(), frame_buffer_primary_.height());
-        // Очистка буфера
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        // Использовать шейдер
-        glUseProgram(shader_primary_.id());
-        // Привязать геометрию
-        glBindVertexArray(geometry_primary_.vao_id());
-        // Нарисовать геометрию
-        glDrawElements(GL_TRIANGLES, geometry_primary_.index_count(), GL_UNSIGNED_INT, nullptr);
-
-        // П Р О Х О Д  - 2
-
-        // Использовать итоговый кадровый буфер
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        // Указать область кадра доступную для отрисовки
-        glScissor(0, 0, g_screen_width, g_screen_height);
-        glViewport(0, 0, g_screen_width, g_screen_height);
-        // Очистка буфера
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        // Привязать цветовое вложение кадрового буфера как текстуру к первому слоту
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, frame_buffer_primary_.attachments_tx()[0]);
-
-        // Фильтрация
-        // Только для примера! Устанавливать параметры текстур в каждом кадре дорого и не есть хорошая практика
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_ ? GL_LINEAR : GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter_ ? GL_LINEAR : GL_NEAREST);
-
-        // Использовать шейдер
-        glUseProgram(shader_secondary_.id());
-        // Привязать геометрию
-        glBindVertexArray(geometry_secondary_.vao_id());
-        // Нарисовать геометрию (квадрат на весь экран) используя текстуру из предыдущего прохода
-        glUniform1i(shader_secondary_.uniforms().frame_texture, 0);
-        glDrawElements(GL_TRIANGLES, geometry_secondary_.index_count(), GL_UNSIGNED_INT, nullptr);
-
-        // Сброс текстур
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gpu_timer_.begin();
+        graph_.execute(&g_profiler);
+        gpu_timer_.end();
     }
 
     /**
@@ -233,31 +274,115 @@ namespace scenes
     }
 
     /**
-     * Событие смены разрешения
-     * Может быть вызвано как изменением размера она так и изменением масштабирования
+     * Событие смены разрешения окна либо набора эффектов (граф объявляется заново)
+     * Смена масштаба разрешения графа не требует - меняется только область рендеринга
      */
     void Passes::on_resolution_change()
     {
         // Остановить рендеринг
         render_ = false;
 
-        // Выгрузить текущий буфер кадра
-        frame_buffer_primary_.unload();
+        // Выгрузить текущий граф (кадровые буферы проходов, текстуры возвращаются в пул)
+        graph_.unload();
+
+        prev_width_ = g_screen_width;
+        prev_height_ = g_screen_height;
+        prev_blur_ = blur_;
+        prev_vignette_ = vignette_;
+
+        // Ресурсы: первичный буфер и буферы пост-обработки (полного размера, рендеринг в область внутри), итоговый буфер
+        const utils::gl::RenderGraphTextureDesc color = {
+                std::max((GLsizei)g_screen_width, 1),
+                std::max((GLsizei)g_screen_height, 1),
+                GL_RGBA8};
+        const utils::gl::RenderGraphTextureDesc depth_stencil = {color.width, color.height, GL_DEPTH32F_STENCIL8};
+
+        const auto scene_color = graph_.create_texture("scene color", color);
+        const auto scene_depth = graph_.create_texture("scene depth", depth_stencil);
+        const auto blur_h = graph_.create_texture("blur horizontal", color);
+        const auto blur_v = graph_.create_texture("blur vertical", color);
+        const auto vignette = graph_.create_texture("vignette", color);
+        const auto back_buffer = graph_.import_frame_buffer("back buffer", 0, g_screen_width, g_screen_height);
+
+        // П Р О Х О Д  - 1 (первичный буфер)
+        graph_.add_pass("scene", {}, {scene_color, scene_depth}, [this](const utils::gl::RenderGraph&){
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glUseProgram(shader_primary_.id());
+            glBindVertexArray(geometry_primary_.vao_id());
+            glDrawElements(GL_TRIANGLES, geometry_primary_.index_count(), geometry_primary_.index_type(), nullptr);
+        });
+
+        // П О С Т - О Б Р А Б О Т К А (объявлена всегда, выключенные эффекты не читаются и отсекаются графом)
+        const auto post_pass = [this](EPostPass pass, utils::gl::RenderGraph::Handle source){
+            return [this, pass, source](const utils::gl::RenderGraph& graph){
+                glUseProgram(shaders_post_[pass].id());
+                glUniform1i(shaders_post_[pass].uniforms().source_texture, 0);
+                glUniform2f(shaders_post_[pass].uniforms().uv_scale, uv_scale().x, uv_scale().y);
+                draw_fullscreen(graph.texture(source));
+            };
+        };
+
+        graph_.add_pass("blur horizontal", {scene_color}, {blur_h}, post_pass(BLUR_HORIZONTAL, scene_color));
+        graph_.add_pass("blur vertical", {blur_h}, {blur_v}, post_pass(BLUR_VERTICAL, blur_h));
+
+        const auto vignette_source = blur_ ? blur_v : scene_color;
+        graph_.add_pass("vignette", {vignette_source}, {vignette}, post_pass(VIGNETTE, vignette_source));
+
+        // П Р О Х О Д  - 2 (вывод результата последнего включенного эффекта в итоговый буфер)
+        const auto result = vignette_ ? vignette : (blur_ ? blur_v : scene_color);
+        graph_.add_pass("present", {result}, {back_buffer}, [this, result](const utils::gl::RenderGraph& graph){
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Создать новый первичный кадровый буфер
-        utils::gl::FrameBufferAttachmentInfo color{GL_RGBA, GL_RGBA, GL_COLOR_ATTACHMENT0, GL_NEAREST};
-        utils::gl::RenderBufferAttachmentInfo depth_stencil{GL_DEPTH32F_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT};
-        frame_buffer_primary_ = utils::gl::FrameBuffer(
-                (GLsizei)((float)g_screen_width * scales_[scale_index_]),
-                (GLsizei)((float)g_screen_height * scales_[scale_index_]),
-                {color},
-                {depth_stencil});
+            // Фильтрация (бикубическая - поверх билинейных выборок)
+            // Только для примера! Устанавливать параметры текстур в каждом кадре дорого и не есть хорошая практика
+            const GLint filter = upscale_filter_ == NEAREST ? GL_NEAREST : GL_LINEAR;
+            glTextureParameteri(graph.texture(result), GL_TEXTURE_MIN_FILTER, filter);
+            glTextureParameteri(graph.texture(result), GL_TEXTURE_MAG_FILTER, filter);
+
+            glUseProgram(shader_secondary_.id());
+            glUniform1i(shader_secondary_.uniforms().frame_texture, 0);
+            glUniform2f(shader_secondary_.uniforms().uv_scale, uv_scale().x, uv_scale().y);
+            glUniform1i(shader_secondary_.uniforms().bicubic, upscale_filter_ == BICUBIC);
+            draw_fullscreen(graph.texture(result));
+
+            // Фильтрация по умолчанию (текстура может быть совмещена с другими ресурсами)
+            glTextureParameteri(graph.texture(result), GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTextureParameteri(graph.texture(result), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        });
+
+        // Отсечение, упорядочивание и совмещение ресурсов
+        graph_.compile(&pool_);
 
         // Включить рендеринг
-        render_ = frame_buffer_primary_.ready();
+        render_ = graph_.ready();
+
+        // Новому графу область рендеринга задается сразу (рендеринг возможен и до следующего обновления)
+        render_width_ = 0;
+        render_height_ = 0;
+        update_render_area();
+    }
+
+    /**
+     * Доля текстур графа, занятая областью рендеринга
+     * @return Масштаб UV координат
+     */
+    glm::vec2 Passes::uv_scale() const
+    {
+        return {
+                static_cast<float>(render_width_) / static_cast<float>(std::max(g_screen_width, 1)),
+                static_cast<float>(render_height_) / static_cast<float>(std::max(g_screen_height, 1))};
+    }
 
-        // Обновить строчку с разрешением
-        resolution_ = std::to_string(frame_buffer_primary_.width()) +
-                "x" + std::to_string(frame_buffer_primary_.height());
+    /**
+     * Нарисовать квадрат на весь экран с текстурой в первом слоте
+     * @param texture_id Текстура
+     */
+    void Passes::draw_fullscreen(GLuint texture_id) const
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture_id);
+        glBindVertexArray(geometry_secondary_.vao_id());
+        glDrawElements(GL_TRIANGLES, geometry_secondary_.index_count(), geometry_secondary_.index_type(), nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 }
\ No newline at end of file
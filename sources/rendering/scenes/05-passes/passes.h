@@ -2,15 +2,23 @@
 
 #include "utils/gl/shader.hpp"
 #include "utils/gl/geometry.hpp"
-#include "utils/gl/frame-buffer.hpp"
+#include "utils/gl/render-graph.hpp"
+#include "utils/gl/gpu-timer.hpp"
+#include "utils/gl/dynamic-resolution.hpp"
+#include "utils/geometry/layout.hpp"
 
 #include "../scene.h"
 
 namespace scenes
 {
     /**
-     * Пример отображения треугольника в два прохода
-     * Первый проход пишет информацию в первичный экранный буфер, второй выводит результат в конечный буфер
+     * Пример отображения треугольника в несколько проходов
+     * Первый проход пишет информацию в первичный экранный буфер, проходы пост-обработки (размытие, затемнение краев)
+     * читают результат предыдущего, последний выводит результат в конечный буфер.
+     * Проходы и их ресурсы объявляются в графе кадра: неиспользуемые проходы отсекаются, временные текстуры совмещаются.
+     * Текстуры графа берутся из пула целей рендеринга, поэтому смена размера окна не выделяет память повторно.
+     * Текстуры создаются под полный размер окна, масштаб разрешения - область рендеринга внутри них (подбирается
+     * автоматически по времени GPU, либо задается вручную), результат масштабируется до размера окна при выводе
      */
     class Passes : public Scene
     {
@@ -23,6 +31,11 @@ namespace scenes
         {
             glm::vec3 position;
             glm::vec3 color;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &VertexPrimary::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::COLOR, &VertexPrimary::color, 1>>;
         };
 
         /**
@@ -33,6 +46,11 @@ namespace scenes
         {
             glm::vec3 position;
             glm::vec2 uv;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &VertexSecondary::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::UV, &VertexSecondary::uv, 1>>;
         };
 
         /**
@@ -48,6 +66,39 @@ namespace scenes
         struct ShaderUniformsSecondary
         {
             GLint frame_texture;
+            GLint uv_scale;
+            GLint bicubic;
+        };
+
+        /**
+         * Идентификатор uniform переменных проходов пост-обработки
+         */
+        struct ShaderUniformsPost
+        {
+            GLint source_texture;
+            GLint uv_scale;
+        };
+
+        /**
+         * Проходы пост-обработки (вариант шейдера на каждый)
+         */
+        enum EPostPass : size_t
+        {
+            BLUR_HORIZONTAL = 0,
+            BLUR_VERTICAL,
+            VIGNETTE,
+            POST_PASS_TOTAL
+        };
+
+        /**
+         * Фильтр масштабирования при выводе
+         */
+        enum EUpscaleFilter : int
+        {
+            NEAREST = 0,
+            BILINEAR,
+            BICUBIC,
+            UPSCALE_FILTER_TOTAL
         };
 
     public:
@@ -66,7 +117,7 @@ namespace scenes
         void unload() override;
 
         /**
-         * Отслеживание изменения разрешения во время обновления
+         * Отслеживание изменения разрешения и набора эффектов во время обновления, подбор масштаба разрешения
          * @param delta Временная дельта кадра
          */
         void update(float delta) override;
@@ -80,8 +131,9 @@ namespace scenes
         /**
          * Рисование сцены
          * В данном примере всего один вызов отрисовки
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
          */
-        void render() override;
+        void render(float alpha) override;
 
         /**
          * Имя примера
@@ -91,31 +143,72 @@ namespace scenes
 
     protected:
         /**
-         * Событие смены разрешения
-         * Может быть вызвано как изменением размера она так и изменением масштабирования
+         * Событие смены разрешения окна либо набора эффектов (граф объявляется заново)
+         * Смена масштаба разрешения графа не требует - меняется только область рендеринга
          */
         void on_resolution_change();
 
+        /**
+         * Задать графу область рендеринга по текущему масштабу (если она изменилась)
+         */
+        void update_render_area();
+
+        /**
+         * Нарисовать квадрат на весь экран с текстурой в первом слоте
+         * @param texture_id Текстура
+         */
+        void draw_fullscreen(GLuint texture_id) const;
+
+        /**
+         * Доля текстур графа, занятая областью рендеринга
+         * @return Масштаб UV координат
+         */
+        [[nodiscard]] glm::vec2 uv_scale() const;
+
     private:
         // Ресурсы
         utils::gl::Shader<ShaderUniformsPrimary, GLint> shader_primary_;
         utils::gl::Shader<ShaderUniformsSecondary, GLint> shader_secondary_;
         utils::gl::Geometry<VertexPrimary> geometry_primary_;
+        utils::gl::Shader<ShaderUniformsPost, GLint> shaders_post_[POST_PASS_TOTAL];
         utils::gl::Geometry<VertexSecondary> geometry_secondary_;
-        utils::gl::FrameBuffer frame_buffer_primary_;
 
-        // Настройки разрешения и масштабирования
-        int prev_width_, prev_height_, prev_scale_index_;
+        // Пул целей рендеринга (объявлен до графа - граф возвращает текстуры в пул при уничтожении)
+        utils::gl::RenderTargetPool pool_;
+
+        // Граф кадра (первичный буфер, буферы пост-обработки и вывод в итоговый буфер)
+        utils::gl::RenderGraph graph_;
+
+        // Замер времени выполнения графа на GPU и регулятор масштаба
+        utils::gl::GpuTimer gpu_timer_;
+        utils::gl::DynamicResolution dynamic_resolution_;
+
+        // Настройки разрешения и масштабирования (и эффектов, заданных при объявлении графа)
+        int prev_width_, prev_height_;
+        bool prev_blur_, prev_vignette_;
         int scale_index_;
         std::vector<float> scales_;
         std::vector<const char*> scale_names_;
 
-        // Имеет смысл приостановить рендеринг пока фрейм-буфер не доступен
-        // Фрейм-буфер может быть пере-создан в результате смены размеров итогового экрана (окна)
+        // Масштаб подбирается автоматически (иначе - из списка), текущий масштаб и размер области рендеринга
+        bool dynamic_scale_;
+        float scale_;
+        GLsizei render_width_, render_height_;
+
+        // Последний замер времени GPU (мс)
+        double gpu_ms_;
+
+        // Имеет смысл приостановить рендеринг пока граф не скомпилирован
+        // Граф объявляется заново в результате смены размеров итогового экрана (окна) либо набора эффектов
         bool render_;
 
-        // Использовать фильтрацию текстуры кадрового буфера
-        bool filter_;
+        // Фильтр масштабирования при выводе
+        int upscale_filter_;
+        std::vector<const char*> upscale_filter_names_;
+
+        // Эффекты пост-обработки
+        bool blur_;
+        bool vignette_;
 
         // Текущее разрешение
         std::string resolution_;
@@ -3,12 +3,19 @@
 #include <glm/gtx/norm.hpp>
 #include <utils/files/load.hpp>
 #include <utils/geometry/generate.hpp>
+#include <utils/geometry/bounds.hpp>
+#include <chrono>
+#include <unordered_set>
+#include <utils/gl/shader-preprocessor.hpp>
 #include <imgui.h>
 
 #include "lighting.h"
 
 // Соотношение сторон экрана
 extern float g_screen_aspect;
+// Размеры экрана (пикселей)
+extern int g_screen_width;
+extern int g_screen_height;
 // Включен ли UI (свободная камера доступна вы отключенном UI)
 extern bool g_use_ui;
 // Управление
@@ -20,6 +27,11 @@ extern bool g_key_downward;
 extern bool g_key_upward;
 extern float g_mouse_delta_x;
 extern float g_mouse_delta_y;
+// Система задач и препроцессор шейдеров
+extern utils::threads::JobSystem g_jobs;
+extern utils::gl::ShaderPreprocessor g_shader_preprocessor;
+// Профилировщик кадра
+extern utils::gl::Profiler g_profiler;
 
 namespace scenes
 {
@@ -30,14 +42,35 @@ namespace scenes
             "Directional"
     };
 
+    const std::vector<const char*> Lighting::occlusion_mode_names_ = {
+            "Frustum only",
+            "GPU Hi-Z (previous frame)",
+            "CPU rasterizer"
+    };
+
+    const std::vector<std::string> Lighting::shader_paths_ = {
+            "../content/shaders/lighting/base.vert",
+            "../content/shaders/lighting/base.frag"
+    };
+
     Lighting::Lighting()
-            : projection_(glm::mat4(1.0f))
+            : bounds_ssbo_id_(0)
+            , commands_buffer_id_(0)
+            , counter_current_(0)
+            , counter_oldest_(0)
+            , counter_pending_(0)
+            , hi_z_view_projection_(glm::mat4(1.0f))
+            , hi_z_valid_(false)
+            , projection_(glm::mat4(1.0f))
             , view_(glm::mat4(1.0f))
             , model_{glm::mat4(1.0f),glm::mat4(1.0f)}
             , camera_pos_(glm::vec3(0.0f, 2.0f, 4.0f))
             , object_pos_{glm::vec3(0.0f, -0.5f, 0.0f), glm::vec3(0.0f, 0.25f, 0.0f)}
             , object_scale_{glm::vec3(10.0f, 0.5f, 10.0f),glm::vec3(1.0f, 1.0f, 1.0f)}
             , object_rotation_{glm::vec3(0.0f),glm::vec3(0.0f)}
+            , prev_camera_pos_(camera_pos_)
+            , prev_cam_yaw_(0.0f)
+            , prev_cam_pitch_(-25.0f)
             , z_far_(100.0f)
             , z_near_(0.1f)
             , fov_(45.0f)
@@ -46,6 +79,13 @@ namespace scenes
             , cam_sensitivity_(0.1f)
             , cam_speed_(1.0f)
             , cam_movement_(0.0f)
+            , static_light_types_(true)
+            , use_lods_(true)
+            , lod_pixel_error_(1.0f)
+            , occlusion_mode_(EOcclusionMode::GPU_HI_Z)
+            , stat_triangles_(0)
+            , stat_visible_(0)
+            , stat_cpu_occlusion_ms_(0.0f)
     {}
 
     Lighting::~Lighting() = default;
@@ -58,14 +98,16 @@ namespace scenes
     {
         // Шейдеры
         {
-            // Загрузить исходные коды шейдеров
+            // Загрузить исходные коды шейдеров (с раскрытием #include, параллельно в рабочих потоках)
+            const auto sources = g_shader_preprocessor.process_all(g_jobs, shader_paths_);
+
             const std::unordered_map<GLuint, std::string> shader_sources = {
-                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/lighting/base.vert")},
-                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/lighting/base.frag")}
+                    {GL_VERTEX_SHADER,  sources[0]},
+                    {GL_FRAGMENT_SHADER, sources[1]}
             };
 
-            // Создать OpenGL ресурс шейдера из исходников
-            shader_ = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources,{
+            // Набор вариантов шейдера (программы компилируются при первом использовании)
+            shader_ = utils::gl::ShaderVariants<ShaderUniforms, GLint>(shader_sources,{
                     "model",
                     "view",
                     "projection",
@@ -78,32 +120,111 @@ namespace scenes
                     "light_hot_spots",
                     "light_count"
             });
+
+            // Время изменения всех файлов исходников (для перезагрузки)
+            shader_file_times_.clear();
+            for(const auto& path : shader_paths_)
+            {
+                for(const auto& file : g_shader_preprocessor.dependencies(path))
+                {
+                    shader_file_times_[file] = std::filesystem::last_write_time(file);
+                }
+            }
+
+            // Отсечение и построение иерархического буфера глубины
+            const auto compute_source = [](const char* path){
+                return std::unordered_map<GLuint, std::string>{{GL_COMPUTE_SHADER, utils::files::load_as_text(path)}};
+            };
+
+            cull_shader_ = utils::gl::Shader<OcclusionUniforms, GLint>(compute_source("../content/shaders/occlusion/cull.comp"),{
+                    "view_projection",
+                    "hi_z_view_projection",
+                    "object_count",
+                    "use_occlusion"
+            });
+            depth_copy_shader_ = utils::gl::Shader<OcclusionUniforms, GLint>(compute_source("../content/shaders/occlusion/depth-copy.comp"), {});
+            depth_reduce_shader_ = utils::gl::Shader<OcclusionUniforms, GLint>(compute_source("../content/shaders/occlusion/depth-reduce.comp"), {});
         }
 
         // Геометрия
         {
             // Данные о геометрии (обычно загружается из файлов)
-            using utils::geometry::EAttrBit;
+            // Атрибуты упаковываются генератором при записи (по типам полей раскладки)
             std::vector<GLuint> indices = {};
-            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(
-                    1.0f,
-                    EAttrBit::POSITION|EAttrBit::UV|EAttrBit::NORMAL,
-                    offsetof(Vertex, position),
-                    offsetof(Vertex, uv),
-                    offsetof(Vertex, normal),0,
-                    &indices);
-
-            // Описание атрибутов шейдера
-            const std::vector<utils::gl::VertexAttributeInfo> attributes = {
-                    {0, 3, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, position)},
-                    {1, 2, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, uv)},
-                    {2, 3, GL_FLOAT, GL_FALSE, (GLsizeiptr)offsetof(Vertex, normal)}
-            };
+            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(1.0f, &indices);
 
-            // Создать OpenGL ресурс геометрических буферов из данных
-            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, attributes);
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+
+            // Копия положений вершин для программной растеризации (пол и куб - перекрывающие объекты)
+            occluder_positions_.clear();
+            for(const auto& v : vertices) occluder_positions_.push_back(v.position);
+            occluder_indices_ = indices;
         }
 
+        // Плотный меш с цепочкой уровней детализации
+        {
+            // Тор высокой плотности (~37 тыс. треугольников)
+            const unsigned segments = 192, sides = 96;
+            const auto size = utils::geometry::gen_torus_size(segments, sides);
+            std::vector<Vertex> vertices(size.vertex_count);
+            std::vector<GLuint> indices(size.index_count);
+            utils::geometry::gen_torus(vertices.data(), indices.data(), 0.3f, 0.09f, segments, sides);
+
+            // Уровни детализации дописываются в тот же индексный буфер (вершинный буфер общий)
+            lods_ = utils::geometry::generate_lod_chain(indices, vertices, {0.5f, 0.25f, 0.125f, 0.0625f, 0.03125f});
+            lod_geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+
+            // Ограничивающий объем меша (в пространстве меша)
+            utils::geometry::Aabb mesh_bounds;
+            for(const auto& v : vertices) mesh_bounds.expand(v.position);
+
+            // Сетка экземпляров на полу (кроме центра, где находится куб)
+            // Экземпляры неподвижны, их объемы в мировых координатах вычисляются однократно
+            for(int x = -4; x <= 4; x++)
+            {
+                for(int z = -4; z <= 4; z++)
+                {
+                    if(std::abs(x) <= 1 && std::abs(z) <= 1) continue;
+                    const glm::vec3 pos = {static_cast<float>(x) * 1.1f, -0.16f, static_cast<float>(z) * 1.1f};
+                    lod_models_.push_back(glm::translate(glm::mat4(1.0f), pos));
+                    lod_bounds_.push_back({mesh_bounds.min + pos, mesh_bounds.max + pos});
+                }
+            }
+
+            lod_selected_.resize(lod_models_.size(), 0);
+            stat_lod_counts_.resize(lods_.size(), 0);
+
+            // Матрицы экземпляров (экземпляр выбирается командой через base_instance)
+            std::vector<Instance> instances(lod_models_.size());
+            for(size_t i = 0; i < lod_models_.size(); i++) instances[i].model = lod_models_[i];
+            lod_geometry_.set_instances(instances, Instance::Layout::attributes(1), 0);
+
+            // Объемы в раскладке std430 (min и max дополнены до vec4)
+            std::vector<glm::vec4> bounds_data;
+            for(const auto& box : lod_bounds_)
+            {
+                bounds_data.emplace_back(box.min, 0.0f);
+                bounds_data.emplace_back(box.max, 0.0f);
+            }
+            glCreateBuffers(1, &bounds_ssbo_id_);
+            glNamedBufferStorage(bounds_ssbo_id_, static_cast<GLsizeiptr>(sizeof(glm::vec4) * bounds_data.size()), bounds_data.data(), 0);
+
+            // Команды рисования (обновляются каждый кадр) и кольцо счетчиков видимых экземпляров
+            lod_commands_.resize(lod_models_.size());
+            glCreateBuffers(1, &commands_buffer_id_);
+            glNamedBufferStorage(commands_buffer_id_, static_cast<GLsizeiptr>(sizeof(utils::gl::DrawElementsIndirectCommand) * lod_commands_.size()), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+            visible_counter_ids_.assign(COUNTER_LATENCY, 0);
+            visible_counter_fences_.assign(COUNTER_LATENCY, nullptr);
+            glCreateBuffers(static_cast<GLsizei>(visible_counter_ids_.size()), visible_counter_ids_.data());
+            for(const GLuint id : visible_counter_ids_) glNamedBufferStorage(id, sizeof(GLuint), nullptr, GL_DYNAMIC_STORAGE_BIT);
+            counter_current_ = counter_oldest_ = counter_pending_ = 0;
+        }
+
+        // Кадровый буфер и иерархический буфер глубины
+        create_targets();
+
         // Источники света
         {
             light_positions_.emplace_back(-2.0f, 0.5f, 0.0f);
@@ -121,9 +242,18 @@ namespace scenes
             light_fall_offs_.emplace_back(1.8f);
         }
 
+        // Варианты под начальный набор источников (ошибки сборки - при загрузке, далее они служат запасными)
+        shader_.get(shader_defines());
+        shader_.get(shader_defines(true));
+
         // Проверка доступности ресурсов
         assert(shader_.ready());
         assert(geometry_.ready());
+        assert(lod_geometry_.ready());
+        assert(cull_shader_.ready());
+        assert(depth_copy_shader_.ready());
+        assert(depth_reduce_shader_.ready());
+        assert(frame_buffer_.ready());
     }
 
     /**
@@ -132,7 +262,47 @@ namespace scenes
     void Lighting::unload()
     {
         shader_.unload();
+        shader_file_times_.clear();
         geometry_.unload();
+        lod_geometry_.unload();
+        frame_buffer_.unload();
+        depth_pyramid_.unload();
+        cull_shader_.unload();
+        depth_copy_shader_.unload();
+        depth_reduce_shader_.unload();
+
+        if(bounds_ssbo_id_) glDeleteBuffers(1, &bounds_ssbo_id_);
+        if(commands_buffer_id_) glDeleteBuffers(1, &commands_buffer_id_);
+        bounds_ssbo_id_ = 0;
+        commands_buffer_id_ = 0;
+
+        for(const GLsync fence : visible_counter_fences_) if(fence) glDeleteSync(fence);
+        if(!visible_counter_ids_.empty()) glDeleteBuffers(static_cast<GLsizei>(visible_counter_ids_.size()), visible_counter_ids_.data());
+        visible_counter_ids_.clear();
+        visible_counter_fences_.clear();
+        counter_current_ = counter_oldest_ = counter_pending_ = 0;
+
+        // Данные, заполняемые при загрузке (повторная загрузка начинается с пустых массивов)
+        occluder_positions_.clear();
+        occluder_indices_.clear();
+        lods_.clear();
+        lod_models_.clear();
+        lod_bounds_.clear();
+        lod_selected_.clear();
+        lod_visible_.clear();
+        lod_commands_.clear();
+        stat_lod_counts_.clear();
+
+        light_positions_.clear();
+        light_colors_.clear();
+        light_directions_.clear();
+        light_types_.clear();
+        light_hot_spots_.clear();
+        light_fall_offs_.clear();
+
+        stat_triangles_ = 0;
+        stat_visible_ = 0;
+        hi_z_valid_ = false;
     }
 
     /**
@@ -141,6 +311,11 @@ namespace scenes
      */
     void Lighting::update([[maybe_unused]] float delta)
     {
+        // Состояние предыдущего шага
+        prev_camera_pos_ = camera_pos_;
+        prev_cam_yaw_ = cam_yaw_;
+        prev_cam_pitch_ = cam_pitch_;
+
         // Управление свободной камерой
         if(!g_use_ui)
         {
@@ -194,6 +369,41 @@ namespace scenes
                     glm::scale(glm::mat4(1.0f),object_scale_[i]);
         }
 
+        // Отсечение на CPU: перекрывающие объекты текущего кадра растеризуются в буфер низкого разрешения
+        if(occlusion_mode_ == EOcclusionMode::CPU_RASTER)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+
+            occlusion_buffer_.begin(projection_ * view_);
+            for(const auto& m : model_) occlusion_buffer_.add_occluder(occluder_positions_, occluder_indices_, m);
+            occlusion_buffer_.rasterize(g_jobs);
+            stat_visible_ = static_cast<GLuint>(occlusion_buffer_.test(g_jobs, lod_bounds_, lod_visible_));
+
+            const auto end = std::chrono::high_resolution_clock::now();
+            stat_cpu_occlusion_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+        }
+
+        // Выбор уровней детализации (экземпляры без масштаба, ошибка в пространстве меша равна мировой)
+        stat_triangles_ = 0;
+        std::fill(stat_lod_counts_.begin(), stat_lod_counts_.end(), 0);
+        for(size_t i = 0; i < lod_models_.size(); i++)
+        {
+            const float distance = glm::length(glm::vec3(lod_models_[i][3]) - camera_pos_);
+            lod_selected_[i] = use_lods_
+                    ? utils::geometry::select_lod(lods_, distance, 1.0f, projection_[1][1], static_cast<float>(g_screen_height), lod_pixel_error_)
+                    : 0;
+
+            stat_triangles_ += lods_[lod_selected_[i]].index_count / 3;
+            stat_lod_counts_[lod_selected_[i]]++;
+
+            // Команда рисования экземпляра (видимость определяется на GPU, либо уже определена на CPU)
+            const auto& lod = lods_[lod_selected_[i]];
+            lod_commands_[i].count = static_cast<GLuint>(lod.index_count);
+            lod_commands_[i].instance_count = occlusion_mode_ == EOcclusionMode::CPU_RASTER ? lod_visible_[i] : 1;
+            lod_commands_[i].first_index = static_cast<GLuint>(lod.first_index);
+            lod_commands_[i].base_vertex = 0;
+            lod_commands_[i].base_instance = static_cast<GLuint>(i);
+        }
     }
 
     /**
@@ -233,14 +443,116 @@ namespace scenes
             }
             ImGui::End();
         }
+
+        if(ImGui::Begin("Shader", nullptr))
+        {
+            ImGui::Checkbox("Static light types", &static_light_types_);
+            ImGui::Text("Compiled variants: %u", (unsigned)shader_.variant_count());
+            if(ImGui::Button("Reload changed")) reload_shaders();
+            if(!shader_reload_error_.empty()) ImGui::TextWrapped("Reload: %s", shader_reload_error_.c_str());
+
+            // Несобираемые варианты (вместо них рисуется последний собранный)
+            for(const auto& [key, error] : shader_.failures())
+            {
+                ImGui::TextWrapped("Failed %s: %s", key.c_str(), error.c_str());
+            }
+
+            ImGui::SetWindowSize({220.0f, 70.0f}, ImGuiCond_Once);
+        }
+        ImGui::End();
+
+        if(ImGui::Begin("Levels of detail", nullptr))
+        {
+            ImGui::Checkbox("Select by distance", &use_lods_);
+            ImGui::SliderFloat("Pixel error", &lod_pixel_error_, 0.1f, 16.0f);
+            ImGui::Text("Triangles: %u (full: %u)",
+                        (unsigned)stat_triangles_,
+                        (unsigned)(lods_[0].index_count / 3 * lod_models_.size()));
+
+            for(size_t i = 0; i < lods_.size(); i++)
+            {
+                ImGui::Text("LOD %u: %u tris, error %.4f, objects %u",
+                            (unsigned)i,
+                            (unsigned)(lods_[i].index_count / 3),
+                            lods_[i].error,
+                            (unsigned)stat_lod_counts_[i]);
+            }
+
+            ImGui::SetWindowSize({300.0f, 200.0f}, ImGuiCond_Once);
+        }
+        ImGui::End();
+
+        if(ImGui::Begin("Occlusion culling", nullptr))
+        {
+            if(ImGui::BeginCombo("Mode", occlusion_mode_names_[static_cast<size_t>(occlusion_mode_)]))
+            {
+                for(size_t j = 0; j < static_cast<size_t>(EOcclusionMode::TOTAL); j++)
+                {
+                    bool is_selected = static_cast<size_t>(occlusion_mode_) == j;
+                    if(ImGui::Selectable(occlusion_mode_names_[j], is_selected)) occlusion_mode_ = static_cast<EOcclusionMode>(j);
+                    if(is_selected) ImGui::SetItemDefaultFocus();
+                }
+                ImGui::EndCombo();
+            }
+
+            ImGui::Text("Visible objects: %u / %u", stat_visible_, (unsigned)lod_models_.size());
+            if(occlusion_mode_ == EOcclusionMode::CPU_RASTER)
+            {
+                ImGui::Text("CPU: %dx%d, %u triangles, %.3f ms",
+                            occlusion_buffer_.width(),
+                            occlusion_buffer_.height(),
+                            (unsigned)occlusion_buffer_.stats().triangles_rasterized,
+                            stat_cpu_occlusion_ms_);
+            }
+            else
+            {
+                ImGui::Text("Hi-Z: %dx%d, %d levels", depth_pyramid_.width(), depth_pyramid_.height(), depth_pyramid_.levels());
+            }
+
+            ImGui::SetWindowSize({300.0f, 110.0f}, ImGuiCond_Once);
+        }
+        ImGui::End();
     }
 
     /**
      * Рисование сцены
-     * В данном примере рисуются 2 квадрата с разными цветами вершин
+     * Сцена рисуется в собственный кадровый буфер: крупные объекты (пол и куб) рисуются всегда и служат
+     * перекрывающими, экземпляры плотного меша проверяются на GPU по иерархическому буферу глубины,
+     * построенному из глубины предыдущего кадра (с матрицами того же кадра), либо уже отсечены на CPU.
+     * Затем из глубины текущего кадра строится буфер для следующего, изображение копируется в основной кадровый буфер.
+     * Камера строится по состоянию между двумя последними шагами обновления (кроме отсечения на CPU - оно выполнено
+     * для камеры шага, и рисовать нужно с ней же)
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
      */
-    void Lighting::render()
+    void Lighting::render(float alpha)
     {
+        // Камера
+        if(occlusion_mode_ != EOcclusionMode::CPU_RASTER)
+        {
+            // Поворот камеры
+            const glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_yaw_, cam_yaw_, alpha)),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_pitch_, cam_pitch_, alpha)),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Смещение камеры
+            const glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), glm::mix(prev_camera_pos_, camera_pos_, alpha));
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            view_ = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        // Пересоздать буферы при изменении размера экрана
+        if(frame_buffer_.width() != std::max(g_screen_width, 1) || frame_buffer_.height() != std::max(g_screen_height, 1))
+        {
+            create_targets();
+        }
+
+        // Рисовать в кадровый буфер сцены
+        glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_.id());
+        glViewport(0, 0, frame_buffer_.width(), frame_buffer_.height());
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
         // Считать передние грани заданными по часовой стрелке
         glFrontFace(GL_CW);
         // Отбрасывать задние грани
@@ -248,32 +560,122 @@ namespace scenes
         // Включить тест глубины
         glEnable(GL_DEPTH_TEST);
 
-        // Использовать шейдер
-        glUseProgram(shader_.id());
-        // Привязать геометрию
-        glBindVertexArray(geometry_.vao_id());
-
-        // Задать матрицу проекции и вида (для всех draw call'ов)
-        glUniformMatrix4fv(shader_.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
-        glUniformMatrix4fv(shader_.uniforms().view, 1, GL_FALSE, glm::value_ptr(view_));
-
-        // Передать информацию об источниках освещения
-        glUniform3fv(shader_.uniforms().light_positions, (GLsizei)light_positions_.size(), glm::value_ptr(light_positions_[0]));
-        glUniform3fv(shader_.uniforms().light_colors, (GLsizei)light_colors_.size(), glm::value_ptr(light_colors_[0]));
-        glUniform3fv(shader_.uniforms().light_directions, (GLsizei)light_directions_.size(), glm::value_ptr(light_directions_[0]));
-        glUniform1uiv(shader_.uniforms().light_types, (GLsizei)light_types_.size(), light_types_.data());
-        glUniform1fv(shader_.uniforms().light_hot_spots, (GLsizei)light_hot_spots_.size(), light_hot_spots_.data());
-        glUniform1fv(shader_.uniforms().light_fall_offs, (GLsizei)light_fall_offs_.size(), light_fall_offs_.data());
-        glUniform1ui(shader_.uniforms().light_count, (GLuint)light_types_.size());
-
-        for(auto &m : model_)
+        // Крупные объекты (вариант шейдера под текущий набор источников, при первом запросе будет скомпилирован)
         {
-            // Нарисовать геометрию используя матрицу модели и информацию об источниках света
-            glUniformMatrix4fv(shader_.uniforms().model, 1, GL_FALSE, glm::value_ptr(m));
-            glDrawElements(GL_TRIANGLES, geometry_.index_count(), GL_UNSIGNED_INT, nullptr);
+            utils::gl::ProfilerScope scope(g_profiler, "Objects");
+            const auto& shader = shader_.get(shader_defines());
+            glUseProgram(shader.id());
+            glBindVertexArray(geometry_.vao_id());
+            set_frame_uniforms(shader);
+
+            for(auto &m : model_)
+            {
+                // Нарисовать геометрию используя матрицу модели и информацию об источниках света
+                glUniformMatrix4fv(shader.uniforms().model, 1, GL_FALSE, glm::value_ptr(m));
+                glDrawElements(GL_TRIANGLES, geometry_.index_count(), geometry_.index_type(), nullptr);
+            }
         }
 
+        // Экземпляры уже отсечены на CPU (команды передаются как есть)
+        if(occlusion_mode_ == EOcclusionMode::CPU_RASTER)
+        {
+            glNamedBufferSubData(commands_buffer_id_, 0,
+                                 static_cast<GLsizeiptr>(sizeof(utils::gl::DrawElementsIndirectCommand) * lod_commands_.size()),
+                                 lod_commands_.data());
+        }
+        // Отсечение экземпляров плотного меша (кол-во экземпляров в командах - 0 либо 1)
+        else
+        {
+            utils::gl::ProfilerScope scope(g_profiler, "Culling");
+
+            // Результаты отсечения предыдущих кадров, барьеры которых уже пройдены (для статистики, без ожидания GPU)
+            while(counter_pending_ > 0)
+            {
+                GLsync& fence = visible_counter_fences_[counter_oldest_];
+                const GLenum status = glClientWaitSync(fence, 0, 0);
+                if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+                glGetNamedBufferSubData(visible_counter_ids_[counter_oldest_], 0, sizeof(GLuint), &stat_visible_);
+                glDeleteSync(fence);
+                fence = nullptr;
+
+                counter_oldest_ = (counter_oldest_ + 1) % visible_counter_ids_.size();
+                counter_pending_--;
+            }
+
+            // Кольцо заполнено - самый старый результат теряется
+            if(counter_pending_ == visible_counter_ids_.size())
+            {
+                glDeleteSync(visible_counter_fences_[counter_oldest_]);
+                visible_counter_fences_[counter_oldest_] = nullptr;
+                counter_oldest_ = (counter_oldest_ + 1) % visible_counter_ids_.size();
+                counter_pending_--;
+            }
+
+            const GLuint counter_id = visible_counter_ids_[counter_current_];
+            const GLuint zero = 0;
+            glNamedBufferSubData(counter_id, 0, sizeof(GLuint), &zero);
+            glNamedBufferSubData(commands_buffer_id_, 0,
+                                 static_cast<GLsizeiptr>(sizeof(utils::gl::DrawElementsIndirectCommand) * lod_commands_.size()),
+                                 lod_commands_.data());
+
+            // Пирамида видимости - текущего кадра, перекрытие проверяется в проекции кадра, из глубины которого
+            // построен иерархический буфер (без буфера - первый кадр, смена размера - только пирамида видимости)
+            const bool occlusion = occlusion_mode_ == EOcclusionMode::GPU_HI_Z && hi_z_valid_;
+            const glm::mat4 view_projection = projection_ * view_;
+
+            glUseProgram(cull_shader_.id());
+            glUniformMatrix4fv(cull_shader_.uniforms().view_projection, 1, GL_FALSE, glm::value_ptr(view_projection));
+            glUniformMatrix4fv(cull_shader_.uniforms().hi_z_view_projection, 1, GL_FALSE, glm::value_ptr(hi_z_view_projection_));
+            glUniform1ui(cull_shader_.uniforms().object_count, static_cast<GLuint>(lod_commands_.size()));
+            glUniform1i(cull_shader_.uniforms().use_occlusion, occlusion ? 1 : 0);
+
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bounds_ssbo_id_);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commands_buffer_id_);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, counter_id);
+            glBindTextureUnit(0, depth_pyramid_.texture_id());
+
+            glDispatchCompute((static_cast<GLuint>(lod_commands_.size()) + 63) / 64, 1, 1);
+
+            // Команды будут прочитаны непрямым рисованием, счетчик - чтением буфера после прохождения барьера кадра
+            glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+            visible_counter_fences_[counter_current_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            counter_current_ = (counter_current_ + 1) % visible_counter_ids_.size();
+            counter_pending_++;
+            glBindTextureUnit(0, 0);
+        }
+
+        // Экземпляры плотного меша (участок индексного буфера выбранного уровня детализации, одним вызовом)
+        {
+            utils::gl::ProfilerScope scope(g_profiler, "Instances");
+            const auto& shader = shader_.get(shader_defines(true));
+            glUseProgram(shader.id());
+            glBindVertexArray(lod_geometry_.vao_id());
+            set_frame_uniforms(shader);
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer_id_);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, lod_geometry_.index_type(), nullptr, static_cast<GLsizei>(lod_commands_.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        // Иерархический буфер глубины для следующего кадра (только когда используется)
+        if(occlusion_mode_ == EOcclusionMode::GPU_HI_Z)
+        {
+            utils::gl::ProfilerScope scope(g_profiler, "Depth pyramid");
+            depth_pyramid_.build(frame_buffer_.attachment_tx(GL_DEPTH_ATTACHMENT), depth_copy_shader_.id(), depth_reduce_shader_.id());
+            hi_z_view_projection_ = projection_ * view_;
+        }
+        hi_z_valid_ = occlusion_mode_ == EOcclusionMode::GPU_HI_Z;
+
+        // Копировать изображение в основной кадровый буфер
+        glBlitNamedFramebuffer(frame_buffer_.id(), 0,
+                               0, 0, frame_buffer_.width(), frame_buffer_.height(),
+                               0, 0, g_screen_width, g_screen_height,
+                               GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
         // Сброс
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindVertexArray(0);
         glActiveTexture(GL_TEXTURE0 );
         glBindTexture(GL_TEXTURE_2D, 0);
     }
@@ -286,4 +688,123 @@ namespace scenes
     {
         return "Basic lightning";
     }
+
+    /**
+     * Макро-определения для специализации шейдера под текущий набор источников света
+     * Размер массивов округляется до степени двойки (чтобы не собирать вариант на каждое кол-во),
+     * маска типов исключает из программы код отсутствующих типов источников
+     * @return Набор определений
+     */
+    utils::gl::ShaderDefines Lighting::shader_defines(bool instanced) const
+    {
+        size_t bucket = 1;
+        while(bucket < light_types_.size()) bucket <<= 1;
+
+        GLuint type_mask = 0;
+        for(auto type : light_types_) type_mask |= (1u << type);
+
+        utils::gl::ShaderDefines defines = {
+                {"MAX_LIGHT_SOURCES", std::to_string(bucket)},
+                {"LIGHT_TYPE_MASK", std::to_string(type_mask)}
+        };
+
+        // Точный список типов (размер массива совпадает с кол-вом источников)
+        if(static_light_types_ && bucket == light_types_.size())
+        {
+            std::string types;
+            for(size_t i = 0; i < light_types_.size(); i++)
+            {
+                if(i > 0) types += ",";
+                types += std::to_string(light_types_[i]) + "u";
+            }
+            defines["LIGHT_TYPES"] = types;
+        }
+
+        // Матрица модели из атрибута экземпляра (для непрямого рисования)
+        if(instanced) defines["INSTANCED"] = "1";
+
+        return defines;
+    }
+
+    /**
+     * Задать матрицы камеры и параметры источников света
+     * Для специализированных вариантов типы и кол-во источников - константы (uniform-переменные отсутствуют)
+     * @param shader Используемый вариант шейдера
+     */
+    void Lighting::set_frame_uniforms(const utils::gl::Shader<ShaderUniforms, GLint>& shader) const
+    {
+        glUniformMatrix4fv(shader.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
+        glUniformMatrix4fv(shader.uniforms().view, 1, GL_FALSE, glm::value_ptr(view_));
+
+        glUniform3fv(shader.uniforms().light_positions, (GLsizei)light_positions_.size(), glm::value_ptr(light_positions_[0]));
+        glUniform3fv(shader.uniforms().light_colors, (GLsizei)light_colors_.size(), glm::value_ptr(light_colors_[0]));
+        glUniform3fv(shader.uniforms().light_directions, (GLsizei)light_directions_.size(), glm::value_ptr(light_directions_[0]));
+        glUniform1uiv(shader.uniforms().light_types, (GLsizei)light_types_.size(), light_types_.data());
+        glUniform1fv(shader.uniforms().light_hot_spots, (GLsizei)light_hot_spots_.size(), light_hot_spots_.data());
+        glUniform1fv(shader.uniforms().light_fall_offs, (GLsizei)light_fall_offs_.size(), light_fall_offs_.data());
+        glUniform1ui(shader.uniforms().light_count, (GLuint)light_types_.size());
+    }
+
+    /**
+     * Создать кадровый буфер и иерархический буфер глубины под текущий размер экрана
+     * Глубина хранится в текстуре (для построения иерархического буфера), буфер предыдущего кадра становится недействительным
+     */
+    void Lighting::create_targets()
+    {
+        const GLsizei width = std::max(g_screen_width, 1);
+        const GLsizei height = std::max(g_screen_height, 1);
+
+        utils::gl::FrameBufferAttachmentInfo color{GL_RGBA8, GL_RGBA, GL_COLOR_ATTACHMENT0, GL_NEAREST};
+        utils::gl::FrameBufferAttachmentInfo depth{GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_DEPTH_ATTACHMENT, GL_NEAREST};
+
+        frame_buffer_ = utils::gl::FrameBuffer(width, height, {color, depth}, {});
+        depth_pyramid_ = utils::gl::DepthPyramid(width, height);
+        hi_z_valid_ = false;
+    }
+
+    /**
+     * Перезагрузить исходники шейдера, если изменился любой из их файлов (включая подключаемые)
+     * Препроцессор сбрасывает кеш измененных файлов и сообщает затронутые корневые исходники,
+     * неизмененные корневые исходники берутся из его кеша. Варианты собираются заново при запросе,
+     * до сборки первого из них (либо при ошибке) рисуется прежний вариант
+     * @return Были ли изменения
+     */
+    bool Lighting::reload_shaders()
+    {
+        std::unordered_set<std::string> affected;
+        for(auto& [file, time] : shader_file_times_)
+        {
+            std::error_code error;
+            const auto current = std::filesystem::last_write_time(file, error);
+            if(error || current == time) continue;
+
+            time = current;
+            for(const auto& root : g_shader_preprocessor.invalidate(file)) affected.insert(root);
+        }
+        if(affected.empty()) return false;
+
+        try
+        {
+            const auto sources = g_shader_preprocessor.process_all(g_jobs, shader_paths_);
+            shader_.reload({
+                    {GL_VERTEX_SHADER,  sources[0]},
+                    {GL_FRAGMENT_SHADER, sources[1]}
+            });
+
+            // Набор подключаемых файлов мог измениться
+            for(const auto& path : shader_paths_)
+            {
+                for(const auto& file : g_shader_preprocessor.dependencies(path))
+                {
+                    if(!shader_file_times_.count(file)) shader_file_times_[file] = std::filesystem::last_write_time(file);
+                }
+            }
+            shader_reload_error_.clear();
+        }
+        catch(const std::exception& ex)
+        {
+            shader_reload_error_ = ex.what();
+        }
+        return true;
+    }
 }
\ No newline at end of file
@@ -1,8 +1,19 @@
 #pragma once
 
 #include "utils/gl/shader.hpp"
+#include "utils/gl/shader-variants.hpp"
 #include "utils/gl/geometry.hpp"
 #include "utils/gl/texture-2d.hpp"
+#include "utils/gl/frame-buffer.hpp"
+#include "utils/gl/depth-pyramid.hpp"
+#include "utils/gl/geometry-pool.hpp"
+#include "utils/gl/profiler.hpp"
+#include "utils/geometry/layout.hpp"
+#include "utils/geometry/simplify.hpp"
+#include "utils/geometry/occlusion-buffer.hpp"
+
+#include <filesystem>
+#include <unordered_map>
 
 #include "../scene.h"
 
@@ -11,19 +22,40 @@ namespace scenes
     /**
      * Пример простого освещение
      * Сцена из нескольких кубов и источников света
+     * Плотные меши вокруг рисуются с уровнем детализации, выбранным по размеру ошибки упрощения на экране,
+     * одним вызовом непрямого рисования после отсечения на GPU по иерархическому буферу глубины предыдущего кадра
+     * либо на CPU по программно растеризованным перекрывающим объектам текущего кадра
      */
     class Lighting : public Scene
     {
     public:
         /**
          * Описание одиночной вершины
-         * В данном примере используется только положение и UV координаты
+         * UV координаты и нормаль упакованы (20 байт вместо 32)
          */
         struct Vertex
         {
             glm::vec3 position;
-            glm::vec2 uv;
-            glm::vec3 normal;
+            utils::geometry::Half2 uv;
+            utils::geometry::Oct16 normal;
+
+            // Раскладка вершины (нормаль восстанавливается в шейдере из 2-х компонентов)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::UV, &Vertex::uv, 1>,
+                    utils::geometry::Attribute<utils::geometry::NORMAL, &Vertex::normal, 2>>;
+        };
+
+        /**
+         * Данные экземпляра плотного меша (выбираются командой рисования через base_instance)
+         */
+        struct Instance
+        {
+            glm::mat4 model;
+
+            // Раскладка экземпляра (матрица передается 4-мя столбцами, location 3-6)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::NONE, &Instance::model, 3>>;
         };
 
         /**
@@ -45,6 +77,18 @@ namespace scenes
             GLint light_count;
         };
 
+        /**
+         * Идентификатор uniform переменных вычислительных шейдеров отсечения
+         * Программы построения иерархического буфера глубины uniform-переменных не имеют
+         */
+        struct OcclusionUniforms
+        {
+            GLint view_projection;
+            GLint hi_z_view_projection;
+            GLint object_count;
+            GLint use_occlusion;
+        };
+
         /**
          * Типы источников освещения
          * Должны соответствовать заданным в шейдере
@@ -58,6 +102,17 @@ namespace scenes
             TOTAL
         };
 
+        /**
+         * Способы отсечения перекрытых экземпляров
+         */
+        enum class EOcclusionMode : int
+        {
+            NONE = 0,       // Только пирамида видимости (на GPU)
+            GPU_HI_Z,       // Иерархический буфер глубины предыдущего кадра (на GPU)
+            CPU_RASTER,     // Программная растеризация перекрывающих объектов текущего кадра (на CPU)
+            TOTAL
+        };
+
     public:
         Lighting();
         ~Lighting() override;
@@ -88,8 +143,9 @@ namespace scenes
         /**
          * Рисование сцены
          * В данном примере всего один вызов отрисовки
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
          */
-        void render() override;
+        void render(float alpha) override;
 
         /**
          * Имя примера
@@ -98,9 +154,81 @@ namespace scenes
         const char* name() override;
 
     protected:
-        // Ресурсы
-        utils::gl::Shader<ShaderUniforms, GLint> shader_;
+        /**
+         * Макро-определения для специализации шейдера под текущий набор источников света
+         * @param instanced Матрица модели передается атрибутом экземпляра
+         * @return Набор определений
+         */
+        [[nodiscard]] utils::gl::ShaderDefines shader_defines(bool instanced = false) const;
+
+        /**
+         * Задать матрицы камеры и параметры источников света
+         * @param shader Используемый вариант шейдера
+         */
+        void set_frame_uniforms(const utils::gl::Shader<ShaderUniforms, GLint>& shader) const;
+
+        /**
+         * Создать кадровый буфер и иерархический буфер глубины под текущий размер экрана
+         */
+        void create_targets();
+
+        /**
+         * Перезагрузить исходники шейдера, если изменился любой из их файлов (включая подключаемые)
+         * @return Были ли изменения
+         */
+        bool reload_shaders();
+
+        // Ресурсы (варианты шейдера компилируются по мере надобности)
+        utils::gl::ShaderVariants<ShaderUniforms, GLint> shader_;
+        // Время изменения файлов исходников шейдера (для перезагрузки)
+        std::unordered_map<std::string, std::filesystem::file_time_type> shader_file_times_;
+        // Ошибка последней перезагрузки исходников
+        std::string shader_reload_error_;
         utils::gl::Geometry<Vertex> geometry_;
+        utils::gl::Geometry<Vertex> lod_geometry_;
+
+        // Кадровый буфер сцены (глубина - текстура) и построенный из его глубины иерархический буфер
+        utils::gl::FrameBuffer frame_buffer_;
+        utils::gl::DepthPyramid depth_pyramid_;
+
+        // Программы отсечения и построения иерархического буфера
+        utils::gl::Shader<OcclusionUniforms, GLint> cull_shader_;
+        utils::gl::Shader<OcclusionUniforms, GLint> depth_copy_shader_;
+        utils::gl::Shader<OcclusionUniforms, GLint> depth_reduce_shader_;
+
+        // Буферы отсечения (объемы экземпляров, команды рисования)
+        GLuint bounds_ssbo_id_;
+        GLuint commands_buffer_id_;
+
+        // Кольцо счетчиков видимых экземпляров: каждый кадр пишет в следующий счетчик, значение читается
+        // через несколько кадров, когда барьер кадра пройден (чтение никогда не ожидает GPU)
+        std::vector<GLuint> visible_counter_ids_;
+        std::vector<GLsync> visible_counter_fences_;
+        // Следующий записываемый счетчик, самый старый непрочитанный и кол-во непрочитанных
+        size_t counter_current_;
+        size_t counter_oldest_;
+        size_t counter_pending_;
+
+        // Команды рисования экземпляров плотного меша (кол-во экземпляров заполняется при отсечении)
+        std::vector<utils::gl::DrawElementsIndirectCommand> lod_commands_;
+
+        // Программный буфер перекрытия, положения вершин и индексы перекрывающего меша (куб)
+        utils::geometry::OcclusionBuffer occlusion_buffer_;
+        std::vector<glm::vec3> occluder_positions_;
+        std::vector<GLuint> occluder_indices_;
+        // Объемы экземпляров в мировых координатах и результат их проверки на CPU
+        std::vector<utils::geometry::Aabb> lod_bounds_;
+        std::vector<uint8_t> lod_visible_;
+
+        // Матрица вида и проекции кадра, из глубины которого построен иерархический буфер
+        glm::mat4 hi_z_view_projection_;
+        bool hi_z_valid_;
+
+        // Уровни детализации плотного меша (участки общего индексного буфера)
+        std::vector<utils::geometry::MeshLod> lods_;
+        // Матрицы моделей и выбранные уровни детализации экземпляров плотного меша
+        std::vector<glm::mat4> lod_models_;
+        std::vector<size_t> lod_selected_;
 
         // Матрицы для преобразования вершин
         glm::mat4 projection_;
@@ -113,6 +241,10 @@ namespace scenes
         glm::vec3 object_scale_[2];
         glm::vec3 object_rotation_[2];
 
+        // Положение и поворот камеры на предыдущем шаге обновления (для интерполяции)
+        glm::vec3 prev_camera_pos_;
+        GLfloat prev_cam_yaw_, prev_cam_pitch_;
+
         // Параметры для построения матрицы проекции
         GLfloat z_far_, z_near_, fov_;
 
@@ -128,7 +260,32 @@ namespace scenes
         std::vector<GLfloat>   light_fall_offs_;
         std::vector<GLfloat>   light_hot_spots_;
 
+        // Типы источников света задаются на этапе компиляции шейдера (вариант на каждую комбинацию)
+        bool static_light_types_;
+
+        // Выбор уровня детализации по расстоянию и допустимая ошибка на экране (пикселей)
+        bool use_lods_;
+        float lod_pixel_error_;
+
+        // Способ отсечения перекрытых экземпляров
+        EOcclusionMode occlusion_mode_;
+
+        // Статистика (треугольников нарисовано и кол-во экземпляров на каждом уровне)
+        size_t stat_triangles_;
+        std::vector<size_t> stat_lod_counts_;
+        // Кол-во видимых экземпляров (при отсечении на GPU - результат одного из предыдущих кадров)
+        GLuint stat_visible_;
+        // Время растеризации и проверки объемов на CPU (мс)
+        float stat_cpu_occlusion_ms_;
+
     private:
+        /**
+         * Кол-во счетчиков видимых экземпляров в кольце (через сколько кадров ожидается результат)
+         */
+        constexpr static size_t COUNTER_LATENCY = 3;
+
         const static std::vector<const char*> light_type_names_;
+        const static std::vector<const char*> occlusion_mode_names_;
+        const static std::vector<std::string> shader_paths_;
     };
 }
\ No newline at end of file
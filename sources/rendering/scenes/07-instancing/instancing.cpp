@@ -0,0 +1,290 @@
+#define GLM_FORCE_SWIZZLE
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <utils/files/load.hpp>
+#include <utils/geometry/generate.hpp>
+#include <imgui.h>
+#include <chrono>
+
+#include "instancing.h"
+
+// Соотношение сторон экрана
+extern float g_screen_aspect;
+// Включен ли UI (свободная камера доступна вы отключенном UI)
+extern bool g_use_ui;
+// Управление
+extern bool g_key_forward;
+extern bool g_key_backward;
+extern bool g_key_left;
+extern bool g_key_right;
+extern bool g_key_downward;
+extern bool g_key_upward;
+extern float g_mouse_delta_x;
+extern float g_mouse_delta_y;
+// Система задач
+extern utils::threads::JobSystem g_jobs;
+
+namespace scenes
+{
+    Instancing::Instancing()
+            : projection_(glm::mat4(1.0f))
+            , view_(glm::mat4(1.0f))
+            , camera_pos_(glm::vec3(0.0f, 40.0f, 60.0f))
+            , prev_camera_pos_(camera_pos_)
+            , prev_cam_yaw_(0.0f)
+            , prev_cam_pitch_(-35.0f)
+            , prev_time_(0.0f)
+            , z_far_(1000.0f)
+            , z_near_(0.1f)
+            , fov_(45.0f)
+            , cam_yaw_(0.0f)
+            , cam_pitch_(-35.0f)
+            , cam_sensitivity_(0.1f)
+            , cam_speed_(20.0f)
+            , cam_movement_(0.0f)
+            , instance_count_(MAX_INSTANCES)
+            , use_culling_(true)
+            , cull_time_ms_(0.0f)
+            , buffer_culled_(false)
+            , time_(0.0f)
+    {}
+
+    Instancing::~Instancing() = default;
+
+    /**
+     * Загрузка шейдеров, геометрии и данных экземпляров
+     * Экземпляры расставляются сеткой, цвет зависит от положения в сетке
+     */
+    void Instancing::load()
+    {
+        // Шейдеры
+        {
+            // Загрузить исходные коды шейдеров
+            const std::unordered_map<GLuint, std::string> shader_sources = {
+                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/instancing/base.vert")},
+                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/instancing/base.frag")}
+            };
+
+            // Создать OpenGL ресурс шейдера из исходников
+            shader_ = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources,{
+                    "view",
+                    "projection",
+                    "time"
+            });
+        }
+
+        // Геометрия
+        {
+            // Данные о геометрии (обычно загружается из файлов)
+            // Нормали упаковываются генератором при записи (по типу поля раскладки)
+            std::vector<GLuint> indices = {};
+            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(1.0f, &indices);
+
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+        }
+
+        // Экземпляры
+        {
+            // Расстановка сеткой (сторона сетки - корень из кол-ва экземпляров)
+            const auto side = (GLsizei)std::ceil(std::sqrt((float)MAX_INSTANCES));
+            const float spacing = 1.5f;
+
+            instances_.resize(MAX_INSTANCES);
+            instance_bounds_.resize(MAX_INSTANCES);
+            for(GLsizei i = 0; i < MAX_INSTANCES; i++)
+            {
+                const auto x = (float)(i % side);
+                const auto z = (float)(i / side);
+                const glm::vec3 pos = {
+                        (x - (float)side * 0.5f) * spacing,
+                        0.0f,
+                        (z - (float)side * 0.5f) * spacing
+                };
+
+                instances_[i].model = glm::translate(glm::mat4(1.0f), pos);
+                instances_[i].color = utils::geometry::pack_unorm8x4({x / (float)side, 0.5f, z / (float)side, 1.0f});
+
+                // Сфера вокруг куба с запасом на смещение волной в вершинном шейдере (амплитуда 0.5)
+                instance_bounds_.set(i, {pos, std::sqrt(3.0f) * 0.5f + 0.5f});
+            }
+
+            // Атрибуты экземпляра по раскладке (делитель 1)
+            geometry_.set_instances(instances_, Instance::Layout::attributes(1));
+        }
+
+        // Проверка доступности ресурсов
+        assert(shader_.ready());
+        assert(geometry_.ready());
+    }
+
+    /**
+     * Выгрузка всех использованных ресурсов граф. API
+     */
+    void Instancing::unload()
+    {
+        shader_.unload();
+        geometry_.unload();
+    }
+
+    /**
+     * Обновление камеры и времени анимации
+     * @param delta Временная дельта кадра
+     */
+    void Instancing::update(float delta)
+    {
+        // Состояние предыдущего шага
+        prev_camera_pos_ = camera_pos_;
+        prev_cam_yaw_ = cam_yaw_;
+        prev_cam_pitch_ = cam_pitch_;
+        prev_time_ = time_;
+
+        time_ += delta;
+
+        // Управление свободной камерой
+        if(!g_use_ui)
+        {
+            cam_pitch_ -= (g_mouse_delta_y * cam_sensitivity_);
+            cam_yaw_ -= (g_mouse_delta_x * cam_sensitivity_);
+
+            cam_movement_ = {};
+            if(g_key_forward) cam_movement_.z = -1.0f;
+            else if(g_key_backward) cam_movement_.z = 1.0f;
+            if (g_key_left) cam_movement_.x = -1.0f;
+            else if(g_key_right) cam_movement_.x = 1.0f;
+            if (g_key_upward) cam_movement_.y = 1.0f;
+            else if(g_key_downward) cam_movement_.y = -1.0f;
+        }
+
+        // Перспективная проекция (с учетом соотношения экрана)
+        projection_ = glm::perspective(fov_, g_screen_aspect, z_near_, z_far_);
+
+        // Камера
+        {
+            // Поворот камеры
+            glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_yaw_),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_pitch_),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Учесть поворот камеры при движении (ось Y всегда направлена вертикально)
+            glm::vec2 h = glm::vec2(cam_movement_.x, cam_movement_.z);
+            glm::vec3 d = glm::length2(h) > 0.0f ? glm::normalize(glm::vec3(h.x, 0.0f, h.y)) : glm::vec3(0.0f);
+            glm::vec4 d_rot = cam_rotation * glm::vec4(d, 0.0f);
+            camera_pos_ += (glm::vec3(d_rot.x, d_rot.y + cam_movement_.y, d_rot.z) * cam_speed_ * delta);
+        }
+    }
+
+    /**
+     * Управление кол-вом рисуемых экземпляров
+     * @param delta Временная дельта кадра
+     */
+    void Instancing::update_ui([[maybe_unused]] float delta)
+    {
+        if(ImGui::Begin("Instancing", nullptr))
+        {
+            const GLsizei drawn = drawn_instance_count();
+
+            ImGui::SliderInt("Instances", &instance_count_, 1, MAX_INSTANCES);
+            ImGui::Checkbox("Frustum culling", &use_culling_);
+            ImGui::Text("Visible: %u", (unsigned)drawn);
+            ImGui::Text("Culling: %.3f ms", use_culling_ ? cull_time_ms_ : 0.0f);
+            ImGui::Text("Triangles: %u", (unsigned)(drawn * (geometry_.index_count() / 3)));
+            ImGui::Text("Draw calls: 1");
+
+            ImGui::SetWindowSize({250.0f, 150.0f}, ImGuiCond_Once);
+            ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + 150.0f }, ImGuiCond_Once);
+        }
+        ImGui::End();
+    }
+
+    /**
+     * Рисование сцены
+     * Камера строится по состоянию между двумя последними шагами обновления, отсечение выполняется для нее же
+     * (раз на кадр, а не на шаг), все видимые экземпляры рисуются одним вызовом
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+     */
+    void Instancing::render(float alpha)
+    {
+        // Камера
+        {
+            // Поворот камеры
+            const glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_yaw_, cam_yaw_, alpha)),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_pitch_, cam_pitch_, alpha)),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Смещение камеры
+            const glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), glm::mix(prev_camera_pos_, camera_pos_, alpha));
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            view_ = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        // Отсечение экземпляров пирамидой видимости (по пакетам в рабочих потоках) и сбор данных видимых
+        if(use_culling_)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+
+            const auto frustum = utils::geometry::extract_frustum(projection_ * view_);
+            const size_t visible = utils::geometry::cull_spheres(g_jobs, frustum, instance_bounds_, (size_t)instance_count_, visible_);
+
+            visible_instances_.resize(visible);
+            g_jobs.parallel_for(visible, utils::geometry::CULL_BATCH_SIZE, [this](size_t begin, size_t end){
+                for(size_t i = begin; i < end; i++) visible_instances_[i] = instances_[visible_[i]];
+            });
+
+            const auto end = std::chrono::high_resolution_clock::now();
+            cull_time_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+        }
+
+        // Считать передние грани заданными по часовой стрелке
+        glFrontFace(GL_CW);
+        // Отбрасывать задние грани
+        glEnable(GL_CULL_FACE);
+        // Включить тест глубины
+        glEnable(GL_DEPTH_TEST);
+
+        // Использовать шейдер
+        glUseProgram(shader_.id());
+        // Привязать геометрию
+        glBindVertexArray(geometry_.vao_id());
+
+        // Задать матрицу проекции, вида и время
+        glUniformMatrix4fv(shader_.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
+        glUniformMatrix4fv(shader_.uniforms().view, 1, GL_FALSE, glm::value_ptr(view_));
+        glUniform1f(shader_.uniforms().time, glm::mix(prev_time_, time_, alpha));
+
+        // Данные видимых экземпляров занимают начало буфера экземпляров
+        // (без отсечения буфер содержит все экземпляры в исходном порядке)
+        if(use_culling_ && !visible_instances_.empty())
+        {
+            geometry_.update_instances(visible_instances_);
+            buffer_culled_ = true;
+        }
+        else if(!use_culling_ && buffer_culled_)
+        {
+            geometry_.update_instances(instances_);
+            buffer_culled_ = false;
+        }
+
+        // Нарисовать экземпляры
+        geometry_.draw_instanced(drawn_instance_count());
+    }
+
+    /**
+     * Кол-во рисуемых экземпляров (видимых либо всех заданных)
+     * @return Кол-во
+     */
+    GLsizei Instancing::drawn_instance_count() const
+    {
+        return use_culling_ ? (GLsizei)visible_instances_.size() : instance_count_;
+    }
+
+    /**
+     * Имя примера
+     * @return Строка с именем
+     */
+    const char *Instancing::name()
+    {
+        return "Instancing";
+    }
+}
\ No newline at end of file
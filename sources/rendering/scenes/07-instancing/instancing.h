@@ -0,0 +1,154 @@
+#pragma once
+
+#include "utils/gl/shader.hpp"
+#include "utils/gl/geometry.hpp"
+#include "utils/geometry/layout.hpp"
+#include "utils/geometry/culling.hpp"
+
+#include "../scene.h"
+
+namespace scenes
+{
+    /**
+     * Пример рисования экземплярами (instancing)
+     * Большое кол-во кубов рисуется одним вызовом, данные каждого куба берутся из буфера экземпляров
+     */
+    class Instancing : public Scene
+    {
+    public:
+        /**
+         * Описание одиночной вершины
+         * В данном примере используется положение и нормаль (упакована в 10-10-10-2)
+         */
+        struct Vertex
+        {
+            glm::vec3 position;
+            utils::geometry::Snorm1010102 normal;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::NORMAL, &Vertex::normal, 1>>;
+        };
+
+        /**
+         * Данные одного экземпляра (атрибуты с делителем 1, цвет упакован в 8-битные компоненты)
+         */
+        struct Instance
+        {
+            glm::mat4 model;
+            utils::geometry::Unorm8x4 color;
+
+            // Раскладка экземпляра (матрица передается 4-мя столбцами, location 2-5)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::NONE, &Instance::model, 2>,
+                    utils::geometry::Attribute<utils::geometry::NONE, &Instance::color, 6>>;
+        };
+
+        /**
+         * Идентификатор uniform переменных в шейдере
+         * Используется при инициализации шейдера
+         */
+        struct ShaderUniforms
+        {
+            GLint view;
+            GLint projection;
+            GLint time;
+        };
+
+        /**
+         * Максимальное кол-во экземпляров
+         */
+        constexpr static GLsizei MAX_INSTANCES = 100000;
+
+    public:
+        Instancing();
+        ~Instancing() override;
+
+        /**
+         * Загрузка шейдеров, геометрии и данных экземпляров
+         */
+        void load() override;
+
+        /**
+         * Выгрузка всех использованных ресурсов граф. API
+         */
+        void unload() override;
+
+        /**
+         * Обновление камеры и времени анимации
+         * @param delta Временная дельта кадра
+         */
+        void update(float delta) override;
+
+        /**
+         * Управление кол-вом рисуемых экземпляров
+         * @param delta Временная дельта кадра
+         */
+        void update_ui(float delta) override;
+
+        /**
+         * Рисование сцены
+         * Отсечение экземпляров (для интерполированной камеры) и один вызов отрисовки на все видимые экземпляры
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+         */
+        void render(float alpha) override;
+
+        /**
+         * Имя примера
+         * @return Строка с именем
+         */
+        const char* name() override;
+
+    protected:
+        /**
+         * Кол-во рисуемых экземпляров (видимых либо всех заданных)
+         * @return Кол-во
+         */
+        [[nodiscard]] GLsizei drawn_instance_count() const;
+
+        // Ресурсы
+        utils::gl::Shader<ShaderUniforms, GLint> shader_;
+        utils::gl::Geometry<Vertex> geometry_;
+
+        // Матрицы для преобразования вершин
+        glm::mat4 projection_;
+        glm::mat4 view_;
+
+        // Положение камеры
+        glm::vec3 camera_pos_;
+
+        // Положение и поворот камеры, время анимации на предыдущем шаге обновления (для интерполяции)
+        glm::vec3 prev_camera_pos_;
+        GLfloat prev_cam_yaw_, prev_cam_pitch_;
+        float prev_time_;
+
+        // Параметры для построения матрицы проекции
+        GLfloat z_far_, z_near_, fov_;
+
+        // Доп параметры для управления камерой
+        GLfloat cam_yaw_, cam_pitch_, cam_sensitivity_, cam_speed_;
+        glm::vec3 cam_movement_;
+
+        // Кол-во рисуемых экземпляров
+        int instance_count_;
+
+        // Данные всех экземпляров и их ограничивающие сферы (структура массивов для SIMD проверки)
+        std::vector<Instance> instances_;
+        utils::geometry::SphereBoundsSoA instance_bounds_;
+
+        // Индексы и данные видимых экземпляров (передаются в буфер экземпляров перед рисованием)
+        std::vector<uint32_t> visible_;
+        std::vector<Instance> visible_instances_;
+
+        // Отсечение пирамидой видимости и время его выполнения (мс)
+        bool use_culling_;
+        float cull_time_ms_;
+
+        // Буфер экземпляров содержит только видимые экземпляры
+        bool buffer_culled_;
+
+        // Время анимации
+        float time_;
+    };
+}
\ No newline at end of file
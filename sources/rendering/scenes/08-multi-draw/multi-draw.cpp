@@ -0,0 +1,384 @@
+#define GLM_FORCE_SWIZZLE
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <utils/files/load.hpp>
+#include <utils/geometry/generate.hpp>
+#include <utils/geometry/optimize.hpp>
+#include <utils/geometry/meshlets.hpp>
+#include <imgui.h>
+#include <random>
+#include <chrono>
+
+#include "multi-draw.h"
+
+// Соотношение сторон экрана
+extern float g_screen_aspect;
+// Включен ли UI (свободная камера доступна вы отключенном UI)
+extern bool g_use_ui;
+// Управление
+extern bool g_key_forward;
+extern bool g_key_backward;
+extern bool g_key_left;
+extern bool g_key_right;
+extern bool g_key_downward;
+extern bool g_key_upward;
+extern float g_mouse_delta_x;
+extern float g_mouse_delta_y;
+
+namespace scenes
+{
+    MultiDraw::MultiDraw()
+            : projection_(glm::mat4(1.0f))
+            , view_(glm::mat4(1.0f))
+            , camera_pos_(glm::vec3(0.0f, 20.0f, 45.0f))
+            , z_far_(500.0f)
+            , z_near_(0.1f)
+            , fov_(45.0f)
+            , cam_yaw_(0.0f)
+            , cam_pitch_(-25.0f)
+            , cam_sensitivity_(0.1f)
+            , cam_speed_(10.0f)
+            , cam_movement_(0.0f)
+            , use_indirect_(true)
+            , use_meshlets_(true)
+            , stat_meshlets_visible_(0)
+            , stat_triangles_submitted_(0)
+            , stat_triangles_culled_(0)
+            , stat_cull_ms_(0.0f)
+            , time_(0.0f)
+    {}
+
+    MultiDraw::~MultiDraw() = default;
+
+    /**
+     * Загрузка шейдеров, мешей в пул геометрии, данных объектов
+     * Объекты расставляются случайным образом (с фиксированным зерном)
+     */
+    void MultiDraw::load()
+    {
+        // Шейдеры (формат атрибутов совпадает с примером instancing)
+        {
+            // Загрузить исходные коды шейдеров
+            const std::unordered_map<GLuint, std::string> shader_sources = {
+                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/instancing/base.vert")},
+                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/instancing/base.frag")}
+            };
+
+            // Создать OpenGL ресурс шейдера из исходников
+            shader_ = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources,{
+                    "view",
+                    "projection",
+                    "time"
+            });
+        }
+
+        // Пул геометрии
+        {
+            // Описание атрибутов шейдера общее для всех мешей пула (по раскладке вершины)
+            // Буфер команд рассчитан на рисование каждого кластера отдельной командой
+            pool_ = utils::gl::GeometryPool<Vertex>(1u << 16, 1u << 18, OBJECT_COUNT * MAX_MESHLETS_PER_MESH, Vertex::Layout::attributes());
+
+            // Меши (обычно загружаются из файлов)
+            std::vector<GLuint> indices = {};
+            std::vector<Vertex> vertices = {};
+
+            // Оптимизация порядка треугольников и вершин перед добавлением в пул, разбиение на кластеры
+            auto add_mesh = [&]()
+            {
+                mesh_stats_.push_back(utils::geometry::optimize_mesh(vertices, indices));
+                meshes_.push_back(pool_.add(vertices, indices));
+
+                const auto meshlets = utils::geometry::build_meshlets(indices, vertices);
+                assert(meshlets.size() <= (size_t)MAX_MESHLETS_PER_MESH);
+                mesh_meshlets_.push_back({meshlets_.size(), meshlets.size()});
+                meshlets_.insert(meshlets_.end(), meshlets.begin(), meshlets.end());
+
+                mesh_bounds_.push_back(utils::geometry::compute_bounding_sphere(vertices.size(), [&](size_t i){
+                    return vertices[i].position;
+                }));
+            };
+
+            vertices = utils::geometry::gen_cube<Vertex>(1.0f, &indices);
+            add_mesh();
+
+            vertices = utils::geometry::gen_quad<Vertex>(1.0f, &indices);
+            add_mesh();
+
+            // Тесселированные меши генерируются сразу в подготовленные буферы
+            auto gen_mesh = [&](const utils::geometry::MeshSize& size, const auto& generate)
+            {
+                vertices.resize(size.vertex_count);
+                indices.resize(size.index_count);
+                generate(vertices.data(), indices.data());
+                add_mesh();
+            };
+
+            gen_mesh(utils::geometry::gen_sphere_uv_size(32, 16), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_sphere_uv(v, i, 0.5f, 32, 16);
+            });
+            gen_mesh(utils::geometry::gen_sphere_ico_size(3), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_sphere_ico(v, i, 0.5f, 3);
+            });
+            gen_mesh(utils::geometry::gen_cylinder_size(32, 4), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_cylinder(v, i, 0.4f, 1.0f, 32, 4, true);
+            });
+            gen_mesh(utils::geometry::gen_cone_size(32, 4), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_cone(v, i, 0.5f, 1.0f, 32, 4, true);
+            });
+            gen_mesh(utils::geometry::gen_torus_size(48, 24), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_torus(v, i, 0.4f, 0.15f, 48, 24);
+            });
+            gen_mesh(utils::geometry::gen_plane_size(32, 32), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_plane(v, i, 1.0f, 1.0f, 32, 32);
+            });
+            gen_mesh(utils::geometry::gen_capsule_size(32, 8), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_capsule(v, i, 0.3f, 0.6f, 32, 8);
+            });
+        }
+
+        // Объекты
+        {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> pos(-30.0f, 30.0f);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::uniform_int_distribution<size_t> mesh(0, meshes_.size() - 1);
+
+            std::vector<Instance> instances(OBJECT_COUNT);
+            object_meshes_.resize(OBJECT_COUNT);
+            object_models_.resize(OBJECT_COUNT);
+            for(GLsizei i = 0; i < OBJECT_COUNT; i++)
+            {
+                instances[i].model =
+                        glm::translate(glm::mat4(1.0f), glm::vec3(pos(rng), pos(rng) * 0.2f, pos(rng))) *
+                        glm::rotate(glm::mat4(1.0f), unit(rng) * 6.28f, glm::normalize(glm::vec3(unit(rng), 1.0f, unit(rng))));
+                instances[i].color = {unit(rng), unit(rng), unit(rng)};
+                object_meshes_[i] = mesh(rng);
+                object_models_[i] = instances[i].model;
+            }
+
+            // Атрибуты экземпляра по раскладке (делитель 1)
+            pool_.set_instances(instances, Instance::Layout::attributes(1));
+        }
+
+        // Проверка доступности ресурсов
+        assert(shader_.ready());
+        assert(pool_.ready());
+    }
+
+    /**
+     * Выгрузка всех использованных ресурсов граф. API
+     */
+    void MultiDraw::unload()
+    {
+        shader_.unload();
+        pool_.unload();
+
+        meshes_.clear();
+        mesh_stats_.clear();
+        object_meshes_.clear();
+        object_models_.clear();
+        meshlets_.clear();
+        mesh_meshlets_.clear();
+        mesh_bounds_.clear();
+    }
+
+    /**
+     * Обновление камеры, времени анимации и запись команд рисования (с отсечением кластеров)
+     * @param delta Временная дельта кадра
+     */
+    void MultiDraw::update(float delta)
+    {
+        time_ += delta;
+
+        // Управление свободной камерой
+        if(!g_use_ui)
+        {
+            cam_pitch_ -= (g_mouse_delta_y * cam_sensitivity_);
+            cam_yaw_ -= (g_mouse_delta_x * cam_sensitivity_);
+
+            cam_movement_ = {};
+            if(g_key_forward) cam_movement_.z = -1.0f;
+            else if(g_key_backward) cam_movement_.z = 1.0f;
+            if (g_key_left) cam_movement_.x = -1.0f;
+            else if(g_key_right) cam_movement_.x = 1.0f;
+            if (g_key_upward) cam_movement_.y = 1.0f;
+            else if(g_key_downward) cam_movement_.y = -1.0f;
+        }
+
+        // Перспективная проекция (с учетом соотношения экрана)
+        projection_ = glm::perspective(fov_, g_screen_aspect, z_near_, z_far_);
+
+        // Камера
+        {
+            // Поворот камеры
+            glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_yaw_),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_pitch_),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Учесть поворот камеры при движении (ось Y всегда направлена вертикально)
+            glm::vec2 h = glm::vec2(cam_movement_.x, cam_movement_.z);
+            glm::vec3 d = glm::length2(h) > 0.0f ? glm::normalize(glm::vec3(h.x, 0.0f, h.y)) : glm::vec3(0.0f);
+            glm::vec4 d_rot = cam_rotation * glm::vec4(d, 0.0f);
+            camera_pos_ += (glm::vec3(d_rot.x, d_rot.y + cam_movement_.y, d_rot.z) * cam_speed_ * delta);
+
+            // Смещение камеры
+            glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), camera_pos_);
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            view_ = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        pool_.clear_draws();
+        stat_meshlets_visible_ = 0;
+        stat_triangles_submitted_ = 0;
+        stat_triangles_culled_ = 0;
+
+        if(!use_meshlets_)
+        {
+            // Запись команд рисования (один объект - одна команда, данные объекта выбираются через base_instance)
+            for(GLsizei i = 0; i < OBJECT_COUNT; i++)
+            {
+                const auto& mesh = meshes_[object_meshes_[i]];
+                pool_.draw(mesh, 1, (GLuint)i);
+                stat_triangles_submitted_ += mesh.index_count / 3;
+            }
+            stat_cull_ms_ = 0.0f;
+            return;
+        }
+
+        // Отсечение в пространстве объекта: пирамида видимости из матрицы projection * view * model,
+        // положение камеры через обратную матрицу модели (кластеры не нужно преобразовывать)
+        const auto cull_start = std::chrono::high_resolution_clock::now();
+        const glm::mat4 view_projection = projection_ * view_;
+
+        for(GLsizei i = 0; i < OBJECT_COUNT; i++)
+        {
+            const size_t mesh_index = object_meshes_[i];
+            const auto& mesh = meshes_[mesh_index];
+            const auto& range = mesh_meshlets_[mesh_index];
+            const auto& bounds = mesh_bounds_[mesh_index];
+
+            const auto frustum = utils::geometry::extract_frustum(view_projection * object_models_[i]);
+            if(!utils::geometry::sphere_in_frustum(frustum, bounds.center, bounds.radius + WAVE_AMPLITUDE))
+            {
+                stat_triangles_culled_ += mesh.index_count / 3;
+                continue;
+            }
+
+            const glm::vec4 camera_local = glm::inverse(object_models_[i]) * glm::vec4(camera_pos_, 1.0f);
+            const glm::vec3 camera = {camera_local.x, camera_local.y, camera_local.z};
+
+            for(size_t m = range.first; m < range.first + range.count; m++)
+            {
+                const auto& meshlet = meshlets_[m];
+                if(!utils::geometry::is_meshlet_visible(meshlet, frustum, camera, WAVE_AMPLITUDE))
+                {
+                    stat_triangles_culled_ += meshlet.index_count / 3;
+                    continue;
+                }
+
+                // Кластер - участок индексов меша, вершины меша общие
+                utils::gl::MeshRange part = mesh;
+                part.first_index = mesh.first_index + meshlet.first_index;
+                part.index_count = meshlet.index_count;
+                pool_.draw(part, 1, (GLuint)i);
+
+                stat_meshlets_visible_++;
+                stat_triangles_submitted_ += meshlet.index_count / 3;
+            }
+        }
+
+        stat_cull_ms_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - cull_start).count();
+    }
+
+    /**
+     * Выбор способа отправки команд рисования
+     * @param delta Временная дельта кадра
+     */
+    void MultiDraw::update_ui([[maybe_unused]] float delta)
+    {
+        if(ImGui::Begin("Multi-draw", nullptr))
+        {
+            ImGui::Checkbox("Indirect", &use_indirect_);
+            ImGui::Checkbox("Meshlet culling", &use_meshlets_);
+            ImGui::Text("Objects: %u", (unsigned)OBJECT_COUNT);
+            ImGui::Text("Draw calls: %u", use_indirect_ ? 1u : (unsigned)pool_.commands().size());
+            ImGui::Text("Triangles: %u (culled %u)", (unsigned)stat_triangles_submitted_, (unsigned)stat_triangles_culled_);
+
+            // Кластеры: видимые и общее кол-во, время отсечения на CPU
+            if(use_meshlets_)
+            {
+                ImGui::Text("Meshlets: %u / %u", (unsigned)stat_meshlets_visible_, (unsigned)meshlets_.size());
+                ImGui::Text("Culling: %.3f ms (%.0f tris/ms)", stat_cull_ms_,
+                            stat_cull_ms_ > 0.0f ? (float)stat_triangles_culled_ / stat_cull_ms_ : 0.0f);
+            }
+
+            // Статистика кеша вершин для каждого меша пула (до и после оптимизации)
+            for(size_t i = 0; i < mesh_stats_.size(); i++)
+            {
+                ImGui::Text("Mesh %u ACMR: %.2f -> %.2f, ATVR: %.2f -> %.2f", (unsigned)i,
+                            mesh_stats_[i].before.acmr, mesh_stats_[i].after.acmr,
+                            mesh_stats_[i].before.atvr, mesh_stats_[i].after.atvr);
+            }
+
+            ImGui::SetWindowSize({320.0f, 330.0f}, ImGuiCond_Once);
+            ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + 330.0f }, ImGuiCond_Once);
+        }
+        ImGui::End();
+    }
+
+    /**
+     * Рисование сцены
+     * Одна привязка VAO и один вызов (либо вызов на каждый объект, для сравнения)
+     * Камера не интерполируется: команды рисования записаны на шаге обновления с отсечением для камеры этого шага
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+     */
+    void MultiDraw::render([[maybe_unused]] float alpha)
+    {
+        // Считать передние грани заданными по часовой стрелке
+        glFrontFace(GL_CW);
+        // Отбрасывать задние грани
+        glEnable(GL_CULL_FACE);
+        // Включить тест глубины
+        glEnable(GL_DEPTH_TEST);
+
+        // Использовать шейдер
+        glUseProgram(shader_.id());
+
+        // Задать матрицу проекции, вида и время
+        glUniformMatrix4fv(shader_.uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
+        glUniformMatrix4fv(shader_.uniforms().view, 1, GL_FALSE, glm::value_ptr(view_));
+        glUniform1f(shader_.uniforms().time, time_);
+
+        if(use_indirect_)
+        {
+            // Все объекты одним вызовом
+            pool_.submit();
+        }
+        else
+        {
+            // Отдельный вызов на каждую команду (та же привязка VAO)
+            glBindVertexArray(pool_.vao_id());
+            for(const auto& cmd : pool_.commands())
+            {
+                glDrawElementsInstancedBaseVertexBaseInstance(
+                        GL_TRIANGLES,
+                        (GLsizei)cmd.count,
+                        GL_UNSIGNED_INT,
+                        reinterpret_cast<const void*>(sizeof(GLuint) * cmd.first_index),
+                        (GLsizei)cmd.instance_count,
+                        cmd.base_vertex,
+                        cmd.base_instance);
+            }
+        }
+    }
+
+    /**
+     * Имя примера
+     * @return Строка с именем
+     */
+    const char *MultiDraw::name()
+    {
+        return "Multi-draw indirect";
+    }
+}
\ No newline at end of file
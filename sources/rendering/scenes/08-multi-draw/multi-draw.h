@@ -0,0 +1,170 @@
+#pragma once
+
+#include "utils/gl/shader.hpp"
+#include "utils/gl/geometry-pool.hpp"
+#include "utils/geometry/optimize.hpp"
+#include "utils/geometry/layout.hpp"
+#include "utils/geometry/meshlets.hpp"
+
+#include "../scene.h"
+
+namespace scenes
+{
+    /**
+     * Пример непрямого рисования (multi-draw indirect)
+     * Разные меши хранятся в общих буферах пула геометрии, вся сцена рисуется одним вызовом
+     */
+    class MultiDraw : public Scene
+    {
+    public:
+        /**
+         * Описание одиночной вершины
+         * В данном примере используется положение и нормаль
+         */
+        struct Vertex
+        {
+            glm::vec3 position;
+            glm::vec3 normal;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::NORMAL, &Vertex::normal, 1>>;
+        };
+
+        /**
+         * Данные одного объекта (выбираются командой рисования через base_instance)
+         */
+        struct Instance
+        {
+            glm::mat4 model;
+            glm::vec3 color;
+
+            // Раскладка экземпляра (матрица передается 4-мя столбцами, location 2-5)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::NONE, &Instance::model, 2>,
+                    utils::geometry::Attribute<utils::geometry::NONE, &Instance::color, 6>>;
+        };
+
+        /**
+         * Идентификатор uniform переменных в шейдере
+         * Используется при инициализации шейдера
+         */
+        struct ShaderUniforms
+        {
+            GLint view;
+            GLint projection;
+            GLint time;
+        };
+
+        /**
+         * Диапазон кластеров меша в общем массиве кластеров
+         */
+        struct MeshletRange
+        {
+            size_t first = 0;
+            size_t count = 0;
+        };
+
+        /**
+         * Кол-во объектов сцены
+         */
+        constexpr static GLsizei OBJECT_COUNT = 4096;
+
+        /**
+         * Максимальное кол-во кластеров одного меша (определяет емкость буфера команд)
+         */
+        constexpr static GLsizei MAX_MESHLETS_PER_MESH = 64;
+
+        /**
+         * Амплитуда смещения объектов в вершинном шейдере (запас для ограничивающих сфер)
+         */
+        constexpr static float WAVE_AMPLITUDE = 0.5f;
+
+    public:
+        MultiDraw();
+        ~MultiDraw() override;
+
+        /**
+         * Загрузка шейдеров, мешей в пул геометрии, данных объектов
+         */
+        void load() override;
+
+        /**
+         * Выгрузка всех использованных ресурсов граф. API
+         */
+        void unload() override;
+
+        /**
+         * Обновление камеры, времени анимации и запись команд рисования (с отсечением кластеров)
+         * @param delta Временная дельта кадра
+         */
+        void update(float delta) override;
+
+        /**
+         * Выбор способа отправки команд рисования
+         * @param delta Временная дельта кадра
+         */
+        void update_ui(float delta) override;
+
+        /**
+         * Рисование сцены
+         * Одна привязка VAO и один вызов (либо вызов на каждый объект, для сравнения)
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+         */
+        void render(float alpha) override;
+
+        /**
+         * Имя примера
+         * @return Строка с именем
+         */
+        const char* name() override;
+
+    protected:
+        // Ресурсы
+        utils::gl::Shader<ShaderUniforms, GLint> shader_;
+        utils::gl::GeometryPool<Vertex> pool_;
+
+        // Меши в пуле и индекс меша каждого объекта
+        std::vector<utils::gl::MeshRange> meshes_;
+        std::vector<size_t> object_meshes_;
+        std::vector<glm::mat4> object_models_;
+
+        // Кластеры всех мешей (плоский массив), диапазон кластеров и ограничивающая сфера каждого меша
+        std::vector<utils::geometry::Meshlet> meshlets_;
+        std::vector<MeshletRange> mesh_meshlets_;
+        std::vector<utils::geometry::BoundingSphere> mesh_bounds_;
+
+        // Статистика оптимизации мешей (в порядке добавления в пул)
+        std::vector<utils::geometry::MeshOptimizationStats> mesh_stats_;
+
+        // Матрицы для преобразования вершин
+        glm::mat4 projection_;
+        glm::mat4 view_;
+
+        // Положение камеры
+        glm::vec3 camera_pos_;
+
+        // Параметры для построения матрицы проекции
+        GLfloat z_far_, z_near_, fov_;
+
+        // Доп параметры для управления камерой
+        GLfloat cam_yaw_, cam_pitch_, cam_sensitivity_, cam_speed_;
+        glm::vec3 cam_movement_;
+
+        // Использовать непрямое рисование (иначе - отдельный вызов на каждый объект)
+        bool use_indirect_;
+
+        // Рисовать видимые кластеры (иначе - меши объектов целиком без отсечения)
+        bool use_meshlets_;
+
+        // Статистика отсечения за кадр
+        size_t stat_meshlets_visible_;
+        size_t stat_triangles_submitted_;
+        size_t stat_triangles_culled_;
+        float stat_cull_ms_;
+
+        // Время анимации
+        float time_;
+    };
+}
\ No newline at end of file
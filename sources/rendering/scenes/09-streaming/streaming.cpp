@@ -0,0 +1,437 @@
+#define GLM_FORCE_SWIZZLE
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <utils/files/load.hpp>
+#include <utils/geometry/generate.hpp>
+#include <imgui.h>
+#include <chrono>
+
+#include "streaming.h"
+
+// Соотношение сторон экрана
+extern float g_screen_aspect;
+// Включен ли UI (свободная камера доступна вы отключенном UI)
+extern bool g_use_ui;
+// Управление
+extern bool g_key_forward;
+extern bool g_key_backward;
+extern bool g_key_left;
+extern bool g_key_right;
+extern bool g_key_downward;
+extern bool g_key_upward;
+extern float g_mouse_delta_x;
+extern float g_mouse_delta_y;
+
+namespace scenes
+{
+    Streaming::Streaming()
+            : camera_ubo_id_(0)
+            , instance_ssbo_id_(0)
+            , ubo_alignment_(256)
+            , ssbo_alignment_(256)
+            , camera_({glm::mat4(1.0f), glm::mat4(1.0f)})
+            , camera_pos_(glm::vec3(0.0f, 30.0f, 70.0f))
+            , z_far_(1000.0f)
+            , z_near_(0.1f)
+            , fov_(45.0f)
+            , cam_yaw_(0.0f)
+            , cam_pitch_(-25.0f)
+            , cam_sensitivity_(0.1f)
+            , cam_speed_(20.0f)
+            , cam_movement_(0.0f)
+            , upload_mode_(RING_BUFFER)
+            , object_count_(16384)
+            , upload_seconds_(0.0)
+            , upload_bytes_(0.0)
+            , measure_time_(0.0f)
+            , upload_mb_per_second_(0.0f)
+            , upload_ms_per_frame_(0.0f)
+            , measured_frames_(0)
+            , time_(0.0f)
+            , bvh_object_count_(0)
+            , bvh_build_cost_(0.0f)
+            , use_culling_(true)
+            , picked_object_(-1)
+            , picked_neighbours_(0)
+            , bvh_build_ms_(0.0f)
+            , bvh_refit_ms_(0.0f)
+            , bvh_query_ms_(0.0f)
+            , bvh_rebuilds_(0)
+    {}
+
+    Streaming::~Streaming() = default;
+
+    /**
+     * Загрузка шейдеров, геометрии, создание буферов
+     * Область кольцевого буфера вмещает данные одного кадра при максимальном кол-ве объектов
+     */
+    void Streaming::load()
+    {
+        // Шейдеры
+        {
+            // Загрузить исходные коды шейдеров
+            const std::unordered_map<GLuint, std::string> shader_sources = {
+                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/streaming/base.vert")},
+                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/streaming/base.frag")}
+            };
+
+            // Создать OpenGL ресурс шейдера из исходников
+            shader_ = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources,{});
+        }
+
+        // Геометрия
+        {
+            // Данные о геометрии (обычно загружается из файлов)
+            std::vector<GLuint> indices = {};
+            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(1.0f, &indices);
+
+            // Создать OpenGL ресурс геометрических буферов из данных (атрибуты шейдера по раскладке вершины)
+            geometry_ = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+        }
+
+        // Буферы
+        {
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment_);
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssbo_alignment_);
+
+            // Кольцевой буфер (3 области)
+            const auto region_size = static_cast<GLsizeiptr>(
+                    sizeof(Camera) + ubo_alignment_ + sizeof(Instance) * MAX_OBJECTS + ssbo_alignment_);
+            ring_ = utils::gl::RingBuffer(region_size, 3);
+
+            // Обычные буферы
+            glCreateBuffers(1, &camera_ubo_id_);
+            glNamedBufferData(camera_ubo_id_, sizeof(Camera), nullptr, GL_DYNAMIC_DRAW);
+            glCreateBuffers(1, &instance_ssbo_id_);
+            glNamedBufferData(instance_ssbo_id_, sizeof(Instance) * MAX_OBJECTS, nullptr, GL_DYNAMIC_DRAW);
+        }
+
+        instances_.resize(MAX_OBJECTS);
+        object_bounds_.reserve(MAX_OBJECTS);
+        visible_instances_.reserve(MAX_OBJECTS);
+        bvh_object_count_ = 0;
+
+        // Проверка доступности ресурсов
+        assert(shader_.ready());
+        assert(geometry_.ready());
+        assert(ring_.ready());
+    }
+
+    /**
+     * Выгрузка всех использованных ресурсов граф. API
+     */
+    void Streaming::unload()
+    {
+        shader_.unload();
+        geometry_.unload();
+        ring_.unload();
+
+        if(camera_ubo_id_) glDeleteBuffers(1, &camera_ubo_id_);
+        if(instance_ssbo_id_) glDeleteBuffers(1, &instance_ssbo_id_);
+        camera_ubo_id_ = 0;
+        instance_ssbo_id_ = 0;
+    }
+
+    /**
+     * Обновление камеры и анимация объектов (на CPU)
+     * @param delta Временная дельта кадра
+     */
+    void Streaming::update(float delta)
+    {
+        time_ += delta;
+
+        // Управление свободной камерой
+        if(!g_use_ui)
+        {
+            cam_pitch_ -= (g_mouse_delta_y * cam_sensitivity_);
+            cam_yaw_ -= (g_mouse_delta_x * cam_sensitivity_);
+
+            cam_movement_ = {};
+            if(g_key_forward) cam_movement_.z = -1.0f;
+            else if(g_key_backward) cam_movement_.z = 1.0f;
+            if (g_key_left) cam_movement_.x = -1.0f;
+            else if(g_key_right) cam_movement_.x = 1.0f;
+            if (g_key_upward) cam_movement_.y = 1.0f;
+            else if(g_key_downward) cam_movement_.y = -1.0f;
+        }
+
+        // Перспективная проекция (с учетом соотношения экрана)
+        camera_.projection = glm::perspective(fov_, g_screen_aspect, z_near_, z_far_);
+
+        // Поворот камеры
+        const glm::mat4 cam_rotation =
+                glm::rotate(glm::mat4(1.0f), glm::radians(cam_yaw_),glm::vec3(0.0f,1.0f,0.0f)) *
+                glm::rotate(glm::mat4(1.0f), glm::radians(cam_pitch_),glm::vec3(1.0f,0.0f,0.0f));
+
+        // Камера
+        {
+
+            // Учесть поворот камеры при движении (ось Y всегда направлена вертикально)
+            glm::vec2 h = glm::vec2(cam_movement_.x, cam_movement_.z);
+            glm::vec3 d = glm::length2(h) > 0.0f ? glm::normalize(glm::vec3(h.x, 0.0f, h.y)) : glm::vec3(0.0f);
+            glm::vec4 d_rot = cam_rotation * glm::vec4(d, 0.0f);
+            camera_pos_ += (glm::vec3(d_rot.x, d_rot.y + cam_movement_.y, d_rot.z) * cam_speed_ * delta);
+
+            // Смещение камеры
+            glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), camera_pos_);
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            camera_.view = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        // Анимация объектов (спираль из вращающихся кубов, все данные меняются каждый кадр)
+        for(GLsizei i = 0; i < object_count_; i++)
+        {
+            const auto t = (float)i / (float)object_count_;
+            const float angle = t * 6.28f * 40.0f + time_ * 0.5f;
+            const float radius = 5.0f + t * 40.0f;
+            const glm::vec3 pos = {std::cos(angle) * radius, std::sin(time_ + t * 30.0f) * 2.0f, std::sin(angle) * radius};
+
+            instances_[i].model =
+                    glm::translate(glm::mat4(1.0f), pos) *
+                    glm::rotate(glm::mat4(1.0f), time_ * 2.0f + t * 100.0f, glm::vec3(0.0f, 1.0f, 0.0f)) *
+                    glm::scale(glm::mat4(1.0f), glm::vec3(0.3f));
+            instances_[i].color = {t, 0.5f + 0.5f * std::sin(time_ + t * 10.0f), 1.0f - t, 1.0f};
+        }
+
+        update_bvh(cam_rotation);
+    }
+
+    /**
+     * Обновление иерархии объемов, выбор объекта лучом из центра экрана и отсечение по пирамиде видимости
+     * Дерево строится заново только при изменении кол-ва объектов либо при заметном ухудшении его качества,
+     * в остальных кадрах объемы узлов пересчитываются под новые положения объектов
+     * @param camera_rotation Матрица поворота камеры
+     */
+    void Streaming::update_bvh(const glm::mat4& camera_rotation)
+    {
+        // Объемы объектов (куб с ребром 0.3 вращается вокруг оси Y)
+        const glm::vec3 extent = {0.15f * std::sqrt(2.0f), 0.15f, 0.15f * std::sqrt(2.0f)};
+        object_bounds_.resize(object_count_);
+        for(GLsizei i = 0; i < object_count_; i++)
+        {
+            const glm::vec3 pos = glm::vec3(instances_[i].model[3]);
+            object_bounds_[i].min = pos - extent;
+            object_bounds_[i].max = pos + extent;
+        }
+
+        // Построение либо пересчет дерева
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+
+            if(bvh_object_count_ != object_count_)
+            {
+                bvh_.build(object_bounds_);
+                bvh_object_count_ = object_count_;
+                bvh_build_cost_ = bvh_.sah_cost();
+                bvh_rebuilds_++;
+
+                const auto end = std::chrono::high_resolution_clock::now();
+                bvh_build_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+                bvh_refit_ms_ = 0.0f;
+            }
+            else
+            {
+                bvh_.refit(object_bounds_);
+
+                // Объекты разошлись относительно исходного разбиения - перестроить в следующем кадре
+                if(bvh_.sah_cost() > bvh_build_cost_ * 2.0f) bvh_object_count_ = 0;
+
+                const auto end = std::chrono::high_resolution_clock::now();
+                bvh_refit_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+            }
+        }
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        // Выбор объекта лучом вдоль направления взгляда (из центра экрана)
+        {
+            utils::geometry::Ray ray;
+            ray.origin = camera_pos_;
+            ray.direction = glm::vec3(camera_rotation * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f));
+            const glm::vec3 inv_direction = 1.0f / ray.direction;
+
+            const auto hit = bvh_.raycast(ray, z_far_, [&](uint32_t object, float max_distance){
+                return utils::geometry::intersect_ray_aabb(object_bounds_[object], ray.origin, inv_direction, max_distance);
+            });
+
+            picked_object_ = hit.hit() ? static_cast<int>(hit.object) : -1;
+            picked_neighbours_ = 0;
+
+            // Выделить выбранный объект и объекты, пересекающие его окрестность
+            if(hit.hit())
+            {
+                utils::geometry::Aabb area = object_bounds_[hit.object];
+                area.min -= glm::vec3(1.0f);
+                area.max += glm::vec3(1.0f);
+
+                bvh_.query_overlap(area, [&](uint32_t object){
+                    if(object == hit.object || !object_bounds_[object].overlaps(area)) return;
+                    instances_[object].color = {1.0f, 1.0f, 0.0f, 1.0f};
+                    picked_neighbours_++;
+                });
+                instances_[hit.object].color = glm::vec4(1.0f);
+            }
+        }
+
+        // Отсечение по пирамиде видимости (поддеревья целиком внутри пирамиды не проверяются)
+        if(use_culling_)
+        {
+            const auto frustum = utils::geometry::extract_frustum(camera_.projection * camera_.view);
+            visible_instances_.clear();
+            bvh_.query_frustum(frustum, [&](uint32_t object){
+                visible_instances_.push_back(instances_[object]);
+            });
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        bvh_query_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    /**
+     * Кол-во объектов, передаваемых и рисуемых в текущем кадре
+     * @return Кол-во объектов
+     */
+    GLsizei Streaming::drawn_object_count() const
+    {
+        return use_culling_ ? static_cast<GLsizei>(visible_instances_.size()) : object_count_;
+    }
+
+    /**
+     * Выбор способа передачи и вывод замеров пропускной способности
+     * @param delta Временная дельта кадра
+     */
+    void Streaming::update_ui(float delta)
+    {
+        // Обновлять средние значения раз в секунду
+        measure_time_ += delta;
+        if(measure_time_ >= 1.0f && measured_frames_ > 0)
+        {
+            upload_mb_per_second_ = upload_seconds_ > 0.0 ? (float)(upload_bytes_ / upload_seconds_ / (1024.0 * 1024.0)) : 0.0f;
+            upload_ms_per_frame_ = (float)(upload_seconds_ * 1000.0 / (double)measured_frames_);
+            upload_seconds_ = 0.0;
+            upload_bytes_ = 0.0;
+            measured_frames_ = 0;
+            measure_time_ = 0.0f;
+        }
+
+        if(ImGui::Begin("Streaming", nullptr))
+        {
+            const char* modes[] = {"Ring buffer", "glBufferSubData", "Orphaning"};
+            if(ImGui::Combo("Upload", &upload_mode_, modes, IM_ARRAYSIZE(modes)))
+            {
+                upload_seconds_ = 0.0;
+                upload_bytes_ = 0.0;
+                measured_frames_ = 0;
+                measure_time_ = 0.0f;
+            }
+            ImGui::SliderInt("Objects", &object_count_, 1, MAX_OBJECTS);
+            ImGui::Text("Per frame: %.2f MB", (float)(sizeof(Instance) * object_count_ + sizeof(Camera)) / (1024.0f * 1024.0f));
+            ImGui::Text("Upload: %.2f ms (%.0f MB/s)", upload_ms_per_frame_, upload_mb_per_second_);
+            ImGui::Text("Ring buffer stalls: %u", (unsigned)ring_.stalls());
+
+            ImGui::Separator();
+            ImGui::Checkbox("BVH frustum culling", &use_culling_);
+            ImGui::Text("Drawn: %d / %d", drawn_object_count(), object_count_);
+            ImGui::Text("Build: %.3f ms (rebuilds: %u)", bvh_build_ms_, (unsigned)bvh_rebuilds_);
+            ImGui::Text("Refit: %.3f ms (SAH cost: %.1f)", bvh_refit_ms_, bvh_.sah_cost());
+            ImGui::Text("Queries: %.3f ms", bvh_query_ms_);
+            if(picked_object_ >= 0) ImGui::Text("Picked: %d (neighbours: %u)", picked_object_, (unsigned)picked_neighbours_);
+            else ImGui::Text("Picked: none");
+
+            ImGui::SetWindowSize({300.0f, 250.0f}, ImGuiCond_Once);
+            ImGui::SetNextWindowPos({0, ImGui::GetWindowPos().y + 250.0f }, ImGuiCond_Once);
+        }
+        ImGui::End();
+    }
+
+    /**
+     * Передать данные кадра выбранным способом и привязать буферы
+     * Замеряется время, которое CPU тратит на передачу (копирование и вызовы драйвера)
+     */
+    void Streaming::upload()
+    {
+        const auto camera_size = static_cast<GLsizeiptr>(sizeof(Camera));
+        // Передается минимум один объект (привязка пустого диапазона недопустима)
+        const bool culled = use_culling_ && !visible_instances_.empty();
+        const auto instances_size = static_cast<GLsizeiptr>(sizeof(Instance) * std::max<GLsizei>(drawn_object_count(), 1));
+        const Instance* instances_data = culled ? visible_instances_.data() : instances_.data();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        if(upload_mode_ == RING_BUFFER)
+        {
+            // Запись в отображенную память без синхронизации с драйвером
+            const auto camera = ring_.allocate(camera_size, ubo_alignment_);
+            std::memcpy(camera.ptr, &camera_, sizeof(Camera));
+
+            const auto instances = ring_.allocate(instances_size, ssbo_alignment_);
+            std::memcpy(instances.ptr, instances_data, static_cast<size_t>(instances_size));
+
+            ring_.bind_range(GL_UNIFORM_BUFFER, 0, camera);
+            ring_.bind_range(GL_SHADER_STORAGE_BUFFER, 0, instances);
+        }
+        else
+        {
+            // Пересоздание хранилища позволяет драйверу не ждать GPU, который еще читает старые данные
+            if(upload_mode_ == BUFFER_ORPHANING)
+            {
+                glNamedBufferData(camera_ubo_id_, camera_size, nullptr, GL_DYNAMIC_DRAW);
+                glNamedBufferData(instance_ssbo_id_, static_cast<GLsizeiptr>(sizeof(Instance) * MAX_OBJECTS), nullptr, GL_DYNAMIC_DRAW);
+            }
+
+            glNamedBufferSubData(camera_ubo_id_, 0, camera_size, &camera_);
+            glNamedBufferSubData(instance_ssbo_id_, 0, instances_size, instances_data);
+
+            glBindBufferBase(GL_UNIFORM_BUFFER, 0, camera_ubo_id_);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instance_ssbo_id_);
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        upload_seconds_ += std::chrono::duration<double>(end - start).count();
+        upload_bytes_ += (double)(camera_size + instances_size);
+        measured_frames_++;
+    }
+
+    /**
+     * Передача данных кадра и рисование сцены
+     * Кольцевой буфер переходит к следующей области в начале кадра и ставит барьер в конце
+     * Камера и объекты не интерполируются: отсечение и выбор объекта лучом выполнены на шаге обновления
+     * для камеры этого шага
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+     */
+    void Streaming::render([[maybe_unused]] float alpha)
+    {
+        // Считать передние грани заданными по часовой стрелке
+        glFrontFace(GL_CW);
+        // Отбрасывать задние грани
+        glEnable(GL_CULL_FACE);
+        // Включить тест глубины
+        glEnable(GL_DEPTH_TEST);
+
+        ring_.begin_frame();
+
+        // Передать данные кадра
+        upload();
+
+        // Использовать шейдер
+        glUseProgram(shader_.id());
+        // Привязать геометрию
+        glBindVertexArray(geometry_.vao_id());
+
+        // Нарисовать объекты (данные объекта выбираются по gl_InstanceID)
+        if(drawn_object_count() > 0) geometry_.draw_instanced(drawn_object_count());
+
+        ring_.end_frame();
+    }
+
+    /**
+     * Имя примера
+     * @return Строка с именем
+     */
+    const char *Streaming::name()
+    {
+        return "Streaming";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "utils/gl/shader.hpp"
+#include "utils/gl/geometry.hpp"
+#include "utils/gl/ring-buffer.hpp"
+#include "utils/geometry/layout.hpp"
+#include "utils/geometry/bvh.hpp"
+
+#include "../scene.h"
+
+namespace scenes
+{
+    /**
+     * Пример потоковой передачи данных кадра
+     * Матрицы камеры и данные объектов обновляются каждый кадр через постоянно отображенный кольцевой буфер,
+     * для сравнения доступна передача через glBufferSubData и через пересоздание хранилища (orphaning)
+     */
+    class Streaming : public Scene
+    {
+    public:
+        /**
+         * Описание одиночной вершины
+         * В данном примере используется положение и нормаль
+         */
+        struct Vertex
+        {
+            glm::vec3 position;
+            glm::vec3 normal;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::NORMAL, &Vertex::normal, 1>>;
+        };
+
+        /**
+         * Данные одного объекта (раскладка std430)
+         */
+        struct Instance
+        {
+            glm::mat4 model;
+            glm::vec4 color;
+        };
+
+        /**
+         * Матрицы камеры (раскладка std140)
+         */
+        struct Camera
+        {
+            glm::mat4 view;
+            glm::mat4 projection;
+        };
+
+        /**
+         * Идентификатор uniform переменных в шейдере
+         * Используется при инициализации шейдера (данные передаются через буферы)
+         */
+        struct ShaderUniforms
+        {};
+
+        /**
+         * Способ передачи данных
+         */
+        enum EUploadMode : int
+        {
+            RING_BUFFER = 0,
+            BUFFER_SUB_DATA,
+            BUFFER_ORPHANING
+        };
+
+        /**
+         * Максимальное кол-во объектов
+         */
+        constexpr static GLsizei MAX_OBJECTS = 65536;
+
+    public:
+        Streaming();
+        ~Streaming() override;
+
+        /**
+         * Загрузка шейдеров, геометрии, создание буферов
+         */
+        void load() override;
+
+        /**
+         * Выгрузка всех использованных ресурсов граф. API
+         */
+        void unload() override;
+
+        /**
+         * Обновление камеры и анимация объектов (на CPU)
+         * @param delta Временная дельта кадра
+         */
+        void update(float delta) override;
+
+        /**
+         * Выбор способа передачи и вывод замеров пропускной способности
+         * @param delta Временная дельта кадра
+         */
+        void update_ui(float delta) override;
+
+        /**
+         * Передача данных кадра и рисование сцены
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+         */
+        void render(float alpha) override;
+
+        /**
+         * Имя примера
+         * @return Строка с именем
+         */
+        const char* name() override;
+
+    protected:
+        /**
+         * Передать данные кадра выбранным способом и привязать буферы
+         */
+        void upload();
+
+        /**
+         * Обновление иерархии объемов, выбор объекта лучом из центра экрана и отсечение по пирамиде видимости
+         * @param camera_rotation Матрица поворота камеры
+         */
+        void update_bvh(const glm::mat4& camera_rotation);
+
+        /**
+         * Кол-во объектов, передаваемых и рисуемых в текущем кадре
+         * @return Кол-во объектов
+         */
+        [[nodiscard]] GLsizei drawn_object_count() const;
+
+        // Ресурсы
+        utils::gl::Shader<ShaderUniforms, GLint> shader_;
+        utils::gl::Geometry<Vertex> geometry_;
+        utils::gl::RingBuffer ring_;
+
+        // Обычные буферы (для сравнения)
+        GLuint camera_ubo_id_;
+        GLuint instance_ssbo_id_;
+
+        // Требования к выравниванию смещений буферов
+        GLint ubo_alignment_;
+        GLint ssbo_alignment_;
+
+        // Данные кадра
+        Camera camera_;
+        std::vector<Instance> instances_;
+
+        // Положение камеры
+        glm::vec3 camera_pos_;
+
+        // Параметры для построения матрицы проекции
+        GLfloat z_far_, z_near_, fov_;
+
+        // Доп параметры для управления камерой
+        GLfloat cam_yaw_, cam_pitch_, cam_sensitivity_, cam_speed_;
+        glm::vec3 cam_movement_;
+
+        // Способ передачи и кол-во объектов
+        int upload_mode_;
+        int object_count_;
+
+        // Замеры (накапливаются в течении секунды)
+        double upload_seconds_, upload_bytes_;
+        float measure_time_;
+        float upload_mb_per_second_, upload_ms_per_frame_;
+        size_t measured_frames_;
+
+        // Время анимации
+        float time_;
+
+        // Иерархия объемов объектов и объемы объектов текущего кадра
+        utils::geometry::Bvh bvh_;
+        std::vector<utils::geometry::Aabb> object_bounds_;
+        // Кол-во объектов и стоимость дерева (SAH) на момент построения
+        int bvh_object_count_;
+        float bvh_build_cost_;
+
+        // Видимые объекты (при отсечении по иерархии)
+        std::vector<Instance> visible_instances_;
+        bool use_culling_;
+
+        // Выбранный лучом объект и его соседи
+        int picked_object_;
+        size_t picked_neighbours_;
+
+        // Замеры работы с иерархией
+        float bvh_build_ms_, bvh_refit_ms_, bvh_query_ms_;
+        size_t bvh_rebuilds_;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,332 @@
+#define GLM_FORCE_SWIZZLE
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <utils/files/load.hpp>
+#include <utils/geometry/generate.hpp>
+#include <stb_image.h>
+#include <imgui.h>
+#include <random>
+#include <chrono>
+
+#include "draw-order.h"
+
+// Соотношение сторон экрана
+extern float g_screen_aspect;
+// Включен ли UI (свободная камера доступна вы отключенном UI)
+extern bool g_use_ui;
+// Управление
+extern bool g_key_forward;
+extern bool g_key_backward;
+extern bool g_key_left;
+extern bool g_key_right;
+extern bool g_key_downward;
+extern bool g_key_upward;
+extern float g_mouse_delta_x;
+extern float g_mouse_delta_y;
+
+namespace scenes
+{
+    DrawOrder::DrawOrder()
+            : projection_(glm::mat4(1.0f))
+            , view_(glm::mat4(1.0f))
+            , camera_pos_(glm::vec3(0.0f, 12.0f, 30.0f))
+            , prev_camera_pos_(camera_pos_)
+            , prev_cam_yaw_(0.0f)
+            , prev_cam_pitch_(-25.0f)
+            , z_far_(200.0f)
+            , z_near_(0.1f)
+            , fov_(45.0f)
+            , cam_yaw_(0.0f)
+            , cam_pitch_(-25.0f)
+            , cam_sensitivity_(0.1f)
+            , cam_speed_(5.0f)
+            , cam_movement_(0.0f)
+            , use_sorting_(true)
+            , stat_sort_ms_(0.0f)
+    {}
+
+    DrawOrder::~DrawOrder() = default;
+
+    /**
+     * Загрузка шейдеров, геометрии, текстур и расстановка объектов
+     * Объекты добавляются в очередь в случайном порядке (с фиксированным зерном)
+     */
+    void DrawOrder::load()
+    {
+        // Шейдеры (вариант без текстуры и с текстурой)
+        {
+            // Загрузить исходные коды шейдеров
+            const std::unordered_map<GLuint, std::string> shader_sources = {
+                    {GL_VERTEX_SHADER,  utils::files::load_as_text("../content/shaders/draw-order/base.vert")},
+                    {GL_FRAGMENT_SHADER, utils::files::load_as_text("../content/shaders/draw-order/base.frag")}
+            };
+
+            const std::vector<std::string> uniforms = {
+                    "model",
+                    "view",
+                    "projection",
+                    "object_color",
+                    "texture_sampler"
+            };
+
+            // Создать OpenGL ресурсы шейдеров из исходников
+            shaders_[0] = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources, uniforms);
+            shaders_[1] = utils::gl::Shader<ShaderUniforms, GLint>(shader_sources, uniforms, {{"TEXTURED", "1"}});
+        }
+
+        // Геометрия (каждый меш в собственных буферах, смена меша - смена VAO)
+        {
+            std::vector<GLuint> indices = {};
+            std::vector<Vertex> vertices = utils::geometry::gen_cube<Vertex>(1.0f, &indices);
+            geometries_[0] = utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+
+            // Тесселированные меши генерируются сразу в подготовленные буферы
+            auto gen_mesh = [&](const utils::geometry::MeshSize& size, const auto& generate)
+            {
+                vertices.resize(size.vertex_count);
+                indices.resize(size.index_count);
+                generate(vertices.data(), indices.data());
+                return utils::gl::Geometry<Vertex>(vertices, indices, Vertex::Layout::attributes());
+            };
+
+            geometries_[1] = gen_mesh(utils::geometry::gen_sphere_uv_size(32, 16), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_sphere_uv(v, i, 0.6f, 32, 16);
+            });
+            geometries_[2] = gen_mesh(utils::geometry::gen_torus_size(48, 24), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_torus(v, i, 0.45f, 0.18f, 48, 24);
+            });
+            geometries_[3] = gen_mesh(utils::geometry::gen_cylinder_size(32, 4), [&](Vertex* v, GLuint* i){
+                utils::geometry::gen_cylinder(v, i, 0.45f, 1.0f, 32, 4, true);
+            });
+        }
+
+        // Текстуры
+        {
+            // Подготовка к загрузке текстурных данных
+            int width = 0, height = 0, channels = 0;
+            unsigned char* bytes;
+            stbi_set_flip_vertically_on_load(true);
+
+            // Загрузить данные из файлов, создать OpenGL ресурсы, удалить данные
+            bytes = stbi_load("../content/textures/box_1.png", &width, &height, &channels, STBI_rgb_alpha);
+            textures_[0] = utils::gl::Texture2D(bytes, width, height, GL_LINEAR_MIPMAP_LINEAR, utils::gl::Texture2D::EColorSpace::RGB_ALPHA, true);
+            stbi_image_free(bytes);
+
+            bytes = stbi_load("../content/textures/box_2.png", &width, &height, &channels, STBI_rgb_alpha);
+            textures_[1] = utils::gl::Texture2D(bytes, width, height, GL_LINEAR_MIPMAP_LINEAR, utils::gl::Texture2D::EColorSpace::RGB_ALPHA, true);
+            stbi_image_free(bytes);
+        }
+
+        // Объекты (сетка на плоскости, меш и текстура выбираются случайно, порядок перемешан)
+        {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::uniform_int_distribution<size_t> mesh(0, MESH_COUNT - 1);
+            std::uniform_int_distribution<int> texture(-1, static_cast<int>(TEXTURE_COUNT) - 1);
+
+            for(int x = 0; x < GRID_SIZE; x++)
+            {
+                for(int z = 0; z < GRID_SIZE; z++)
+                {
+                    Object object = {};
+                    object.model =
+                            glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(x - GRID_SIZE / 2) * 1.6f, 0.0f, static_cast<float>(z - GRID_SIZE / 2) * 1.6f)) *
+                            glm::rotate(glm::mat4(1.0f), unit(rng) * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
+                    object.color = glm::vec3(0.4f) + glm::vec3(unit(rng), unit(rng), unit(rng)) * 0.6f;
+                    object.mesh = mesh(rng);
+                    object.texture = texture(rng);
+                    objects_.push_back(object);
+                }
+            }
+
+            std::shuffle(objects_.begin(), objects_.end(), rng);
+        }
+
+        // Проверка доступности ресурсов
+        for(const auto& shader : shaders_) assert(shader.ready());
+        for(const auto& geometry : geometries_) assert(geometry.ready());
+        for(const auto& texture : textures_) assert(texture.ready());
+    }
+
+    /**
+     * Выгрузка всех использованных ресурсов граф. API
+     */
+    void DrawOrder::unload()
+    {
+        for(auto& shader : shaders_) shader.unload();
+        for(auto& geometry : geometries_) geometry.unload();
+        for(auto& texture : textures_) texture.unload();
+
+        objects_.clear();
+        queue_.clear();
+    }
+
+    /**
+     * Обновление камеры и заполнение очереди рисования
+     * @param delta Временная дельта кадра
+     */
+    void DrawOrder::update(float delta)
+    {
+        // Состояние предыдущего шага
+        prev_camera_pos_ = camera_pos_;
+        prev_cam_yaw_ = cam_yaw_;
+        prev_cam_pitch_ = cam_pitch_;
+
+        // Управление свободной камерой
+        if(!g_use_ui)
+        {
+            cam_pitch_ -= (g_mouse_delta_y * cam_sensitivity_);
+            cam_yaw_ -= (g_mouse_delta_x * cam_sensitivity_);
+
+            cam_movement_ = {};
+            if(g_key_forward) cam_movement_.z = -1.0f;
+            else if(g_key_backward) cam_movement_.z = 1.0f;
+            if (g_key_left) cam_movement_.x = -1.0f;
+            else if(g_key_right) cam_movement_.x = 1.0f;
+            if (g_key_upward) cam_movement_.y = 1.0f;
+            else if(g_key_downward) cam_movement_.y = -1.0f;
+        }
+
+        // Перспективная проекция (с учетом соотношения экрана)
+        projection_ = glm::perspective(fov_, g_screen_aspect, z_near_, z_far_);
+
+        // Камера
+        {
+            // Поворот камеры
+            glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_yaw_),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(cam_pitch_),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Учесть поворот камеры при движении (ось Y всегда направлена вертикально)
+            glm::vec2 h = glm::vec2(cam_movement_.x, cam_movement_.z);
+            glm::vec3 d = glm::length2(h) > 0.0f ? glm::normalize(glm::vec3(h.x, 0.0f, h.y)) : glm::vec3(0.0f);
+            glm::vec4 d_rot = cam_rotation * glm::vec4(d, 0.0f);
+            camera_pos_ += (glm::vec3(d_rot.x, d_rot.y + cam_movement_.y, d_rot.z) * cam_speed_ * delta);
+        }
+
+        // Заполнение очереди (непрозрачные объекты одного прохода, от ближних к дальним внутри одного состояния)
+        queue_.clear();
+        for(size_t i = 0; i < objects_.size(); i++)
+        {
+            const auto& object = objects_[i];
+            const auto& geometry = geometries_[object.mesh];
+            const size_t shader = object.texture < 0 ? 0 : 1;
+
+            utils::gl::DrawPacket packet;
+            packet.program_id = shaders_[shader].id();
+            packet.vao_id = geometry.vao_id();
+            packet.texture_id = object.texture < 0 ? 0 : textures_[object.texture].id();
+            packet.index_type = geometry.index_type();
+            packet.index_count = geometry.index_count();
+            packet.user_data = static_cast<uint32_t>(i);
+
+            // Материал - сочетание текстуры и меша (оба меняют состояние)
+            const auto material = static_cast<uint32_t>((object.texture + 1) * MESH_COUNT + object.mesh);
+            const float depth = glm::length(glm::vec3(object.model[3]) - camera_pos_);
+            queue_.submit(utils::gl::make_sort_key(0, static_cast<uint32_t>(shader), material, depth), packet);
+        }
+
+        // Сортировка по ключу
+        if(use_sorting_)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            queue_.sort();
+            const auto end = std::chrono::high_resolution_clock::now();
+            stat_sort_ms_ = std::chrono::duration<float, std::milli>(end - start).count();
+        }
+
+        // Смены состояния в порядке добавления и после сортировки (без вызовов OpenGL)
+        stat_submitted_ = queue_.count_state_changes(false);
+        if(use_sorting_) stat_sorted_ = queue_.count_state_changes(true);
+    }
+
+    /**
+     * Сортировка очереди и счетчики смен состояния
+     * @param delta Временная дельта кадра
+     */
+    void DrawOrder::update_ui([[maybe_unused]] float delta)
+    {
+        if(ImGui::Begin("Render queue", nullptr))
+        {
+            ImGui::Checkbox("Sort by key", &use_sorting_);
+            ImGui::Text("Draws: %u", (unsigned)queue_.size());
+
+            // Смены программы, VAO и текстуры (до и после сортировки)
+            const auto print_stats = [](const char* label, const utils::gl::RenderQueueStats& stats){
+                ImGui::Text("%s: %u (programs %u, VAOs %u, textures %u)", label,
+                            (unsigned)stats.state_changes(),
+                            (unsigned)stats.program_changes,
+                            (unsigned)stats.vao_changes,
+                            (unsigned)stats.texture_changes);
+            };
+
+            print_stats("Submitted order", stat_submitted_);
+            if(use_sorting_)
+            {
+                print_stats("Sorted", stat_sorted_);
+                ImGui::Text("Radix sort: %.3f ms", stat_sort_ms_);
+            }
+            print_stats("Executed", stat_executed_);
+
+            ImGui::SetWindowSize({380.0f, 140.0f}, ImGuiCond_Once);
+        }
+        ImGui::End();
+    }
+
+    /**
+     * Рисование сцены
+     * Выполнение команд очереди (после сортировки, либо в порядке добавления)
+     * Камера строится по состоянию между двумя последними шагами обновления (очередь отсортирована для камеры шага)
+     * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+     */
+    void DrawOrder::render(float alpha)
+    {
+        // Камера
+        {
+            // Поворот камеры
+            const glm::mat4 cam_rotation =
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_yaw_, cam_yaw_, alpha)),glm::vec3(0.0f,1.0f,0.0f)) *
+                    glm::rotate(glm::mat4(1.0f), glm::radians(glm::mix(prev_cam_pitch_, cam_pitch_, alpha)),glm::vec3(1.0f,0.0f,0.0f));
+
+            // Смещение камеры
+            const glm::mat4 cam_translate = glm::translate(glm::mat4(1.0f), glm::mix(prev_camera_pos_, camera_pos_, alpha));
+
+            // Инверсия (матрица вида будет конвертировать глобальные координаты в пространство камеры)
+            view_ = glm::inverse(cam_translate * cam_rotation);
+        }
+
+        // Считать передние грани заданными по часовой стрелке
+        glFrontFace(GL_CW);
+        // Отбрасывать задние грани
+        glEnable(GL_CULL_FACE);
+        // Включить тест глубины
+        glEnable(GL_DEPTH_TEST);
+
+        // Текущий шейдер (выбирается при смене программы)
+        const utils::gl::Shader<ShaderUniforms, GLint>* shader = nullptr;
+
+        stat_executed_ = queue_.execute(
+                [&](GLuint program_id){
+                    // Матрицы проекции и вида задаются один раз на смену программы
+                    shader = &shaders_[program_id == shaders_[0].id() ? 0 : 1];
+                    glUniformMatrix4fv(shader->uniforms().projection, 1, GL_FALSE, glm::value_ptr(projection_));
+                    glUniformMatrix4fv(shader->uniforms().view, 1, GL_FALSE, glm::value_ptr(view_));
+                    glUniform1i(shader->uniforms().texture, 0);
+                },
+                [&](const utils::gl::DrawPacket& packet){
+                    const auto& object = objects_[packet.user_data];
+                    glUniformMatrix4fv(shader->uniforms().model, 1, GL_FALSE, glm::value_ptr(object.model));
+                    glUniform3fv(shader->uniforms().color, 1, glm::value_ptr(object.color));
+                },
+                use_sorting_);
+    }
+
+    /**
+     * Имя примера
+     * @return Строка с именем
+     */
+    const char *DrawOrder::name()
+    {
+        return "Render queue";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "utils/gl/shader.hpp"
+#include "utils/gl/geometry.hpp"
+#include "utils/gl/texture-2d.hpp"
+#include "utils/gl/render-queue.hpp"
+#include "utils/geometry/layout.hpp"
+
+#include "../scene.h"
+
+namespace scenes
+{
+    /**
+     * Пример очереди рисования
+     * Объекты с разными шейдерами, мешами и текстурами добавляются в очередь в произвольном порядке,
+     * очередь сортируется по 64-битному ключу (проход, шейдер, материал, глубина), состояние меняется только при смене полей
+     */
+    class DrawOrder : public Scene
+    {
+    public:
+        /**
+         * Описание одиночной вершины
+         * В данном примере используется положение, UV координаты и нормаль
+         */
+        struct Vertex
+        {
+            glm::vec3 position;
+            glm::vec2 uv;
+            glm::vec3 normal;
+
+            // Раскладка вершины (атрибуты шейдера и данные для генераторов геометрии)
+            using Layout = utils::geometry::VertexLayout<
+                    utils::geometry::Attribute<utils::geometry::POSITION, &Vertex::position, 0>,
+                    utils::geometry::Attribute<utils::geometry::UV, &Vertex::uv, 1>,
+                    utils::geometry::Attribute<utils::geometry::NORMAL, &Vertex::normal, 2>>;
+        };
+
+        /**
+         * Идентификатор uniform переменных в шейдере
+         * Используется при инициализации шейдера
+         */
+        struct ShaderUniforms
+        {
+            GLint model;
+            GLint view;
+            GLint projection;
+            GLint color;
+            GLint texture;
+        };
+
+        /**
+         * Объект сцены
+         */
+        struct Object
+        {
+            glm::mat4 model;
+            glm::vec3 color;
+            // Индекс меша и текстуры (-1 - без текстуры, шейдер без выборки)
+            size_t mesh;
+            int texture;
+        };
+
+        /**
+         * Кол-во мешей, текстур и шейдеров
+         */
+        constexpr static size_t MESH_COUNT = 4;
+        constexpr static size_t TEXTURE_COUNT = 2;
+        constexpr static size_t SHADER_COUNT = 2;
+
+        /**
+         * Размер сетки объектов (по каждой оси)
+         */
+        constexpr static int GRID_SIZE = 24;
+
+    public:
+        DrawOrder();
+        ~DrawOrder() override;
+
+        /**
+         * Загрузка шейдеров, геометрии, текстур и расстановка объектов
+         */
+        void load() override;
+
+        /**
+         * Выгрузка всех использованных ресурсов граф. API
+         */
+        void unload() override;
+
+        /**
+         * Обновление камеры и заполнение очереди рисования
+         * @param delta Временная дельта кадра
+         */
+        void update(float delta) override;
+
+        /**
+         * Сортировка очереди и счетчики смен состояния
+         * @param delta Временная дельта кадра
+         */
+        void update_ui(float delta) override;
+
+        /**
+         * Рисование сцены
+         * Выполнение команд очереди (после сортировки, либо в порядке добавления)
+         * @param alpha Доля шага обновления, прошедшая после последнего update (для интерполяции)
+         */
+        void render(float alpha) override;
+
+        /**
+         * Имя примера
+         * @return Строка с именем
+         */
+        const char* name() override;
+
+    protected:
+        // Ресурсы (шейдер без текстуры и с текстурой)
+        utils::gl::Shader<ShaderUniforms, GLint> shaders_[SHADER_COUNT];
+        utils::gl::Geometry<Vertex> geometries_[MESH_COUNT];
+        utils::gl::Texture2D textures_[TEXTURE_COUNT];
+
+        // Объекты (в порядке добавления в очередь)
+        std::vector<Object> objects_;
+
+        // Очередь рисования кадра
+        utils::gl::RenderQueue queue_;
+
+        // Матрицы для преобразования вершин
+        glm::mat4 projection_;
+        glm::mat4 view_;
+
+        // Положение камеры
+        glm::vec3 camera_pos_;
+
+        // Положение и поворот камеры на предыдущем шаге обновления (для интерполяции)
+        glm::vec3 prev_camera_pos_;
+        GLfloat prev_cam_yaw_, prev_cam_pitch_;
+
+        // Параметры для построения матрицы проекции
+        GLfloat z_far_, z_near_, fov_;
+
+        // Доп параметры для управления камерой
+        GLfloat cam_yaw_, cam_pitch_, cam_sensitivity_, cam_speed_;
+        glm::vec3 cam_movement_;
+
+        // Сортировать очередь (иначе команды выполняются в порядке добавления)
+        bool use_sorting_;
+
+        // Смены состояния в порядке добавления и после сортировки, выполненные за кадр
+        utils::gl::RenderQueueStats stat_submitted_;
+        utils::gl::RenderQueueStats stat_sorted_;
+        utils::gl::RenderQueueStats stat_executed_;
+        // Время сортировки (мс)
+        float stat_sort_ms_;
+    };
+}
\ No newline at end of file
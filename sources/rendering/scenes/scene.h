@@ -25,7 +25,8 @@ namespace scenes
 
         /**
          * Обновить данные сцены (положения, камеры, скелеты, прочее)
-         * @param delta Разница в секундах между кадрами
+         * Вызывается с фиксированным шагом (за кадр может быть выполнено несколько шагов либо ни одного)
+         * @param delta Шаг обновления в секундах
          */
         virtual void update(float delta) = 0;
 
@@ -37,8 +38,10 @@ namespace scenes
 
         /**
          * Все необходимые команды рисования для отображения сцены
+         * @param alpha Доля шага обновления, прошедшая после последнего update (0..1) - для интерполяции
+         * между предыдущим и текущим состоянием сцены
          */
-        virtual void render() = 0;
+        virtual void render(float alpha) = 0;
 
         /**
          * Название сцены (используется для вывода на UI)